@@ -288,6 +288,8 @@ pvr::Result OpenGLESIntroducingPVRUtils::renderFrame()
 
 	// Sets the _scene animation to this _frame
 	animInst.updateAnimation(_frame);
+	// Bring the world matrix cache up to date once, for all the world matrix queries of this frame
+	_scene->updateWorldMatrices();
 
 	setOpenglState();
 
@@ -492,6 +492,8 @@ void MultiviewVR::renderToMultiViewFbo()
 
 	// Sets the scene animation to this _frame
 	animInstance.updateAnimation(_frame);
+	// Bring the world matrix cache up to date once, for all the world matrix queries of this frame
+	_scene->updateWorldMatrices();
 
 	// Get the direction of the first light from the scene
 	glm::vec3 lightDirVec3;
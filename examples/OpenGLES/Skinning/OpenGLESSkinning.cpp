@@ -98,6 +98,7 @@ class OpenGLESSkinning : public pvr::Shell
 	// 3D Model
 	pvr::assets::ModelHandle _scene;
 	glm::mat4x4 _projectionMatrix;
+	std::vector<glm::mat4> _bonePalette;
 
 	uint32_t _lightPositionIdx;
 	uint32_t _viewProjectionIdx;
@@ -373,6 +374,8 @@ pvr::Result OpenGLESSkinning::renderFrame()
 	}
 
 	animInst.updateAnimation(_currentFrame);
+	// Bring the world matrix cache up to date once, for all the world matrix queries of this frame
+	_scene->updateWorldMatrices();
 	// Setting up the "view projection" matrix only once - it doesn't change with the object
 	// Technically the camera projection stats COULD be animated, but we don't check for that
 	// and we assume the camera projection parameters are static - hence we set it up just once,
@@ -504,9 +507,11 @@ void OpenGLESSkinning::renderNode(uint32_t nodeId, const glm::mat4& viewMatrix,
 		}
 		_deviceResources->ssboView.pointToMappedMemory(bones);
 		auto root = _deviceResources->ssboView;
+		_bonePalette.resize(numBones);
+		_scene->getBonePalette(nodeId, pvr::assets::BonePaletteFormat::Mat4x4, _bonePalette.data());
 		for (uint32_t boneId = 0; boneId < numBones; ++boneId)
 		{
-			const auto& bone = _scene->getBoneWorldMatrix(nodeId, boneId);
+			const glm::mat4& bone = _bonePalette[boneId];
 
 			auto bonesArrayRoot = root.getElement(_bonesIdx, boneId);
 			bonesArrayRoot.getElement(_boneMatrixIdx).setValue(bone);
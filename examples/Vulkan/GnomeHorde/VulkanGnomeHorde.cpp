@@ -79,13 +79,16 @@ struct TileProcessingResult
 };
 
 class VulkanGnomeHorde;
+// The queues are bounded ring buffers, large enough for all the work of a frame, so that dispatching the work of a
+// frame never allocates.
 // This queue is to enqueue tasks used for the "determine visibility" producer queues
 // There, our "task" granularity is a "line" of tiles to process.
-typedef pvr::LockedQueue<int32_t> LineTasksQueue;
+typedef pvr::LockedQueue<int32_t, 64> LineTasksQueue;
 
 // This queue is used to create command buffers, so its task granularity is a tile.
 // It is Used for the "create command buffers for tile XXX" queues
-typedef pvr::LockedQueue<TileProcessingResult> TileResultsQueue;
+typedef pvr::LockedQueue<TileProcessingResult, 4096> TileResultsQueue;
+static_assert(NUM_TILES_Z <= 64 && NUM_TILES_X * NUM_TILES_Z + NUM_TILES_Z <= 4096, "The work queues must fit all the work of a frame");
 
 class GnomeHordeWorkerThread
 {
@@ -464,6 +464,8 @@ pvr::Result VulkanMultiSampling::renderFrame()
 
 	// Sets the _scene animation to this _frame
 	animInst.updateAnimation(_frame);
+	// Bring the world matrix cache up to date once, for all the world matrix queries of this frame
+	_scene->updateWorldMatrices();
 
 	//  We can build the world view matrix from the camera position, target and an up vector.
 	//  A _scene is composed of nodes. There are 3 types of nodes:
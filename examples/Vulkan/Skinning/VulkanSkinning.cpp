@@ -334,6 +334,8 @@ pvr::Result VulkanSkinning::renderFrame()
 		}
 	}
 	_scene->getAnimationInstance(0).updateAnimation(_currentFrame);
+	// Bring the world matrix cache up to date once, for all the world matrix queries of this frame
+	_scene->updateWorldMatrices();
 
 	// Set the _scene animation to the current frame
 	_deviceResources->mgr.updateAutomaticSemantics(swapchainIndex);
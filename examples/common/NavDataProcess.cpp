@@ -1,4 +1,352 @@
 #include "NavDataProcess.h"
+#include <chrono>
+
+namespace {
+const uint32_t NoEarNode = 0xffffffffu;
+
+// A polygon vertex, in the ring of remaining vertices and in the z-order list used to find vertices near an ear.
+struct EarNode
+{
+	glm::dvec2 point;
+	uint32_t prev, next;
+	uint32_t prevZ, nextZ;
+	uint32_t z;
+	bool removed;
+};
+
+// Ear clipping triangulator working on a linked list of polygon vertices. The vertices are linked anti-clockwise, so an
+// ear is a convex vertex whose triangle with its neighbours contains no reflex vertex.
+class EarClipper
+{
+public:
+	EarClipper(const glm::dvec2* points, uint32_t numPoints, std::vector<std::array<uint32_t, 3> >& triangles)
+		: _nodes(numPoints), _triangles(triangles), _useHash(numPoints > 80), _minBounds(0.0), _invSize(0.0)
+	{
+		double signedArea = 0.0;
+		for (uint32_t i = 0, j = numPoints - 1; i < numPoints; j = i++)
+		{
+			signedArea += (points[j].x - points[i].x) * (points[i].y + points[j].y);
+		}
+		const bool antiClockwise = signedArea >= 0.0;
+		for (uint32_t i = 0; i < numPoints; ++i)
+		{
+			EarNode& node = _nodes[i];
+			node.point = points[i];
+			node.prev = antiClockwise ? (i + numPoints - 1) % numPoints : (i + 1) % numPoints;
+			node.next = antiClockwise ? (i + 1) % numPoints : (i + numPoints - 1) % numPoints;
+			node.prevZ = node.nextZ = NoEarNode;
+			node.z = 0;
+			node.removed = false;
+		}
+
+		if (_useHash)
+		{
+			glm::dvec2 maxBounds = points[0];
+			_minBounds = points[0];
+			for (uint32_t i = 1; i < numPoints; ++i)
+			{
+				_minBounds = glm::min(_minBounds, points[i]);
+				maxBounds = glm::max(maxBounds, points[i]);
+			}
+			const double size = glm::max(maxBounds.x - _minBounds.x, maxBounds.y - _minBounds.y);
+			_invSize = size != 0.0 ? 32767.0 / size : 0.0;
+		}
+	}
+
+	void triangulate()
+	{
+		triangulateRing(filterPoints(0, NoEarNode), 0);
+	}
+
+	void getRemaining(std::vector<uint32_t>& remaining) const
+	{
+		remaining.clear();
+		for (uint32_t i = 0; i < _nodes.size(); ++i)
+		{
+			if (!_nodes[i].removed)
+			{
+				remaining.push_back(i);
+			}
+		}
+	}
+
+private:
+	// Twice the signed area of the triangle a, b, c. Positive if anti-clockwise.
+	double cross(uint32_t a, uint32_t b, uint32_t c) const
+	{
+		const glm::dvec2& pa = _nodes[a].point;
+		const glm::dvec2& pb = _nodes[b].point;
+		const glm::dvec2& pc = _nodes[c].point;
+		return (pb.x - pa.x) * (pc.y - pa.y) - (pb.y - pa.y) * (pc.x - pa.x);
+	}
+
+	bool equals(uint32_t a, uint32_t b) const
+	{
+		return _nodes[a].point == _nodes[b].point;
+	}
+
+	bool isPointInTriangle(uint32_t a, uint32_t b, uint32_t c, uint32_t p) const
+	{
+		return cross(a, b, p) >= 0.0 && cross(b, c, p) >= 0.0 && cross(c, a, p) >= 0.0;
+	}
+
+	// A vertex blocks the ear a, b, c if it is a reflex (or straight) vertex inside the triangle. Only reflex vertices
+	// need to be considered: if a convex vertex is inside the triangle, so is a reflex one.
+	bool blocksEar(uint32_t a, uint32_t b, uint32_t c, uint32_t p) const
+	{
+		return p != a && p != c && !equals(p, a) && !equals(p, c) && isPointInTriangle(a, b, c, p) && cross(_nodes[p].prev, p, _nodes[p].next) <= 0.0;
+	}
+
+	bool isEar(uint32_t ear) const
+	{
+		const uint32_t a = _nodes[ear].prev, c = _nodes[ear].next;
+		if (cross(a, ear, c) <= 0.0)
+		{
+			return false;
+		}
+		for (uint32_t p = _nodes[c].next; p != a; p = _nodes[p].next)
+		{
+			if (blocksEar(a, ear, c, p))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// As isEar, but only visits the vertices whose z-order is within the bounding box of the triangle.
+	bool isEarHashed(uint32_t ear) const
+	{
+		const uint32_t a = _nodes[ear].prev, c = _nodes[ear].next;
+		if (cross(a, ear, c) <= 0.0)
+		{
+			return false;
+		}
+		const glm::dvec2 minTriangle = glm::min(glm::min(_nodes[a].point, _nodes[ear].point), _nodes[c].point);
+		const glm::dvec2 maxTriangle = glm::max(glm::max(_nodes[a].point, _nodes[ear].point), _nodes[c].point);
+		const uint32_t minZ = zOrder(minTriangle), maxZ = zOrder(maxTriangle);
+
+		for (uint32_t p = _nodes[ear].prevZ; p != NoEarNode && _nodes[p].z >= minZ; p = _nodes[p].prevZ)
+		{
+			if (blocksEar(a, ear, c, p))
+			{
+				return false;
+			}
+		}
+		for (uint32_t n = _nodes[ear].nextZ; n != NoEarNode && _nodes[n].z <= maxZ; n = _nodes[n].nextZ)
+		{
+			if (blocksEar(a, ear, c, n))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Interleave the bits of the (15 bit) quantized co-ordinates
+	uint32_t zOrder(const glm::dvec2& point) const
+	{
+		uint32_t x = static_cast<uint32_t>((point.x - _minBounds.x) * _invSize);
+		uint32_t y = static_cast<uint32_t>((point.y - _minBounds.y) * _invSize);
+		x = (x | (x << 8)) & 0x00FF00FF;
+		x = (x | (x << 4)) & 0x0F0F0F0F;
+		x = (x | (x << 2)) & 0x33333333;
+		x = (x | (x << 1)) & 0x55555555;
+		y = (y | (y << 8)) & 0x00FF00FF;
+		y = (y | (y << 4)) & 0x0F0F0F0F;
+		y = (y | (y << 2)) & 0x33333333;
+		y = (y | (y << 1)) & 0x55555555;
+		return x | (y << 1);
+	}
+
+	// Link the vertices of the ring in z-order.
+	void indexCurve(uint32_t start)
+	{
+		std::vector<uint32_t> ring;
+		uint32_t p = start;
+		do
+		{
+			_nodes[p].z = zOrder(_nodes[p].point);
+			ring.push_back(p);
+			p = _nodes[p].next;
+		} while (p != start);
+
+		std::sort(ring.begin(), ring.end(), [this](uint32_t lhs, uint32_t rhs) { return _nodes[lhs].z < _nodes[rhs].z; });
+		for (uint32_t i = 0; i < ring.size(); ++i)
+		{
+			_nodes[ring[i]].prevZ = i > 0 ? ring[i - 1] : NoEarNode;
+			_nodes[ring[i]].nextZ = i + 1 < ring.size() ? ring[i + 1] : NoEarNode;
+		}
+	}
+
+	void removeNode(uint32_t p)
+	{
+		EarNode& node = _nodes[p];
+		_nodes[node.next].prev = node.prev;
+		_nodes[node.prev].next = node.next;
+		if (node.prevZ != NoEarNode)
+		{
+			_nodes[node.prevZ].nextZ = node.nextZ;
+		}
+		if (node.nextZ != NoEarNode)
+		{
+			_nodes[node.nextZ].prevZ = node.prevZ;
+		}
+		node.removed = true;
+	}
+
+	// Remove duplicate and collinear vertices. Returns a vertex of the remaining ring.
+	uint32_t filterPoints(uint32_t start, uint32_t end)
+	{
+		if (start == NoEarNode)
+		{
+			return start;
+		}
+		if (end == NoEarNode)
+		{
+			end = start;
+		}
+		uint32_t p = start;
+		bool again;
+		do
+		{
+			again = false;
+			if (equals(p, _nodes[p].next) || cross(_nodes[p].prev, p, _nodes[p].next) == 0.0)
+			{
+				removeNode(p);
+				p = end = _nodes[p].prev;
+				if (p == _nodes[p].next)
+				{
+					break;
+				}
+				again = true;
+			}
+			else
+			{
+				p = _nodes[p].next;
+			}
+		} while (again || p != end);
+		return end;
+	}
+
+	int orientation(uint32_t a, uint32_t b, uint32_t c) const
+	{
+		const double value = cross(a, b, c);
+		return value > 0.0 ? 1 : (value < 0.0 ? -1 : 0);
+	}
+
+	bool onSegment(uint32_t p, uint32_t q, uint32_t r) const
+	{
+		const glm::dvec2 &pp = _nodes[p].point, &pq = _nodes[q].point, &pr = _nodes[r].point;
+		return pq.x <= glm::max(pp.x, pr.x) && pq.x >= glm::min(pp.x, pr.x) && pq.y <= glm::max(pp.y, pr.y) && pq.y >= glm::min(pp.y, pr.y);
+	}
+
+	bool intersects(uint32_t p1, uint32_t q1, uint32_t p2, uint32_t q2) const
+	{
+		const int o1 = orientation(p1, q1, p2), o2 = orientation(p1, q1, q2);
+		const int o3 = orientation(p2, q2, p1), o4 = orientation(p2, q2, q1);
+		return (o1 != o2 && o3 != o4) || (o1 == 0 && onSegment(p1, p2, q1)) || (o2 == 0 && onSegment(p1, q2, q1)) || (o3 == 0 && onSegment(p2, p1, q2)) ||
+			(o4 == 0 && onSegment(p2, q1, q2));
+	}
+
+	// Whether the diagonal a-b starts inside the polygon at a
+	bool isLocallyInside(uint32_t a, uint32_t b) const
+	{
+		const uint32_t prev = _nodes[a].prev, next = _nodes[a].next;
+		return cross(prev, a, next) > 0.0 ? cross(a, b, next) <= 0.0 && cross(a, prev, b) <= 0.0 : cross(a, b, prev) > 0.0 || cross(a, next, b) > 0.0;
+	}
+
+	// Clip the small self-intersections (a-p-p.next-b where a-p crosses p.next-b) that stop ears from being found.
+	uint32_t cureLocalIntersections(uint32_t start)
+	{
+		uint32_t p = start;
+		do
+		{
+			const uint32_t a = _nodes[p].prev, b = _nodes[_nodes[p].next].next;
+			if (!equals(a, b) && intersects(a, p, _nodes[p].next, b) && isLocallyInside(a, b) && isLocallyInside(b, a))
+			{
+				_triangles.push_back(std::array<uint32_t, 3>{ a, p, b });
+				removeNode(_nodes[p].next);
+				removeNode(p);
+				p = start = b;
+			}
+			p = _nodes[p].next;
+		} while (p != start);
+		return filterPoints(p, NoEarNode);
+	}
+
+	// Clip ears off the ring until only two vertices remain. If no ear can be found, retry after removing degenerate
+	// vertices (pass 1), then after curing local self-intersections (pass 2), then give up.
+	void triangulateRing(uint32_t ear, int pass)
+	{
+		if (ear == NoEarNode || _nodes[ear].removed)
+		{
+			return;
+		}
+		if (pass == 0 && _useHash)
+		{
+			indexCurve(ear);
+		}
+		uint32_t stop = ear;
+		while (_nodes[ear].prev != _nodes[ear].next)
+		{
+			const uint32_t prev = _nodes[ear].prev, next = _nodes[ear].next;
+			if (_useHash ? isEarHashed(ear) : isEar(ear))
+			{
+				_triangles.push_back(std::array<uint32_t, 3>{ prev, ear, next });
+				removeNode(ear);
+				// Skipping the next vertex leads to fewer sliver triangles
+				ear = stop = _nodes[next].next;
+				continue;
+			}
+			ear = next;
+			if (ear == stop)
+			{
+				if (pass == 0)
+				{
+					triangulateRing(filterPoints(ear, NoEarNode), 1);
+				}
+				else if (pass == 1)
+				{
+					triangulateRing(cureLocalIntersections(filterPoints(ear, NoEarNode)), 2);
+				}
+				break;
+			}
+		}
+	}
+
+	std::vector<EarNode> _nodes;
+	std::vector<std::array<uint32_t, 3> >& _triangles;
+	bool _useHash;
+	glm::dvec2 _minBounds;
+	double _invSize;
+};
+} // namespace
+
+void triangulatePolygon(const glm::dvec2* points, uint32_t numPoints, std::vector<std::array<uint32_t, 3> >& outTriangles, std::vector<uint32_t>* outRemaining)
+{
+	outTriangles.clear();
+	if (numPoints < 3)
+	{
+		if (outRemaining)
+		{
+			outRemaining->clear();
+			for (uint32_t i = 0; i < numPoints; ++i)
+			{
+				outRemaining->push_back(i);
+			}
+		}
+		return;
+	}
+	outTriangles.reserve(numPoints - 2);
+	EarClipper clipper(points, numPoints, outTriangles);
+	clipper.triangulate();
+	if (outRemaining)
+	{
+		clipper.getRemaining(*outRemaining);
+	}
+}
+
 glm::dvec3 NavDataProcess::findIntersect(const glm::dvec2 minBounds, const glm::dvec2 maxBounds, const glm::dvec2 inPoint, const glm::dvec2 outPoint) const
 {
 	double m = (inPoint.y - outPoint.y) / (inPoint.x - outPoint.x);
@@ -109,88 +457,37 @@ std::array<glm::dvec2, 2> NavDataProcess::findPerpendicularPoints(const glm::dve
 
 void NavDataProcess::triangulate(std::vector<uint64_t>& nodeIds, std::vector<std::array<uint64_t, 3> >& triangles) const
 {
+	const auto startTime = std::chrono::high_resolution_clock::now();
 	triangles.clear();
-	if (nodeIds.front() == nodeIds.back())
+	if (!nodeIds.empty() && nodeIds.front() == nodeIds.back())
 	{
 		nodeIds.pop_back();
 	}
 
-	while (nodeIds.size() >= 3)
+	// Look every node up once, rather than once per ear test.
+	std::vector<glm::dvec2> points(nodeIds.size());
+	for (uint32_t i = 0; i < nodeIds.size(); ++i)
 	{
-		size_t size = nodeIds.size();
-
-		for (uint32_t i = 0; i < nodeIds.size(); ++i)
-		{
-			Vertex prevNode;
-			Vertex nextNode;
-			Vertex currentNode = _osm.getNodeById(nodeIds[i]);
-			std::vector<uint64_t> otherNodes = nodeIds;
-			otherNodes.erase(otherNodes.begin() + i);
-
-			if (i == 0)
-			{
-				prevNode = _osm.getNodeById(nodeIds.back());
-				nextNode = _osm.getNodeById(nodeIds[1]);
-				otherNodes.pop_back();
-				otherNodes.erase(otherNodes.begin());
-			}
-			else if (i == (nodeIds.size() - 1))
-			{
-				prevNode = _osm.getNodeById(nodeIds[i - 1]);
-				nextNode = _osm.getNodeById(nodeIds[0]);
-				otherNodes.pop_back();
-				otherNodes.erase(otherNodes.begin());
-			}
-			else
-			{
-				prevNode = _osm.getNodeById(nodeIds[i - 1]);
-				nextNode = _osm.getNodeById(nodeIds[i + 1]);
-				otherNodes.erase(otherNodes.begin() + i);
-				otherNodes.erase(otherNodes.begin() + i - 1);
-			}
-
-			// Check if the vertex is interior or exterior
-			if (checkWinding(std::vector<glm::dvec2>{ prevNode.coords, currentNode.coords, nextNode.coords }) == pvr::PolygonWindingOrder::FrontFaceCW)
-				continue;
-
-			// Determine if any of the other points are inside the triangle
-			bool pointInTriangle = false;
-			for (uint32_t j = 0; j < otherNodes.size(); ++j)
-			{
-				glm::dvec2 prevPoint = prevNode.coords - currentNode.coords;
-				glm::dvec2 nextPoint = nextNode.coords - currentNode.coords;
-				glm::dvec2 currentPoint = _osm.getNodeById(otherNodes[j]).coords - currentNode.coords;
-				double d = prevPoint.x * nextPoint.y - nextPoint.x * prevPoint.y;
-
-				double currentWeight =
-					(currentPoint.x * (prevPoint.y - nextPoint.y) + currentPoint.y * (nextPoint.x - prevPoint.x) + prevPoint.x * nextPoint.y - nextPoint.x * prevPoint.y) / d;
-
-				double prevWeight = (currentPoint.x * nextPoint.y - currentPoint.y * nextPoint.x) / d;
-				double nextWeight = (currentPoint.y * prevPoint.x - currentPoint.x * prevPoint.y) / d;
-
-				if ((currentWeight > 0.0) && (currentWeight < 1.0) && (prevWeight > 0.0) && (prevWeight < 1.0) && (nextWeight > 0.0) && (nextWeight < 1.0))
-				{
-					pointInTriangle = true;
-					break;
-				}
-			}
-
-			if (pointInTriangle)
-			{
-				continue;
-			}
+		points[i] = _osm.getNodeById(nodeIds[i]).coords;
+	}
 
-			// Add the new triangle and remove the necessary point
-			triangles.push_back(std::array<uint64_t, 3>{ prevNode.id, currentNode.id, nextNode.id });
-			nodeIds.erase(nodeIds.begin() + i);
-			break;
-		}
+	std::vector<std::array<uint32_t, 3> > indices;
+	std::vector<uint32_t> remaining;
+	triangulatePolygon(points.data(), static_cast<uint32_t>(points.size()), indices, &remaining);
 
-		if (size == nodeIds.size())
-		{
-			break;
-		}
+	triangles.reserve(indices.size());
+	for (uint32_t i = 0; i < indices.size(); ++i)
+	{
+		triangles.push_back(std::array<uint64_t, 3>{ nodeIds[indices[i][0]], nodeIds[indices[i][1]], nodeIds[indices[i][2]] });
 	}
+	for (uint32_t i = 0; i < remaining.size(); ++i)
+	{
+		nodeIds[i] = nodeIds[remaining[i]];
+	}
+	nodeIds.resize(remaining.size());
+
+	_triangulationTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	++_numTriangulatedPolygons;
 }
 
 BuildingType::BuildingType NavDataProcess::getBuildingType(const Tag* tags, uint32_t numTags) const
@@ -280,6 +280,235 @@ public:
 	}
 };
 
+// Storage keyed by OSM id (nodes, ways, intersections). Entries are stored contiguously in insertion order and never move
+// when entries are added, so references and indices stay valid while the store grows, and ids are mapped to indices with an
+// open-addressing hash table. New ids are generated above getMaxId(), so for OSM files (which are sorted by id) insertion
+// order is also id order. Supports the subset of the std::map interface used by the data processing.
+template<typename T>
+class IdStore
+{
+public:
+	typedef std::pair<const uint64_t, T> value_type;
+	typedef typename std::deque<value_type>::iterator iterator;
+	typedef typename std::deque<value_type>::const_iterator const_iterator;
+
+	IdStore() : _maxId(0), _numSlotsUsed(0) {}
+
+	iterator begin()
+	{
+		return _entries.begin();
+	}
+	iterator end()
+	{
+		return _entries.end();
+	}
+	const_iterator begin() const
+	{
+		return _entries.begin();
+	}
+	const_iterator end() const
+	{
+		return _entries.end();
+	}
+	size_t size() const
+	{
+		return _entries.size();
+	}
+	bool empty() const
+	{
+		return _entries.empty();
+	}
+	void clear()
+	{
+		_entries.clear();
+		_slots.clear();
+		_maxId = 0;
+		_numSlotsUsed = 0;
+	}
+
+	// The largest id added to the store (0 if empty). New entries are given ids above it.
+	uint64_t getMaxId() const
+	{
+		return _maxId;
+	}
+	// Marks the ids up to maxId as taken without storing entries for them.
+	void reserveIds(uint64_t maxId)
+	{
+		_maxId = std::max(_maxId, maxId);
+	}
+
+	// Dense index of an id, or NoIndex.
+	static const uint32_t NoIndex = 0xffffffffu;
+	uint32_t getIndex(uint64_t id) const
+	{
+		if (_slots.empty())
+		{
+			return NoIndex;
+		}
+		const size_t mask = _slots.size() - 1;
+		for (size_t slot = hash(id) & mask;; slot = (slot + 1) & mask)
+		{
+			if (_slots[slot].index == NoIndex || _slots[slot].id == id)
+			{
+				return _slots[slot].index;
+			}
+		}
+	}
+
+	uint64_t getId(uint32_t index) const
+	{
+		return _entries[index].first;
+	}
+	T& at(uint32_t index)
+	{
+		return _entries[index].second;
+	}
+	const T& at(uint32_t index) const
+	{
+		return _entries[index].second;
+	}
+	// The most recently added entry.
+	value_type& back()
+	{
+		return _entries.back();
+	}
+	const value_type& back() const
+	{
+		return _entries.back();
+	}
+
+	iterator find(uint64_t id)
+	{
+		const uint32_t index = getIndex(id);
+		return index == NoIndex ? _entries.end() : _entries.begin() + index;
+	}
+	const_iterator find(uint64_t id) const
+	{
+		const uint32_t index = getIndex(id);
+		return index == NoIndex ? _entries.end() : _entries.begin() + index;
+	}
+
+	// As std::map: Returns the entry with this id, default constructing it if it does not exist.
+	T& operator[](uint64_t id)
+	{
+		uint32_t index = getIndex(id);
+		if (index == NoIndex)
+		{
+			if ((_numSlotsUsed + 1) * 2 > _slots.size())
+			{
+				rehash(std::max<size_t>(_slots.size() * 2, 16));
+			}
+			index = static_cast<uint32_t>(_entries.size());
+			_entries.emplace_back(id, T());
+			insertSlot(id, index);
+			_maxId = std::max(_maxId, id);
+		}
+		return _entries[index].second;
+	}
+
+	// As std::map: Removes the entry with this id, returning the number of entries removed. Removing the most recently added
+	// entry is constant time. Removing any other entry rebuilds the store, which is linear in its size and moves the entries.
+	size_t erase(uint64_t id)
+	{
+		if (_slots.empty())
+		{
+			return 0;
+		}
+		const size_t mask = _slots.size() - 1;
+		size_t slot = hash(id) & mask;
+		while (_slots[slot].index != NoIndex && _slots[slot].id != id)
+		{
+			slot = (slot + 1) & mask;
+		}
+		const uint32_t index = _slots[slot].index;
+		if (index == NoIndex)
+		{
+			return 0;
+		}
+
+		if (index + 1 != _entries.size())
+		{
+			std::deque<value_type> entries;
+			for (uint32_t i = 0; i < _entries.size(); ++i)
+			{
+				if (i != index)
+				{
+					entries.emplace_back(std::move(_entries[i]));
+				}
+			}
+			_entries.swap(entries);
+			rehash(_slots.size());
+			return 1;
+		}
+
+		// Backward shift deletion: Move the following slots of the probe sequence into the hole, unless that would put them
+		// before their home slot.
+		for (size_t next = (slot + 1) & mask; _slots[next].index != NoIndex; next = (next + 1) & mask)
+		{
+			if (((next - (hash(_slots[next].id) & mask)) & mask) >= ((next - slot) & mask))
+			{
+				_slots[slot] = _slots[next];
+				slot = next;
+			}
+		}
+		_slots[slot].index = NoIndex;
+		--_numSlotsUsed;
+		_entries.pop_back();
+		return 1;
+	}
+
+private:
+#pragma pack(push, 4) // force 4byte alignment, 12 byte slots
+	struct Slot
+	{
+		uint64_t id;
+		uint32_t index;
+	};
+#pragma pack(pop)
+
+	static size_t hash(uint64_t id)
+	{
+		id ^= id >> 33;
+		id *= 0xff51afd7ed558ccdull;
+		id ^= id >> 33;
+		return static_cast<size_t>(id);
+	}
+
+	void insertSlot(uint64_t id, uint32_t index)
+	{
+		const size_t mask = _slots.size() - 1;
+		size_t slot = hash(id) & mask;
+		while (_slots[slot].index != NoIndex)
+		{
+			slot = (slot + 1) & mask;
+		}
+		_slots[slot].id = id;
+		_slots[slot].index = index;
+		++_numSlotsUsed;
+	}
+
+	void rehash(size_t numSlots)
+	{
+		Slot emptySlot;
+		emptySlot.id = 0;
+		emptySlot.index = NoIndex;
+		std::vector<Slot>().swap(_slots); // Release the old table first, the slots are rebuilt from the entries
+		_slots.assign(numSlots, emptySlot);
+		_numSlotsUsed = 0;
+		for (uint32_t i = 0; i < _entries.size(); ++i)
+		{
+			insertSlot(_entries[i].first, i);
+		}
+	}
+
+	std::deque<value_type> _entries;
+	std::vector<Slot> _slots;
+	uint64_t _maxId;
+	size_t _numSlotsUsed;
+};
+
+typedef IdStore<Vertex> NodeStore;
+
 // Structure for storing data for an individual map tile.
 struct Tile
 {
@@ -288,7 +517,7 @@ struct Tile
 	glm::vec2 screenMin;
 	glm::vec2 screenMax;
 
-	std::map<uint64_t, Vertex> nodes;
+	NodeStore nodes;
 	std::vector<Way> areaWays;
 	std::vector<Way> roadWays;
 	std::vector<Way> parkingWays;
@@ -324,20 +553,20 @@ struct OSM
 	glm::dvec2 maxLonLat;
 
 	Bounds bounds;
-	std::map<uint64_t, Vertex> nodes;
+	NodeStore nodes;
 	std::vector<uint64_t> original_intersections;
-	std::vector<std::vector<std::map<uint64_t, BoundaryData> > > boundaryNodes;
-	std::map<uint64_t, IntersectionData> intersectionNodes;
+	std::vector<std::vector<IdStore<BoundaryData> > > boundaryNodes;
+	IdStore<IntersectionData> intersectionNodes;
 	std::vector<LabelData> labels[LOD::Count];
 	std::vector<AmenityLabelData> amenityLabels[LOD::Count];
 	std::vector<IconData> icons[LOD::Count];
 	std::set<std::string> uniqueIconNames;
 
-	std::map<uint64_t, Way> originalRoadWays; // roadWays;
-	std::map<uint64_t, ConvertedWay> convertedRoads;
-	std::map<uint64_t, Way> parkingWays;
-	std::map<uint64_t, Way> buildWays;
-	std::map<uint64_t, Way> triangulatedRoads; // tempRoads;
+	IdStore<Way> originalRoadWays; // roadWays;
+	IdStore<ConvertedWay> convertedRoads;
+	IdStore<Way> parkingWays;
+	IdStore<Way> buildWays;
+	IdStore<Way> triangulatedRoads; // tempRoads;
 	std::vector<uint64_t> areaOutlines;
 
 	std::vector<RouteData> route;
@@ -409,6 +638,18 @@ inline float cameraRotationTimeInMs(float angleDeg, float ms360)
 	return glm::abs(angleDeg / 360.f * ms360);
 }
 
+/*!*********************************************************************************************************************
+\param	points	The vertices of a simple polygon (either winding), without a repeated closing vertex.
+\param	numPoints	The number of vertices.
+\param	outTriangles	The triangles, as indices into points. Triangles are wound anti-clockwise.
+\param	outRemaining	Optional. The indices of the vertices left over when the polygon could not be fully triangulated
+(two for a fully triangulated polygon, fewer if collinear or duplicate vertices were dropped).
+\brief	Triangulates a polygon by ear clipping. Vertices are kept in a doubly linked list, so clipping an ear is O(1), and
+for larger polygons the vertices are also linked in z-order (Morton) order, so that the test for vertices inside a
+candidate ear only visits the vertices near it.
+***********************************************************************************************************************/
+void triangulatePolygon(const glm::dvec2* points, uint32_t numPoints, std::vector<std::array<uint32_t, 3> >& outTriangles, std::vector<uint32_t>* outRemaining = nullptr);
+
 /*!*****************************************************************************
 Class NavDataProcess This class handles the loading of OSM data from an XML file
 and pre-processing (i.e. triangulation) the raw data into usable rendering data.
@@ -429,7 +670,7 @@ public:
 	};
 
 	// Constructor takes a stream which the class uses to read the XML file.
-	NavDataProcess(std::unique_ptr<pvr::Stream> stream, const glm::ivec2& screenDimensions)
+	NavDataProcess(std::unique_ptr<pvr::Stream> stream, const glm::ivec2& screenDimensions) : _triangulationTime(0.0), _numTriangulatedPolygons(0)
 	{
 		_assetStream = std::move(stream);
 		_windowsDim = screenDimensions;
@@ -480,6 +721,15 @@ public:
 	{
 		return _osm;
 	}
+	// Total time spent triangulating building and area polygons, in milliseconds.
+	double getTriangulationTime() const
+	{
+		return _triangulationTime;
+	}
+	uint32_t getNumTriangulatedPolygons() const
+	{
+		return _numTriangulatedPolygons;
+	}
 	void processLabelBoundary(LabelData& label, glm::uvec2& tileCoords);
 
 	/*!*********************************************************************************************************************
@@ -496,6 +746,10 @@ private:
 	glm::ivec2 _windowsDim;
 	std::unique_ptr<pvr::Stream> _assetStream;
 
+	// Triangulation statistics, reported once the tiles have been filled.
+	mutable double _triangulationTime; // Milliseconds
+	mutable uint32_t _numTriangulatedPolygons;
+
 	// Raw data handling fuctions
 	pvr::Result loadOSMData();
 	glm::dvec2 lonLatToMetres(const glm::dvec2 origin, const glm::dvec2 point) const;
@@ -557,7 +811,7 @@ private:
 	/*!*********************************************************************************************************************
 			\return std::vector<std::vector<uint64_t>> A vector of triangle ways.
 			\param  nodeIds A vector of node IDs for a closed way (anti-clockwise
-	   wound).
+	   wound). The triangulated vertices are removed from it.
 			\brief  Triangluates an anti-clockwise wound closed way.
 			***********************************************************************************************************************/
 	void triangulate(std::vector<uint64_t>& nodeIds, std::vector<std::array<uint64_t, 3> >& outTriangulates) const;
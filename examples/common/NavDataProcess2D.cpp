@@ -43,6 +43,7 @@ void NavDataProcess::initTiles()
 	processLabels(_osm.bounds.max - _osm.bounds.min);
 	sortTiles();
 	_osm.cleanData();
+	Log(LogLevel::Information, "Triangulated %u polygons in %.2f ms.", _numTriangulatedPolygons, _triangulationTime);
 }
 
 void NavDataProcess::convertRoute(const glm::dvec2& mapWorldDim, uint32_t numCols, uint32_t numRows, float& totalRouteDistance)
@@ -78,7 +79,7 @@ pvr::Result NavDataProcess::loadOSMData()
 #endif
 	pugi::xml_document mapData;
 	std::vector<char> mapStream = _assetStream->readToEnd<char>();
-	pugi::xml_parse_result result = mapData.load_string(mapStream.data(), static_cast<uint32_t>(mapStream.size()));
+	pugi::xml_parse_result result = mapData.load_buffer(mapStream.data(), mapStream.size());
 
 	Log(LogLevel::Debug, "XML parse result: %s", result.description());
 	if (!result)
@@ -399,9 +400,14 @@ void NavDataProcess::calculateRoute()
 	}
 
 	uint32_t count = 0;
-	// Hold previosuly visited IDs to prevent going back on ourselves.
-	std::set<uint64_t> previousIntersectIDs;
-	std::set<uint64_t> previousWayIDs;
+	// Flag the intersections, and the previously visited intersections and ways to prevent going back on ourselves, by node / way index.
+	std::vector<bool> isIntersection(_osm.nodes.size(), false);
+	std::vector<bool> visitedIntersections(_osm.nodes.size(), false);
+	std::vector<bool> visitedWays(_osm.originalRoadWays.size(), false);
+	for (uint32_t i = 0; i < _osm.original_intersections.size(); ++i)
+	{
+		isIntersection[_osm.nodes.getIndex(_osm.original_intersections[i])] = true;
+	}
 	uint64_t nextID = _osm.original_intersections[0];
 	uint64_t lastID = -1;
 	std::vector<std::pair<uint64_t, glm::dvec2> > tempCoords;
@@ -416,12 +422,13 @@ void NavDataProcess::calculateRoute()
 		// Find the next way for the route.
 		for (uint32_t i = 0; i < node.wayIds.size(); ++i)
 		{
-			Way way = _osm.originalRoadWays.find(node.wayIds[i])->second;
+			const uint32_t wayIndex = _osm.originalRoadWays.getIndex(node.wayIds[i]);
+			const Way& way = _osm.originalRoadWays.at(wayIndex);
 
 			// Make sure we have not visited this way in the past.
-			if (previousWayIDs.find(way.id) == previousWayIDs.end())
+			if (!visitedWays[wayIndex])
 			{
-				previousWayIDs.insert(way.id);
+				visitedWays[wayIndex] = true;
 
 				if (_osm.getNodeById(way.nodeIds.back()).wayIds.size() == 1 && _osm.getNodeById(way.nodeIds[0]).wayIds.size() == 1)
 				{
@@ -430,7 +437,8 @@ void NavDataProcess::calculateRoute()
 
 				for (auto id : way.nodeIds)
 				{
-					glm::dvec2 coords = _osm.getNodeById(id).coords;
+					const uint32_t nodeIndex = _osm.nodes.getIndex(id);
+					glm::dvec2 coords = _osm.nodes.at(nodeIndex).coords;
 
 					// Check the node is not outside the map boundary.
 					if (isOutOfBounds(coords) || isTooCloseToBoundary(coords))
@@ -445,19 +453,12 @@ void NavDataProcess::calculateRoute()
 
 					tempCoords.push_back(std::pair<uint64_t, glm::dvec2>(id, coords));
 
-					if (!nextJunctionFound)
+					// Find the next node that is an intersection.
+					if (!nextJunctionFound && isIntersection[nodeIndex] && !visitedIntersections[nodeIndex])
 					{
-						// Find the next node that is an intersection.
-						for (uint32_t j = 0; j < _osm.original_intersections.size(); ++j)
-						{
-							if (id == _osm.original_intersections[j] && previousIntersectIDs.find(id) == previousIntersectIDs.end())
-							{
-								previousIntersectIDs.insert(id);
-								nextID = id;
-								nextJunctionFound = true;
-								break;
-							}
-						}
+						visitedIntersections[nodeIndex] = true;
+						nextID = id;
+						nextJunctionFound = true;
 					}
 
 					if (nextJunctionFound)
@@ -473,10 +474,10 @@ void NavDataProcess::calculateRoute()
 
 							if (glm::abs(a1 - a2) > 0.25f)
 							{
-								std::reverse(way.nodeIds.begin(), way.nodeIds.end());
 								tempCoords.clear();
 
-								for (uint32_t j = 0; j < way.nodeIds.size(); ++j)
+								// Walk the way backwards
+								for (uint32_t j = static_cast<uint32_t>(way.nodeIds.size()); j-- > 0;)
 								{
 									tempCoords.push_back(std::pair<uint64_t, glm::dvec2>(way.nodeIds[j], _osm.getNodeById(way.nodeIds[j]).coords));
 								}
@@ -594,7 +595,7 @@ applied to the text based on the slope of the road segment i.e. the line between
 ***********************************************************************************************************************/
 void NavDataProcess::processLabels(const glm::dvec2& mapWorldDim)
 {
-	for (uint32_t lod = 0; lod <= LOD::Count; ++lod)
+	for (uint32_t lod = 0; lod < LOD::Count; ++lod)
 	{
 		auto& _osmlodlabels = _osm.labels[lod];
 		if (_osmlodlabels.size() == 0)
@@ -718,8 +719,8 @@ void createNewWayWithIntersection(OSM& _osm, Way& newLineStrip, Way& newTriStrip
 {
 	Vertex newNode0 = _osm.getNodeById(newTriStrip.nodeIds[0]); // Take copies to use for the new way
 	Vertex newNode1 = _osm.getNodeById(newTriStrip.nodeIds[1]);
-	newNode0.id = _osm.nodes.rbegin()->first + 1; // Generate new ids
-	newNode1.id = _osm.nodes.rbegin()->first + 2;
+	newNode0.id = _osm.nodes.getMaxId() + 1; // Generate new ids
+	newNode1.id = _osm.nodes.getMaxId() + 2;
 
 	_osm.insertOrOverwriteNode(std::move(newNode0)); // Add the new vertices
 	_osm.insertOrOverwriteNode(std::move(newNode1));
@@ -801,7 +802,7 @@ void breakUpAllIntersectionWays(OSM& _osm, uint64_t intersection_id)
 
 			assertion(triangulatedIntersectIndex < triangulatedWay.nodeIds.size(), "Intersection index out of bounds.");
 
-			uint64_t newWayId = _osm.originalRoadWays.rbegin()->first + 1;
+			uint64_t newWayId = _osm.originalRoadWays.getMaxId() + 1;
 			Way newNonTriangulatedRoad = originalWay; // Copy the way. We mainly need the data...
 			Way newTriangulatedRoad = triangulatedWay; // The triangulated version as well.
 			newNonTriangulatedRoad.id = newWayId;
@@ -929,7 +930,7 @@ void processIntersection(OSM& _osm, uint64_t intersection_id)
 
 	// Sweep CCW to actually create the intersections:
 	Vertex tmpint = _osm.getNodeById(nonTriangulatedWays[0].nodeIds.front()); // Take (any) copy to use for the new intersection center
-	tmpint.id = _osm.nodes.rbegin()->first + 1; // Generate new ids
+	tmpint.id = _osm.nodes.getMaxId() + 1; // Generate new ids
 	tmpint.coords = centrePoint;
 	tmpint.texCoords = glm::vec2(TexUVCenter, TexUVUp);
 
@@ -1133,7 +1134,7 @@ void processIntersection(OSM& _osm, uint64_t intersection_id)
 		t.key = "name";
 		t.value = getIntersectionRoadName(temp);
 
-		ConvertedWay intersection(_osm.originalRoadWays.rbegin()->first + 1, false, std::vector<Tag>() = { t }, getIntersectionRoadType(triangulatedWays));
+		ConvertedWay intersection(_osm.originalRoadWays.getMaxId() + 1, false, std::vector<Tag>() = { t }, getIntersectionRoadType(triangulatedWays));
 
 		intersection.isIntersection = true;
 		intersection.isRoundabout = roundabout;
@@ -1195,6 +1196,10 @@ void NavDataProcess::calculateIntersections()
 void NavDataProcess::convertToTriangleList()
 {
 	std::vector<std::array<uint64_t, 3> > triangles;
+	// The intersections have already been added by calculateIntersections, merge the roads in so that the converted roads stay in id order.
+	IdStore<ConvertedWay> intersections;
+	std::swap(intersections, _osm.convertedRoads);
+	auto intersectionIterator = intersections.begin();
 	// Finally sort into triangle lists and get outlines ready for tiling
 	for (auto wayIterator = _osm.triangulatedRoads.begin(); wayIterator != _osm.triangulatedRoads.end(); ++wayIterator)
 	{
@@ -1264,7 +1269,15 @@ void NavDataProcess::convertToTriangleList()
 				convertedRoad.triangulatedIds.push_back(std::array<uint64_t, 3>{ node0.id, node1.id, node2.id });
 			}
 		}
-		_osm.convertedRoads[convertedRoad.id] = convertedRoad;
+		for (; intersectionIterator != intersections.end() && intersectionIterator->first < convertedRoad.id; ++intersectionIterator)
+		{
+			_osm.convertedRoads[intersectionIterator->first] = std::move(intersectionIterator->second);
+		}
+		_osm.convertedRoads[convertedRoad.id] = std::move(convertedRoad);
+	}
+	for (; intersectionIterator != intersections.end(); ++intersectionIterator)
+	{
+		_osm.convertedRoads[intersectionIterator->first] = std::move(intersectionIterator->second);
 	}
 }
 
@@ -1497,7 +1510,7 @@ std::vector<uint64_t> NavDataProcess::tessellate(const std::vector<uint64_t>& ol
 				}
 				else // Create a new node
 				{
-					newNode.id = _osm.nodes.rbegin()->first + 1;
+					newNode.id = _osm.nodes.getMaxId() + 1;
 				}
 
 				newNode.coords = lastPointOnCurve = newCoords;
@@ -1526,7 +1539,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 
 	if (nodeIds.size() == 2)
 	{
-		uint64_t id = _osm.nodes.rbegin()->first + 1;
+		uint64_t id = _osm.nodes.getMaxId() + 1;
 		const Vertex& node0 = _osm.getNodeById(nodeIds[0]);
 		const Vertex& node1 = _osm.getNodeById(nodeIds[1]);
 
@@ -1554,7 +1567,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 	{
 		{
 			// Add first item
-			uint64_t id = _osm.nodes.rbegin()->first + 1;
+			uint64_t id = _osm.nodes.getMaxId() + 1;
 			std::array<glm::dvec2, 2> firstPerps = findPerpendicularPoints(_osm.getNodeById(nodeIds[0]).coords, _osm.getNodeById(nodeIds[1]).coords, width, 1);
 			Vertex newNode0(id, firstPerps[0], false, glm::vec2(TexUVLeft, TexUVUp));
 			Vertex newNode1(++id, firstPerps[1], false, glm::vec2(TexUVRight, TexUVUp));
@@ -1566,7 +1579,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 
 		for (uint32_t i = 1; i < (nodeIds.size() - 1); ++i)
 		{
-			uint64_t id = _osm.nodes.rbegin()->first + 1;
+			uint64_t id = _osm.nodes.getMaxId() + 1;
 			const Vertex& node0 = _osm.getNodeById(nodeIds[i - 1]);
 			const Vertex& node1 = _osm.getNodeById(nodeIds[i]);
 			const Vertex& node2 = _osm.getNodeById(nodeIds[i + 1]);
@@ -1586,7 +1599,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 
 		{
 			// Add last item
-			uint64_t id = _osm.nodes.rbegin()->first + 1;
+			uint64_t id = _osm.nodes.getMaxId() + 1;
 			std::array<glm::dvec2, 2> thirdPerps;
 			thirdPerps = findPerpendicularPoints(_osm.getNodeById(*(nodeIds.end() - 2)).coords, _osm.getNodeById(*(nodeIds.end() - 1)).coords, width, 2);
 
@@ -1631,13 +1644,13 @@ std::array<uint64_t, 2> NavDataProcess::calculateEndCaps(Vertex& first, Vertex&
 	// Setup new nodes used for end cap.
 	newNode1.coords -= v1;
 	newNode1.texCoords.y = 4 * TexUVUp;
-	newNode1.id = _osm.nodes.rbegin()->first + 1;
+	newNode1.id = _osm.nodes.getMaxId() + 1;
 	_osm.insertOrOverwriteNode(std::move(newNode1));
 	debug_assertion(newNode1.texCoords.x != -10000.f && newNode1.texCoords.y != -10000.f, "TexCoord DEFAULT");
 
 	newNode2.coords -= v1;
 	newNode2.texCoords.y = 4 * TexUVUp;
-	newNode2.id = _osm.nodes.rbegin()->first + 1;
+	newNode2.id = _osm.nodes.getMaxId() + 1;
 	_osm.insertOrOverwriteNode(std::move(newNode2));
 	debug_assertion(newNode2.texCoords.x != -10000.f && newNode2.texCoords.y != -10000.f, "TexCoord DEFAULT");
 
@@ -1971,26 +1984,25 @@ void NavDataProcess::clipRoad(
 			// add the triangle into the tile
 			Way newWay;
 
-			uint64_t nodeId = (_osm.nodes.rbegin()->first + 1);
+			// The clipped vertices are only looked up through the tile, so just reserve their ids in _osm.nodes rather than storing copies there.
+			uint64_t nodeId = (_osm.nodes.getMaxId() + 1);
 			Tile& tile = _osm.tiles[minTileIndex.x][minTileIndex.y];
 			{
 				auto& tmp = tile.nodes[nodeId] = vertex0;
 				tmp.id = nodeId;
-				newWay.nodeIds.push_back(nodeId);
-				_osm.nodes[nodeId++] = vertex0;
+				newWay.nodeIds.push_back(nodeId++);
 			}
 			{
 				auto& tmp = tile.nodes[nodeId] = vertex1;
 				tmp.id = nodeId;
-				newWay.nodeIds.push_back(nodeId);
-				_osm.nodes[nodeId++] = vertex1;
+				newWay.nodeIds.push_back(nodeId++);
 			}
 			{
 				auto& tmp = tile.nodes[nodeId] = vertex2;
 				tmp.id = nodeId;
-				newWay.nodeIds.push_back(nodeId);
-				_osm.nodes[nodeId++] = vertex2;
+				newWay.nodeIds.push_back(nodeId++);
 			}
+			_osm.nodes.reserveIds(nodeId - 1);
 
 			newWay.id = roadParams.wayId;
 			newWay.tags = roadParams.wayTags;
@@ -2150,7 +2162,8 @@ bool NavDataProcess::isTooCloseToBoundary(const glm::dvec2& point) const
 ***********************************************************************************************************************/
 glm::ivec2 NavDataProcess::findTile2(glm::dvec2& point) const
 {
-	glm::uvec2 tileCoords;
+	// Points on the far map border may lie fractionally past the last tile due to rounding, these belong to the last tile.
+	glm::uvec2 tileCoords(_osm.numCols - 1, _osm.numRows - 1);
 
 	for (uint32_t i = 0; i < _osm.numCols; ++i)
 	{
@@ -53,6 +53,7 @@ void NavDataProcess::initTiles()
 	calculateJunctionTexCoords();
 
 	cleanData();
+	Log(LogLevel::Information, "Triangulated %u polygons in %.2f ms.", _numTriangulatedPolygons, _triangulationTime);
 }
 
 /*!*********************************************************************************************************************
@@ -67,7 +68,7 @@ pvr::Result NavDataProcess::loadOSMData()
 #endif
 	pugi::xml_document mapData;
 	std::vector<char> mapStream = _assetStream->readToEnd<char>();
-	pugi::xml_parse_result result = mapData.load_string(mapStream.data(), static_cast<uint32_t>(mapStream.size()));
+	pugi::xml_parse_result result = mapData.load_buffer(mapStream.data(), mapStream.size());
 
 	Log(LogLevel::Debug, "XML parse result: %s", result.description());
 	if (!result)
@@ -366,31 +367,39 @@ void NavDataProcess::calculateRoute()
 	}
 
 	uint32_t count = 0;
-	// Hold previosuly visited IDs to prevent going back on ourselves.
-	std::set<uint64_t> previousIntersectIDs;
-	std::set<uint64_t> previousWayIDs;
+	// Flag the intersections, and the previously visited intersections and ways to prevent going back on ourselves, by node / way index.
+	std::vector<bool> isIntersection(_osm.nodes.size(), false);
+	std::vector<bool> visitedIntersections(_osm.nodes.size(), false);
+	std::vector<bool> visitedWays(_osm.originalRoadWays.size(), false);
+	uint32_t numVisitedIntersections = 0;
+	for (uint32_t i = 0; i < _osm.original_intersections.size(); ++i)
+	{
+		isIntersection[_osm.nodes.getIndex(_osm.original_intersections[i])] = true;
+	}
 	uint64_t nextID = _osm.original_intersections[0];
 	uint64_t lastID = 0;
 	std::vector<std::pair<uint64_t, glm::dvec2> > tempCoords;
 
-	while (previousIntersectIDs.size() < _osm.original_intersections.size())
+	while (numVisitedIntersections < _osm.original_intersections.size())
 	{
 		bool nextJunctionFound = false;
-		Vertex node = _osm.nodes.find(nextID)->second;
+		const Vertex& node = _osm.getNodeById(nextID);
 
 		// Find the next way for the route.
 		for (uint32_t i = 0; i < node.wayIds.size(); ++i)
 		{
-			Way way = _osm.originalRoadWays.find(node.wayIds[i])->second;
+			const uint32_t wayIndex = _osm.originalRoadWays.getIndex(node.wayIds[i]);
+			const Way& way = _osm.originalRoadWays.at(wayIndex);
 
 			// Make sure we have not visited this way in the past.
-			if (previousWayIDs.find(way.id) == previousWayIDs.end())
+			if (!visitedWays[wayIndex])
 			{
-				previousWayIDs.insert(way.id);
+				visitedWays[wayIndex] = true;
 
 				for (auto id : way.nodeIds)
 				{
-					glm::dvec2 coords = _osm.nodes.find(id)->second.coords;
+					const uint32_t nodeIndex = _osm.nodes.getIndex(id);
+					glm::dvec2 coords = _osm.nodes.at(nodeIndex).coords;
 
 					// Check the node is not outside the map boundary.
 					if (isOutOfBounds(coords))
@@ -403,19 +412,13 @@ void NavDataProcess::calculateRoute()
 
 					tempCoords.push_back(std::pair<uint64_t, glm::dvec2>(id, coords));
 
-					if (!nextJunctionFound)
+					// Find the next node that is an intersection.
+					if (!nextJunctionFound && isIntersection[nodeIndex] && !visitedIntersections[nodeIndex])
 					{
-						// Find the next node that is an intersection.
-						for (uint32_t j = 0; j < _osm.original_intersections.size(); ++j)
-						{
-							if (id == _osm.original_intersections[j] && previousIntersectIDs.find(id) == previousIntersectIDs.end())
-							{
-								previousIntersectIDs.insert(id);
-								nextID = id;
-								nextJunctionFound = true;
-								break;
-							}
-						}
+						visitedIntersections[nodeIndex] = true;
+						++numVisitedIntersections;
+						nextID = id;
+						nextJunctionFound = true;
 					}
 
 					if (nextJunctionFound)
@@ -431,10 +434,10 @@ void NavDataProcess::calculateRoute()
 
 							if (glm::abs(a1 - a2) > 0.25f)
 							{
-								std::reverse(way.nodeIds.begin(), way.nodeIds.end());
 								tempCoords.clear();
 
-								for (uint32_t j = 0; j < way.nodeIds.size(); ++j)
+								// Walk the way backwards
+								for (uint32_t j = static_cast<uint32_t>(way.nodeIds.size()); j-- > 0;)
 									tempCoords.push_back(std::pair<uint64_t, glm::dvec2>(way.nodeIds[j], _osm.nodes.find(way.nodeIds[j])->second.coords));
 							}
 						}
@@ -545,7 +548,7 @@ applied to the text based on the slope of the road segment i.e. the line between
 ***********************************************************************************************************************/
 void NavDataProcess::processLabels(const glm::dvec2& mapWorldDim)
 {
-	for (int lod = 0; lod <= LOD::Count; ++lod)
+	for (int lod = 0; lod < LOD::Count; ++lod)
 	{
 		auto& osmlodlabels = _osm.labels[lod];
 		if (osmlodlabels.size() == 0)
@@ -644,35 +647,38 @@ glm::dvec2 NavDataProcess::lonLatToMetres(const glm::dvec2 origin, const glm::dv
 ***********************************************************************************************************************/
 void NavDataProcess::triangulateAllRoads()
 {
-	// Triangulate the roads
-	for (auto wayIterator = _osm.originalRoadWays.begin(); wayIterator != _osm.originalRoadWays.end(); ++wayIterator)
+	// Triangulate the roads. Ways split off below are added to the end and triangulated in turn. Indices and references stay
+	// valid while ways are added, iterators do not.
+	for (uint32_t wayIndex = 0; wayIndex < _osm.originalRoadWays.size(); ++wayIndex)
 	{
-		if (wayIterator->second.area)
-			_osm.triangulatedRoads[wayIterator->first] = wayIterator->second;
+		const uint64_t wayId = _osm.originalRoadWays.getId(wayIndex);
+		Way& way = _osm.originalRoadWays.at(wayIndex);
+		if (way.area)
+			_osm.triangulatedRoads[wayId] = way;
 		else
 		{
 			uint32_t breakIndex = 0;
 			// Increases node density around sharp bends, which in turn increases the number of triangles produced by the triangulation function,
 			// which improves visual quality for sharp bends, at the cost of memory usage, initialisation time and potentially frame times
-			if (wayIterator->second.nodeIds.size() > 2)
-				wayIterator->second.nodeIds = tessellate(wayIterator->second.nodeIds, breakIndex);
+			if (way.nodeIds.size() > 2)
+				way.nodeIds = tessellate(way.nodeIds, breakIndex);
 
 			// This loop breaks a way if the start or end intersects with another part of the way
-			for (uint32_t i = 1; i < (wayIterator->second.nodeIds.size() - 1); ++i)
+			for (uint32_t i = 1; i < (way.nodeIds.size() - 1); ++i)
 			{
-				if ((wayIterator->second.nodeIds[i] == wayIterator->second.nodeIds.front()) || (wayIterator->second.nodeIds[i] == wayIterator->second.nodeIds.back()))
+				if ((way.nodeIds[i] == way.nodeIds.front()) || (way.nodeIds[i] == way.nodeIds.back()))
 				{
-					if (wayIterator->second.nodeIds[i] == wayIterator->second.nodeIds.back())
+					if (way.nodeIds[i] == way.nodeIds.back())
 					{
-						i = static_cast<uint32_t>(wayIterator->second.nodeIds.size() - i - 1);
+						i = static_cast<uint32_t>(way.nodeIds.size() - i - 1);
 					}
 
-					Way newWay = wayIterator->second;
-					newWay.id = _osm.originalRoadWays.rbegin()->first + 1;
+					Way newWay = way;
+					newWay.id = _osm.originalRoadWays.getMaxId() + 1;
 
 					std::vector<uint64_t> newIds;
-					newIds.insert(newIds.end(), wayIterator->second.nodeIds.begin() + i, wayIterator->second.nodeIds.end());
-					wayIterator->second.nodeIds.erase(wayIterator->second.nodeIds.begin() + i + 1, wayIterator->second.nodeIds.end());
+					newIds.insert(newIds.end(), way.nodeIds.begin() + i, way.nodeIds.end());
+					way.nodeIds.erase(way.nodeIds.begin() + i + 1, way.nodeIds.end());
 					uint32_t intersectSize = static_cast<uint32_t>(_osm.nodes.find(newIds[0])->second.wayIds.size());
 					_osm.nodes.find(newIds[0])->second.wayIds.push_back(newWay.id);
 
@@ -682,7 +688,7 @@ void NavDataProcess::triangulateAllRoads()
 						std::vector<uint64_t>& wayIds = _osm.nodes.find(newIds[j])->second.wayIds;
 						for (uint32_t k = 0; k < wayIds.size(); ++k)
 						{
-							if (wayIds[k] == wayIterator->first)
+							if (wayIds[k] == wayId)
 							{
 								wayIds.erase(wayIds.begin() + k);
 								break;
@@ -701,39 +707,39 @@ void NavDataProcess::triangulateAllRoads()
 				}
 			}
 			// This breaks a closed way
-			if (wayIterator->second.nodeIds.front() == wayIterator->second.nodeIds.back())
+			if (way.nodeIds.front() == way.nodeIds.back())
 			{
 				// If the start or end of a closed road is next to an intersection, move it onto the intersection to avoid artifacts
-				if ((_osm.nodes.find(wayIterator->second.nodeIds[1])->second.wayIds.size() > 1) && (_osm.nodes.find(wayIterator->second.nodeIds[0])->second.wayIds.size() == 2))
+				if ((_osm.nodes.find(way.nodeIds[1])->second.wayIds.size() > 1) && (_osm.nodes.find(way.nodeIds[0])->second.wayIds.size() == 2))
 				{
-					_osm.nodes.find(wayIterator->second.nodeIds[0])->second.wayIds.pop_back();
-					wayIterator->second.nodeIds.erase(wayIterator->second.nodeIds.begin());
-					wayIterator->second.nodeIds.push_back(wayIterator->second.nodeIds[0]);
-					_osm.nodes.find(wayIterator->second.nodeIds[0])->second.wayIds.push_back(wayIterator->first);
+					_osm.nodes.find(way.nodeIds[0])->second.wayIds.pop_back();
+					way.nodeIds.erase(way.nodeIds.begin());
+					way.nodeIds.push_back(way.nodeIds[0]);
+					_osm.nodes.find(way.nodeIds[0])->second.wayIds.push_back(wayId);
 				}
-				else if ((_osm.nodes.find(wayIterator->second.nodeIds[wayIterator->second.nodeIds.size() - 2])->second.wayIds.size() > 1) &&
-					(_osm.nodes.find(wayIterator->second.nodeIds.back())->second.wayIds.size() == 2))
+				else if ((_osm.nodes.find(way.nodeIds[way.nodeIds.size() - 2])->second.wayIds.size() > 1) &&
+					(_osm.nodes.find(way.nodeIds.back())->second.wayIds.size() == 2))
 				{
-					_osm.nodes.find(wayIterator->second.nodeIds.back())->second.wayIds.pop_back();
-					wayIterator->second.nodeIds.pop_back();
-					wayIterator->second.nodeIds.insert(wayIterator->second.nodeIds.begin(), wayIterator->second.nodeIds.back());
-					_osm.nodes.find(wayIterator->second.nodeIds.back())->second.wayIds.push_back(wayIterator->first);
+					_osm.nodes.find(way.nodeIds.back())->second.wayIds.pop_back();
+					way.nodeIds.pop_back();
+					way.nodeIds.insert(way.nodeIds.begin(), way.nodeIds.back());
+					_osm.nodes.find(way.nodeIds.back())->second.wayIds.push_back(wayId);
 				}
 
 				// If the break point of the way is next to an intersection, move it onto the intersection
-				if ((_osm.nodes.find(wayIterator->second.nodeIds[breakIndex + 1])->second.wayIds.size() > 1) &&
-					(_osm.nodes.find(wayIterator->second.nodeIds[breakIndex])->second.wayIds.size() == 1))
+				if ((_osm.nodes.find(way.nodeIds[breakIndex + 1])->second.wayIds.size() > 1) &&
+					(_osm.nodes.find(way.nodeIds[breakIndex])->second.wayIds.size() == 1))
 					breakIndex++;
-				else if ((_osm.nodes.find(wayIterator->second.nodeIds[breakIndex - 1])->second.wayIds.size() > 1) &&
-					(_osm.nodes.find(wayIterator->second.nodeIds[breakIndex])->second.wayIds.size() == 1))
+				else if ((_osm.nodes.find(way.nodeIds[breakIndex - 1])->second.wayIds.size() > 1) &&
+					(_osm.nodes.find(way.nodeIds[breakIndex])->second.wayIds.size() == 1))
 					breakIndex--;
 
-				Way newWay = wayIterator->second;
-				newWay.id = _osm.originalRoadWays.rbegin()->first + 1;
+				Way newWay = way;
+				newWay.id = _osm.originalRoadWays.getMaxId() + 1;
 
 				std::vector<uint64_t> newIds;
-				newIds.insert(newIds.end(), wayIterator->second.nodeIds.begin() + breakIndex, wayIterator->second.nodeIds.end());
-				wayIterator->second.nodeIds.erase(wayIterator->second.nodeIds.begin() + breakIndex + 1, wayIterator->second.nodeIds.end());
+				newIds.insert(newIds.end(), way.nodeIds.begin() + breakIndex, way.nodeIds.end());
+				way.nodeIds.erase(way.nodeIds.begin() + breakIndex + 1, way.nodeIds.end());
 				uint32_t intersectSize = static_cast<uint32_t>(_osm.nodes.find(newIds[0])->second.wayIds.size());
 				_osm.nodes.find(newIds[0])->second.wayIds.push_back(newWay.id);
 
@@ -743,7 +749,7 @@ void NavDataProcess::triangulateAllRoads()
 					std::vector<uint64_t>& wayIds = _osm.nodes.find(newIds[i])->second.wayIds;
 					for (uint32_t j = 0; j < wayIds.size(); ++j)
 					{
-						if (wayIds[j] == wayIterator->first)
+						if (wayIds[j] == wayId)
 						{
 							wayIds.erase(wayIds.begin() + j);
 							break;
@@ -759,8 +765,8 @@ void NavDataProcess::triangulateAllRoads()
 					_osm.original_intersections.push_back(newIds[0]);
 			}
 
-			_osm.triangulatedRoads[wayIterator->first] = wayIterator->second;
-			_osm.triangulatedRoads.find(wayIterator->first)->second.nodeIds = triangulateRoad(wayIterator->second.nodeIds, wayIterator->second.width);
+			_osm.triangulatedRoads[wayId] = way;
+			_osm.triangulatedRoads.find(wayId)->second.nodeIds = triangulateRoad(way.nodeIds, way.width);
 		}
 	}
 }
@@ -818,7 +824,7 @@ void NavDataProcess::calculateIntersections()
 
 			uint32_t newIntersectIndex = intersectIndex * 2 + 1;
 
-			uint64_t newId = _osm.originalRoadWays.rbegin()->first + 1;
+			uint64_t newId = _osm.originalRoadWays.getMaxId() + 1;
 			Way newLineStrip = originalWay;
 			Way newTriStrip = newWay;
 			newLineStrip.id = newId;
@@ -851,9 +857,9 @@ void NavDataProcess::calculateIntersections()
 			Vertex newNode0 = _osm.nodes.find(newTriStrip.nodeIds[0])->second;
 			Vertex newNode1 = _osm.nodes.find(newTriStrip.nodeIds[1])->second;
 			Vertex newNode2 = _osm.nodes.find(newTriStrip.nodeIds[2])->second;
-			newNode0.id = _osm.nodes.rbegin()->first + 1;
-			newNode1.id = _osm.nodes.rbegin()->first + 2;
-			newNode2.id = _osm.nodes.rbegin()->first + 3;
+			newNode0.id = _osm.nodes.getMaxId() + 1;
+			newNode1.id = _osm.nodes.getMaxId() + 2;
+			newNode2.id = _osm.nodes.getMaxId() + 3;
 
 			_osm.nodes[newNode0.id] = newNode0;
 			_osm.nodes[newNode1.id] = newNode1;
@@ -1047,7 +1053,7 @@ void NavDataProcess::calculateIntersections()
 				t.key = "name";
 				t.value = getIntersectionRoadName(temp);
 
-				ConvertedWay intersection(_osm.originalRoadWays.rbegin()->first + 1, false, std::vector<Tag>() = { t }, getIntersectionRoadType(orderedWays));
+				ConvertedWay intersection(_osm.originalRoadWays.getMaxId() + 1, false, std::vector<Tag>() = { t }, getIntersectionRoadType(orderedWays));
 
 				intersection.isIntersection = true;
 				intersection.isRoundabout = roundabout;
@@ -1071,6 +1077,10 @@ void NavDataProcess::calculateIntersections()
 void NavDataProcess::convertToTriangleList()
 {
 	std::vector<std::array<uint64_t, 3> > triangles;
+	// The intersections have already been added by calculateIntersections, merge the roads in so that the converted roads stay in id order.
+	IdStore<ConvertedWay> intersections;
+	std::swap(intersections, _osm.convertedRoads);
+	auto intersectionIterator = intersections.begin();
 	// Finally sort into triangle lists and get outlines ready for tiling
 	for (auto wayIterator = _osm.triangulatedRoads.begin(); wayIterator != _osm.triangulatedRoads.end(); ++wayIterator)
 	{
@@ -1144,7 +1154,15 @@ void NavDataProcess::convertToTriangleList()
 				convertedRoad.triangulatedIds.push_back(std::array<uint64_t, 3>{ node0.id, node1.id, node2.id });
 			}
 		}
-		_osm.convertedRoads[convertedRoad.id] = convertedRoad;
+		for (; intersectionIterator != intersections.end() && intersectionIterator->first < convertedRoad.id; ++intersectionIterator)
+		{
+			_osm.convertedRoads[intersectionIterator->first] = std::move(intersectionIterator->second);
+		}
+		_osm.convertedRoads[convertedRoad.id] = std::move(convertedRoad);
+	}
+	for (; intersectionIterator != intersections.end(); ++intersectionIterator)
+	{
+		_osm.convertedRoads[intersectionIterator->first] = std::move(intersectionIterator->second);
 	}
 }
 
@@ -1165,8 +1183,8 @@ void NavDataProcess::sortTiles()
 			{
 				if (multiJunct && !way.isRoundabout)
 				{
-					_osm.intersectionNodes.rbegin()->second.nodes.insert(
-						_osm.intersectionNodes.rbegin()->second.nodes.end(), way.triangulatedIds[i].begin(), way.triangulatedIds[i].end());
+					_osm.intersectionNodes.back().second.nodes.insert(
+						_osm.intersectionNodes.back().second.nodes.end(), way.triangulatedIds[i].begin(), way.triangulatedIds[i].end());
 				}
 				else
 				{
@@ -1304,17 +1322,17 @@ void NavDataProcess::sortTiles()
 
 			Vertex _node0 = node0;
 			_node0.height = buildingHeight;
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
 
 			Vertex _node1 = node1;
 			_node1.height = buildingHeight;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
 
 			Vertex _node2 = node2;
 			_node2.height = buildingHeight;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			/******* Cuboid Faces ***********/
@@ -1323,18 +1341,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(_node2, _node0, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node0, _node0, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1342,18 +1360,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(node1, node0, id, wayIterator->second.tags, WayTypes::Building);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node1, _node0, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1361,18 +1379,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(_node1, node1, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node2, _node2, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1380,18 +1398,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(node0, node2, id, wayIterator->second.tags, WayTypes::Building);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node0, _node2, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1399,18 +1417,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(_node0, node0, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node1, _node2, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1418,18 +1436,18 @@ void NavDataProcess::sortTiles()
 			fillTiles(node2, node1, id, wayIterator->second.tags, WayTypes::Building);
 			id++;
 
-			node0.id = _osm.nodes.rbegin()->first + 1;
+			node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node0.id] = node0;
-			node1.id = _osm.nodes.rbegin()->first + 1;
+			node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node1.id] = node1;
-			node2.id = _osm.nodes.rbegin()->first + 1;
+			node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[node2.id] = node2;
 
-			_node0.id = _osm.nodes.rbegin()->first + 1;
+			_node0.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node0.id] = _node0;
-			_node1.id = _osm.nodes.rbegin()->first + 1;
+			_node1.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node1.id] = _node1;
-			_node2.id = _osm.nodes.rbegin()->first + 1;
+			_node2.id = _osm.nodes.getMaxId() + 1;
 			_osm.nodes[_node2.id] = _node2;
 
 			fillTiles(node1, _node1, id, wayIterator->second.tags, WayTypes::Building, buildingHeight);
@@ -1487,7 +1505,8 @@ void NavDataProcess::insertWay(std::vector<Way>& insertIn, Way& way)
 ***********************************************************************************************************************/
 glm::ivec2 NavDataProcess::findTile2(glm::dvec2& point) const
 {
-	glm::uvec2 tileCoords;
+	// Points on the far map border may lie fractionally past the last tile due to rounding, these belong to the last tile.
+	glm::uvec2 tileCoords(_osm.numCols - 1, _osm.numRows - 1);
 	glm::dvec2 tmpPoint = point;
 	for (uint32_t i = 0; i < _osm.numCols; ++i)
 	{
@@ -1554,7 +1573,7 @@ void NavDataProcess::fillTiles(Vertex startNode, Vertex endNode, const uint64_t
 			startNode.coords = glm::dvec2(result.x, result.y);
 		}
 
-		startNode.id = _osm.nodes.rbegin()->first + 1;
+		startNode.id = _osm.nodes.getMaxId() + 1;
 		startNode.tileBoundNode = true;
 		_osm.nodes[startNode.id] = startNode;
 	}
@@ -1562,7 +1581,7 @@ void NavDataProcess::fillTiles(Vertex startNode, Vertex endNode, const uint64_t
 	{
 		glm::dvec3 result = findIntersect(_osm.bounds.min, _osm.bounds.max, startNode.coords, endNode.coords);
 		endNode.coords = glm::dvec2(result.x, result.y);
-		endNode.id = _osm.nodes.rbegin()->first + 1;
+		endNode.id = _osm.nodes.getMaxId() + 1;
 		endNode.tileBoundNode = true;
 		_osm.nodes[endNode.id] = endNode;
 	}
@@ -1592,9 +1611,9 @@ void NavDataProcess::fillTiles(Vertex startNode, Vertex endNode, const uint64_t
 
 	if (isIntersection)
 	{
-		if (_osm.intersectionNodes.rbegin()->second.junctionWays.size() == 0 ||
-			_osm.intersectionNodes.rbegin()->second.junctionWays.rbegin()->first != static_cast<uint32_t>(_osm.tiles[startTile.x][startTile.y].roadWays.size()) - 1)
-			_osm.intersectionNodes.rbegin()->second.junctionWays.push_back(
+		if (_osm.intersectionNodes.back().second.junctionWays.size() == 0 ||
+			_osm.intersectionNodes.back().second.junctionWays.rbegin()->first != static_cast<uint32_t>(_osm.tiles[startTile.x][startTile.y].roadWays.size()) - 1)
+			_osm.intersectionNodes.back().second.junctionWays.push_back(
 				std::pair<uint32_t, glm::uvec2>(static_cast<uint32_t>(_osm.tiles[startTile.x][startTile.y].roadWays.size()) - 1, startTile));
 	}
 
@@ -1618,7 +1637,7 @@ void NavDataProcess::fillTiles(Vertex startNode, Vertex endNode, const uint64_t
 		glm::dvec3 result = findIntersect(_osm.tiles[currentTile.x][currentTile.y].min, _osm.tiles[currentTile.x][currentTile.y].max, currentNode.coords, endNode.coords);
 
 		// Find the node on the tile boundary
-		Vertex newNode = Vertex(_osm.nodes.rbegin()->first + 1, glm::dvec2(result.x, result.y), true);
+		Vertex newNode = Vertex(_osm.nodes.getMaxId() + 1, glm::dvec2(result.x, result.y), true);
 
 		double weight = glm::distance(startNode.coords, newNode.coords) / t_dist;
 		glm::vec2 weightedTexCoord = glm::mix(currentNode.texCoords, endNode.texCoords, weight);
@@ -1672,10 +1691,10 @@ void NavDataProcess::fillTiles(Vertex startNode, Vertex endNode, const uint64_t
 		// Add the new node to the next tile (creating a new way if necessary)
 		insert(currentTile, wayType, &newWay, newNode.id);
 
-		if (isIntersection && !_osm.intersectionNodes.rbegin()->second.isBound)
+		if (isIntersection && !_osm.intersectionNodes.back().second.isBound)
 		{
-			_osm.intersectionNodes.rbegin()->second.isBound = true;
-			_osm.intersectionNodes.rbegin()->second.junctionWays.push_back(
+			_osm.intersectionNodes.back().second.isBound = true;
+			_osm.intersectionNodes.back().second.junctionWays.push_back(
 				std::pair<uint32_t, glm::uvec2>(static_cast<uint32_t>(_osm.tiles[currentTile.x][currentTile.y].roadWays.size()) - 1, currentTile));
 		}
 
@@ -1729,7 +1748,7 @@ void NavDataProcess::addCornerPoints(Tile& tile, std::vector<Way>& way)
 				glm::dvec2 point0 = tile.nodes.find(nodeIds[0])->second.coords;
 				glm::dvec2 point1 = tile.nodes.find(nodeIds[1])->second.coords;
 
-				Vertex newNode(_osm.nodes.rbegin()->first + 1);
+				Vertex newNode(_osm.nodes.getMaxId() + 1);
 				newNode.coords.x = ((point0.x == tile.min.x) || (point0.x == tile.max.x)) ? point0.x : point1.x;
 				newNode.coords.y = ((point0.y == tile.min.y) || (point0.y == tile.max.y)) ? point0.y : point1.y;
 
@@ -1757,7 +1776,7 @@ void NavDataProcess::addCornerPoints(Tile& tile, std::vector<Way>& way)
 						newPoint.x = ((currentNode.coords.x == tile.min.x) || (currentNode.coords.x == tile.max.x)) ? currentNode.coords.x : nextNode.coords.x;
 						newPoint.y = ((currentNode.coords.y == tile.min.y) || (currentNode.coords.y == tile.max.y)) ? currentNode.coords.y : nextNode.coords.y;
 
-						Vertex newNode(_osm.nodes.rbegin()->first + 1, newPoint);
+						Vertex newNode(_osm.nodes.getMaxId() + 1, newPoint);
 
 						_osm.nodes[newNode.id] = newNode;
 						tile.nodes[newNode.id] = newNode;
@@ -1858,7 +1877,7 @@ std::vector<uint64_t> NavDataProcess::tessellate(const std::vector<uint64_t>& ol
 					offset = newCoords - node1.coords;
 				}
 				else // Create a new node
-					newNode.id = _osm.nodes.rbegin()->first + 1;
+					newNode.id = _osm.nodes.getMaxId() + 1;
 
 				newNode.coords = lastPointOnCurve = newCoords;
 				_osm.nodes[newNode.id] = newNode;
@@ -1898,7 +1917,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 
 	if (nodeIds.size() == 2)
 	{
-		uint64_t id = _osm.nodes.rbegin()->first + 1;
+		uint64_t id = _osm.nodes.getMaxId() + 1;
 		Vertex node0 = _osm.nodes.find(nodeIds[0])->second;
 		Vertex node1 = _osm.nodes.find(nodeIds[1])->second;
 
@@ -1926,7 +1945,7 @@ std::vector<uint64_t> NavDataProcess::triangulateRoad(const std::vector<uint64_t
 	{
 		for (uint32_t i = 1; i < (nodeIds.size() - 1); ++i)
 		{
-			uint64_t id = _osm.nodes.rbegin()->first + 1;
+			uint64_t id = _osm.nodes.getMaxId() + 1;
 			Vertex node0 = _osm.nodes.find(nodeIds[i - 1])->second;
 			Vertex node1 = _osm.nodes.find(nodeIds[i])->second;
 			Vertex node2 = _osm.nodes.find(nodeIds[i + 1])->second;
@@ -2276,7 +2295,7 @@ void NavDataProcess::calculateMapBoundaryTexCoords()
 void NavDataProcess::calculateJunctionTexCoords()
 {
 	// Iterate over intersection nodes and calculate appropriate texture co-ordinates for the junction.
-	for (std::map<uint64_t, IntersectionData>::iterator itr = _osm.intersectionNodes.begin(); itr != _osm.intersectionNodes.end(); ++itr)
+	for (auto itr = _osm.intersectionNodes.begin(); itr != _osm.intersectionNodes.end(); ++itr)
 	{
 		std::map<uint64_t, std::pair<Vertex*, Vertex*> > uniqueFoundNodes;
 		std::vector<std::pair<glm::uvec2, Way*> > junctionWays;
@@ -2305,7 +2324,7 @@ void NavDataProcess::calculateJunctionTexCoords()
 			{
 				Tile& myTile = _osm.tiles[currentTile.x][currentTile.y];
 
-				std::map<uint64_t, Vertex>::iterator it = myTile.nodes.find(itr->second.nodes[j]);
+				auto it = myTile.nodes.find(itr->second.nodes[j]);
 				if (it == myTile.nodes.end())
 				{
 					continue;
@@ -2385,21 +2404,21 @@ void NavDataProcess::calculateJunctionTexCoords()
 				way->nodeIds.clear();
 
 				Vertex newNode0 = *foundNodes[index_1].first;
-				newNode0.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+				newNode0.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 				_osm.tiles[currentTile.x][currentTile.y].nodes[newNode0.id] = newNode0;
 
 				Vertex newNode1 = *foundNodes[index_3].first;
-				newNode1.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+				newNode1.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 				_osm.tiles[currentTile.x][currentTile.y].nodes[newNode1.id] = newNode1;
 
 				Vertex newNode2 = *foundNodes[index_2].first;
-				newNode2.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+				newNode2.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 				newNode2.texCoords = foundNodes[index_2].second->texCoords;
 				_osm.tiles[currentTile.x][currentTile.y].nodes[newNode2.id] = newNode2;
 
 				// Extra point used to cover gaps and prevent artefacts in junction.
 				Vertex newNode3 = newNode2;
-				newNode3.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+				newNode3.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 				newNode3.coords = calculateMidPoint(foundNodes[index_2].first->coords, foundNodes[index_1].first->coords, foundNodes[index_3].first->coords);
 				newNode3.texCoords = glm::vec2(glm::mix(-0.05f, 0.55f, 0.5f), 0.245f);
 				_osm.tiles[currentTile.x][currentTile.y].nodes[newNode3.id] = newNode3;
@@ -2420,7 +2439,7 @@ void NavDataProcess::calculateJunctionTexCoords()
 					(texCoordFlippedEdgeCase && compareReal(foundNodes[index_3].first->texCoords.x, foundNodes[index_1].second->texCoords.x)))
 				{
 					Vertex newNode = newNode0;
-					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 
 					if (texCoordFlippedEdgeCase || roundAboutEdgeCase1)
 						newNode.texCoords = foundNodes[index_2].second->texCoords;
@@ -2438,7 +2457,7 @@ void NavDataProcess::calculateJunctionTexCoords()
 					(texCoordFlippedEdgeCase && compareReal(foundNodes[index_3].first->texCoords.x, foundNodes[index_2].first->texCoords.x)))
 				{
 					Vertex newNode = newNode2;
-					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 
 					if (texCoordFlippedEdgeCase || roundAboutEdgeCase2)
 						newNode.texCoords = foundNodes[index_1].first->texCoords;
@@ -2455,7 +2474,7 @@ void NavDataProcess::calculateJunctionTexCoords()
 				else
 				{
 					Vertex newNode = newNode2;
-					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+					newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 
 					if (compareReal(newNode.texCoords.x, -0.05f))
 						_osm.tiles[currentTile.x][currentTile.y].nodes[newNode2.id].texCoords = glm::vec2(0.55f, 0.245f);
@@ -2539,7 +2558,7 @@ void NavDataProcess::calculateCrossRoadJunctionTexCoords(std::vector<std::pair<V
 
 		// Mid point node.
 		Vertex newNode;
-		newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		newNode.coords = foundNodes[indices[0]].first->coords - (v1 * (len / 2.0));
 		newNode.texCoords = glm::vec2(glm::mix(-0.05f, 0.55f, 0.5f), 0.245f);
 		newNode.height = 0.000075f;
@@ -2549,50 +2568,50 @@ void NavDataProcess::calculateCrossRoadJunctionTexCoords(std::vector<std::pair<V
 		Vertex newNode0 = *foundNodes[indices[0]].first;
 		newNode0.texCoords = glm::vec2(-0.05f, 0.245f);
 		newNode0.height = 0.00005f;
-		newNode0.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode0.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode0.id] = newNode0;
 
 		Vertex newNode1 = *foundNodes[indices[1]].first;
 		newNode1.texCoords = glm::vec2(-0.05f, 0.245f);
 		newNode1.height = 0.000075f;
-		newNode1.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode1.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode1.id] = newNode1;
 
 		Vertex newNode2 = *foundNodes[indices[2]].first;
 		newNode2.texCoords = glm::vec2(0.55f, 0.245f);
 		newNode2.height = 0.00005f;
-		newNode2.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode2.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode2.id] = newNode2;
 
 		Vertex newNode3 = *foundNodes[indices[3]].first;
 		newNode3.texCoords = glm::vec2(0.55f, 0.245f);
 		newNode3.height = 0.000075f;
-		newNode3.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode3.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode3.id] = newNode3;
 
 		/* Nodes to create quad (2 triangles) to fill gaps in the junction. */
 		Vertex newNode4 = *foundNodes[indices[0]].second;
 		newNode4.texCoords = glm::vec2(-0.05f, 0.245f);
 		newNode4.height = 0.00005f;
-		newNode4.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode4.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode4.id] = newNode4;
 
 		Vertex newNode5 = *foundNodes[indices[1]].first;
 		newNode5.texCoords = glm::vec2(0.55f, 0.245f);
 		newNode5.height = 0.000075f;
-		newNode5.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode5.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode5.id] = newNode5;
 
 		Vertex newNode6 = *foundNodes[indices[2]].first;
 		newNode6.texCoords = glm::vec2(-0.05f, 0.245f);
 		newNode6.height = 0.00005f;
-		newNode6.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode6.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode6.id] = newNode6;
 
 		Vertex newNode7 = *foundNodes[indices[3]].second;
 		newNode7.texCoords = glm::vec2(0.55f, 0.245f);
 		newNode7.height = 0.000075f;
-		newNode7.id = _osm.tiles[currentTile.x][currentTile.y].nodes.rbegin()->first + 1;
+		newNode7.id = _osm.tiles[currentTile.x][currentTile.y].nodes.getMaxId() + 1;
 		_osm.tiles[currentTile.x][currentTile.y].nodes[newNode7.id] = newNode7;
 
 		/* Quad to fill holes in junction. */
@@ -2762,12 +2781,12 @@ std::array<uint64_t, 2> NavDataProcess::calculateEndCaps(Vertex& first, Vertex&
 	// Setup new nodes used for end cap.
 	newNode1.coords -= v1;
 	newNode1.texCoords.y = 1.0f;
-	newNode1.id = _osm.nodes.rbegin()->first + 1;
+	newNode1.id = _osm.nodes.getMaxId() + 1;
 	_osm.nodes[newNode1.id] = newNode1;
 
 	newNode2.coords -= v1;
 	newNode2.texCoords.y = 1.0f;
-	newNode2.id = _osm.nodes.rbegin()->first + 1;
+	newNode2.id = _osm.nodes.getMaxId() + 1;
 	_osm.nodes[newNode2.id] = newNode2;
 
 	std::array<uint64_t, 2> retval;
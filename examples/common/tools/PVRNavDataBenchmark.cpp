@@ -0,0 +1,377 @@
+/*!
+\brief A command line tool timing the map preprocessing of the Navigation2D and Navigation3D examples: NavDataProcess::loadAndProcessData and
+NavDataProcess::initTiles, the part of it spent triangulating building and parking polygons, and the peak resident set size. It is built once with
+NavDataProcess2D.cpp and once with NavDataProcess3D.cpp, as the examples are. Without OSM maps on the command line it generates a city grid.
+\file examples/common/tools/PVRNavDataBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "../NavDataProcess.h"
+#include "PVRCore/stream/BufferStream.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+namespace {
+const double BlockSize = 0.001; // Degrees
+const double StreetWidth = 0.00015; // Degrees
+
+// Generates the OSM XML of a grid of numBlocks x numBlocks city blocks: Named streets along the block edges, crossing at every corner, and blocks
+// of concave "comb" shaped buildings (one in 40 a large star shaped one with hundreds of vertices), parking lots and amenities, both windings.
+class CityGenerator
+{
+public:
+	explicit CityGenerator(uint32_t numBlocks) : _numBlocks(numBlocks), _seed(12345), _nextNodeId(1000000), _nextWayId(5000000) {}
+
+	std::string generate()
+	{
+		const double minLon = -0.1, minLat = 51.5;
+		const double size = _numBlocks * BlockSize;
+		char header[256];
+		snprintf(header, sizeof(header), "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<osm version=\"0.6\">\n <bounds minlat=\"%.7f\" minlon=\"%.7f\" maxlat=\"%.7f\" maxlon=\"%.7f\"/>\n",
+			minLat, minLon, minLat + size, minLon + size);
+
+		// The street corners, shared by the crossing streets.
+		std::vector<uint64_t> corners((_numBlocks + 1) * (_numBlocks + 1));
+		for (uint32_t y = 0; y <= _numBlocks; ++y)
+		{
+			for (uint32_t x = 0; x <= _numBlocks; ++x)
+			{
+				corners[y * (_numBlocks + 1) + x] = addNode(minLon + x * BlockSize, minLat + y * BlockSize);
+			}
+		}
+		for (uint32_t street = 0; street <= _numBlocks; ++street)
+		{
+			for (uint32_t vertical = 0; vertical < 2; ++vertical)
+			{
+				std::vector<uint64_t> nodeIds;
+				for (uint32_t i = 0; i <= _numBlocks; ++i)
+				{
+					const uint32_t x = vertical ? street : i, y = vertical ? i : street;
+					if (i)
+					{
+						// A slightly bent midpoint, so that not every road is a straight line.
+						const double bend = (random(9) - 4.0) * BlockSize * 0.01;
+						nodeIds.push_back(vertical ? addNode(minLon + x * BlockSize + bend, minLat + (y - 0.5) * BlockSize)
+												   : addNode(minLon + (x - 0.5) * BlockSize, minLat + y * BlockSize + bend));
+					}
+					nodeIds.push_back(corners[y * (_numBlocks + 1) + x]);
+				}
+				char tags[128];
+				snprintf(tags, sizeof(tags), "<tag k=\"highway\" v=\"%s\"/><tag k=\"name\" v=\"%s %u\"/>", street % 4 ? "residential" : "primary",
+					vertical ? "Avenue" : "Street", street);
+				addWay(nodeIds, tags);
+			}
+		}
+
+		for (uint32_t y = 0; y < _numBlocks; ++y)
+		{
+			for (uint32_t x = 0; x < _numBlocks; ++x)
+			{
+				addBlock(minLon + x * BlockSize + StreetWidth, minLat + y * BlockSize + StreetWidth, minLon + (x + 1) * BlockSize - StreetWidth,
+					minLat + (y + 1) * BlockSize - StreetWidth);
+			}
+		}
+		return header + _nodes + _ways + "</osm>\n";
+	}
+
+	uint32_t getNumNodes() const
+	{
+		return static_cast<uint32_t>(_nextNodeId - 1000000);
+	}
+
+	uint32_t getNumWays() const
+	{
+		return static_cast<uint32_t>(_nextWayId - 5000000);
+	}
+
+private:
+	uint32_t random(uint32_t range)
+	{
+		_seed = _seed * 1664525u + 1013904223u;
+		return (_seed >> 8) % range;
+	}
+
+	uint64_t addNode(double lon, double lat, const char* tags = "")
+	{
+		char node[256];
+		snprintf(node, sizeof(node), " <node id=\"%llu\" lat=\"%.7f\" lon=\"%.7f\">%s</node>\n", static_cast<unsigned long long>(_nextNodeId), lat, lon, tags);
+		_nodes += node;
+		return _nextNodeId++;
+	}
+
+	void addWay(const std::vector<uint64_t>& nodeIds, const char* tags)
+	{
+		char buffer[64];
+		snprintf(buffer, sizeof(buffer), " <way id=\"%llu\">", static_cast<unsigned long long>(_nextWayId++));
+		_ways += buffer;
+		for (uint64_t nodeId : nodeIds)
+		{
+			snprintf(buffer, sizeof(buffer), "<nd ref=\"%llu\"/>", static_cast<unsigned long long>(nodeId));
+			_ways += buffer;
+		}
+		_ways += tags;
+		_ways += "</way>\n";
+	}
+
+	// Adds a closed way through the points, in either winding.
+	void addPolygon(const std::vector<glm::dvec2>& points, const char* tags)
+	{
+		std::vector<uint64_t> nodeIds;
+		const bool reverse = random(2) != 0;
+		for (size_t i = 0; i < points.size(); ++i)
+		{
+			const glm::dvec2& point = points[reverse ? points.size() - 1 - i : i];
+			nodeIds.push_back(addNode(point.x, point.y));
+		}
+		nodeIds.push_back(nodeIds.front());
+		addWay(nodeIds, tags);
+	}
+
+	// A rectangle with numTeeth notches cut into its top edge, anti-clockwise.
+	static std::vector<glm::dvec2> comb(glm::dvec2 min, glm::dvec2 max, uint32_t numTeeth)
+	{
+		std::vector<glm::dvec2> points;
+		points.push_back(min);
+		points.push_back(glm::dvec2(max.x, min.y));
+		const double toothWidth = (max.x - min.x) / (2 * numTeeth + 1);
+		const double notchY = min.y + (max.y - min.y) * 0.6;
+		for (uint32_t tooth = 0; tooth <= numTeeth; ++tooth)
+		{
+			const double right = max.x - 2 * tooth * toothWidth, left = right - toothWidth;
+			points.push_back(glm::dvec2(right, max.y));
+			points.push_back(glm::dvec2(left, max.y));
+			if (tooth < numTeeth)
+			{
+				points.push_back(glm::dvec2(left, notchY));
+				points.push_back(glm::dvec2(left - toothWidth, notchY));
+			}
+		}
+		return points;
+	}
+
+	// A star with numPoints tips of jittered radius, anti-clockwise.
+	std::vector<glm::dvec2> star(glm::dvec2 min, glm::dvec2 max, uint32_t numPoints)
+	{
+		std::vector<glm::dvec2> points;
+		const glm::dvec2 centre = (min + max) * 0.5, radius = (max - min) * 0.5;
+		for (uint32_t i = 0; i < numPoints * 2; ++i)
+		{
+			const double angle = glm::pi<double>() * i / numPoints;
+			const double scale = i % 2 ? 0.55 + random(20) * 0.01 : 0.85 + random(15) * 0.01;
+			points.push_back(centre + glm::dvec2(glm::cos(angle), glm::sin(angle)) * radius * scale);
+		}
+		return points;
+	}
+
+	// Four lots per block, each a building, a parking lot or (rarely) empty.
+	void addBlock(double minLon, double minLat, double maxLon, double maxLat)
+	{
+		const glm::dvec2 lotSize((maxLon - minLon) * 0.5, (maxLat - minLat) * 0.5);
+		for (uint32_t lot = 0; lot < 4; ++lot)
+		{
+			const glm::dvec2 min = glm::dvec2(minLon, minLat) + glm::dvec2(lot % 2, lot / 2) * lotSize + lotSize * 0.05;
+			const glm::dvec2 max = min + lotSize * 0.9;
+			const uint32_t kind = random(40);
+			if (kind == 0)
+			{
+				addPolygon(star(min, max, 60 + random(140)), "<tag k=\"building\" v=\"yes\"/><tag k=\"name\" v=\"Hall\"/>");
+			}
+			else if (kind < 3)
+			{
+				addPolygon(comb(min, max, 1), "<tag k=\"amenity\" v=\"parking\"/>");
+			}
+			else if (kind < 4)
+			{
+				addNode((min.x + max.x) * 0.5, (min.y + max.y) * 0.5, "<tag k=\"amenity\" v=\"cafe\"/><tag k=\"name\" v=\"Cafe\"/>");
+			}
+			else
+			{
+				addPolygon(comb(min, max, 1 + random(6)), "<tag k=\"building\" v=\"yes\"/>");
+			}
+		}
+	}
+
+	uint32_t _numBlocks;
+	uint32_t _seed;
+	uint64_t _nextNodeId;
+	uint64_t _nextWayId;
+	std::string _nodes;
+	std::string _ways;
+};
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+
+bool readFile(const char* filename, std::string& contents)
+{
+	FILE* file = fopen(filename, "rb");
+	if (!file)
+	{
+		return false;
+	}
+	char buffer[65536];
+	for (size_t numRead; (numRead = fread(buffer, 1, sizeof(buffer), file)) != 0;)
+	{
+		contents.append(buffer, numRead);
+	}
+	fclose(file);
+	return true;
+}
+
+// The peak resident set size of the process so far in MB, or 0 where it is not available.
+double getPeakResidentMegabytes()
+{
+#if defined(_WIN32)
+	return 0.0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0.0;
+	}
+#if defined(__APPLE__)
+	return usage.ru_maxrss / (1024.0 * 1024.0); // Bytes
+#else
+	return usage.ru_maxrss / 1024.0; // Kilobytes
+#endif
+#endif
+}
+
+struct Timings
+{
+	double loadMilliseconds;
+	double initTilesMilliseconds;
+	double triangulationMilliseconds;
+	uint32_t numPolygons;
+	size_t numNodes;
+	size_t numWayVertices;
+};
+
+// Preprocesses the map as the examples do, on a 1280x720 window.
+bool processMap(const std::string& map, Timings& timings)
+{
+	NavDataProcess process(std::unique_ptr<pvr::Stream>(new pvr::BufferStream("map.osm", map.data(), map.size())), glm::ivec2(1280, 720));
+	const auto start = std::chrono::high_resolution_clock::now();
+	if (process.loadAndProcessData() != pvr::Result::Success)
+	{
+		return false;
+	}
+	const auto loaded = std::chrono::high_resolution_clock::now();
+	process.initTiles();
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	timings.loadMilliseconds = std::chrono::duration<double, std::milli>(loaded - start).count();
+	timings.initTilesMilliseconds = std::chrono::duration<double, std::milli>(end - loaded).count();
+	timings.triangulationMilliseconds = process.getTriangulationTime();
+	timings.numPolygons = process.getNumTriangulatedPolygons();
+	timings.numNodes = timings.numWayVertices = 0;
+	for (const std::vector<Tile>& column : process.getTiles())
+	{
+		for (const Tile& tile : column)
+		{
+			timings.numNodes += tile.nodes.size();
+			for (const std::vector<Way>* ways : { &tile.areaWays, &tile.roadWays, &tile.parkingWays, &tile.buildWays, &tile.innerWays })
+			{
+				for (const Way& way : *ways)
+				{
+					timings.numWayVertices += way.nodeIds.size();
+				}
+			}
+		}
+	}
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numRepeats = 3;
+	uint32_t numBlocks = 24;
+	std::vector<std::string> filenames;
+	bool validArguments = true;
+	for (int i = 1; i < argc && validArguments; ++i)
+	{
+		if (argv[i][0] != '-')
+		{
+			filenames.push_back(argv[i]);
+		}
+		else
+		{
+			validArguments = readOption(argv[i], "-repeat=", numRepeats) || readOption(argv[i], "-blocks=", numBlocks);
+		}
+	}
+	if (!validArguments || !numRepeats || !numBlocks)
+	{
+		printf("Usage: %s [-repeat=<runs, of which the fastest is reported>] [-blocks=<city blocks per side of the generated map>] [OSM maps...]\n", argv[0]);
+		printf("The peak resident set size is that of the process, so run one map per process to compare it between maps.\n");
+		return 1;
+	}
+
+	try
+	{
+		std::vector<std::pair<std::string, std::string> > maps;
+		if (filenames.empty())
+		{
+			CityGenerator generator(numBlocks);
+			maps.push_back(std::make_pair(std::string(), generator.generate()));
+			maps.back().first = pvr::strings::createFormatted("generated %ux%u blocks (%u nodes, %u ways)", numBlocks, numBlocks, generator.getNumNodes(), generator.getNumWays());
+		}
+		for (const std::string& filename : filenames)
+		{
+			maps.push_back(std::make_pair(filename, std::string()));
+			if (!readFile(filename.c_str(), maps.back().second))
+			{
+				printf("Could not read %s\n", filename.c_str());
+				return 1;
+			}
+		}
+
+		for (const auto& map : maps)
+		{
+			Timings best = {};
+			for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+			{
+				Timings timings;
+				if (!processMap(map.second, timings))
+				{
+					printf("Could not process %s\n", map.first.c_str());
+					return 1;
+				}
+				if (!repeat || timings.loadMilliseconds + timings.initTilesMilliseconds < best.loadMilliseconds + best.initTilesMilliseconds)
+				{
+					best = timings;
+				}
+			}
+			printf("%s, %.1f MB, best of %u runs\n", map.first.c_str(), map.second.size() / (1024.0 * 1024.0), numRepeats);
+			printf("  loadAndProcessData: %9.2f ms\n", best.loadMilliseconds);
+			printf("  initTiles:          %9.2f ms\n", best.initTilesMilliseconds);
+			printf("  triangulation:      %9.2f ms (%u polygons)\n", best.triangulationMilliseconds, best.numPolygons);
+			printf("  tiles:              %zu nodes, %zu way vertices\n", best.numNodes, best.numWayVertices);
+			printf("  peak RSS:           %9.1f MB\n", getPeakResidentMegabytes());
+		}
+	}
+	catch (const std::exception& e)
+	{
+		printf("Failed: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
@@ -8,6 +8,14 @@
 //!\cond NO_DOXYGEN
 
 #include "PVRAssets/Helper.h"
+#include "PVRAssets/fileio/PODReader.h"
+#include "PVRAssets/fileio/GltfReader.h"
+#include "PVRCore/Log.h"
+#include "PVRCore/Threading.h"
+#include "../external/glm/gtc/packing.hpp"
+#include <algorithm>
+#include <cctype>
+#include <exception>
 namespace pvr {
 namespace assets {
 namespace helper {
@@ -69,28 +77,28 @@ void VertexRead(const unsigned char* data, const DataType type, uint32_t count,
 	case DataType::Int8:
 		for (i = 0; i < count; ++i)
 		{
-			out[i] = static_cast<float>(reinterpret_cast<const char*>(data)[i]);
+			out[i] = static_cast<float>(reinterpret_cast<const int8_t*>(data)[i]);
 		}
 		break;
 
 	case DataType::Int8Norm:
 		for (i = 0; i < count; ++i)
 		{
-			out[i] = static_cast<float>(reinterpret_cast<const char*>(data)[i]) / static_cast<float>((1 << 7) - 1);
+			out[i] = static_cast<float>(reinterpret_cast<const int8_t*>(data)[i]) / static_cast<float>((1 << 7) - 1);
 		}
 		break;
 
 	case DataType::UInt8:
 		for (i = 0; i < count; ++i)
 		{
-			out[i] = static_cast<float>(reinterpret_cast<const char*>(data)[i]);
+			out[i] = static_cast<float>(reinterpret_cast<const uint8_t*>(data)[i]);
 		}
 		break;
 
 	case DataType::UInt8Norm:
 		for (i = 0; i < count; ++i)
 		{
-			out[i] = static_cast<float>(reinterpret_cast<const char*>(data)[i]) / static_cast<float>((1 << 8) - 1);
+			out[i] = static_cast<float>(reinterpret_cast<const uint8_t*>(data)[i]) / static_cast<float>((1 << 8) - 1);
 		}
 		break;
 
@@ -115,6 +123,20 @@ void VertexRead(const unsigned char* data, const DataType type, uint32_t count,
 		}
 		break;
 
+	case DataType::UInt16Norm:
+		for (i = 0; i < count; ++i)
+		{
+			out[i] = static_cast<float>(reinterpret_cast<const uint16_t*>(data)[i]) / static_cast<float>((1 << 16) - 1);
+		}
+		break;
+
+	case DataType::Float16:
+		for (i = 0; i < count; ++i)
+		{
+			out[i] = glm::unpackHalf1x16(reinterpret_cast<const uint16_t*>(data)[i]);
+		}
+		break;
+
 	case DataType::RGBA:
 	{
 		uint32_t dwVal = *reinterpret_cast<const uint32_t*>(data);
@@ -227,6 +249,60 @@ void loadModel(IAssetProvider& assetProvider, const char* filename, assets::Mode
 	assets::PODReader reader(std::move(assetStream));
 	outModel = assets::Model::createWithReader(reader);
 }
+
+bool isGltfFile(const std::string& filename)
+{
+	const size_t dot = filename.find_last_of('.');
+	if (dot == std::string::npos)
+	{
+		return false;
+	}
+	std::string extension = filename.substr(dot + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension == "gltf" || extension == "glb";
+}
+
+void loadModelsParallel(IAssetProvider& assetProvider, const std::vector<std::string>& filenames, std::vector<assets::ModelHandle>& outModels, uint32_t maxThreads)
+{
+	outModels.clear();
+	outModels.resize(filenames.size());
+	if (filenames.empty())
+	{
+		return;
+	}
+
+	// Errors are kept per file rather than left to parallelFor, so that the first one in the order of the files is rethrown.
+	std::vector<std::exception_ptr> errors(filenames.size());
+	async::parallelFor(
+		static_cast<uint32_t>(filenames.size()),
+		[&](uint32_t i) {
+			try
+			{
+				Stream::ptr_type assetStream = assetProvider.getAssetStream(filenames[i]);
+				if (isGltfFile(filenames[i]))
+				{
+					outModels[i] = assets::Model::createWithReader(assets::GltfReader(std::move(assetStream), assetProvider));
+				}
+				else
+				{
+					outModels[i] = assets::Model::createWithReader(assets::PODReader(std::move(assetStream)));
+				}
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		},
+		maxThreads);
+
+	for (auto& error : errors)
+	{
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+}
 } // namespace helper
 } // namespace assets
 } // namespace pvr
@@ -9,6 +9,8 @@
 #include "PVRAssets/model/Mesh.h"
 #include "PVRAssets/Model.h"
 #include "PVRCore/IAssetProvider.h"
+#include <string>
+#include <vector>
 
 namespace pvr {
 namespace assets {
@@ -31,6 +33,25 @@ void VertexIndexRead(const uint8_t* data, const IndexType type, uint32_t* const
 /// <param name="filename">The filename to read the model from</param>
 /// <param name="outModel">The model to fill</param>
 void loadModel(IAssetProvider& assetProvider, const char* filename, assets::ModelHandle& outModel);
+
+/// <summary>Check if a file is a glTF model (.gltf or .glb, in any case), i.e. should be read with the GltfReader
+/// rather than the PODReader.</summary>
+/// <param name="filename">The filename to check</param>
+/// <returns>True if the extension of the filename is .gltf or .glb</returns>
+bool isGltfFile(const std::string& filename);
+
+/// <summary>Loads several models concurrently on the calling thread and the workers of the shared TaskScheduler (see
+/// async::parallelFor), one model per thread at a time. Files for which isGltfFile is true are read with the
+/// GltfReader, all other files with the PODReader. If any model fails to load, the first exception (in the order of
+/// filenames) is rethrown after all the models have been loaded.</summary>
+/// <param name="assetProvider">The asset provider to use for opening the asset streams. It will be called from several
+/// threads at once.</param>
+/// <param name="filenames">The filenames to read the models from</param>
+/// <param name="outModels">The models, in the same order as filenames</param>
+/// <param name="maxThreads">The maximum number of threads to use, including the calling thread. 0 uses all the workers
+/// of the shared TaskScheduler.</param>
+void loadModelsParallel(
+	IAssetProvider& assetProvider, const std::vector<std::string>& filenames, std::vector<assets::ModelHandle>& outModels, uint32_t maxThreads = 0);
 } // namespace helper
 } // namespace assets
 } // namespace pvr
@@ -0,0 +1,600 @@
+/*!
+\brief Implementation of the mesh optimization passes.
+\file PVRAssets/MeshOptimizer.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/MeshOptimizer.h"
+#include "PVRAssets/Helper.h"
+#include "PVRCore/Profiling.h"
+#include <algorithm>
+#include <cstring>
+
+namespace pvr {
+namespace assets {
+namespace utils {
+namespace {
+const uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+// A FIFO post-transform cache: A vertex is cached if fewer than cacheSize vertices were transformed since it was.
+class FifoCache
+{
+public:
+	FifoCache(uint32_t numVertices, uint32_t cacheSize) : _timestamps(numVertices, 0), _time(cacheSize + 1), _cacheSize(cacheSize) {}
+
+	// Returns the number of vertices of the triangle that were transformed.
+	uint32_t accessTriangle(const uint32_t* triangle)
+	{
+		return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+	}
+
+	void clear()
+	{
+		_time += _cacheSize + 1;
+	}
+
+private:
+	uint32_t access(uint32_t vertex)
+	{
+		if (_time - _timestamps[vertex] > _cacheSize)
+		{
+			_timestamps[vertex] = _time++;
+			return 1;
+		}
+		return 0;
+	}
+
+	std::vector<uint32_t> _timestamps;
+	uint32_t _time;
+	uint32_t _cacheSize;
+};
+
+// The triangles using each vertex. A triangle using a vertex more than once is listed once per use.
+struct VertexTriangles
+{
+	std::vector<uint32_t> offsets; // The triangles of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1] - 1]
+	std::vector<uint32_t> triangles;
+
+	VertexTriangles(const uint32_t* indices, size_t numIndices, uint32_t numVertices) : offsets(numVertices + 1, 0), triangles(numIndices)
+	{
+		for (size_t i = 0; i < numIndices; ++i)
+		{
+			++offsets[indices[i] + 1];
+		}
+		for (uint32_t v = 0; v < numVertices; ++v)
+		{
+			offsets[v + 1] += offsets[v];
+		}
+		std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < numIndices; ++i)
+		{
+			triangles[next[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	uint32_t getNumTriangles(uint32_t vertex) const
+	{
+		return offsets[vertex + 1] - offsets[vertex];
+	}
+};
+
+glm::vec3 getTriangleNormal(const glm::vec3* positions, const uint32_t* triangle)
+{
+	const glm::vec3& p0 = positions[triangle[0]];
+	return glm::cross(positions[triangle[1]] - p0, positions[triangle[2]] - p0); // Twice the area long
+}
+
+glm::vec3 getTriangleCentroid(const glm::vec3* positions, const uint32_t* triangle)
+{
+	return (positions[triangle[0]] + positions[triangle[1]] + positions[triangle[2]]) / 3.f;
+}
+
+// The vertex data blocks of a mesh that hold per-vertex data, i.e. those with a non-zero stride.
+struct VertexBlocks
+{
+	std::vector<uint32_t> blocks;
+
+	explicit VertexBlocks(const Mesh& mesh)
+	{
+		for (uint32_t block = 0; block < mesh.getNumDataElements(); ++block)
+		{
+			if (mesh.getStride(block))
+			{
+				blocks.push_back(block);
+			}
+		}
+	}
+
+	// Vertices can only be moved if every block holds data for all of them.
+	bool coverAllVertices(const Mesh& mesh) const
+	{
+		for (uint32_t block : blocks)
+		{
+			if (mesh.getDataSize(block) < static_cast<size_t>(mesh.getNumVertices()) * mesh.getStride(block))
+			{
+				return false;
+			}
+		}
+		return !blocks.empty();
+	}
+};
+
+uint64_t hashVertex(const Mesh& mesh, const VertexBlocks& vertexBlocks, uint32_t vertex)
+{
+	uint64_t hash = 14695981039346656037ull; // FNV-1a
+	for (uint32_t block : vertexBlocks.blocks)
+	{
+		const uint32_t stride = mesh.getStride(block);
+		const uint8_t* data = static_cast<const uint8_t*>(mesh.getData(block)) + static_cast<size_t>(vertex) * stride;
+		for (uint32_t i = 0; i < stride; ++i)
+		{
+			hash = (hash ^ data[i]) * 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+bool areVerticesEqual(const Mesh& mesh, const VertexBlocks& vertexBlocks, uint32_t lhs, uint32_t rhs)
+{
+	for (uint32_t block : vertexBlocks.blocks)
+	{
+		const size_t stride = mesh.getStride(block);
+		const uint8_t* data = static_cast<const uint8_t*>(mesh.getData(block));
+		if (memcmp(data + lhs * stride, data + rhs * stride, stride) != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Points every index at the first vertex whose data is identical to that of the vertex it references.
+void deduplicateVertices(const Mesh& mesh, const VertexBlocks& vertexBlocks, std::vector<uint32_t>& indices)
+{
+	const uint32_t numVertices = mesh.getNumVertices();
+	size_t tableSize = 1;
+	while (tableSize < static_cast<size_t>(numVertices) * 2)
+	{
+		tableSize *= 2;
+	}
+	std::vector<uint32_t> table(tableSize, InvalidIndex); // Open addressing, linear probing
+	std::vector<uint32_t> remap(numVertices);
+	for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+	{
+		size_t slot = static_cast<size_t>(hashVertex(mesh, vertexBlocks, vertex)) & (tableSize - 1);
+		while (table[slot] != InvalidIndex && !areVerticesEqual(mesh, vertexBlocks, table[slot], vertex))
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+		if (table[slot] == InvalidIndex)
+		{
+			table[slot] = vertex;
+		}
+		remap[vertex] = table[slot];
+	}
+	for (uint32_t& index : indices)
+	{
+		index = remap[index];
+	}
+}
+
+// Renumbers the vertices referenced by the indices, either in the order the indices first use them or in their
+// current order, and drops the vertices no index references.
+void renumberVertices(Mesh& mesh, const VertexBlocks& vertexBlocks, std::vector<uint32_t>& indices, bool inOrderOfUse)
+{
+	const uint32_t numVertices = mesh.getNumVertices();
+	std::vector<uint32_t> newIndices(numVertices, InvalidIndex);
+	uint32_t numUsed = 0;
+	if (inOrderOfUse)
+	{
+		for (uint32_t index : indices)
+		{
+			if (newIndices[index] == InvalidIndex)
+			{
+				newIndices[index] = numUsed++;
+			}
+		}
+	}
+	else
+	{
+		for (uint32_t index : indices)
+		{
+			newIndices[index] = 0;
+		}
+		for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+		{
+			if (newIndices[vertex] != InvalidIndex)
+			{
+				newIndices[vertex] = numUsed++;
+			}
+		}
+	}
+
+	std::vector<StridedBuffer>& dataBlocks = mesh.getInternalData().vertexAttributeDataBlocks;
+	for (uint32_t block : vertexBlocks.blocks)
+	{
+		StridedBuffer& data = dataBlocks[block];
+		const size_t stride = data.stride;
+		StridedBuffer newData;
+		newData.stride = data.stride;
+		newData.resize(numUsed * stride);
+		for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+		{
+			if (newIndices[vertex] != InvalidIndex)
+			{
+				memcpy(newData.data() + newIndices[vertex] * stride, data.data() + vertex * stride, stride);
+			}
+		}
+		data.swap(newData);
+	}
+	for (uint32_t& index : indices)
+	{
+		index = newIndices[index];
+	}
+	mesh.setNumVertices(numUsed);
+}
+
+bool readPositions(const Mesh& mesh, std::vector<glm::vec3>& positions)
+{
+	const Mesh::VertexAttributeData* attribute = mesh.getVertexAttributeByName("POSITION");
+	if (!attribute || static_cast<uint32_t>(attribute->getDataIndex()) >= mesh.getNumDataElements())
+	{
+		return false;
+	}
+	const uint32_t block = static_cast<uint32_t>(attribute->getDataIndex());
+	const uint32_t stride = mesh.getStride(block);
+	const uint32_t width = std::min(attribute->getN(), 3u);
+	const size_t size = mesh.getDataSize(block);
+	if (!stride || size < attribute->getOffset() + static_cast<size_t>(mesh.getNumVertices() - 1) * stride + width * dataTypeSize(attribute->getVertexLayout().dataType))
+	{
+		return false;
+	}
+	positions.assign(mesh.getNumVertices(), glm::vec3(0.f));
+	const uint8_t* data = static_cast<const uint8_t*>(mesh.getData(block)) + attribute->getOffset();
+	for (uint32_t vertex = 0; vertex < mesh.getNumVertices(); ++vertex)
+	{
+		helper::VertexRead(data + static_cast<size_t>(vertex) * stride, attribute->getVertexLayout().dataType, width, &positions[vertex].x);
+	}
+	return true;
+}
+
+bool isIndexedTriangleList(const Mesh& mesh)
+{
+	return mesh.getPrimitiveType() == PrimitiveTopology::TriangleList && mesh.getMeshInfo().isIndexed && !mesh.getNumStrips() && mesh.getFaces().getDataSize();
+}
+
+void readIndices(const Mesh& mesh, std::vector<uint32_t>& indices)
+{
+	const Mesh::FaceData& faces = mesh.getFaces();
+	const uint32_t indexSize = indexTypeSizeInBytes(faces.getDataType());
+	indices.resize(std::min(mesh.getNumFaces() * 3, faces.getDataSize() / indexSize));
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		helper::VertexIndexRead(faces.getData() + i * indexSize, faces.getDataType(), &indices[i]);
+	}
+}
+
+void writeIndices(Mesh& mesh, const std::vector<uint32_t>& indices)
+{
+	const IndexType indexType = mesh.getFaces().getDataType();
+	std::vector<uint8_t> data(indices.size() * indexTypeSizeInBytes(indexType));
+	if (indexType == IndexType::IndexType16Bit)
+	{
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			const uint16_t index = static_cast<uint16_t>(indices[i]);
+			memcpy(data.data() + i * sizeof(index), &index, sizeof(index));
+		}
+	}
+	else if (!indices.empty())
+	{
+		memcpy(data.data(), indices.data(), data.size());
+	}
+	mesh.addFaces(data.data(), static_cast<uint32_t>(data.size()), indexType);
+}
+} // namespace
+
+VertexCacheStatistics analyzeVertexCache(const uint32_t* indices, size_t numIndices, uint32_t numVertices, uint32_t cacheSize)
+{
+	VertexCacheStatistics statistics;
+	FifoCache cache(numVertices, cacheSize);
+	std::vector<bool> used(numVertices, false);
+	for (size_t i = 0; i + 2 < numIndices; i += 3)
+	{
+		statistics.numTransformedVertices += cache.accessTriangle(indices + i);
+		++statistics.numTriangles;
+		for (size_t j = i; j < i + 3; ++j)
+		{
+			if (!used[indices[j]])
+			{
+				used[indices[j]] = true;
+				++statistics.numVertices;
+			}
+		}
+	}
+	if (statistics.numTriangles)
+	{
+		statistics.acmr = static_cast<float>(statistics.numTransformedVertices) / statistics.numTriangles;
+		statistics.atvr = static_cast<float>(statistics.numTransformedVertices) / statistics.numVertices;
+	}
+	return statistics;
+}
+
+VertexCacheStatistics analyzeVertexCache(const Mesh& mesh, uint32_t cacheSize)
+{
+	if (!isIndexedTriangleList(mesh))
+	{
+		return VertexCacheStatistics();
+	}
+	std::vector<uint32_t> indices;
+	readIndices(mesh, indices);
+	if (std::find_if(indices.begin(), indices.end(), [&](uint32_t index) { return index >= mesh.getNumVertices(); }) != indices.end())
+	{
+		throw InvalidDataError("[analyzeVertexCache] The mesh has indices referencing vertices that do not exist");
+	}
+	return analyzeVertexCache(indices.data(), indices.size(), mesh.getNumVertices(), cacheSize);
+}
+
+void optimizeVertexCache(uint32_t* indices, size_t numIndices, uint32_t numVertices, uint32_t cacheSize)
+{
+	const size_t numTriangles = numIndices / 3;
+	if (numTriangles < 2)
+	{
+		return;
+	}
+	const VertexTriangles vertexTriangles(indices, numTriangles * 3, numVertices);
+
+	std::vector<uint32_t> liveTriangles(numVertices); // The number of triangles of each vertex not yet emitted
+	for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+	{
+		liveTriangles[vertex] = vertexTriangles.getNumTriangles(vertex);
+	}
+	std::vector<uint32_t> timestamps(numVertices, 0);
+	std::vector<bool> emitted(numTriangles, false);
+	std::vector<uint32_t> deadEndStack; // The vertices of the emitted triangles, to resume from when a fan is exhausted
+	deadEndStack.reserve(numTriangles * 3);
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> output;
+	output.reserve(numTriangles * 3);
+
+	uint32_t time = cacheSize + 1;
+	uint32_t nextVertex = 0; // Scans the vertices in order when the dead-end stack is exhausted
+	uint32_t fanningVertex = 0;
+	while (fanningVertex != InvalidIndex)
+	{
+		// Emit all the remaining triangles around the fanning vertex.
+		candidates.clear();
+		for (uint32_t i = vertexTriangles.offsets[fanningVertex]; i < vertexTriangles.offsets[fanningVertex + 1]; ++i)
+		{
+			const uint32_t triangle = vertexTriangles.triangles[i];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+			emitted[triangle] = true;
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t vertex = indices[triangle * 3 + corner];
+				output.push_back(vertex);
+				deadEndStack.push_back(vertex);
+				candidates.push_back(vertex);
+				--liveTriangles[vertex];
+				if (time - timestamps[vertex] > cacheSize)
+				{
+					timestamps[vertex] = time++;
+				}
+			}
+		}
+
+		// Continue with the candidate that will still be in the cache after its triangles are emitted, preferring the
+		// oldest in the cache.
+		fanningVertex = InvalidIndex;
+		int64_t bestPriority = -1;
+		for (uint32_t vertex : candidates)
+		{
+			if (!liveTriangles[vertex])
+			{
+				continue;
+			}
+			int64_t priority = 0;
+			if (time - timestamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+			{
+				priority = time - timestamps[vertex];
+			}
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				fanningVertex = vertex;
+			}
+		}
+		// Dead end: Resume from the most recently used vertex with triangles left, or failing that the next in order.
+		while (fanningVertex == InvalidIndex && !deadEndStack.empty())
+		{
+			if (liveTriangles[deadEndStack.back()])
+			{
+				fanningVertex = deadEndStack.back();
+			}
+			deadEndStack.pop_back();
+		}
+		for (; fanningVertex == InvalidIndex && nextVertex < numVertices; ++nextVertex)
+		{
+			if (liveTriangles[nextVertex])
+			{
+				fanningVertex = nextVertex;
+			}
+		}
+	}
+	std::copy(output.begin(), output.end(), indices);
+}
+
+void optimizeOverdraw(uint32_t* indices, size_t numIndices, const glm::vec3* positions, uint32_t numVertices, uint32_t cacheSize, float threshold)
+{
+	const uint32_t numTriangles = static_cast<uint32_t>(numIndices / 3);
+	if (numTriangles < 2)
+	{
+		return;
+	}
+
+	// Hard boundaries: Where all three vertices of a triangle miss the cache, the cache order restarted anyway.
+	std::vector<uint32_t> hardClusters;
+	FifoCache cache(numVertices, cacheSize);
+	for (uint32_t triangle = 0; triangle < numTriangles; ++triangle)
+	{
+		if (cache.accessTriangle(indices + triangle * 3) == 3)
+		{
+			hardClusters.push_back(triangle);
+		}
+	}
+	hardClusters.push_back(numTriangles);
+
+	// Soft boundaries: Split each cluster as soon as the part before the split has an ACMR within the threshold of the
+	// whole cluster, so that sorting the parts independently costs little cache efficiency.
+	std::vector<uint32_t> clusters;
+	for (size_t i = 0; i + 1 < hardClusters.size(); ++i)
+	{
+		const uint32_t begin = hardClusters[i], end = hardClusters[i + 1];
+		cache.clear();
+		uint32_t numMisses = 0;
+		for (uint32_t triangle = begin; triangle < end; ++triangle)
+		{
+			numMisses += cache.accessTriangle(indices + triangle * 3);
+		}
+		const float maxAcmr = threshold * numMisses / (end - begin);
+
+		cache.clear();
+		clusters.push_back(begin);
+		numMisses = 0;
+		uint32_t clusterBegin = begin;
+		for (uint32_t triangle = begin; triangle < end; ++triangle)
+		{
+			numMisses += cache.accessTriangle(indices + triangle * 3);
+			if (numMisses <= maxAcmr * (triangle + 1 - clusterBegin) && triangle + 1 < end)
+			{
+				clusterBegin = triangle + 1;
+				clusters.push_back(clusterBegin);
+				numMisses = 0;
+				cache.clear();
+			}
+		}
+		// A last part that never reached the threshold is merged back into the one before it.
+		if (clusterBegin != begin && numMisses > maxAcmr * (end - clusterBegin))
+		{
+			clusters.pop_back();
+		}
+	}
+	clusters.push_back(numTriangles);
+	const size_t numClusters = clusters.size() - 1;
+
+	// Sort the clusters by how much they face away from the centre of the mesh.
+	glm::vec3 meshCentroid(0.f);
+	float meshArea = 0.f;
+	std::vector<glm::vec3> clusterCentroids(numClusters, glm::vec3(0.f));
+	std::vector<glm::vec3> clusterNormals(numClusters, glm::vec3(0.f));
+	for (size_t cluster = 0; cluster < numClusters; ++cluster)
+	{
+		float clusterArea = 0.f;
+		for (uint32_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle)
+		{
+			const glm::vec3 normal = getTriangleNormal(positions, indices + triangle * 3);
+			const float area = glm::length(normal);
+			const glm::vec3 centroid = getTriangleCentroid(positions, indices + triangle * 3);
+			clusterNormals[cluster] += normal;
+			clusterCentroids[cluster] += centroid * area;
+			clusterArea += area;
+		}
+		meshCentroid += clusterCentroids[cluster];
+		meshArea += clusterArea;
+		clusterCentroids[cluster] = clusterArea > 0.f ? clusterCentroids[cluster] / clusterArea : getTriangleCentroid(positions, indices + clusters[cluster] * 3);
+	}
+	if (meshArea > 0.f)
+	{
+		meshCentroid /= meshArea;
+	}
+
+	std::vector<float> sortKeys(numClusters);
+	std::vector<uint32_t> order(numClusters);
+	for (size_t cluster = 0; cluster < numClusters; ++cluster)
+	{
+		const float normalLength = glm::length(clusterNormals[cluster]);
+		sortKeys[cluster] = normalLength > 0.f ? glm::dot(clusterCentroids[cluster] - meshCentroid, clusterNormals[cluster] / normalLength) : 0.f;
+		order[cluster] = static_cast<uint32_t>(cluster);
+	}
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+	std::vector<uint32_t> sorted;
+	sorted.reserve(numTriangles * 3);
+	for (uint32_t cluster : order)
+	{
+		sorted.insert(sorted.end(), indices + clusters[cluster] * 3, indices + clusters[cluster + 1] * 3);
+	}
+	std::copy(sorted.begin(), sorted.end(), indices);
+}
+
+MeshOptimizationStatistics optimizeMesh(Mesh& mesh, const MeshOptimizerOptions& options)
+{
+	PVR_PROFILE_SCOPE_CATEGORY("optimizeMesh", "assets");
+	MeshOptimizationStatistics statistics;
+	statistics.numVerticesBefore = statistics.numVerticesAfter = mesh.getNumVertices();
+	if (!isIndexedTriangleList(mesh))
+	{
+		return statistics;
+	}
+
+	std::vector<uint32_t> indices;
+	readIndices(mesh, indices);
+	if (std::find_if(indices.begin(), indices.end(), [&](uint32_t index) { return index >= mesh.getNumVertices(); }) != indices.end())
+	{
+		throw InvalidDataError("[optimizeMesh] The mesh has indices referencing vertices that do not exist");
+	}
+	statistics.before = analyzeVertexCache(indices.data(), indices.size(), mesh.getNumVertices(), options.cacheSize);
+
+	const VertexBlocks vertexBlocks(mesh);
+	// The levels of detail of the mesh index the same vertices, so they must stay where they are.
+	const bool canMoveVertices = vertexBlocks.coverAllVertices(mesh) && mesh.getLevelsOfDetail().empty();
+	if (options.deduplicateVertices && canMoveVertices)
+	{
+		deduplicateVertices(mesh, vertexBlocks, indices);
+	}
+
+	// Content exported by tools that already optimize for the vertex cache may have a better order than Tipsify finds.
+	std::vector<uint32_t> exportedIndices(indices);
+	optimizeVertexCache(indices.data(), indices.size(), mesh.getNumVertices(), options.cacheSize);
+	if (analyzeVertexCache(indices.data(), indices.size(), mesh.getNumVertices(), options.cacheSize).numTransformedVertices >
+		analyzeVertexCache(exportedIndices.data(), exportedIndices.size(), mesh.getNumVertices(), options.cacheSize).numTransformedVertices)
+	{
+		indices.swap(exportedIndices);
+	}
+
+	std::vector<glm::vec3> positions;
+	if (options.optimizeOverdraw && readPositions(mesh, positions))
+	{
+		optimizeOverdraw(indices.data(), indices.size(), positions.data(), mesh.getNumVertices(), options.cacheSize, options.overdrawThreshold);
+	}
+
+	if ((options.optimizeVertexFetch || options.deduplicateVertices) && canMoveVertices)
+	{
+		renumberVertices(mesh, vertexBlocks, indices, options.optimizeVertexFetch);
+	}
+	writeIndices(mesh, indices);
+
+	statistics.optimized = true;
+	statistics.after = analyzeVertexCache(indices.data(), indices.size(), mesh.getNumVertices(), options.cacheSize);
+	statistics.numVerticesAfter = mesh.getNumVertices();
+	return statistics;
+}
+
+std::vector<MeshOptimizationStatistics> optimizeModel(Model& model, const MeshOptimizerOptions& options)
+{
+	std::vector<MeshOptimizationStatistics> statistics;
+	statistics.reserve(model.getNumMeshes());
+	for (uint32_t i = 0; i < model.getNumMeshes(); ++i)
+	{
+		statistics.push_back(optimizeMesh(model.getMesh(i), options));
+	}
+	return statistics;
+}
+} // namespace utils
+} // namespace assets
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,107 @@
+/*!
+\brief Contains functions reordering the triangles and vertices of meshes for the post-transform vertex cache, for
+overdraw and for vertex fetch, and measuring the vertex cache efficiency of meshes.
+\file PVRAssets/MeshOptimizer.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRAssets/Model.h"
+#include <vector>
+
+namespace pvr {
+namespace assets {
+namespace utils {
+/// <summary>The efficiency of a triangle list with a post-transform vertex cache, simulated as a FIFO.</summary>
+struct VertexCacheStatistics
+{
+	uint32_t numTriangles; //!< The number of triangles
+	uint32_t numVertices; //!< The number of distinct vertices the triangles reference
+	uint32_t numTransformedVertices; //!< The number of vertices transformed, i.e. of cache misses
+	float acmr; //!< Average Cache Miss Ratio: Vertices transformed per triangle. From 3 (no reuse) down to about 0.5.
+	float atvr; //!< Average Transformed Vertex Ratio: Vertices transformed per distinct vertex. 1 is optimal.
+
+	/// <summary>Constructor. All zero.</summary>
+	VertexCacheStatistics() : numTriangles(0), numVertices(0), numTransformedVertices(0), acmr(0.f), atvr(0.f) {}
+};
+
+/// <summary>The passes optimizeMesh applies, and their parameters.</summary>
+struct MeshOptimizerOptions
+{
+	uint32_t cacheSize; //!< The number of vertices in the post-transform cache that the triangles are ordered for
+	bool optimizeOverdraw; //!< Sort clusters of triangles so that outward facing ones tend to be drawn first. Off by default.
+	float overdrawThreshold; //!< How much the overdraw pass may degrade the ACMR, e.g. 1.05 for up to 5%
+	bool deduplicateVertices; //!< Merge the vertices whose data is identical in every data block
+	bool optimizeVertexFetch; //!< Renumber the vertices in the order the triangles use them, dropping unused ones
+
+	/// <summary>Constructor. Enables every pass except the overdraw one, for a 16 vertex cache.</summary>
+	MeshOptimizerOptions() : cacheSize(16), optimizeOverdraw(false), overdrawThreshold(1.05f), deduplicateVertices(true), optimizeVertexFetch(true) {}
+};
+
+/// <summary>The effect of optimizeMesh on a mesh.</summary>
+struct MeshOptimizationStatistics
+{
+	bool optimized; //!< False if the mesh was left unchanged because it is not an indexed triangle list
+	VertexCacheStatistics before; //!< The vertex cache efficiency before the optimization
+	VertexCacheStatistics after; //!< The vertex cache efficiency after the optimization
+	uint32_t numVerticesBefore; //!< The number of vertices of the mesh before the optimization
+	uint32_t numVerticesAfter; //!< The number of vertices of the mesh after the optimization
+
+	/// <summary>Constructor. Not optimized.</summary>
+	MeshOptimizationStatistics() : optimized(false), numVerticesBefore(0), numVerticesAfter(0) {}
+};
+
+/// <summary>Simulate a FIFO post-transform vertex cache over a triangle list.</summary>
+/// <param name="indices">The indices of the triangle list</param>
+/// <param name="numIndices">The number of indices. Must be a multiple of 3.</param>
+/// <param name="numVertices">The number of vertices. Every index must be less than this.</param>
+/// <param name="cacheSize">The number of vertices in the cache</param>
+/// <returns>The cache efficiency of the triangle list.</returns>
+VertexCacheStatistics analyzeVertexCache(const uint32_t* indices, size_t numIndices, uint32_t numVertices, uint32_t cacheSize = 16);
+
+/// <summary>Simulate a FIFO post-transform vertex cache over the triangles of a mesh.</summary>
+/// <param name="mesh">An indexed triangle list mesh. Other meshes return all zero statistics.</param>
+/// <param name="cacheSize">The number of vertices in the cache</param>
+/// <returns>The cache efficiency of the mesh.</returns>
+VertexCacheStatistics analyzeVertexCache(const Mesh& mesh, uint32_t cacheSize = 16);
+
+/// <summary>Reorder the triangles of a triangle list for the post-transform vertex cache, using Tipsify (Sander,
+/// Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007). Runs in linear time.
+/// The vertices of each triangle keep their winding order.</summary>
+/// <param name="indices">The indices of the triangle list. Reordered in place.</param>
+/// <param name="numIndices">The number of indices. Must be a multiple of 3.</param>
+/// <param name="numVertices">The number of vertices. Every index must be less than this.</param>
+/// <param name="cacheSize">The number of vertices in the cache to optimize for</param>
+void optimizeVertexCache(uint32_t* indices, size_t numIndices, uint32_t numVertices, uint32_t cacheSize = 16);
+
+/// <summary>Reorder the triangles of a triangle list already optimized for the vertex cache to reduce overdraw. The
+/// triangles are split into clusters at the points where the cache order allows it without degrading the ACMR by
+/// more than the threshold, and the clusters are sorted so that those facing away from the centre of the mesh, which
+/// tend to occlude the others, are drawn first.</summary>
+/// <param name="indices">The indices of the triangle list. Reordered in place.</param>
+/// <param name="numIndices">The number of indices. Must be a multiple of 3.</param>
+/// <param name="positions">The positions of the vertices</param>
+/// <param name="numVertices">The number of vertices. Every index must be less than this.</param>
+/// <param name="cacheSize">The number of vertices in the cache the triangles were optimized for</param>
+/// <param name="threshold">How much the ACMR of the clusters may degrade, e.g. 1.05 for up to 5%</param>
+void optimizeOverdraw(uint32_t* indices, size_t numIndices, const glm::vec3* positions, uint32_t numVertices, uint32_t cacheSize = 16, float threshold = 1.05f);
+
+/// <summary>Optimize an indexed triangle list mesh in place: merge its duplicate vertices, reorder its triangles for
+/// the vertex cache (keeping their original order if it is already better) and, if enabled, for overdraw (using the
+/// "POSITION" attribute), then renumber the vertices in the order the triangles use them, across all of its vertex
+/// data blocks. Meshes that are not indexed triangle lists are left unchanged. The vertices of meshes that have levels
+/// of detail are neither merged nor renumbered, so generate them afterwards. Typically called on every mesh of a
+/// model just after loading it (see optimizeModel).</summary>
+/// <param name="mesh">The mesh to optimize</param>
+/// <param name="options">The passes to apply</param>
+/// <returns>The vertex cache statistics and vertex counts before and after.</returns>
+MeshOptimizationStatistics optimizeMesh(Mesh& mesh, const MeshOptimizerOptions& options = MeshOptimizerOptions());
+
+/// <summary>Optimize every mesh of a model in place (see optimizeMesh).</summary>
+/// <param name="model">The model to optimize</param>
+/// <param name="options">The passes to apply</param>
+/// <returns>The statistics of each mesh, in the order of the meshes of the model.</returns>
+std::vector<MeshOptimizationStatistics> optimizeModel(Model& model, const MeshOptimizerOptions& options = MeshOptimizerOptions());
+} // namespace utils
+} // namespace assets
+} // namespace pvr
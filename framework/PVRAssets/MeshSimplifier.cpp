@@ -0,0 +1,869 @@
+/*!
+\brief Implementation of the quadric error mesh simplification and of the level of detail generation.
+\file PVRAssets/MeshSimplifier.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/MeshSimplifier.h"
+#include "PVRAssets/Helper.h"
+#include "PVRAssets/MeshOptimizer.h"
+#include "PVRAssets/VertexQuantizer.h"
+#include "PVRCore/Profiling.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace pvr {
+namespace assets {
+namespace utils {
+namespace {
+const uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+// The weight of the planes through the open borders, perpendicular to their triangles, relative to the area weight
+// of the triangle planes. Keeps the borders from shrinking as their vertices slide along them.
+const float BorderWeight = 10.f;
+
+// How far down the sorted collapses a pass may go, relative to the cost of the collapse that would reach its goal.
+// Stops a pass from using expensive collapses because the cheap ones around them were blocked.
+const float PassCostFactor = 1.5f;
+
+enum class VertexKind : uint8_t
+{
+	Interior, // Can collapse onto any neighbour
+	Border, // On an open border: Can only collapse along it
+	Locked, // Non manifold, or on a border with lockBorder: Never collapses
+};
+
+// The weighted sum of the squared distances of a point to a set of planes: p^T A p + 2 b^T p + c, A symmetric.
+struct Quadric
+{
+	float a00, a11, a22, a10, a20, a21;
+	float b0, b1, b2;
+	float c;
+	float weight;
+
+	Quadric() : a00(0.f), a11(0.f), a22(0.f), a10(0.f), a20(0.f), a21(0.f), b0(0.f), b1(0.f), b2(0.f), c(0.f), weight(0.f) {}
+
+	// Adds the squared distance to the plane n.p + d = 0, or the squared difference between the linear function
+	// n.p + d and 0, without adding to the total weight.
+	void addTerms(const glm::vec3& n, float d, float w)
+	{
+		a00 += w * n.x * n.x;
+		a11 += w * n.y * n.y;
+		a22 += w * n.z * n.z;
+		a10 += w * n.y * n.x;
+		a20 += w * n.z * n.x;
+		a21 += w * n.z * n.y;
+		b0 += w * n.x * d;
+		b1 += w * n.y * d;
+		b2 += w * n.z * d;
+		c += w * d * d;
+	}
+
+	void addPlane(const glm::vec3& n, float d, float w)
+	{
+		addTerms(n, d, w);
+		weight += w;
+	}
+
+	void add(const Quadric& other)
+	{
+		a00 += other.a00;
+		a11 += other.a11;
+		a22 += other.a22;
+		a10 += other.a10;
+		a20 += other.a20;
+		a21 += other.a21;
+		b0 += other.b0;
+		b1 += other.b1;
+		b2 += other.b2;
+		c += other.c;
+		weight += other.weight;
+	}
+
+	float evaluate(const glm::vec3& p) const
+	{
+		return a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z + 2.f * (a10 * p.x * p.y + a20 * p.x * p.z + a21 * p.y * p.z) + 2.f * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+	}
+};
+
+struct PositionHasher
+{
+	size_t operator()(const glm::vec3& position) const
+	{
+		uint32_t bits[3];
+		memcpy(bits, &position, sizeof(bits));
+		// -0.f == 0.f, so they must hash the same. Done on the bits, as -ffast-math removes arithmetic like f + 0.f.
+		for (uint32_t& component : bits)
+		{
+			if (component == 0x80000000u)
+			{
+				component = 0;
+			}
+		}
+		return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+	}
+};
+
+uint32_t getNextCorner(uint32_t corner)
+{
+	return corner % 3 == 2 ? corner - 2 : corner + 1;
+}
+
+uint32_t getPreviousCorner(uint32_t corner)
+{
+	return corner % 3 == 0 ? corner + 2 : corner - 1;
+}
+
+// The triangle corners at each position, as indices into the index list. Every triangle references three different
+// positions, so it has one corner at each of them.
+struct PositionCorners
+{
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> corners;
+
+	void build(const std::vector<uint32_t>& cornerPositions, uint32_t numPositions)
+	{
+		offsets.assign(numPositions + 1, 0);
+		corners.resize(cornerPositions.size());
+		for (uint32_t position : cornerPositions)
+		{
+			++offsets[position + 1];
+		}
+		for (uint32_t p = 0; p < numPositions; ++p)
+		{
+			offsets[p + 1] += offsets[p];
+		}
+		std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < cornerPositions.size(); ++i)
+		{
+			corners[next[cornerPositions[i]]++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	const uint32_t* begin(uint32_t position) const
+	{
+		return corners.data() + offsets[position];
+	}
+
+	const uint32_t* end(uint32_t position) const
+	{
+		return corners.data() + offsets[position + 1];
+	}
+};
+
+struct Collapse
+{
+	uint32_t from; // The position that disappears
+	uint32_t to; // The position its vertices collapse onto
+	float cost; // The position and attribute error
+	float positionError; // The position part of the cost: The squared distance, relative to the extent of the mesh
+
+	bool operator<(const Collapse& other) const
+	{
+		return cost < other.cost;
+	}
+};
+
+// Positions are identified by the first vertex that has them, and normalized to the unit cube so that the errors
+// and the attribute weights do not depend on the scale of the mesh. Vertices are only ever replaced by other
+// vertices, so the result can reuse the vertex data.
+class Simplifier
+{
+public:
+	Simplifier(const uint32_t* indices, size_t numIndices, const glm::vec3* positions, uint32_t numVertices, const float* attributes, const float* attributeWeights,
+		uint32_t numAttributes, bool lockBorder)
+		: _numVertices(numVertices), _numAttributes(numAttributes), _extent(0.f), _maxError(0.f), _staleErrorLimit(0.f), _stale(numVertices, 1), _bestCollapses(numVertices)
+	{
+		buildPositions(indices, numIndices, positions);
+		_attributes.resize(static_cast<size_t>(numVertices) * numAttributes);
+		for (size_t i = 0; i < _attributes.size(); ++i)
+		{
+			_attributes[i] = attributes[i] * attributeWeights[i % numAttributes];
+		}
+
+		// Triangles collapsed to a line or a point cannot be simplified and are dropped like those that collapse.
+		_indices.reserve(numIndices);
+		_cornerPositions.reserve(numIndices);
+		for (size_t i = 0; i + 2 < numIndices; i += 3)
+		{
+			const uint32_t p0 = _positionIds[indices[i]], p1 = _positionIds[indices[i + 1]], p2 = _positionIds[indices[i + 2]];
+			if (p0 == p1 || p1 == p2 || p2 == p0)
+			{
+				continue;
+			}
+			_indices.insert(_indices.end(), indices + i, indices + i + 3);
+			_cornerPositions.insert(_cornerPositions.end(), { p0, p1, p2 });
+		}
+		_corners.build(_cornerPositions, _numVertices);
+		_remap.resize(_numVertices);
+		std::iota(_remap.begin(), _remap.end(), 0);
+		classifyPositions(lockBorder);
+		computeQuadrics();
+	}
+
+	// Collapses edges until the number of triangles or the error limit (squared, relative to the extent) is reached.
+	// Can be called again with a lower target to continue. Returns the largest error since the start, in the units
+	// of the positions: The quadrics accumulate, so the error is always measured against the original triangles.
+	float run(size_t targetTriangles, float errorLimit)
+	{
+		std::vector<Collapse> collapses;
+		std::vector<std::pair<uint32_t, uint32_t>> wedges;
+		std::vector<uint8_t> locked(_numVertices);
+		while (_indices.size() / 3 > targetTriangles)
+		{
+			// Only the positions around the collapses of the previous pass need a new collapse.
+			collapses.clear();
+			for (uint32_t from = 0; from < _numVertices; ++from)
+			{
+				if (_positionIds[from] != from || _kinds[from] == VertexKind::Locked)
+				{
+					continue;
+				}
+				if (_stale[from] || _staleErrorLimit != errorLimit)
+				{
+					_bestCollapses[from] = findCollapse(from, errorLimit, wedges);
+				}
+				if (_bestCollapses[from].to != InvalidIndex)
+				{
+					collapses.push_back(_bestCollapses[from]);
+				}
+			}
+			std::sort(collapses.begin(), collapses.end());
+			_staleErrorLimit = errorLimit;
+
+			// An edge collapse removes two triangles, or one on a border.
+			const size_t numTriangles = _indices.size() / 3;
+			const size_t collapseGoal = (numTriangles - targetTriangles) / 2;
+			const float passCostLimit = collapseGoal < collapses.size() ? collapses[collapseGoal].cost * PassCostFactor : std::numeric_limits<float>::max();
+
+			// The collapses of a pass were found before the others moved their neighbours, so each endpoint collapses
+			// at most once and the triangles are checked for flips again with the moves made so far.
+			std::fill(_stale.begin(), _stale.end(), 0);
+			std::fill(locked.begin(), locked.end(), 0);
+			size_t numRemoved = 0;
+			size_t numCollapses = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				if (numTriangles - numRemoved <= targetTriangles || collapse.cost > passCostLimit)
+				{
+					break;
+				}
+				if (locked[collapse.from] || locked[collapse.to] || flipsTriangle(collapse.from, collapse.to))
+				{
+					continue;
+				}
+
+				mapWedges(collapse.from, collapse.to, wedges);
+				for (const std::pair<uint32_t, uint32_t>& wedge : wedges)
+				{
+					_remap[wedge.first] = wedge.second;
+					if (_numAttributes)
+					{
+						_attributeQuadrics[wedge.second].add(_attributeQuadrics[wedge.first]);
+						for (uint32_t i = 0; i < _numAttributes * 4; ++i)
+						{
+							_gradients[wedge.second * _numAttributes * 4 + i] += _gradients[wedge.first * _numAttributes * 4 + i];
+						}
+					}
+				}
+				_positionQuadrics[collapse.to].add(_positionQuadrics[collapse.from]);
+
+				for (const uint32_t* corner = _corners.begin(collapse.from); corner != _corners.end(collapse.from); ++corner)
+				{
+					const uint32_t next = _positionIds[_remap[_indices[getNextCorner(*corner)]]];
+					const uint32_t previous = _positionIds[_remap[_indices[getPreviousCorner(*corner)]]];
+					_stale[next] = _stale[previous] = 1;
+					numRemoved += next == collapse.to || previous == collapse.to;
+				}
+				_stale[collapse.from] = _stale[collapse.to] = 1;
+				locked[collapse.from] = locked[collapse.to] = 1;
+				_maxError = std::max(_maxError, collapse.positionError);
+				++numCollapses;
+			}
+			if (!numCollapses)
+			{
+				break;
+			}
+
+			size_t numKept = 0;
+			for (size_t i = 0; i < _indices.size(); i += 3)
+			{
+				const uint32_t v0 = _remap[_indices[i]], v1 = _remap[_indices[i + 1]], v2 = _remap[_indices[i + 2]];
+				const uint32_t p0 = _positionIds[v0], p1 = _positionIds[v1], p2 = _positionIds[v2];
+				if (p0 == p1 || p1 == p2 || p2 == p0)
+				{
+					continue;
+				}
+				_cornerPositions[numKept] = p0;
+				_indices[numKept++] = v0;
+				_cornerPositions[numKept] = p1;
+				_indices[numKept++] = v1;
+				_cornerPositions[numKept] = p2;
+				_indices[numKept++] = v2;
+			}
+			_indices.resize(numKept);
+			_cornerPositions.resize(numKept);
+			_corners.build(_cornerPositions, _numVertices);
+			std::iota(_remap.begin(), _remap.end(), 0);
+		}
+		return std::sqrt(_maxError) * _extent;
+	}
+
+	const std::vector<uint32_t>& getIndices() const
+	{
+		return _indices;
+	}
+
+private:
+	// The cheapest collapse of a position within the error limit that does not flip a triangle, if any.
+	Collapse findCollapse(uint32_t from, float errorLimit, std::vector<std::pair<uint32_t, uint32_t>>& wedges) const
+	{
+		Collapse best = { from, InvalidIndex, std::numeric_limits<float>::max(), 0.f };
+		for (const uint32_t* corner = _corners.begin(from); corner != _corners.end(from); ++corner)
+		{
+			// Around an interior position, every neighbour follows it in exactly one triangle. On a border, the
+			// neighbour before it along the border only precedes it.
+			for (uint32_t i = 0; i < (_kinds[from] == VertexKind::Interior ? 1u : 2u); ++i)
+			{
+				const uint32_t to = _cornerPositions[i ? getPreviousCorner(*corner) : getNextCorner(*corner)];
+				if (!canCollapse(from, to))
+				{
+					continue;
+				}
+				Collapse collapse = { from, to, 0.f, getPositionError(from, _positions[to]) };
+				if (collapse.positionError > errorLimit || collapse.positionError >= best.cost || !mapWedges(from, to, wedges))
+				{
+					continue;
+				}
+				collapse.cost = collapse.positionError;
+				for (const std::pair<uint32_t, uint32_t>& wedge : wedges)
+				{
+					collapse.cost += getAttributeError(wedge.first, _positions[to], wedge.second);
+				}
+				if (collapse.cost < best.cost && !flipsTriangle(from, to))
+				{
+					best = collapse;
+				}
+			}
+		}
+		return best;
+	}
+
+	void buildPositions(const uint32_t* indices, size_t numIndices, const glm::vec3* positions)
+	{
+		glm::vec3 minimum(std::numeric_limits<float>::max());
+		glm::vec3 maximum(-std::numeric_limits<float>::max());
+		for (size_t i = 0; i < numIndices; ++i)
+		{
+			minimum = glm::min(minimum, positions[indices[i]]);
+			maximum = glm::max(maximum, positions[indices[i]]);
+		}
+		if (!numIndices)
+		{
+			minimum = maximum = glm::vec3(0.f);
+		}
+		_extent = std::max(maximum.x - minimum.x, std::max(maximum.y - minimum.y, maximum.z - minimum.z));
+		const float scale = _extent > 0.f ? 1.f / _extent : 1.f;
+
+		_positions.resize(_numVertices);
+		_positionIds.resize(_numVertices);
+		std::unordered_map<glm::vec3, uint32_t, PositionHasher> firstVertices;
+		firstVertices.reserve(_numVertices);
+		for (uint32_t vertex = 0; vertex < _numVertices; ++vertex)
+		{
+			_positionIds[vertex] = firstVertices.emplace(positions[vertex], vertex).first->second;
+			_positions[vertex] = (positions[vertex] - minimum) * scale;
+		}
+	}
+
+	uint32_t countEdges(uint32_t from, uint32_t to) const
+	{
+		uint32_t count = 0;
+		for (const uint32_t* corner = _corners.begin(from); corner != _corners.end(from); ++corner)
+		{
+			count += _cornerPositions[getNextCorner(*corner)] == to;
+		}
+		return count;
+	}
+
+	bool hasEdge(uint32_t from, uint32_t to) const
+	{
+		for (const uint32_t* corner = _corners.begin(from); corner != _corners.end(from); ++corner)
+		{
+			if (_cornerPositions[getNextCorner(*corner)] == to)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// A position is on a border if one of its edges has no opposite edge, and is non manifold if an edge is used
+	// twice in the same direction or it is on more than one border.
+	void classifyPositions(bool lockBorder)
+	{
+		_kinds.assign(_numVertices, VertexKind::Interior);
+		for (uint32_t position = 0; position < _numVertices; ++position)
+		{
+			bool isManifold = true;
+			uint32_t numBordersOut = 0, numBordersIn = 0;
+			for (const uint32_t* corner = _corners.begin(position); corner != _corners.end(position); ++corner)
+			{
+				const uint32_t next = _cornerPositions[getNextCorner(*corner)];
+				const uint32_t previous = _cornerPositions[getPreviousCorner(*corner)];
+				isManifold &= countEdges(position, next) == 1;
+				numBordersOut += !hasEdge(next, position);
+				numBordersIn += !hasEdge(position, previous);
+			}
+			if (!isManifold || numBordersOut > 1 || numBordersIn > 1 || numBordersOut != numBordersIn)
+			{
+				_kinds[position] = VertexKind::Locked;
+			}
+			else if (numBordersOut)
+			{
+				_kinds[position] = lockBorder ? VertexKind::Locked : VertexKind::Border;
+			}
+		}
+	}
+
+	void computeQuadrics()
+	{
+		_positionQuadrics.assign(_numVertices, Quadric());
+		_attributeQuadrics.assign(_numAttributes ? _numVertices : 0, Quadric());
+		_gradients.assign(static_cast<size_t>(_numVertices) * _numAttributes * 4, 0.f);
+		for (uint32_t i = 0; i < _indices.size(); i += 3)
+		{
+			const uint32_t* triangle = &_indices[i];
+			const glm::vec3& p0 = _positions[triangle[0]];
+			const glm::vec3& p1 = _positions[triangle[1]];
+			const glm::vec3& p2 = _positions[triangle[2]];
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			const float length = glm::length(normal);
+			if (length == 0.f)
+			{
+				continue;
+			}
+			normal /= length;
+			const float area = length * .5f;
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				_positionQuadrics[_cornerPositions[i + k]].addPlane(normal, -glm::dot(normal, p0), area);
+			}
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				const uint32_t from = _cornerPositions[i + k], to = _cornerPositions[getNextCorner(i + k)];
+				if (hasEdge(to, from))
+				{
+					continue;
+				}
+				const glm::vec3 edge = _positions[to] - _positions[from];
+				glm::vec3 borderNormal = glm::cross(edge, normal);
+				const float borderLength = glm::length(borderNormal);
+				if (borderLength == 0.f)
+				{
+					continue;
+				}
+				borderNormal /= borderLength;
+				const float d = -glm::dot(borderNormal, _positions[from]);
+				_positionQuadrics[from].addPlane(borderNormal, d, glm::dot(edge, edge) * BorderWeight);
+				_positionQuadrics[to].addPlane(borderNormal, d, glm::dot(edge, edge) * BorderWeight);
+			}
+			if (_numAttributes)
+			{
+				addAttributeGradients(triangle, area);
+			}
+		}
+	}
+
+	// Over the triangle, each attribute is the linear function g.p + d of the position. Its squared difference with
+	// a new value a, (g.p + d - a)^2, expands to a quadric in p plus terms in a that need the sums of g and d.
+	void addAttributeGradients(const uint32_t* triangle, float area)
+	{
+		const glm::vec3& p0 = _positions[triangle[0]];
+		const glm::vec3 e1 = _positions[triangle[1]] - p0;
+		const glm::vec3 e2 = _positions[triangle[2]] - p0;
+		const float d00 = glm::dot(e1, e1), d01 = glm::dot(e1, e2), d11 = glm::dot(e2, e2);
+		const float denominator = d00 * d11 - d01 * d01;
+		if (denominator <= 0.f)
+		{
+			return;
+		}
+		const float inverse = 1.f / denominator;
+
+		Quadric quadric;
+		quadric.weight = area;
+		const float* a0 = &_attributes[triangle[0] * _numAttributes];
+		const float* a1 = &_attributes[triangle[1] * _numAttributes];
+		const float* a2 = &_attributes[triangle[2] * _numAttributes];
+		for (uint32_t i = 0; i < _numAttributes; ++i)
+		{
+			const float da1 = a1[i] - a0[i], da2 = a2[i] - a0[i];
+			const glm::vec3 gradient = e1 * ((d11 * da1 - d01 * da2) * inverse) + e2 * ((d00 * da2 - d01 * da1) * inverse);
+			const float d = a0[i] - glm::dot(gradient, p0);
+			quadric.addTerms(gradient, d, area);
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				float* sums = &_gradients[(triangle[k] * _numAttributes + i) * 4];
+				sums[0] += gradient.x * area;
+				sums[1] += gradient.y * area;
+				sums[2] += gradient.z * area;
+				sums[3] += d * area;
+			}
+		}
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			_attributeQuadrics[triangle[k]].add(quadric);
+		}
+	}
+
+	float getPositionError(uint32_t position, const glm::vec3& target) const
+	{
+		const Quadric& quadric = _positionQuadrics[position];
+		return quadric.weight > 0.f ? std::max(0.f, quadric.evaluate(target)) / quadric.weight : 0.f;
+	}
+
+	// The error of the triangles around vertex if it moved to target with the attributes of vertex replacement.
+	float getAttributeError(uint32_t vertex, const glm::vec3& target, uint32_t replacement) const
+	{
+		if (!_numAttributes)
+		{
+			return 0.f;
+		}
+		const Quadric& quadric = _attributeQuadrics[vertex];
+		if (quadric.weight <= 0.f)
+		{
+			return 0.f;
+		}
+		float error = quadric.evaluate(target);
+		const float* values = &_attributes[replacement * _numAttributes];
+		for (uint32_t i = 0; i < _numAttributes; ++i)
+		{
+			const float* sums = &_gradients[(vertex * _numAttributes + i) * 4];
+			error += values[i] * (values[i] * quadric.weight - 2.f * (sums[0] * target.x + sums[1] * target.y + sums[2] * target.z + sums[3]));
+		}
+		return std::max(0.f, error) / quadric.weight;
+	}
+
+	bool canCollapse(uint32_t from, uint32_t to) const
+	{
+		if (_kinds[from] == VertexKind::Interior)
+		{
+			return true;
+		}
+		return _kinds[from] == VertexKind::Border && _kinds[to] != VertexKind::Interior && hasEdge(from, to) != hasEdge(to, from);
+	}
+
+	// Finds the vertex at position to that each vertex at position from becomes: The one the triangles of the edge
+	// use. Fails, to keep the seams of the attributes, if a vertex is not on the edge or would have to become two.
+	bool mapWedges(uint32_t from, uint32_t to, std::vector<std::pair<uint32_t, uint32_t>>& wedges) const
+	{
+		wedges.clear();
+		for (const uint32_t* corner = _corners.begin(from); corner != _corners.end(from); ++corner)
+		{
+			const uint32_t source = _indices[*corner];
+			const uint32_t next = getNextCorner(*corner), previous = getPreviousCorner(*corner);
+			const uint32_t target = _cornerPositions[next] == to ? _indices[next] : _cornerPositions[previous] == to ? _indices[previous] : InvalidIndex;
+			auto wedge = std::find_if(wedges.begin(), wedges.end(), [&](const std::pair<uint32_t, uint32_t>& w) { return w.first == source; });
+			if (wedge == wedges.end())
+			{
+				wedges.emplace_back(source, target);
+			}
+			else if (wedge->second == InvalidIndex)
+			{
+				wedge->second = target;
+			}
+			else if (target != InvalidIndex && target != wedge->second)
+			{
+				return false;
+			}
+		}
+		return std::find_if(wedges.begin(), wedges.end(), [](const std::pair<uint32_t, uint32_t>& w) { return w.second == InvalidIndex; }) == wedges.end();
+	}
+
+	// Whether moving from onto to turns one of the triangles that remain around from upside down, with the vertices
+	// moved so far in the pass.
+	bool flipsTriangle(uint32_t from, uint32_t to) const
+	{
+		const glm::vec3& source = _positions[from];
+		const glm::vec3& target = _positions[to];
+		for (const uint32_t* corner = _corners.begin(from); corner != _corners.end(from); ++corner)
+		{
+			const uint32_t next = _remap[_indices[getNextCorner(*corner)]], previous = _remap[_indices[getPreviousCorner(*corner)]];
+			if (_positionIds[next] == to || _positionIds[previous] == to || _positionIds[next] == _positionIds[previous])
+			{
+				continue;
+			}
+			const glm::vec3& b = _positions[next];
+			const glm::vec3& c = _positions[previous];
+			if (glm::dot(glm::cross(b - source, c - source), glm::cross(b - target, c - target)) <= 0.f)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint32_t _numVertices;
+	uint32_t _numAttributes;
+	float _extent;
+	float _maxError; // The largest position error of the collapses so far
+	float _staleErrorLimit; // The error limit the best collapses were found with
+	std::vector<uint8_t> _stale; // Per position: Whether its best collapse must be found again
+	std::vector<Collapse> _bestCollapses; // Per position
+	std::vector<glm::vec3> _positions; // Per vertex, normalized
+	std::vector<uint32_t> _positionIds; // Per vertex: The first vertex with the same position
+	std::vector<float> _attributes; // Per vertex, weighted
+	std::vector<uint32_t> _indices;
+	std::vector<uint32_t> _cornerPositions; // The position of each index
+	std::vector<uint32_t> _remap; // Per vertex: The vertex it collapsed onto in the current pass, or itself
+	PositionCorners _corners;
+	std::vector<VertexKind> _kinds; // Per position
+	std::vector<Quadric> _positionQuadrics; // Per position
+	std::vector<Quadric> _attributeQuadrics; // Per vertex
+	std::vector<float> _gradients; // Per vertex and attribute: The weighted sums of the gradients and of the offsets
+};
+
+bool isIndexedTriangleList(const Mesh& mesh)
+{
+	return mesh.getPrimitiveType() == PrimitiveTopology::TriangleList && mesh.getMeshInfo().isIndexed && !mesh.getNumStrips() && mesh.getFaces().getDataSize();
+}
+
+// Reads up to maxWidth values of an attribute of every vertex. Returns the number of values read per vertex, 0 if
+// the mesh does not have the attribute.
+uint32_t readAttribute(const Mesh& mesh, const char* semantic, uint32_t maxWidth, std::vector<float>& values)
+{
+	const Mesh::VertexAttributeData* attribute = mesh.getVertexAttributeByName(semantic);
+	if (!attribute || static_cast<uint32_t>(attribute->getDataIndex()) >= mesh.getNumDataElements() || !mesh.getNumVertices())
+	{
+		return 0;
+	}
+	const uint32_t block = static_cast<uint32_t>(attribute->getDataIndex());
+	const uint32_t stride = mesh.getStride(block);
+	const uint32_t width = std::min(attribute->getN(), maxWidth);
+	const DataType dataType = attribute->getVertexLayout().dataType;
+	if (!stride || !width ||
+		mesh.getDataSize(block) < attribute->getOffset() + static_cast<size_t>(mesh.getNumVertices() - 1) * stride + width * dataTypeSize(dataType))
+	{
+		return 0;
+	}
+	values.assign(static_cast<size_t>(mesh.getNumVertices()) * width, 0.f);
+	const uint8_t* data = static_cast<const uint8_t*>(mesh.getData(block)) + attribute->getOffset();
+	for (uint32_t vertex = 0; vertex < mesh.getNumVertices(); ++vertex)
+	{
+		helper::VertexRead(data + static_cast<size_t>(vertex) * stride, dataType, width, &values[static_cast<size_t>(vertex) * width]);
+	}
+	return width;
+}
+
+// The triangles, model space positions and weighted attributes of a mesh, as simplify takes them.
+struct SimplifierInput
+{
+	std::vector<uint32_t> indices;
+	std::vector<glm::vec3> positions;
+	std::vector<float> attributes;
+	std::vector<float> attributeWeights;
+	uint32_t numAttributes;
+
+	SimplifierInput() : numAttributes(0) {}
+};
+
+bool readSimplifierInput(const Mesh& mesh, const SimplificationOptions& options, SimplifierInput& input)
+{
+	if (!isIndexedTriangleList(mesh))
+	{
+		return false;
+	}
+	const uint32_t numVertices = mesh.getNumVertices();
+	std::vector<float> values;
+	if (readAttribute(mesh, "POSITION", 3, values) != 3)
+	{
+		return false;
+	}
+	input.positions.resize(numVertices);
+	for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+	{
+		input.positions[vertex] = glm::vec3(mesh.getUnpackMatrix() * glm::vec4(values[vertex * 3], values[vertex * 3 + 1], values[vertex * 3 + 2], 1.f));
+	}
+
+	const Mesh::FaceData& faces = mesh.getFaces();
+	const uint32_t indexSize = indexTypeSizeInBytes(faces.getDataType());
+	input.indices.resize(std::min(mesh.getNumFaces() * 3, faces.getDataSize() / indexSize));
+	for (size_t i = 0; i < input.indices.size(); ++i)
+	{
+		helper::VertexIndexRead(faces.getData() + i * indexSize, faces.getDataType(), &input.indices[i]);
+		if (input.indices[i] >= numVertices)
+		{
+			throw InvalidDataError("[simplifyMesh] The mesh has indices referencing vertices that do not exist");
+		}
+	}
+
+	// Normals quantized to two signed normalized octahedral coordinates (see VertexQuantizer.h) are decoded first.
+	std::vector<float> normals;
+	if (options.normalWeight > 0.f)
+	{
+		const Mesh::VertexAttributeData* attribute = mesh.getVertexAttributeByName("NORMAL");
+		const uint32_t width = readAttribute(mesh, "NORMAL", 3, values);
+		const DataType dataType = attribute ? attribute->getVertexLayout().dataType : DataType::None;
+		if (width >= 2 && attribute->getN() != 3 && (dataType == DataType::Int8Norm || dataType == DataType::Int16Norm))
+		{
+			normals.resize(static_cast<size_t>(numVertices) * 3);
+			for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+			{
+				const glm::vec3 normal = decodeOctahedral(glm::vec2(values[vertex * width], values[vertex * width + 1]));
+				memcpy(&normals[vertex * 3], &normal, sizeof(normal));
+			}
+		}
+		else if (width == 3)
+		{
+			normals.swap(values);
+		}
+	}
+	std::vector<float> texCoords;
+	if (options.texCoordWeight > 0.f && readAttribute(mesh, "UV0", 2, texCoords) != 2)
+	{
+		texCoords.clear();
+	}
+
+	input.numAttributes = (normals.empty() ? 0 : 3) + (texCoords.empty() ? 0 : 2);
+	input.attributes.resize(static_cast<size_t>(numVertices) * input.numAttributes);
+	for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+	{
+		float* out = &input.attributes[static_cast<size_t>(vertex) * input.numAttributes];
+		if (!normals.empty())
+		{
+			out = std::copy(&normals[vertex * 3], &normals[vertex * 3] + 3, out);
+		}
+		if (!texCoords.empty())
+		{
+			std::copy(&texCoords[vertex * 2], &texCoords[vertex * 2] + 2, out);
+		}
+	}
+	if (!normals.empty())
+	{
+		input.attributeWeights.insert(input.attributeWeights.end(), 3, options.normalWeight);
+	}
+	if (!texCoords.empty())
+	{
+		input.attributeWeights.insert(input.attributeWeights.end(), 2, options.texCoordWeight);
+	}
+	return true;
+}
+
+void encodeIndices(const uint32_t* indices, size_t numIndices, IndexType indexType, std::vector<uint8_t>& data)
+{
+	data.resize(numIndices * indexTypeSizeInBytes(indexType));
+	if (indexType == IndexType::IndexType16Bit)
+	{
+		for (size_t i = 0; i < numIndices; ++i)
+		{
+			const uint16_t index = static_cast<uint16_t>(indices[i]);
+			memcpy(data.data() + i * sizeof(index), &index, sizeof(index));
+		}
+	}
+	else if (numIndices)
+	{
+		memcpy(data.data(), indices, data.size());
+	}
+}
+} // namespace
+
+size_t simplify(uint32_t* destination, const uint32_t* indices, size_t numIndices, const glm::vec3* positions, uint32_t numVertices, const float* attributes,
+	const float* attributeWeights, uint32_t numAttributes, const SimplificationOptions& options, float* resultError)
+{
+	PVR_PROFILE_SCOPE_CATEGORY("simplify", "assets");
+	if (numIndices % 3)
+	{
+		throw InvalidArgumentError("numIndices", "[simplify] The number of indices must be a multiple of 3");
+	}
+	if (numAttributes && (!attributes || !attributeWeights))
+	{
+		throw InvalidArgumentError("attributes", "[simplify] The attributes and their weights are required");
+	}
+	if (std::find_if(indices, indices + numIndices, [&](uint32_t index) { return index >= numVertices; }) != indices + numIndices)
+	{
+		throw InvalidArgumentError("indices", "[simplify] The indices reference vertices that do not exist");
+	}
+
+	Simplifier simplifier(indices, numIndices, positions, numVertices, attributes, attributeWeights, numAttributes, options.lockBorder);
+	const float error = simplifier.run(options.targetIndexCount / 3, options.targetError * options.targetError);
+	if (resultError)
+	{
+		*resultError = error;
+	}
+	std::copy(simplifier.getIndices().begin(), simplifier.getIndices().end(), destination);
+	return simplifier.getIndices().size();
+}
+
+float simplifyMesh(const Mesh& mesh, const SimplificationOptions& options, std::vector<uint32_t>& indices)
+{
+	PVR_PROFILE_SCOPE_CATEGORY("simplifyMesh", "assets");
+	SimplifierInput input;
+	if (!readSimplifierInput(mesh, options, input))
+	{
+		throw InvalidArgumentError("mesh", "[simplifyMesh] The mesh must be an indexed triangle list with a POSITION attribute");
+	}
+	float error = 0.f;
+	indices.resize(input.indices.size());
+	indices.resize(simplify(indices.data(), input.indices.data(), input.indices.size(), input.positions.data(), mesh.getNumVertices(), input.attributes.data(),
+		input.attributeWeights.data(), input.numAttributes, options, &error));
+	return error;
+}
+
+uint32_t generateMeshLevelsOfDetail(Mesh& mesh, const LevelOfDetailOptions& options)
+{
+	PVR_PROFILE_SCOPE_CATEGORY("generateMeshLevelsOfDetail", "assets");
+	mesh.clearLevelsOfDetail();
+	SimplifierInput input;
+	if (!readSimplifierInput(mesh, options.simplification, input))
+	{
+		return 0;
+	}
+
+	// Each level continues simplifying the previous one, so the levels are nested and their errors increase.
+	Simplifier simplifier(input.indices.data(), input.indices.size(), input.positions.data(), mesh.getNumVertices(), input.attributes.data(),
+		input.attributeWeights.data(), input.numAttributes, options.simplification.lockBorder);
+	std::vector<uint32_t> indices;
+	std::vector<uint8_t> data;
+	size_t previousTriangles = input.indices.size() / 3;
+	for (uint32_t level = 0; level < options.maxLevels; ++level)
+	{
+		const size_t targetTriangles = static_cast<size_t>(previousTriangles * options.reduction);
+		if (targetTriangles < options.minTriangles)
+		{
+			break;
+		}
+		const float error = simplifier.run(targetTriangles, options.maxError * options.maxError);
+		const size_t numTriangles = simplifier.getIndices().size() / 3;
+		if (numTriangles > previousTriangles * 9 / 10 || numTriangles < options.minTriangles)
+		{
+			break;
+		}
+
+		indices = simplifier.getIndices();
+		optimizeVertexCache(indices.data(), indices.size(), mesh.getNumVertices());
+		encodeIndices(indices.data(), indices.size(), mesh.getFaces().getDataType(), data);
+		mesh.addLevelOfDetail(data.data(), static_cast<uint32_t>(data.size()), mesh.getFaces().getDataType(), error);
+		previousTriangles = numTriangles;
+	}
+	return static_cast<uint32_t>(mesh.getLevelsOfDetail().size());
+}
+
+std::vector<uint32_t> generateModelLevelsOfDetail(Model& model, const LevelOfDetailOptions& options)
+{
+	std::vector<uint32_t> numLevels;
+	numLevels.reserve(model.getNumMeshes());
+	for (uint32_t i = 0; i < model.getNumMeshes(); ++i)
+	{
+		numLevels.push_back(generateMeshLevelsOfDetail(model.getMesh(i), options));
+	}
+	return numLevels;
+}
+} // namespace utils
+} // namespace assets
+} // namespace pvr
+//!\endcond
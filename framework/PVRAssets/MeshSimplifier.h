@@ -0,0 +1,125 @@
+/*!
+\brief Contains functions simplifying the triangles of meshes with quadric error metrics, generating chains of levels
+of detail for them and selecting the level of detail to draw from its error in pixels.
+\file PVRAssets/MeshSimplifier.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRAssets/Model.h"
+#include <cmath>
+#include <vector>
+
+namespace pvr {
+namespace assets {
+namespace utils {
+/// <summary>When simplification stops, and how much the vertex attributes weigh against the positions.</summary>
+struct SimplificationOptions
+{
+	uint32_t targetIndexCount; //!< Stop once the triangles have at most this many indices. 0 to only stop at the error.
+	float targetError; //!< Stop before the error exceeds this fraction of the largest extent of the mesh, e.g. 0.01 for 1%
+	float normalWeight; //!< The cost of changing the normals by 1 against moving the surface by the largest extent
+	float texCoordWeight; //!< The cost of changing the texture coordinates by 1 against moving the surface by the largest extent
+	bool lockBorder; //!< Keep the vertices on the open borders of the mesh. Otherwise they only move along the borders.
+
+	/// <summary>Constructor. Simplifies as much as possible within 1% of the size of the mesh. Turning the normals by
+	/// about 6 degrees, or moving the texture coordinates by 1% of the texture, costs as much as moving the surface
+	/// by 0.1% of the size of the mesh.</summary>
+	SimplificationOptions() : targetIndexCount(0), targetError(0.01f), normalWeight(0.01f), texCoordWeight(0.1f), lockBorder(false) {}
+};
+
+/// <summary>The levels of detail generateMeshLevelsOfDetail creates.</summary>
+struct LevelOfDetailOptions
+{
+	uint32_t maxLevels; //!< The largest number of levels to create, not counting the full detail mesh
+	float reduction; //!< The fraction of the triangles of the previous level each level aims to keep, e.g. 0.5
+	float maxError; //!< The largest error of any level, as a fraction of the largest extent of the mesh
+	uint32_t minTriangles; //!< No level is created with fewer triangles than this
+	SimplificationOptions simplification; //!< The attribute weights and border handling. The targets are ignored.
+
+	/// <summary>Constructor. Up to 4 levels, each with half the triangles of the previous one, within 5% of the
+	/// size of the mesh.</summary>
+	LevelOfDetailOptions() : maxLevels(4), reduction(0.5f), maxError(0.05f), minTriangles(16) {}
+};
+
+/// <summary>Simplify a triangle list by collapsing its edges in the order of the quadric error metric of Garland and
+/// Heckbert ("Surface Simplification Using Quadric Error Metrics", 1997), extended with the attribute gradients of
+/// Hoppe ("New Quadric Metric for Simplifying Meshes with Appearance Attributes", 1999). Each edge collapses onto
+/// one of its vertices, so the result only references existing vertices and can be drawn with the same vertex
+/// buffers. Vertices sharing a position are welded for the topology: Seams in the attributes only collapse along
+/// themselves, open borders only collapse along themselves (or not at all with lockBorder), and non manifold
+/// vertices are kept. Collapses that would flip a triangle are rejected.</summary>
+/// <param name="destination">The indices of the simplified triangles. Must have room for numIndices indices.</param>
+/// <param name="indices">The indices of the triangle list</param>
+/// <param name="numIndices">The number of indices. Must be a multiple of 3.</param>
+/// <param name="positions">The positions of the vertices</param>
+/// <param name="numVertices">The number of vertices. Every index must be less than this.</param>
+/// <param name="attributes">numAttributes values per vertex to preserve, e.g. normals and texture coordinates. May
+/// be null if numAttributes is 0.</param>
+/// <param name="attributeWeights">numAttributes weights: The cost of changing each attribute by 1 against moving
+/// the surface by the largest extent of the mesh</param>
+/// <param name="numAttributes">The number of attributes per vertex</param>
+/// <param name="options">The targets to stop at. The weights are ignored.</param>
+/// <param name="resultError">If not null, receives the largest distance between the simplified surface and the
+/// original, in the units of the positions. Attribute errors are not included.</param>
+/// <returns>The number of indices written to destination.</returns>
+size_t simplify(uint32_t* destination, const uint32_t* indices, size_t numIndices, const glm::vec3* positions, uint32_t numVertices, const float* attributes,
+	const float* attributeWeights, uint32_t numAttributes, const SimplificationOptions& options, float* resultError = nullptr);
+
+/// <summary>Simplify the triangles of an indexed triangle list mesh (see simplify), preserving its "NORMAL" (also
+/// if octahedral, see VertexQuantizer.h) and "UV0" attributes. The positions are transformed by the unpack matrix of
+/// the mesh. The mesh is not modified.</summary>
+/// <param name="mesh">An indexed triangle list mesh with a "POSITION" attribute</param>
+/// <param name="options">The targets to stop at and the weights of the attributes</param>
+/// <param name="indices">Receives the indices of the simplified triangles</param>
+/// <returns>The largest distance, in model units, between the simplified surface and the original.</returns>
+float simplifyMesh(const Mesh& mesh, const SimplificationOptions& options, std::vector<uint32_t>& indices);
+
+/// <summary>Replace the levels of detail of an indexed triangle list mesh with a chain of simplified versions of
+/// its triangles (see simplifyMesh), each aiming for options.reduction times the triangles of the previous one. Each
+/// level continues simplifying the previous one with the same quadrics, so the errors are measured against the full
+/// detail triangles and increase along the chain. The levels are reordered for the vertex cache. The chain ends at
+/// the first level that cannot be reduced by at least 10% within the error limit. Meshes that are not indexed
+/// triangle lists or have no "POSITION" attribute get no levels.</summary>
+/// <param name="mesh">The mesh to generate the levels of detail of</param>
+/// <param name="options">The levels to generate</param>
+/// <returns>The number of levels of detail generated.</returns>
+uint32_t generateMeshLevelsOfDetail(Mesh& mesh, const LevelOfDetailOptions& options = LevelOfDetailOptions());
+
+/// <summary>Generate the levels of detail of every mesh of a model (see generateMeshLevelsOfDetail).</summary>
+/// <param name="model">The model to generate the levels of detail of</param>
+/// <param name="options">The levels to generate</param>
+/// <returns>The number of levels of detail of each mesh, in the order of the meshes of the model.</returns>
+std::vector<uint32_t> generateModelLevelsOfDetail(Model& model, const LevelOfDetailOptions& options = LevelOfDetailOptions());
+
+/// <summary>Get the factor converting a size at a distance of 1 from the camera to pixels on the screen, for a
+/// perspective projection.</summary>
+/// <param name="fovY">The vertical field of view, in radians</param>
+/// <param name="viewportHeight">The height of the viewport, in pixels</param>
+/// <returns>The projection scale to pass to selectLevelOfDetail.</returns>
+inline float getProjectionScale(float fovY, float viewportHeight)
+{
+	return viewportHeight / (2.f * std::tan(fovY * .5f));
+}
+
+/// <summary>Select the least detailed level of detail of a mesh whose error projects to at most maxPixelError pixels
+/// on the screen.</summary>
+/// <param name="mesh">The mesh</param>
+/// <param name="distance">The distance from the camera to the closest point of the mesh, in world units</param>
+/// <param name="projectionScale">See getProjectionScale</param>
+/// <param name="maxPixelError">The largest error allowed, in pixels</param>
+/// <param name="worldScale">The largest scale of the world matrix of the mesh, converting model units to world units</param>
+/// <returns>0 for the full detail faces, i + 1 for getLevelsOfDetail()[i].</returns>
+inline uint32_t selectLevelOfDetail(const Mesh& mesh, float distance, float projectionScale, float maxPixelError = 1.f, float worldScale = 1.f)
+{
+	const std::vector<Mesh::LevelOfDetail>& levels = mesh.getLevelsOfDetail();
+	uint32_t level = 0;
+	while (level < levels.size() && levels[level].error * worldScale * projectionScale <= maxPixelError * distance)
+	{
+		++level;
+	}
+	return level;
+}
+} // namespace utils
+} // namespace assets
+} // namespace pvr
@@ -11,6 +11,8 @@
 #include "PVRAssets/model/Light.h"
 #include "PVRAssets/model/Mesh.h"
 #include "PVRAssets/fileio/PODReader.h"
+#include <atomic>
+#include <memory>
 
 /// <summary>Main namespace of the PowerVR Framework.</summary>
 namespace pvr {
@@ -39,6 +41,16 @@ struct Skeleton
 	std::vector<glm::mat4> invBindMatrices;
 };
 
+/// <summary>The layout of each bone transformation written by Model::getBonePalette.</summary>
+enum class BonePaletteFormat : uint32_t
+{
+	Mat4x4, //!< A column-major glm::mat4, as returned by Model::getBoneWorldMatrix (64 bytes).
+	Mat3x4, //!< The top three rows of the affine transformation, each stored as a vec4 (a glm::mat3x4, 48 bytes). Apply
+			//!< in a shader as vec4(position, 1.0) * bone.
+	DualQuaternion, //!< A unit dual quaternion: the rotation quaternion (x,y,z,w) followed by the dual part (x,y,z,w), 32
+					//!< bytes. Only meaningful for bones without scaling.
+};
+
 /// <summary>The Model class represents an entire Scene, or Model. It is mainly a Node structure, allowing various
 /// different kinds of data to be stored in the Nodes. The class contains a tree-like structure of Nodes. Each Node
 /// can be a Mesh node (containing a Mesh), Camera node or Light node. The tree-structure assumes transformational
@@ -128,6 +140,32 @@ public:
 			// Animation
 			bool hasAnimation;
 
+			/// <summary>Set whenever the local transformation changes. Cleared when the Model recalculates the world
+			/// matrix of this node.</summary>
+			bool transformDirty;
+
+			/// <summary>The transformation generation of the Model this node belongs to, shared with it. Set by the
+			/// Model when it allocates its nodes or updates its world matrices. Null until then.</summary>
+			std::shared_ptr<std::atomic<uint32_t>> modelTransformGeneration;
+
+			/// <summary>Flag the local transformation of this node as modified, so that the cached world matrices of this
+			/// node and all its children are recalculated. Call after modifying the transformation data directly.</summary>
+			void setTransformDirty()
+			{
+				transformDirty = true;
+				invalidateModelWorldMatrices();
+			}
+
+			/// <summary>Let the Model this node belongs to know that its world matrix cache is out of date, without
+			/// flagging this node. Used to notify the Model once after flagging several of its nodes.</summary>
+			void invalidateModelWorldMatrices() const
+			{
+				if (modelTransformGeneration)
+				{
+					++*modelTransformGeneration;
+				}
+			}
+
 			/// <summary>Get current frame scale animation</summary>
 			/// <returns>Returns scale</returns>
 			glm::vec3& getFrameScaleAnimation()
@@ -216,6 +254,7 @@ public:
 			{
 				transformFlags = TransformFlags::Identity;
 				hasAnimation = false;
+				transformDirty = true;
 			}
 		};
 
@@ -288,6 +327,7 @@ public:
 		void setParentID(uint32_t parentID)
 		{
 			_data.parentIndex = parentID;
+			_data.setTransformDirty();
 		}
 
 		/// <summary>Set the user data of this node. A bit copy of the data will be made.</summary>
@@ -1255,12 +1295,35 @@ public:
 	}
 
 	/// <summary>Return the model-to-world matrix of a node. Corresponds to the Model's current frame of animation. This
-	/// version will store a copy of the matrix in an internal cache so that repeated calls for it will use the cached
-	/// copy of it. Will also store the cached versions of all parents of this node, or use cached versions of them if
-	/// they exist. Use this if you have long hierarchies and/or repeated calls per frame.</summary>
+	/// version returns the matrix from the internal world matrix cache if it is up to date, that is if
+	/// updateWorldMatrices has been called since any node transformation of this Model last changed. Otherwise it
+	/// falls back to getWorldMatrixNoCache. Never modifies the Model, so it can be called from several threads at once.
+	/// </summary>
 	/// <param name="nodeId">The node for which to return the world matrix.</param>
 	/// <returns>Return The world matrix of (nodeId).</returns>
-	glm::mat4x4 getWorldMatrix(uint32_t nodeId) const;
+	glm::mat4x4 getWorldMatrix(uint32_t nodeId) const
+	{
+		if (!areWorldMatricesUpToDate())
+		{
+			return getWorldMatrixNoCache(nodeId);
+		}
+		return _worldMatrices[nodeId];
+	}
+
+	/// <summary>Bring the world matrix cache up to date. The nodes are visited once, in an order where parents always
+	/// come before their children, and only the nodes whose transformation (or the transformation of one of their
+	/// ancestors) has been flagged as changed are recalculated. Call this once per frame, after updating the
+	/// animations and before querying the world matrices, for getWorldMatrix and getBonePalette to use the cache.
+	/// </summary>
+	void updateWorldMatrices();
+
+	/// <summary>Check if the world matrix cache is up to date, so that getWorldMatrix and getBonePalette use it.
+	/// </summary>
+	/// <returns>True if no node transformation of this Model has changed since the last updateWorldMatrices.</returns>
+	bool areWorldMatricesUpToDate() const
+	{
+		return _worldMatrices.size() == _data.nodes.size() && _cachedTransformGeneration == *_transformGeneration;
+	}
 
 	/// <summary>Return the model-to-world matrix of a node. Corresponds to the Model's current frame of animation. This
 	/// version will not use caching and will recalculate the matrix. Faster if the matrix is only used a few times.
@@ -1276,6 +1339,19 @@ public:
 	/// <returns>Return The world matrix of (nodeId, boneID)</returns>
 	glm::mat4x4 getBoneWorldMatrix(uint32_t skinNodeID, uint32_t boneId) const;
 
+	/// <summary>Write the model-to-world transformation of every bone of a skinned node, in the order of the bones of
+	/// its skeleton. The bones are calculated in a single pass over the world matrix cache, so call updateWorldMatrices
+	/// first: if the cache is out of date, the world matrix of every bone is calculated from scratch
+	/// (getWorldMatrixNoCache). Each transformation is the same as getBoneWorldMatrix would return for the bone.
+	/// </summary>
+	/// <param name="skinNodeID">The skinned mesh node whose bone palette to calculate</param>
+	/// <param name="format">The layout to write each bone transformation in</param>
+	/// <param name="outPalette">The buffer to write to. Must have room for getSkeleton(...).bones.size() entries.
+	/// </param>
+	/// <param name="stride">The distance in bytes between the start of consecutive bones in outPalette, for example
+	/// the array stride of a StructuredBufferView. 0 means tightly packed.</param>
+	void getBonePalette(uint32_t skinNodeID, BonePaletteFormat format, void* outPalette, size_t stride = 0) const;
+
 	/// <summary>Transform a custom matrix with a node's parent's transformation. Allows a custom matrix to be applied to a
 	/// node, while honoring the hierarchical transformations applied by its parent hierarchy.</summary>
 	/// <param name="nodeId">The node whose parents will be applied to the transformation.</param>
@@ -1765,6 +1841,8 @@ public:
 	void destroy()
 	{
 		_data = InternalData();
+		_nodeUpdateOrder.clear();
+		_worldMatrices.clear();
 	}
 
 	/// <summary>Allocate the specified number of mesh nodes.</summary>
@@ -1780,13 +1858,16 @@ public:
 		return static_cast<uint32_t>(_data.textures.size()) - 1;
 	}
 
-#ifdef DEBUG
-	int64_t total, frameNCacheHit, frameZeroCacheHit;
-	float frameHitPerc, frameZeroHitPerc;
-#endif
-	std::vector<float> cachedFrame; // Cache indicating the frames at which the matrix cache was filled
-	std::vector<glm::mat4x4> worldMatrixFrameN; // Cache of world matrices for the frame described in fCachedFrame
-	std::vector<glm::mat4x4> worldMatrixFrameZero; // Cache of frame 0 matrices
+private:
+	std::vector<glm::mat4x4> _worldMatrices; // Cache of the world matrices of all nodes, indexed by node id
+	std::vector<uint32_t> _nodeUpdateOrder; // Node ids sorted so that parents always come before their children
+	std::vector<uint32_t> _cachedParentIds; // The parent of each node when _nodeUpdateOrder was built
+	std::vector<uint32_t> _worldParentIds; // The parent each world matrix is relative to: None for nodes in a parenting cycle
+	std::vector<uint8_t> _worldMatrixChanged; // Scratch: which world matrices changed in the current update
+	// Incremented whenever a node transformation of this Model changes. Shared with the nodes (and with copies of the
+	// Model, which then invalidate each other's caches, but never miss an update).
+	std::shared_ptr<std::atomic<uint32_t>> _transformGeneration = std::make_shared<std::atomic<uint32_t>>(0);
+	uint32_t _cachedTransformGeneration = 0; // Value of _transformGeneration at the last update
 	InternalData _data;
 };
 
@@ -0,0 +1,452 @@
+/*!
+\brief Implementation of the vertex attribute quantization.
+\file PVRAssets/VertexQuantizer.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/VertexQuantizer.h"
+#include "PVRCore/Profiling.h"
+#include "../external/glm/gtc/packing.hpp"
+#include "../external/glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace pvr {
+namespace assets {
+namespace utils {
+namespace {
+enum class AttributeKind
+{
+	Unchanged,
+	Position,
+	Direction,
+	TexCoord,
+	BoneWeight,
+};
+
+AttributeKind getAttributeKind(const Mesh::VertexAttributeData& attribute, const VertexQuantizationOptions& options)
+{
+	if (attribute.getVertexLayout().dataType != DataType::Float32)
+	{
+		return AttributeKind::Unchanged;
+	}
+	const StringHash& semantic = attribute.getSemantic();
+	const uint32_t width = attribute.getN();
+	if (!width || width > 4)
+	{
+		return AttributeKind::Unchanged;
+	}
+	if (options.quantizePositions && width == 3 && semantic == "POSITION")
+	{
+		return AttributeKind::Position;
+	}
+	if (options.quantizeNormals && (width == 3 || width == 4) && (semantic == "NORMAL" || semantic == "TANGENT" || semantic == "BINORMAL"))
+	{
+		return AttributeKind::Direction;
+	}
+	if (options.quantizeTexCoords && semantic.str().size() == 3 && semantic.str().compare(0, 2, "UV") == 0 && semantic.str()[2] >= '0' && semantic.str()[2] <= '7')
+	{
+		return AttributeKind::TexCoord;
+	}
+	if (options.quantizeBoneWeights && (semantic == "BONEWEIGHT" || semantic == "WEIGHTS_0"))
+	{
+		return AttributeKind::BoneWeight;
+	}
+	return AttributeKind::Unchanged;
+}
+
+float signNotZero(float value)
+{
+	return value >= 0.f ? 1.f : -1.f;
+}
+
+uint32_t alignTo4(uint32_t value)
+{
+	return (value + 3u) & ~3u;
+}
+
+int32_t getSnormMax(DataType type)
+{
+	return type == DataType::Int8Norm ? 127 : 32767;
+}
+
+void writeSnorm(uint8_t* out, DataType type, int32_t value)
+{
+	if (type == DataType::Int8Norm)
+	{
+		*reinterpret_cast<int8_t*>(out) = static_cast<int8_t>(value);
+	}
+	else
+	{
+		const int16_t value16 = static_cast<int16_t>(value);
+		memcpy(out, &value16, sizeof(value16));
+	}
+}
+
+// Rounds the octahedral coordinates of the direction to the neighbouring grid point that decodes closest to it,
+// rather than to the nearest one, which roughly halves the angular error.
+glm::ivec2 quantizeOctahedral(const glm::vec3& direction, int32_t maxValue)
+{
+	const glm::vec2 scaled = encodeOctahedral(direction) * static_cast<float>(maxValue);
+	const glm::ivec2 base(static_cast<int32_t>(std::floor(scaled.x)), static_cast<int32_t>(std::floor(scaled.y)));
+	glm::ivec2 best = base;
+	float bestCosine = -2.f;
+	for (int32_t candidate = 0; candidate < 4; ++candidate)
+	{
+		const glm::ivec2 quantized = glm::clamp(base + glm::ivec2(candidate & 1, candidate >> 1), glm::ivec2(-maxValue), glm::ivec2(maxValue));
+		const float cosine = glm::dot(decodeOctahedral(glm::vec2(quantized) / static_cast<float>(maxValue)), direction);
+		if (cosine > bestCosine)
+		{
+			bestCosine = cosine;
+			best = quantized;
+		}
+	}
+	return best;
+}
+
+float angleInDegrees(const glm::vec3& a, const glm::vec3& b)
+{
+	return glm::degrees(std::acos(glm::clamp(glm::dot(a, b), -1.f, 1.f)));
+}
+
+// The conversion of one attribute of a data block.
+struct AttributeConversion
+{
+	Mesh::VertexAttributeData* attribute;
+	AttributeKind kind;
+	uint32_t oldOffset;
+	uint32_t oldSize;
+	DataType newType;
+	uint32_t newWidth;
+	uint32_t newOffset;
+	QuantizedAttributeStatistics statistics;
+};
+
+// Decides the new type, width and offset of each attribute, and returns the new stride.
+uint32_t layOutAttributes(std::vector<AttributeConversion>& conversions, const VertexQuantizationOptions& options)
+{
+	uint32_t offset = 0;
+	for (AttributeConversion& conversion : conversions)
+	{
+		const uint32_t oldWidth = conversion.attribute->getN();
+		conversion.statistics.semantic = conversion.attribute->getSemantic();
+		conversion.statistics.dataTypeBefore = conversion.attribute->getVertexLayout().dataType;
+		conversion.statistics.widthBefore = oldWidth;
+		switch (conversion.kind)
+		{
+		case AttributeKind::Position:
+			conversion.newType = DataType::UInt16Norm;
+			conversion.newWidth = 4;
+			break;
+		case AttributeKind::Direction:
+			conversion.newType = options.normalType == DataType::Int8Norm ? DataType::Int8Norm : DataType::Int16Norm;
+			conversion.newWidth = oldWidth == 4 ? 4 : 2;
+			break;
+		case AttributeKind::TexCoord:
+			conversion.newType = DataType::Float16;
+			conversion.newWidth = oldWidth;
+			break;
+		case AttributeKind::BoneWeight:
+			conversion.newType = DataType::UInt8Norm;
+			conversion.newWidth = oldWidth;
+			break;
+		case AttributeKind::Unchanged:
+			conversion.newType = conversion.statistics.dataTypeBefore;
+			conversion.newWidth = oldWidth;
+			break;
+		}
+		conversion.statistics.dataTypeAfter = conversion.newType;
+		conversion.statistics.widthAfter = conversion.newWidth;
+		conversion.newOffset = offset;
+		offset = alignTo4(offset + conversion.newWidth * dataTypeSize(conversion.newType));
+	}
+	return offset;
+}
+
+void convertPosition(AttributeConversion& conversion, const float* in, uint8_t* out, const glm::vec3& minimum, const glm::vec3& extent)
+{
+	uint16_t quantized[4];
+	glm::vec3 decoded;
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		const float normalized = extent[i] > 0.f ? glm::clamp((in[i] - minimum[i]) / extent[i], 0.f, 1.f) : 0.f;
+		quantized[i] = static_cast<uint16_t>(std::lround(normalized * 65535.f));
+		decoded[i] = minimum[i] + quantized[i] / 65535.f * extent[i];
+	}
+	quantized[3] = 65535;
+	memcpy(out, quantized, sizeof(quantized));
+	conversion.statistics.maxError = std::max(conversion.statistics.maxError, glm::length(decoded - glm::vec3(in[0], in[1], in[2])));
+}
+
+void convertDirection(AttributeConversion& conversion, const float* in, uint8_t* out)
+{
+	const uint32_t componentSize = dataTypeSize(conversion.newType);
+	const int32_t maxValue = getSnormMax(conversion.newType);
+	glm::vec3 direction(in[0], in[1], in[2]);
+	const float length = glm::length(direction);
+	const bool isDegenerate = !(length > 0.f); // Also catches NaNs
+	direction = isDegenerate ? glm::vec3(0.f, 0.f, 1.f) : direction / length;
+
+	const glm::ivec2 quantized = quantizeOctahedral(direction, maxValue);
+	writeSnorm(out, conversion.newType, quantized.x);
+	writeSnorm(out + componentSize, conversion.newType, quantized.y);
+	if (conversion.newWidth == 4)
+	{
+		writeSnorm(out + 2 * componentSize, conversion.newType, in[3] < 0.f ? -maxValue : maxValue);
+		writeSnorm(out + 3 * componentSize, conversion.newType, 0);
+	}
+	if (!isDegenerate)
+	{
+		const float error = angleInDegrees(decodeOctahedral(glm::vec2(quantized) / static_cast<float>(maxValue)), direction);
+		conversion.statistics.maxError = std::max(conversion.statistics.maxError, error);
+	}
+}
+
+void convertTexCoord(AttributeConversion& conversion, const float* in, uint8_t* out)
+{
+	for (uint32_t i = 0; i < conversion.newWidth; ++i)
+	{
+		const uint16_t half = glm::packHalf1x16(in[i]);
+		memcpy(out + i * sizeof(half), &half, sizeof(half));
+		conversion.statistics.maxError = std::max(conversion.statistics.maxError, std::abs(glm::unpackHalf1x16(half) - in[i]));
+	}
+}
+
+// Rounds the weights so that, if they summed to 1, their quantized values still sum to 255, putting the rounding
+// error on the largest weight.
+void convertBoneWeight(AttributeConversion& conversion, const float* in, uint8_t* out)
+{
+	float sum = 0.f;
+	int32_t quantizedSum = 0;
+	uint32_t largest = 0;
+	int32_t quantized[4];
+	for (uint32_t i = 0; i < conversion.newWidth; ++i)
+	{
+		quantized[i] = static_cast<int32_t>(std::lround(glm::clamp(in[i], 0.f, 1.f) * 255.f));
+		sum += in[i];
+		quantizedSum += quantized[i];
+		if (in[i] > in[largest])
+		{
+			largest = i;
+		}
+	}
+	if (std::abs(sum - 1.f) < .01f)
+	{
+		quantized[largest] = glm::clamp(quantized[largest] + 255 - quantizedSum, 0, 255);
+	}
+	for (uint32_t i = 0; i < conversion.newWidth; ++i)
+	{
+		out[i] = static_cast<uint8_t>(quantized[i]);
+		conversion.statistics.maxError = std::max(conversion.statistics.maxError, std::abs(quantized[i] / 255.f - in[i]));
+	}
+}
+
+// Texture coordinates that half floats cannot represent within the tolerance, e.g. because they tile a texture many
+// times, are left as they are.
+bool fitsInFloat16(const uint8_t* data, uint32_t stride, uint32_t numVertices, uint32_t offset, uint32_t width, float tolerance)
+{
+	for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+	{
+		float values[4];
+		memcpy(values, data + static_cast<size_t>(vertex) * stride + offset, width * sizeof(float));
+		for (uint32_t i = 0; i < width; ++i)
+		{
+			if (!(std::abs(glm::unpackHalf1x16(glm::packHalf1x16(values[i])) - values[i]) <= tolerance))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool getPositionRange(const Mesh& mesh, glm::vec3& minimum, glm::vec3& maximum)
+{
+	const Mesh::VertexAttributeData* attribute = mesh.getVertexAttributeByName("POSITION");
+	if (!attribute || attribute->getVertexLayout().dataType != DataType::Float32 || attribute->getN() != 3)
+	{
+		return false;
+	}
+	const uint32_t block = static_cast<uint32_t>(attribute->getDataIndex());
+	if (block >= mesh.getNumDataElements() || !mesh.getNumVertices())
+	{
+		return false;
+	}
+	const uint32_t stride = mesh.getStride(block);
+	if (!stride || mesh.getDataSize(block) < static_cast<size_t>(mesh.getNumVertices()) * stride)
+	{
+		return false;
+	}
+	const uint8_t* data = static_cast<const uint8_t*>(mesh.getData(block)) + attribute->getOffset();
+	minimum = glm::vec3(std::numeric_limits<float>::max());
+	maximum = glm::vec3(-std::numeric_limits<float>::max());
+	for (uint32_t vertex = 0; vertex < mesh.getNumVertices(); ++vertex)
+	{
+		glm::vec3 position;
+		memcpy(&position, data + static_cast<size_t>(vertex) * stride, sizeof(position));
+		minimum = glm::min(minimum, position);
+		maximum = glm::max(maximum, position);
+	}
+	return std::isfinite(minimum.x + minimum.y + minimum.z + maximum.x + maximum.y + maximum.z);
+}
+} // namespace
+
+glm::vec2 encodeOctahedral(const glm::vec3& direction)
+{
+	const glm::vec3 projected = direction / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+	if (projected.z >= 0.f)
+	{
+		return glm::vec2(projected.x, projected.y);
+	}
+	return glm::vec2((1.f - std::abs(projected.y)) * signNotZero(projected.x), (1.f - std::abs(projected.x)) * signNotZero(projected.y));
+}
+
+glm::vec3 decodeOctahedral(const glm::vec2& octahedral)
+{
+	glm::vec3 direction(octahedral.x, octahedral.y, 1.f - std::abs(octahedral.x) - std::abs(octahedral.y));
+	if (direction.z < 0.f)
+	{
+		direction.x = (1.f - std::abs(octahedral.y)) * signNotZero(octahedral.x);
+		direction.y = (1.f - std::abs(octahedral.x)) * signNotZero(octahedral.y);
+	}
+	return glm::normalize(direction);
+}
+
+VertexQuantizationStatistics quantizeMesh(Mesh& mesh, const VertexQuantizationOptions& options)
+{
+	PVR_PROFILE_SCOPE_CATEGORY("quantizeMesh", "assets");
+	VertexQuantizationStatistics statistics;
+	const uint32_t numVertices = mesh.getNumVertices();
+	for (uint32_t block = 0; block < mesh.getNumDataElements(); ++block)
+	{
+		statistics.vertexDataSizeBefore += mesh.getDataSize(block);
+	}
+
+	glm::vec3 minimum(0.f), maximum(0.f);
+	const bool canQuantizePositions = options.quantizePositions && getPositionRange(mesh, minimum, maximum);
+	const glm::vec3 extent = canQuantizePositions ? maximum - minimum : glm::vec3(0.f);
+
+	std::vector<StridedBuffer>& dataBlocks = mesh.getInternalData().vertexAttributeDataBlocks;
+	for (uint32_t block = 0; block < dataBlocks.size(); ++block)
+	{
+		StridedBuffer& data = dataBlocks[block];
+		const uint32_t stride = data.stride;
+		if (!stride || !numVertices || data.size() < static_cast<size_t>(numVertices) * stride)
+		{
+			continue;
+		}
+
+		std::vector<AttributeConversion> conversions;
+		bool isConverted = false;
+		bool isValid = true;
+		for (uint32_t i = 0; i < mesh.getVertexAttributesSize(); ++i)
+		{
+			Mesh::VertexAttributeData& attribute = mesh.getVertexAttributes()[i];
+			if (static_cast<uint32_t>(attribute.getDataIndex()) != block)
+			{
+				continue;
+			}
+			AttributeConversion conversion = {};
+			conversion.attribute = &attribute;
+			conversion.kind = getAttributeKind(attribute, options);
+			conversion.oldOffset = attribute.getOffset();
+			conversion.oldSize = attribute.getN() * dataTypeSize(attribute.getVertexLayout().dataType);
+			isValid = isValid && conversion.oldOffset + conversion.oldSize <= stride;
+			if (!isValid)
+			{
+				break;
+			}
+			if ((conversion.kind == AttributeKind::Position && !canQuantizePositions) ||
+				(conversion.kind == AttributeKind::TexCoord && !fitsInFloat16(data.data(), stride, numVertices, conversion.oldOffset, attribute.getN(), options.texCoordTolerance)))
+			{
+				conversion.kind = AttributeKind::Unchanged;
+			}
+			isConverted = isConverted || conversion.kind != AttributeKind::Unchanged;
+			conversions.push_back(conversion);
+		}
+		if (!isConverted || !isValid)
+		{
+			continue;
+		}
+
+		std::sort(conversions.begin(), conversions.end(), [](const AttributeConversion& lhs, const AttributeConversion& rhs) { return lhs.oldOffset < rhs.oldOffset; });
+		const uint32_t newStride = layOutAttributes(conversions, options);
+
+		StridedBuffer newData;
+		newData.resize(static_cast<size_t>(numVertices) * newStride);
+		for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+		{
+			const uint8_t* in = data.data() + static_cast<size_t>(vertex) * stride;
+			uint8_t* out = newData.data() + static_cast<size_t>(vertex) * newStride;
+			for (AttributeConversion& conversion : conversions)
+			{
+				float values[4] = {};
+				if (conversion.kind != AttributeKind::Unchanged)
+				{
+					memcpy(values, in + conversion.oldOffset, conversion.oldSize);
+				}
+				switch (conversion.kind)
+				{
+				case AttributeKind::Position:
+					convertPosition(conversion, values, out + conversion.newOffset, minimum, extent);
+					break;
+				case AttributeKind::Direction:
+					convertDirection(conversion, values, out + conversion.newOffset);
+					break;
+				case AttributeKind::TexCoord:
+					convertTexCoord(conversion, values, out + conversion.newOffset);
+					break;
+				case AttributeKind::BoneWeight:
+					convertBoneWeight(conversion, values, out + conversion.newOffset);
+					break;
+				case AttributeKind::Unchanged:
+					memcpy(out + conversion.newOffset, in + conversion.oldOffset, conversion.oldSize);
+					break;
+				}
+			}
+		}
+		data.swap(newData);
+		data.stride = static_cast<uint16_t>(newStride);
+
+		for (AttributeConversion& conversion : conversions)
+		{
+			conversion.attribute->setDataType(conversion.newType);
+			conversion.attribute->setN(static_cast<uint8_t>(conversion.newWidth));
+			conversion.attribute->setOffset(conversion.newOffset);
+			if (conversion.kind != AttributeKind::Unchanged)
+			{
+				statistics.attributes.push_back(conversion.statistics);
+			}
+			if (conversion.kind == AttributeKind::Position)
+			{
+				// An axis along which every position is the same is stored as 0, so any scale works for it.
+				const glm::vec3 scale(extent.x > 0.f ? extent.x : 1.f, extent.y > 0.f ? extent.y : 1.f, extent.z > 0.f ? extent.z : 1.f);
+				mesh.setUnpackMatrix(glm::scale(glm::translate(mesh.getUnpackMatrix(), minimum), scale));
+			}
+		}
+	}
+
+	for (uint32_t block = 0; block < mesh.getNumDataElements(); ++block)
+	{
+		statistics.vertexDataSizeAfter += mesh.getDataSize(block);
+	}
+	return statistics;
+}
+
+std::vector<VertexQuantizationStatistics> quantizeModel(Model& model, const VertexQuantizationOptions& options)
+{
+	std::vector<VertexQuantizationStatistics> statistics;
+	statistics.reserve(model.getNumMeshes());
+	for (uint32_t i = 0; i < model.getNumMeshes(); ++i)
+	{
+		statistics.push_back(quantizeMesh(model.getMesh(i), options));
+	}
+	return statistics;
+}
+} // namespace utils
+} // namespace assets
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,109 @@
+/*!
+\brief Contains functions converting the vertex attributes of meshes to compact data types: positions to 16 bit
+normalized integers with an unpack matrix, normals and tangents to octahedral signed normalized integers, texture
+coordinates to half floats and bone weights to 8 bit normalized integers.
+\file PVRAssets/VertexQuantizer.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRAssets/Model.h"
+#include <vector>
+
+namespace pvr {
+namespace assets {
+namespace utils {
+/// <summary>The attributes quantizeMesh converts, and their formats. Only attributes stored as Float32 are converted.
+/// </summary>
+struct VertexQuantizationOptions
+{
+	bool quantizePositions; //!< Convert "POSITION" to 4 x UInt16Norm (w = 1) and fold its range into the unpack matrix
+	bool quantizeNormals; //!< Convert "NORMAL", "TANGENT" and "BINORMAL" to octahedral coordinates
+	DataType normalType; //!< Int16Norm or Int8Norm: The type of the octahedral normals, tangents and binormals
+	bool quantizeTexCoords; //!< Convert "UV0" to "UV7" to Float16
+	float texCoordTolerance; //!< The largest error allowed on texture coordinates. Those exceeding it stay Float32.
+	bool quantizeBoneWeights; //!< Convert "BONEWEIGHT" to UInt8Norm, keeping the sum of the weights of a vertex
+
+	/// <summary>Constructor. Converts every attribute, with 16 bit octahedral normals, and texture coordinates if
+	/// they are within 1/1024 of their value, i.e. if they are between -4 and 4.</summary>
+	VertexQuantizationOptions()
+		: quantizePositions(true), quantizeNormals(true), normalType(DataType::Int16Norm), quantizeTexCoords(true), texCoordTolerance(1.f / 1024.f),
+		  quantizeBoneWeights(true)
+	{}
+};
+
+/// <summary>The conversion of one vertex attribute by quantizeMesh.</summary>
+struct QuantizedAttributeStatistics
+{
+	StringHash semantic; //!< The semantic of the attribute
+	DataType dataTypeBefore; //!< The data type of the attribute before the conversion
+	DataType dataTypeAfter; //!< The data type of the attribute after the conversion
+	uint32_t widthBefore; //!< The number of values of the attribute before the conversion
+	uint32_t widthAfter; //!< The number of values of the attribute after the conversion
+
+	/// <summary>The largest difference between the original and the decoded value of any vertex: The distance in
+	/// model units for positions, the angle in degrees for normals, tangents and binormals, and the largest absolute
+	/// difference of any component for the others.</summary>
+	float maxError;
+
+	/// <summary>Constructor.</summary>
+	QuantizedAttributeStatistics() : dataTypeBefore(DataType::None), dataTypeAfter(DataType::None), widthBefore(0), widthAfter(0), maxError(0.f) {}
+};
+
+/// <summary>The effect of quantizeMesh on a mesh.</summary>
+struct VertexQuantizationStatistics
+{
+	size_t vertexDataSizeBefore; //!< The size in bytes of the vertex data of the mesh before the conversion
+	size_t vertexDataSizeAfter; //!< The size in bytes of the vertex data of the mesh after the conversion
+	std::vector<QuantizedAttributeStatistics> attributes; //!< The attributes that were converted
+
+	/// <summary>Constructor.</summary>
+	VertexQuantizationStatistics() : vertexDataSizeBefore(0), vertexDataSizeAfter(0) {}
+};
+
+/// <summary>Encode a unit vector with the octahedral mapping (Cigolle et al., "A Survey of Efficient Representations
+/// for Independent Unit Vectors", 2014).</summary>
+/// <param name="direction">A unit vector</param>
+/// <returns>The octahedral coordinates of the vector, each from -1 to 1.</returns>
+glm::vec2 encodeOctahedral(const glm::vec3& direction);
+
+/// <summary>Decode an octahedral unit vector. The shaders of quantized meshes do the same with:
+/// vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+/// if (n.z &lt; 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x &gt;= 0.0 ? 1.0 : -1.0, n.y &gt;= 0.0 ? 1.0 : -1.0);
+/// n = normalize(n);</summary>
+/// <param name="octahedral">The octahedral coordinates of the vector, each from -1 to 1</param>
+/// <returns>The unit vector.</returns>
+glm::vec3 decodeOctahedral(const glm::vec2& octahedral);
+
+/// <summary>Convert the Float32 vertex attributes of a mesh in place to compact data types, rewriting the layouts of
+/// its vertex data blocks. The converted attributes keep their semantics and data blocks, so the vertex buffers and
+/// input layouts built from the mesh by PVRUtils use them as they are, but the shaders must decode them:
+/// <list type="bullet">
+/// <item><description>"POSITION" becomes 4 x UInt16Norm, from 0 to 1 over the bounding box of the mesh, with w = 1.
+/// The unpack matrix of the mesh is multiplied by the transform back to model space, so that the shaders get the
+/// model space position from getUnpackMatrix() * position. For static meshes it can be folded into the model matrix.
+/// For skinned meshes (see Mesh::getSkeletonId) it must be applied before the bone matrices, which expect model space
+/// positions, for example by folding it into every inverse bind matrix, and not into the model matrix.
+/// </description></item>
+/// <item><description>"NORMAL", "TANGENT" and "BINORMAL" become 2 x normalType octahedral coordinates (see
+/// decodeOctahedral), or 4 (x, y, sign, 0) if they had a 4th component holding the handedness.</description></item>
+/// <item><description>"UV0" to "UV7" become Float16, unless that loses more precision than the tolerance.
+/// </description></item>
+/// <item><description>"BONEWEIGHT" becomes UInt8Norm, rounded so that the weights of each vertex still sum to 1.
+/// </description></item>
+/// </list>
+/// Every attribute is aligned to 4 bytes. Data blocks that do not hold data for every vertex are left unchanged.
+/// </summary>
+/// <param name="mesh">The mesh to convert</param>
+/// <param name="options">The attributes to convert</param>
+/// <returns>The vertex data sizes before and after, and the largest error of each converted attribute.</returns>
+VertexQuantizationStatistics quantizeMesh(Mesh& mesh, const VertexQuantizationOptions& options = VertexQuantizationOptions());
+
+/// <summary>Convert the vertex attributes of every mesh of a model in place (see quantizeMesh).</summary>
+/// <param name="model">The model to convert</param>
+/// <param name="options">The attributes to convert</param>
+/// <returns>The statistics of each mesh, in the order of the meshes of the model.</returns>
+std::vector<VertexQuantizationStatistics> quantizeModel(Model& model, const VertexQuantizationOptions& options = VertexQuantizationOptions());
+} // namespace utils
+} // namespace assets
+} // namespace pvr
@@ -6,6 +6,7 @@
 */
 //!\cond NO_DOXYGEN
 #include <cstring>
+#include <algorithm>
 
 #include "PVRAssets/Volume.h"
 #include "PVRAssets/Helper.h"
@@ -23,17 +24,43 @@ Volume::~Volume()
 	delete[] _volumeMesh.vertexData;
 }
 
+namespace {
+inline size_t hashCombine(size_t seed, size_t value)
+{
+	return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+inline size_t hashFloat(float f)
+{
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	// -0.0f == 0.0f, so they must hash the same. Done on the bits, as -ffast-math removes arithmetic like f + 0.0f.
+	if (bits == 0x80000000u)
+	{
+		bits = 0;
+	}
+	return std::hash<uint32_t>()(bits);
+}
+} // namespace
+
+size_t Volume::PositionHasher::operator()(const glm::vec3& v) const
+{
+	return hashCombine(hashCombine(hashFloat(v.x), hashFloat(v.y)), hashFloat(v.z));
+}
+
+size_t Volume::TriangleKeyHasher::operator()(const TriangleKey& key) const
+{
+	return hashCombine(hashCombine(std::hash<uint32_t>()(key.edgeIndices[0]), std::hash<uint32_t>()(key.edgeIndices[1])), std::hash<uint32_t>()(key.edgeIndices[2]));
+}
+
 uint32_t Volume::findOrCreateVertex(const glm::vec3& vertex, bool& existed)
 {
 	// First check whether we already have a vertex here
-	for (uint32_t i = 0; i < _volumeMesh.numVertices; ++i)
+	auto inserted = _vertexLookup.insert(std::make_pair(vertex, _volumeMesh.numVertices));
+	if (!inserted.second)
 	{
-		if (_volumeMesh.vertices[i].x == vertex.x && _volumeMesh.vertices[i].y == vertex.y && _volumeMesh.vertices[i].z == vertex.z)
-		{
-			// Don't do anything more if the vertex already exists
-			existed = true;
-			return i;
-		}
+		// Don't do anything more if the vertex already exists
+		existed = true;
+		return inserted.first->second;
 	}
 
 	if (_volumeMesh.numVertices == 0)
@@ -86,20 +113,20 @@ uint32_t Volume::findOrCreateEdge(const glm::vec3& v0, const glm::vec3& v1, bool
 	vertexIndices[0] = findOrCreateVertex(v0, alreadyExisted[0]);
 	vertexIndices[1] = findOrCreateVertex(v1, alreadyExisted[1]);
 
+	// The edge is undirected: Key it on the sorted vertex index pair
+	const uint64_t edgeKey = (static_cast<uint64_t>(std::min(vertexIndices[0], vertexIndices[1])) << 32) | std::max(vertexIndices[0], vertexIndices[1]);
 	if (alreadyExisted[0] && alreadyExisted[1])
 	{
 		// Check whether we already have an edge here
-		for (uint32_t i = 0; i < _volumeMesh.numEdges; ++i)
+		auto it = _edgeLookup.find(edgeKey);
+		if (it != _edgeLookup.end())
 		{
-			if ((_volumeMesh.edges[i].vertexIndices[0] == vertexIndices[0] && _volumeMesh.edges[i].vertexIndices[1] == vertexIndices[1]) ||
-				(_volumeMesh.edges[i].vertexIndices[0] == vertexIndices[1] && _volumeMesh.edges[i].vertexIndices[1] == vertexIndices[0]))
-			{
-				// Don't do anything more if the edge already exists
-				existed = true;
-				return i;
-			}
+			// Don't do anything more if the edge already exists
+			existed = true;
+			return it->second;
 		}
 	}
+	_edgeLookup[edgeKey] = _volumeMesh.numEdges;
 
 	// Add the edge
 	_volumeMesh.edges[_volumeMesh.numEdges].vertexIndices[0] = vertexIndices[0];
@@ -124,22 +151,19 @@ void Volume::findOrCreateTriangle(const glm::vec3& v0, const glm::vec3& v1, cons
 		return;
 	}
 
-	// First check whether we already have a triangle here
+	// First check whether we already have a triangle here. The edges are distinct, so two triangles are the same if
+	// they have the same set of edges: Key them on the sorted edge indices.
+	TriangleKey triangleKey = { { edgeIndex0, edgeIndex1, edgeIndex2 } };
+	std::sort(triangleKey.edgeIndices, triangleKey.edgeIndices + 3);
 	if (alreadyExisted[0] && alreadyExisted[1] && alreadyExisted[2])
 	{
-		for (uint32_t i = 0; i < _volumeMesh.numTriangles; ++i)
+		if (_triangleLookup.find(triangleKey) != _triangleLookup.end())
 		{
-			if ((_volumeMesh.triangles[i].edgeIndices[0] == edgeIndex0 || _volumeMesh.triangles[i].edgeIndices[0] == edgeIndex1 ||
-					_volumeMesh.triangles[i].edgeIndices[0] == edgeIndex2) &&
-				(_volumeMesh.triangles[i].edgeIndices[1] == edgeIndex0 || _volumeMesh.triangles[i].edgeIndices[1] == edgeIndex1 ||
-					_volumeMesh.triangles[i].edgeIndices[1] == edgeIndex2) &&
-				(_volumeMesh.triangles[i].edgeIndices[2] == edgeIndex0 || _volumeMesh.triangles[i].edgeIndices[2] == edgeIndex1 || _volumeMesh.triangles[i].edgeIndices[2] == edgeIndex2))
-			{
-				// Don't do anything more if the triangle already exists
-				return;
-			}
+			// Don't do anything more if the triangle already exists
+			return;
 		}
 	}
+	_triangleLookup[triangleKey] = _volumeMesh.numTriangles;
 
 	// Add the triangle then
 	_volumeMesh.triangles[_volumeMesh.numTriangles].edgeIndices[0] = edgeIndex0;
@@ -242,8 +266,15 @@ bool Volume::init(const uint8_t* const data, uint32_t numVertices, uint32_t vert
 
 	_volumeMesh.vertices = new glm::vec3[numVertices];
 
+	_vertexLookup.clear();
+	_edgeLookup.clear();
+	_triangleLookup.clear();
+	_vertexLookup.reserve(numVertices);
+
 	if (faceData)
 	{
+		_edgeLookup.reserve(3 * numFaces);
+		_triangleLookup.reserve(numFaces);
 		_volumeMesh.edges = new VolumeEdge[3 * numFaces];
 		_volumeMesh.triangles = new VolumeTriangle[3 * numFaces];
 
@@ -285,39 +316,34 @@ bool Volume::init(const uint8_t* const data, uint32_t numVertices, uint32_t vert
 		}
 	}
 
+	// The lookup tables are only needed while building
+	std::unordered_map<glm::vec3, uint32_t, PositionHasher, PositionEqual>().swap(_vertexLookup);
+	std::unordered_map<uint64_t, uint32_t>().swap(_edgeLookup);
+	std::unordered_map<TriangleKey, uint32_t, TriangleKeyHasher>().swap(_triangleLookup);
+
 #ifdef DEBUG
 	// Check the data is valid
-	for (uint32_t edge = 0; edge < _volumeMesh.numEdges; ++edge)
 	{
-		uint32_t count = 0;
+		std::vector<uint32_t> edgeUseCount(_volumeMesh.numEdges, 0);
 		for (uint32_t triangle = 0; triangle < _volumeMesh.numTriangles; ++triangle)
 		{
-			if (_volumeMesh.triangles[triangle].edgeIndices[0] == edge)
-			{
-				++count;
-			}
-
-			if (_volumeMesh.triangles[triangle].edgeIndices[1] == edge)
-			{
-				++count;
-			}
-
-			if (_volumeMesh.triangles[triangle].edgeIndices[2] == edge)
-			{
-				++count;
-			}
+			++edgeUseCount[_volumeMesh.triangles[triangle].edgeIndices[0]];
+			++edgeUseCount[_volumeMesh.triangles[triangle].edgeIndices[1]];
+			++edgeUseCount[_volumeMesh.triangles[triangle].edgeIndices[2]];
 		}
 
 		/*
 			Every edge should be referenced exactly twice.
 			If they aren't then the mesh isn't closed which will cause problems when rendering.
 		*/
-		if (count != 2)
+		for (uint32_t edge = 0; edge < _volumeMesh.numEdges; ++edge)
 		{
-			_isClosed = false;
+			if (edgeUseCount[edge] != 2)
+			{
+				_isClosed = false;
+			}
 		}
 	}
-
 #endif
 
 	// Create the real mesh
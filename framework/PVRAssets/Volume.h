@@ -7,6 +7,7 @@
 #pragma once
 
 #include "PVRAssets/model/Mesh.h"
+#include <unordered_map>
 
 namespace pvr {
 
@@ -147,5 +148,35 @@ protected:
 	VolumeMesh _volumeMesh; ///< The internal data of the mesh
 
 	bool _isClosed; ///< Is the mesh closed
+
+private:
+	struct PositionHasher
+	{
+		size_t operator()(const glm::vec3& v) const;
+	};
+	struct PositionEqual
+	{
+		bool operator()(const glm::vec3& a, const glm::vec3& b) const
+		{
+			return a.x == b.x && a.y == b.y && a.z == b.z;
+		}
+	};
+	struct TriangleKey
+	{
+		uint32_t edgeIndices[3]; // Sorted
+		bool operator==(const TriangleKey& rhs) const
+		{
+			return edgeIndices[0] == rhs.edgeIndices[0] && edgeIndices[1] == rhs.edgeIndices[1] && edgeIndices[2] == rhs.edgeIndices[2];
+		}
+	};
+	struct TriangleKeyHasher
+	{
+		size_t operator()(const TriangleKey& key) const;
+	};
+
+	// Lookup tables used to weld vertices, edges and triangles while the volume is being built. Released at the end of init.
+	std::unordered_map<glm::vec3, uint32_t, PositionHasher, PositionEqual> _vertexLookup;
+	std::unordered_map<uint64_t, uint32_t> _edgeLookup; // Key: Sorted vertex index pair
+	std::unordered_map<TriangleKey, uint32_t, TriangleKeyHasher> _triangleLookup;
 };
 } // namespace pvr
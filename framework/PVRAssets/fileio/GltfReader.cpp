@@ -1,5 +1,6 @@
 #include "GltfReader.h"
 #include "PVRAssets/Model.h"
+#include "PVRCore/Profiling.h"
 #define TINYGLTF_IMPLEMENTATION
 #define TINYGLTF_NO_STB_IMAGE
 #define TINYGLTF_NO_EXTERNAL_IMAGE
@@ -581,6 +582,32 @@ enum class VertexAttributeIndex
 	Count,
 };
 
+// Add the description of a vertex attribute, renaming the texture coordinate semantics to the framework ones.
+template<typename GltfAttribute_>
+void addGltfVertexAttribute(pvr::assets::Mesh& mesh, VertexAttributeIndex attribIndex, const GltfAttribute_& tinyAttrib, uint32_t offset)
+{
+	pvr::assets::VertexAttributeData attribData;
+
+	attribData.setN(tinyAttrib.N);
+	attribData.setDataType(tinyAttrib.dataType.first);
+	attribData.setDataIndex(0);
+	attribData.setOffset(offset);
+
+	if (attribIndex == VertexAttributeIndex::UV0)
+	{
+		attribData.setSemantic("UV0");
+	}
+	else if (attribIndex == VertexAttributeIndex::UV1)
+	{
+		attribData.setSemantic("UV1");
+	}
+	else
+	{
+		attribData.setSemantic(tinyAttrib.semantic);
+	}
+	mesh.addVertexAttribute(attribData);
+}
+
 void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, std::vector<MeshprimitivesIterator>& meshPrimitives)
 {
 	uint32_t meshIndex = 0;
@@ -594,7 +621,9 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 		std::pair<pvr::DataType, size_t> dataType;
 		uint32_t N;
 		pvr::StringHash semantic;
-		GltfAttribute() : data(), strideInBytes(), attribStrideInBytes(), dataType(), N() {}
+		int32_t bufferView;
+		size_t byteOffset;
+		GltfAttribute() : data(), strideInBytes(), attribStrideInBytes(), dataType(), N(), bufferView(-1), byteOffset() {}
 	};
 
 	for (uint32_t m = 0; m < tinyModel.meshes.size(); ++m)
@@ -605,10 +634,6 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 		meshPrimitives[m].numPrimitives = static_cast<uint32_t>(tinyMesh.primitives.size());
 
 		// process primitive meshes
-		std::vector<char> attributeInterleaved;
-
-		GltfAttribute gltfAttributes[static_cast<uint32_t>(VertexAttributeIndex::Count)];
-
 		for (uint32_t p = 0; p < tinyMesh.primitives.size(); ++p)
 		{
 			pvr::assets::Mesh& mesh = asset.getMesh(meshIndex);
@@ -616,8 +641,8 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 			mesh.setPrimitiveType(tinyGltf_primitiveTopology(static_cast<int32_t>(tinyPrimitive.mode)));
 
 			// VERTEX ATTRIBUTES
+			GltfAttribute gltfAttributes[static_cast<uint32_t>(VertexAttributeIndex::Count)];
 			uint32_t numvertices = 0;
-
 			// save string comparison if the attributes is found.
 			bool positionAttribFound = false;
 			bool texAttrib0Found = false;
@@ -629,9 +654,7 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 
 			uint32_t dataAttribsStride = 0;
 
-			uint32_t totalBufferSizeInBytes = 0;
-			bool isInterleaved = false;
-			for (auto attrib : tinyPrimitive.attributes)
+			for (const auto& attrib : tinyPrimitive.attributes)
 			{
 				const tinygltf::Accessor& tinyAccessor = tinyAccessors[attrib.second];
 				const tinygltf::BufferView& tinyBufferView = tinyModel.bufferViews[tinyAccessor.bufferView];
@@ -678,67 +701,76 @@ void parseAllMesh(const tinygltf::Model& tinyModel, pvr::assets::Model& asset, s
 					attribIndex = VertexAttributeIndex::Tangent;
 					tangentAttribFound = true;
 				}
-				gltfAttributes[static_cast<uint32_t>(attribIndex)].data = tinyBuffer.data.data() + tinyBufferView.byteOffset + tinyAccessor.byteOffset;
-				gltfAttributes[static_cast<uint32_t>(attribIndex)].strideInBytes = static_cast<uint32_t>(tinyBufferView.byteStride);
-				gltfAttributes[static_cast<uint32_t>(attribIndex)].N = tinyGltf_getTypeNumComponents(tinyAccessor.type); // Get number of component this type has. e.g vec3, vec4
-				gltfAttributes[static_cast<uint32_t>(attribIndex)].dataType = tinyGltf_getComponentTypeToDataType(tinyAccessor.componentType);
-				gltfAttributes[static_cast<uint32_t>(attribIndex)].semantic = attrib.first;
+				if (attribIndex == VertexAttributeIndex::Count)
+				{
+					continue; // Attribute not supported by the framework (e.g. COLOR_0, TEXCOORD_2)
+				}
+				GltfAttribute& gltfAttrib = gltfAttributes[static_cast<uint32_t>(attribIndex)];
+				gltfAttrib.N = tinyGltf_getTypeNumComponents(tinyAccessor.type); // Get number of component this type has. e.g vec3, vec4
+				gltfAttrib.dataType = tinyGltf_getComponentTypeToDataType(tinyAccessor.componentType);
+				gltfAttrib.attribStrideInBytes = gltfAttrib.N * static_cast<uint32_t>(gltfAttrib.dataType.second);
+				// A byteStride of 0 means the elements are tightly packed
+				gltfAttrib.strideInBytes = tinyBufferView.byteStride ? static_cast<uint32_t>(tinyBufferView.byteStride) : gltfAttrib.attribStrideInBytes;
+				gltfAttrib.data = tinyBuffer.data.data() + tinyBufferView.byteOffset + tinyAccessor.byteOffset;
+				gltfAttrib.semantic = attrib.first;
+				gltfAttrib.bufferView = tinyAccessor.bufferView;
+				gltfAttrib.byteOffset = tinyAccessor.byteOffset;
 				numvertices = static_cast<uint32_t>(tinyAccessor.count);
-				dataAttribsStride += static_cast<uint32_t>(tinyBufferView.byteStride);
+				dataAttribsStride += gltfAttrib.attribStrideInBytes;
+			}
 
-				if (gltfAttributes[static_cast<uint32_t>(attribIndex)].strideInBytes >
-					(gltfAttributes[static_cast<uint32_t>(attribIndex)].N * gltfAttributes[static_cast<uint32_t>(attribIndex)].dataType.second))
+			// If all the attributes are already interleaved in a single buffer view with exactly the layout we want (no
+			// padding, no other attributes), the whole vertex block can be used as is, without interleaving it vertex by vertex.
+			const GltfAttribute* sortedAttribs[ARRAY_SIZE(gltfAttributes)];
+			uint32_t numAttribs = 0;
+			for (uint32_t j = 0; j < ARRAY_SIZE(gltfAttributes); ++j)
+			{
+				if (gltfAttributes[j].data != nullptr)
 				{
-					isInterleaved = true;
+					sortedAttribs[numAttribs++] = &gltfAttributes[j];
 				}
 			}
+			std::sort(sortedAttribs, sortedAttribs + numAttribs, [](const GltfAttribute* lhs, const GltfAttribute* rhs) { return lhs->byteOffset < rhs->byteOffset; });
+			bool isInterleaved = numAttribs > 0;
+			for (uint32_t j = 0; j < numAttribs && isInterleaved; ++j)
+			{
+				isInterleaved = sortedAttribs[j]->bufferView == sortedAttribs[0]->bufferView && sortedAttribs[j]->strideInBytes == dataAttribsStride &&
+					(j == 0 || sortedAttribs[j - 1]->byteOffset + sortedAttribs[j - 1]->attribStrideInBytes == sortedAttribs[j]->byteOffset);
+			}
+			const GltfAttribute* firstAttrib = numAttribs ? sortedAttribs[0] : nullptr;
 
-			totalBufferSizeInBytes = dataAttribsStride * numvertices;
-			uint32_t bufferOffset = 0;
-
-			// If the vertices already interleaved than do nothing  and copy the data, else interleave the vertices.
-			// Interleave the vertices.
-			if (!isInterleaved)
+			const uint32_t totalBufferSizeInBytes = dataAttribsStride * numvertices;
+			if (isInterleaved)
 			{
-				attributeInterleaved.resize(totalBufferSizeInBytes);
-				for (uint32_t i = 0; i < numvertices; ++i)
+				for (uint32_t j = 0; j < ARRAY_SIZE(gltfAttributes); ++j)
 				{
-					for (uint32_t j = 0; j < ARRAY_SIZE(gltfAttributes); ++j)
+					if (gltfAttributes[j].data != nullptr)
 					{
-						if (gltfAttributes[j].data != nullptr)
+						addGltfVertexAttribute(
+							mesh, static_cast<VertexAttributeIndex>(j), gltfAttributes[j], static_cast<uint32_t>(gltfAttributes[j].byteOffset - firstAttrib->byteOffset));
+					}
+				}
+				mesh.addData(firstAttrib->data, totalBufferSizeInBytes, dataAttribsStride, 0);
+			}
+			else
+			{
+				// Interleave the vertices directly into the data block of the mesh, one attribute at a time.
+				mesh.addData(nullptr, totalBufferSizeInBytes, dataAttribsStride, 0);
+				uint8_t* vertexData = mesh.getData(0);
+				uint32_t attribOffset = 0;
+				for (uint32_t j = 0; j < ARRAY_SIZE(gltfAttributes); ++j)
+				{
+					const GltfAttribute& tinyAttrib = gltfAttributes[j];
+					if (tinyAttrib.data != nullptr)
+					{
+						for (uint32_t i = 0; i < numvertices; ++i)
 						{
-							const auto& tinyAttrib = gltfAttributes[j];
-							memcpy(attributeInterleaved.data() + bufferOffset, tinyAttrib.data + tinyAttrib.strideInBytes * i, tinyAttrib.strideInBytes);
-
-							// set the vertex attribute only once for each attribute.
-							if (i == 0)
-							{
-								pvr::assets::VertexAttributeData attribData;
-
-								attribData.setN(tinyAttrib.N);
-								attribData.setDataType(tinyAttrib.dataType.first);
-								attribData.setDataIndex(0);
-								attribData.setOffset(bufferOffset);
-
-								if (j == static_cast<uint32_t>(VertexAttributeIndex::UV0))
-								{
-									attribData.setSemantic("UV0");
-								}
-								else if (j == static_cast<uint32_t>(VertexAttributeIndex::UV1))
-								{
-									attribData.setSemantic("UV1");
-								}
-								else
-								{
-									attribData.setSemantic(tinyAttrib.semantic);
-								}
-								mesh.addVertexAttribute(attribData);
-							}
-							bufferOffset += static_cast<uint32_t>(tinyAttrib.dataType.second) * tinyAttrib.N;
+							memcpy(vertexData + dataAttribsStride * i + attribOffset, tinyAttrib.data + tinyAttrib.strideInBytes * i, tinyAttrib.attribStrideInBytes);
 						}
+						addGltfVertexAttribute(mesh, static_cast<VertexAttributeIndex>(j), tinyAttrib, attribOffset);
+						attribOffset += tinyAttrib.attribStrideInBytes;
 					}
 				}
-				mesh.addData((const uint8_t*)attributeInterleaved.data(), totalBufferSizeInBytes, dataAttribsStride, 0);
 			}
 
 			mesh.setNumVertices(numvertices);
@@ -780,11 +812,51 @@ void parseAllCameras(const tinygltf::Model& tinyModel, pvr::assets::Model& asset
 	}
 }
 // Implements load external file function which get called by the tinygltf for loading secondary assets.
+// tinygltf copies every buffer into the model once it is loaded, so buffers are not loaded from here: Their requests
+// (the only ones made with checkSize) are recorded, and loadBuffers later loads them directly into the model. The JSON
+// of a .glb is parsed as if it was a .gltf, so its buffer without a uri, the one stored in the BIN chunk, is requested
+// with an empty filename: The storage of the BIN chunk is then handed over to it instead of being copied.
 class GltfFileLoader : public tinygltf::IFileLoader
 {
 public:
-	GltfFileLoader(pvr::IAssetProvider& assetProvider) : assetProvider(&assetProvider) {}
+	GltfFileLoader(pvr::IAssetProvider& assetProvider, const tinygltf::Model& tinyModel, std::vector<unsigned char>* binChunk = nullptr)
+		: assetProvider(&assetProvider), tinyModel(&tinyModel), binChunk(binChunk)
+	{}
 	bool loadExternalFile(std::vector<unsigned char>* out, std::string* err, const std::string& filename, const std::string& basedir, size_t reqBytes, bool checkSize)
+	{
+		if (checkSize)
+		{
+			// Buffers are parsed in order, each one added to the model after it is loaded.
+			BufferRequest request = { tinyModel->buffers.size(), filename, reqBytes };
+			bufferRequests.push_back(request);
+			return true;
+		}
+		return readFile(out, err, filename, reqBytes, checkSize);
+	}
+
+	// Load the buffers requested while tinygltf parsed the model into it.
+	bool loadBuffers(tinygltf::Model& model, std::string* err)
+	{
+		for (const BufferRequest& request : bufferRequests)
+		{
+			std::vector<unsigned char>& data = model.buffers[request.index].data;
+			if (!(request.filename.empty() ? takeBinChunk(&data, err, request.size) : readFile(&data, err, request.filename, request.size, true)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	struct BufferRequest
+	{
+		size_t index;
+		std::string filename;
+		size_t size;
+	};
+
+	bool readFile(std::vector<unsigned char>* out, std::string* err, const std::string& filename, size_t reqBytes, bool checkSize)
 	{
 		auto stream = assetProvider->getAssetStream(filename);
 		if (!stream)
@@ -815,13 +887,97 @@ public:
 		return true;
 	}
 
-private:
+	bool takeBinChunk(std::vector<unsigned char>* out, std::string* err, size_t reqBytes)
+	{
+		if (!binChunk || binChunk->empty() || reqBytes > binChunk->size())
+		{
+			if (err)
+			{
+				(*err) += "Buffer without a uri does not match the BIN chunk of the binary glTF file\n";
+			}
+			return false;
+		}
+		// The BIN chunk may be padded past the end of the buffer. Shrinking does not reallocate.
+		out->swap(*binChunk);
+		out->resize(reqBytes);
+		binChunk = nullptr;
+		return true;
+	}
+
 	pvr::IAssetProvider* assetProvider;
+	const tinygltf::Model* tinyModel;
+	std::vector<unsigned char>* binChunk;
+	std::vector<BufferRequest> bufferRequests;
 };
+
+// Binary glTF (.glb) container: A 12 byte header (magic, version, total length) followed by chunks, each one an 8 byte
+// header (length, type) followed by its data.
+const uint32_t GlbMagic = 0x46546C67; // "glTF"
+const uint32_t GlbChunkJson = 0x4E4F534A; // "JSON"
+const uint32_t GlbChunkBin = 0x004E4942; // "BIN\0"
+
+// Provides size bytes of the stream from the current position and advances past them: In place if the stream can be
+// accessed directly in memory (e.g. a memory mapped file), otherwise by reading them into storage.
+const char* readOrMapBlock(const Stream& stream, size_t size, std::vector<char>& storage)
+{
+	const void* view = stream.getMappedView(stream.getPosition(), size);
+	if (view)
+	{
+		stream.seek(static_cast<long>(size), Stream::SeekOriginFromCurrent);
+		return static_cast<const char*>(view);
+	}
+	storage.resize(size);
+	if (size)
+	{
+		stream.readExact(1, size, storage.data());
+	}
+	return storage.data();
+}
+
+// Read the chunks of a .glb after its header. The JSON chunk is used in place if the stream allows it. The BIN chunk is
+// read straight into its own allocation, which is later handed over to the tinygltf buffer, instead of reading the
+// whole file and copying the binary data out of it.
+void readGlbChunks(const Stream& stream, uint32_t totalLength, const char*& json, size_t& jsonLength, std::vector<char>& jsonStorage, std::vector<unsigned char>& bin)
+{
+	json = nullptr;
+	jsonLength = 0;
+	uint32_t remaining = totalLength > 12 ? totalLength - 12 : 0;
+	while (remaining >= 8)
+	{
+		uint32_t chunkHeader[2]; // length, type
+		stream.readExact(sizeof(uint32_t), 2, chunkHeader);
+		remaining -= 8;
+		if (chunkHeader[0] > remaining)
+		{
+			throw InvalidDataError("[GltfReader::readAsset_]: Chunk of binary glTF file [" + stream.getFileName() + "] extends past the end of the file");
+		}
+		if (chunkHeader[1] == GlbChunkJson && !json)
+		{
+			json = readOrMapBlock(stream, chunkHeader[0], jsonStorage);
+			jsonLength = chunkHeader[0];
+		}
+		else if (chunkHeader[1] == GlbChunkBin && bin.empty())
+		{
+			bin.resize(chunkHeader[0]);
+			stream.readExact(1, chunkHeader[0], bin.data());
+		}
+		else if (chunkHeader[0])
+		{
+			// Unknown chunks must be ignored
+			stream.seek(static_cast<long>(chunkHeader[0]), Stream::SeekOriginFromCurrent);
+		}
+		remaining -= chunkHeader[0];
+	}
+	if (!jsonLength)
+	{
+		throw InvalidDataError("[GltfReader::readAsset_]: Binary glTF file [" + stream.getFileName() + "] does not contain a JSON chunk");
+	}
+}
 } // namespace
 
 void GltfReader::readAsset_(Model& asset)
 {
+	PVR_PROFILE_SCOPE_CATEGORY("GltfReader::readAsset", "assets");
 	/// IMPLEMENTATION NOTES
 	// Mesh: GLTF has number of primitives in a mesh and each of those can have different properties, like materials, primitive topology.
 	//       Each of the primitives are considered as mesh in the framework.
@@ -829,15 +985,36 @@ void GltfReader::readAsset_(Model& asset)
 	tinygltf::Model tinyModel;
 	tinygltf::TinyGLTF tinyLoader;
 	std::string err;
-	std::vector<char> data = _assetStream->readToEnd<char>();
+	// Both .gltf and .glb are supported. A .glb is recognised by its magic number rather than by its extension.
+	// The JSON is used in place if the stream can be accessed directly in memory, otherwise it is read into data.
+	std::vector<char> data;
+	const char* json = nullptr;
+	size_t jsonLength = 0;
+	std::vector<unsigned char> binChunk;
+	const size_t startPosition = _assetStream->getPosition();
+	uint32_t glbHeader[3] = {}; // magic, version, length
+	size_t dataRead = 0;
+	_assetStream->read(sizeof(uint32_t), 3, glbHeader, dataRead);
+	const bool isBinary = (dataRead == 3 && glbHeader[0] == GlbMagic);
+	if (isBinary)
+	{
+		readGlbChunks(*_assetStream, glbHeader[2], json, jsonLength, data, binChunk);
+	}
+	else
+	{
+		_assetStream->seek(static_cast<long>(startPosition), Stream::SeekOriginFromStart);
+		jsonLength = _assetStream->getSize() - startPosition;
+		json = readOrMapBlock(*_assetStream, jsonLength, data);
+	}
 	uint32_t findIndex = static_cast<uint32_t>(_assetStream->getFileName().find_last_of("."));
 	std::string ext = _assetStream->getFileName().substr(findIndex, std::string::npos);
 	std::string dir;
 	pvr::strings::getFileDirectory(_assetStream->getFileName(), dir);
 
-	GltfFileLoader gltfStreamProvider(_assetProvider);
+	GltfFileLoader gltfStreamProvider(_assetProvider, tinyModel, isBinary ? &binChunk : nullptr);
 
-	if (!tinyLoader.LoadASCIIFromString(gltfStreamProvider, &tinyModel, &err, static_cast<const char*>(data.data()), static_cast<uint32_t>(data.size()), dir))
+	if (!tinyLoader.LoadASCIIFromString(gltfStreamProvider, &tinyModel, &err, json, static_cast<uint32_t>(jsonLength), dir) ||
+		!gltfStreamProvider.loadBuffers(tinyModel, &err))
 	{
 		Log("%s", err.c_str());
 		throw pvr::FileNotFoundError(err);
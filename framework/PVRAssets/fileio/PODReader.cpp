@@ -9,6 +9,7 @@
 #include "PVRAssets/fileio/PODDefines.h"
 #include "PVRAssets/Model.h"
 #include "PVRCore/Log.h"
+#include "PVRCore/Profiling.h"
 #include "PVRAssets/Helper.h"
 #include "PVRCore/stream/Stream.h"
 #include <cstdio>
@@ -27,10 +28,32 @@ void readBytes(Stream& stream, T& data)
 template<typename T>
 void readByteArray(Stream& stream, T* data, uint32_t count)
 {
-	for (uint32_t i = 0; i < count; ++i)
+	if (count)
+	{
+		stream.readExact(sizeof(T), count, data);
+	}
+}
+
+// POD files are little endian. On little endian hosts, arrays of 2 and 4 byte values can be read as a single block.
+inline bool isHostLittleEndian()
+{
+	const uint16_t one = 1;
+	return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+// Get the next size bytes of the stream, and advance past them. If the stream can be accessed in place (e.g. a memory
+// mapped file) they are used directly, otherwise they are read into scratch.
+const uint8_t* readDataBlock(Stream& stream, uint32_t size, std::vector<uint8_t>& scratch)
+{
+	const void* view = stream.getMappedView(stream.getPosition(), size);
+	if (view)
 	{
-		readBytes(stream, data[i]);
+		stream.seek(static_cast<long>(size), Stream::SeekOriginFromCurrent);
+		return static_cast<const uint8_t*>(view);
 	}
+	scratch.resize(size);
+	readByteArray(stream, scratch.data(), size);
+	return scratch.data();
 }
 
 template<typename T>
@@ -75,6 +98,10 @@ template<typename T>
 void read4ByteArray(Stream& stream, T* data, uint32_t count)
 {
 	// PVR_STATIC_ASSERT(read4ByteArraySizeAssert, sizeof(T) == 4)
+	if (isHostLittleEndian() && sizeof(T) == 4)
+	{
+		return readByteArray(stream, data, count);
+	}
 	for (uint32_t i = 0; i < count; ++i)
 	{
 		read4Bytes(stream, data[i]);
@@ -103,6 +130,10 @@ template<typename T>
 void read2ByteArray(Stream& stream, T* data, uint32_t count)
 {
 	// PVR_STATIC_ASSERT(read2ByteArraySizeAssert, sizeof(T) == 2)
+	if (isHostLittleEndian() && sizeof(T) == 2)
+	{
+		return readByteArray(stream, data, count);
+	}
 	for (uint32_t i = 0; i < count; ++i)
 	{
 		read2Bytes(stream, data[i]);
@@ -178,12 +209,13 @@ void readVertexIndexData(Stream& stream, assets::Mesh& mesh)
 {
 	uint32_t identifier, dataLength, size(0);
 	std::vector<uint8_t> data;
+	const uint8_t* faces = nullptr;
 	IndexType type(IndexType::IndexType16Bit);
 	while (readTag(stream, identifier, dataLength))
 	{
 		if (identifier == (pod::e_meshVertexIndexList | pod::c_endTagMask))
 		{
-			mesh.addFaces(data.data(), size, type);
+			mesh.addFaces(faces, size, type);
 			return;
 		}
 		switch (identifier)
@@ -208,6 +240,12 @@ void readVertexIndexData(Stream& stream, assets::Mesh& mesh)
 			continue;
 		}
 		case pod::e_blockData:
+			if (isHostLittleEndian())
+			{
+				faces = readDataBlock(stream, dataLength, data);
+				size = dataLength;
+				break;
+			}
 			switch (type)
 			{
 			case IndexType::IndexType16Bit:
@@ -217,6 +255,7 @@ void readVertexIndexData(Stream& stream, assets::Mesh& mesh)
 				read4ByteArrayIntoVector<uint32_t>(stream, data, dataLength / 4);
 				break;
 			}
+			faces = data.data();
 			size = dataLength;
 			break;
 		default:
@@ -271,23 +310,36 @@ void readVertexData(Stream& stream, assets::Mesh& mesh, const char* const semant
 			if (dataIndex == -1) // This POD file isn't using interleaved data so this data block must be valid vertex data
 			{
 				std::vector<uint8_t> data;
+				const uint8_t* block = nullptr;
 				switch (dataTypeSize(type))
 				{
 				case 1:
-					readByteArrayIntoVector<uint8_t>(stream, data, dataLength);
+					block = readDataBlock(stream, dataLength, data);
 					break;
 				case 2:
+					if (isHostLittleEndian())
+					{
+						block = readDataBlock(stream, dataLength, data);
+						break;
+					}
 					read2ByteArrayIntoVector<uint16_t>(stream, data, dataLength / 2);
+					block = data.data();
 					break;
 				case 4:
-					read2ByteArrayIntoVector<uint32_t>(stream, data, dataLength / 4);
+					if (isHostLittleEndian())
+					{
+						block = readDataBlock(stream, dataLength, data);
+						break;
+					}
+					read4ByteArrayIntoVector<uint32_t>(stream, data, dataLength / 4);
+					block = data.data();
 					break;
 				default:
 				{
 					throw InvalidDataError("[PODReader::readVertexData] : Vertex DataType width was >4");
 				}
 				}
-				dataIndex = mesh.addData(data.data(), dataLength, stride);
+				dataIndex = mesh.addData(block, dataLength, stride);
 			}
 			else
 			{
@@ -984,6 +1036,7 @@ struct DataCarrier
 	size_t attribOffset;
 	size_t indexDataSize;
 	size_t valueToAddToVertices;
+	std::vector<bool>* processedVertices; //!< One bit per vertex, so that vertices shared between batches are only processed once
 };
 template<typename OP>
 class ProcessVertexByIndex
@@ -1002,18 +1055,21 @@ public:
 	}
 };
 
-static std::map<int, int> indices;
-
 template<typename OP, typename IndexType>
-void processByIndex(OP op, const uint8_t* indexData, size_t totalSize)
+void processByIndex(OP op, const uint8_t* indexData, size_t totalSize, std::vector<bool>& processedVertices)
 {
 	const uint8_t* const initialData = indexData;
 	while (indexData < initialData + totalSize)
 	{
-		IndexType index = *reinterpret_cast<const IndexType*>(indexData);
-		if (indices.find(index) == indices.end())
+		IndexType index;
+		memcpy(&index, indexData, sizeof(IndexType));
+		if (index >= processedVertices.size())
+		{
+			processedVertices.resize(static_cast<size_t>(index) + 1, false);
+		}
+		if (!processedVertices[index])
 		{
-			indices[index] = 0;
+			processedVertices[index] = true;
 			op(index);
 		}
 		indexData += (sizeof(IndexType));
@@ -1047,7 +1103,8 @@ void addValueWithIndex(const DataCarrier& data, size_t width)
 	typedef AddOp<ValueType> OP;
 	typedef ProcessVertexByIndex<OP> Process;
 	processByIndex<Process, IndexType>(
-		Process(OP((ValueType)data.valueToAddToVertices, width), data.vertexData, data.vboStride, data.attribOffset), data.indexData, data.indexDataSize);
+		Process(OP((ValueType)data.valueToAddToVertices, width), data.vertexData, data.vboStride, data.attribOffset), data.indexData, data.indexDataSize,
+		*data.processedVertices);
 }
 
 template<typename ValueType>
@@ -1111,7 +1168,8 @@ void mergeBoneBatches(uint32_t boneIndexAttributeId, pvr::assets::Mesh& mesh, Bo
 
 	const auto& attrib = *mesh.getVertexAttribute(boneIndexAttributeId);
 
-	indices.clear();
+	std::vector<bool> processedVertices(meshData.primitiveData.numVertices, false);
+	data.processedVertices = &processedVertices;
 	IndexType faceDataType = meshData.faces.getDataType();
 	for (uint32_t i = 0; i < bonebatches.numBones.size(); ++i)
 	{
@@ -1213,8 +1271,8 @@ void readMeshBlock(Stream& stream, assets::Mesh& mesh, assets::Model& model)
 		case pod::e_meshInterleavedDataList | pod::c_startTagMask:
 		{
 			UInt8Buffer data;
-			readByteArrayIntoVector<uint8_t>(stream, data, dataLength);
-			interleavedDataIndex = mesh.addData(data.data(), static_cast<uint32_t>(data.size()), 0);
+			const uint8_t* block = readDataBlock(stream, dataLength, data);
+			interleavedDataIndex = mesh.addData(block, dataLength, 0);
 			break;
 		}
 		case pod::e_meshBoneBatchIndexList | pod::c_startTagMask:
@@ -1432,6 +1490,7 @@ PODReader::PODReader() : _modelsToLoad(true) {}
 
 void PODReader::readAsset_(assets::Model& asset)
 {
+	PVR_PROFILE_SCOPE_CATEGORY("PODReader::readAsset", "assets");
 	uint32_t identifier, dataLength;
 	while (readTag(*_assetStream, identifier, dataLength))
 	{
@@ -5,11 +5,14 @@
 \copyright Copyright (c) Imagination Technologies Limited.
 */
 //!\cond NO_DOXYGEN
+#include <algorithm>
 #include <cstring>
 
 #include "PVRAssets/Model.h"
 #include "PVRAssets/model/Animation.h"
 #include "PVRCore/Errors.h"
+#include "PVRCore/Log.h"
+#include "PVRCore/Threading.h"
 #include "PVRCore/math/MathUtils.h"
 #include "PVRCore/strings/StringFunctions.h"
 namespace pvr {
@@ -50,19 +53,43 @@ AnimationData::InternalData& AnimationData::getInternalData()
 	return _data;
 }
 
-void AnimationInstance::updateAnimation(float time)
+namespace {
+// Find the first keyframe at or after time, for a time strictly between the first and the last keyframe. The cursor
+// holds the result of the previous search: it is checked first, along with the next couple of keyframes, before
+// falling back to a binary search.
+inline uint32_t findKeyFrame(const std::vector<float>& timeInSeconds, float time, uint32_t& cursor)
+{
+	const uint32_t numKeyFrames = static_cast<uint32_t>(timeInSeconds.size());
+	uint32_t f2 = cursor;
+	if (f2 > 0 && f2 < numKeyFrames && timeInSeconds[f2 - 1] < time)
+	{
+		const uint32_t lastLinear = std::min(f2 + 2, numKeyFrames - 1);
+		for (; f2 < lastLinear && timeInSeconds[f2] < time; ++f2)
+			;
+		if (!(timeInSeconds[f2] < time))
+		{
+			return cursor = f2;
+		}
+	}
+	f2 = static_cast<uint32_t>(std::lower_bound(timeInSeconds.begin(), timeInSeconds.end(), time) - timeInSeconds.begin());
+	return cursor = f2;
+}
+
+// Write the animated transformations of all the channels to their nodes, then let the Model of the nodes know its world
+// matrices need updating: Once per update, rather than once per node.
+void animateNodes(AnimationInstance& instance, float time)
 {
 	time *= 0.001f; // ms to sec.
-	for (uint32_t i = 0; i < keyframeChannels.size(); ++i)
+	std::vector<KeyFrameData>& keyFrames = instance.animationData->getInternalData().keyFrames;
+	for (uint32_t i = 0; i < instance.keyframeChannels.size(); ++i)
 	{
-		KeyframeChannel& keyframeNodes = keyframeChannels[i];
-		KeyFrameData& keyFrame = animationData->getInternalData().keyFrames[keyframeNodes.keyFrame];
+		AnimationInstance::KeyframeChannel& keyframeNodes = instance.keyframeChannels[i];
+		KeyFrameData& keyFrame = keyFrames[keyframeNodes.keyFrame];
 
 		// find the time slice.
 		uint32_t f1 = 0, f2 = 0;
 		float t = 0.0f;
 
-		// TODO: OPTIMZE FOR FAST PATH
 		KeyFrameData::InterpolationType interp = keyFrame.interpolation;
 		if (time <= keyFrame.timeInSeconds[0])
 		{
@@ -76,10 +103,8 @@ void AnimationInstance::updateAnimation(float time)
 		}
 		else
 		{
-			f2 = 0;
 			// find which f2 includes the time.
-			for (; f2 < keyFrame.timeInSeconds.size() && keyFrame.timeInSeconds[f2] < time; ++f2)
-				;
+			f2 = findKeyFrame(keyFrame.timeInSeconds, time, keyframeNodes.cursor);
 			f1 = f2 - 1;
 			t = (time - keyFrame.timeInSeconds[f1]) / (keyFrame.timeInSeconds[f2] - keyFrame.timeInSeconds[f1]);
 		}
@@ -101,7 +126,9 @@ void AnimationInstance::updateAnimation(float time)
 			// animate all the nodes.
 			for (uint32_t i = 0; i < keyframeNodes.nodes.size(); ++i)
 			{
-				static_cast<Node*>(keyframeNodes.nodes[i])->getInternalData().getFrameScaleAnimation() = scale;
+				pvr::assets::Node::InternalData& internalData = static_cast<Node*>(keyframeNodes.nodes[i])->getInternalData();
+				internalData.getFrameScaleAnimation() = scale;
+				internalData.transformDirty = true;
 			}
 		}
 		else if (keyFrame.rotate.size())
@@ -119,7 +146,9 @@ void AnimationInstance::updateAnimation(float time)
 			// animate all the node.
 			for (uint32_t i = 0; i < keyframeNodes.nodes.size(); ++i)
 			{
-				static_cast<Node*>(keyframeNodes.nodes[i])->getInternalData().getFrameRotationAnimation() = quat;
+				pvr::assets::Node::InternalData& internalData = static_cast<Node*>(keyframeNodes.nodes[i])->getInternalData();
+				internalData.getFrameRotationAnimation() = quat;
+				internalData.transformDirty = true;
 			}
 		}
 
@@ -141,6 +170,7 @@ void AnimationInstance::updateAnimation(float time)
 				Node& n = *static_cast<Node*>(keyframeNodes.nodes[i]);
 				pvr::assets::Node::InternalData& internalData = n.getInternalData();
 				internalData.getFrameTranslationAnimation() = trans;
+				internalData.transformDirty = true;
 			}
 		}
 
@@ -155,10 +185,67 @@ void AnimationInstance::updateAnimation(float time)
 				pvr::math::constructSRT(&internalData.getScale(), &internalData.getRotate(), &internalData.getTranslation(), transMat4);
 				transMat4 = transX * transMat4;
 				memcpy(internalData.frameXform, glm::value_ptr(transMat4), sizeof(glm::mat4));
+				internalData.transformDirty = true;
+			}
+		}
+	}
+
+	// All the nodes of an instance usually belong to one Model, so only a change of Model bumps another generation.
+	const std::atomic<uint32_t>* invalidated = nullptr;
+	for (const AnimationInstance::KeyframeChannel& channel : instance.keyframeChannels)
+	{
+		if (channel.nodes.size())
+		{
+			const Node::InternalData& internalData = static_cast<const Node*>(channel.nodes[0])->getInternalData();
+			if (internalData.modelTransformGeneration.get() != invalidated)
+			{
+				internalData.invalidateModelWorldMatrices();
+				invalidated = internalData.modelTransformGeneration.get();
 			}
 		}
 	}
 }
+} // namespace
+
+void AnimationInstance::updateAnimation(float time)
+{
+	animateNodes(*this, time);
+}
+
+namespace {
+template<typename GetTime>
+void updateAnimationsParallel(AnimationInstance* const* instances, size_t numInstances, GetTime getTime, uint32_t maxThreads)
+{
+	if (numInstances == 0)
+	{
+		return;
+	}
+	// Chunks small enough for a few hundred instances to be shared out evenly, large enough that the threads are not all
+	// contending for the next one.
+	const size_t chunkSize = 16;
+	const uint32_t numChunks = static_cast<uint32_t>((numInstances + chunkSize - 1) / chunkSize);
+	async::parallelFor(
+		numChunks,
+		[&](uint32_t chunk) {
+			const size_t end = std::min(numInstances, (chunk + 1) * chunkSize);
+			for (size_t i = chunk * chunkSize; i < end; ++i)
+			{
+				animateNodes(*instances[i], getTime(i));
+			}
+		},
+		maxThreads);
+}
+} // namespace
+
+void updateAnimations(AnimationInstance* const* instances, size_t numInstances, float timeInMs, uint32_t maxThreads)
+{
+	updateAnimationsParallel(instances, numInstances, [timeInMs](size_t) { return timeInMs; }, maxThreads);
+}
+
+void updateAnimations(AnimationInstance* const* instances, const float* timesInMs, size_t numInstances, uint32_t maxThreads)
+{
+	updateAnimationsParallel(instances, numInstances, [timesInMs](size_t i) { return timesInMs[i]; }, maxThreads);
+}
 
 } // namespace assets
 } // namespace pvr
@@ -21,6 +21,8 @@ struct KeyFrameData
 
 	};
 
+	// The times and the values are separate arrays, so the keyframe search only reads the times, and an update only reads
+	// two values of the one stream present.
 	std::vector<float> timeInSeconds;
 	// At Most One of the following is present
 	std::vector<glm::vec3> scale;
@@ -209,7 +211,10 @@ struct AnimationInstance
 		std::vector<void*> nodes;
 		// keyframe (Scale/ Rotate/ Translate)
 		uint32_t keyFrame;
-		KeyframeChannel() : keyFrame(0) {}
+		// The keyframe found by the last update. As time usually only moves forward by a small step between updates,
+		// the search for the next keyframe starts here.
+		uint32_t cursor;
+		KeyframeChannel() : keyFrame(0), cursor(1) {}
 	};
 
 	// the animation data
@@ -231,5 +236,23 @@ public:
 	void updateAnimation(float timeInMs);
 };
 
+/// <summary>Update several animation instances, spreading them across the calling thread and the shared TaskScheduler.
+/// The instances are updated independently, so no two of them may animate the same nodes.</summary>
+/// <param name="instances">The animation instances to update</param>
+/// <param name="numInstances">The number of animation instances</param>
+/// <param name="timeInMs">The time to update all the animation instances to</param>
+/// <param name="maxThreads">The maximum number of threads to use, including the calling thread. 0 uses all the workers
+/// of the shared TaskScheduler (see async::parallelFor).</param>
+void updateAnimations(AnimationInstance* const* instances, size_t numInstances, float timeInMs, uint32_t maxThreads = 0);
+
+/// <summary>Update several animation instances, each to its own time, spreading them across the calling thread and the
+/// shared TaskScheduler. The instances are updated independently, so no two of them may animate the same nodes.</summary>
+/// <param name="instances">The animation instances to update</param>
+/// <param name="timesInMs">The time to update each animation instance to</param>
+/// <param name="numInstances">The number of animation instances (and times)</param>
+/// <param name="maxThreads">The maximum number of threads to use, including the calling thread. 0 uses all the workers
+/// of the shared TaskScheduler (see async::parallelFor).</param>
+void updateAnimations(AnimationInstance* const* instances, const float* timesInMs, size_t numInstances, uint32_t maxThreads = 0);
+
 } // namespace assets
 } // namespace pvr
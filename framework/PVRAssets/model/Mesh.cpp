@@ -173,6 +173,15 @@ void Mesh::addFaces(const uint8_t* data, uint32_t size, IndexType indexType)
 	}
 }
 
+void Mesh::addLevelOfDetail(const uint8_t* data, uint32_t size, IndexType indexType, float error)
+{
+	_data.levelsOfDetail.push_back(LevelOfDetail());
+	LevelOfDetail& level = _data.levelsOfDetail.back();
+	level.faces.setData(data, size, indexType);
+	level.numFaces = size / (indexType == IndexType::IndexType32Bit ? 4 : 2) / 3;
+	level.error = error;
+}
+
 void Mesh::removeVertexAttribute(const StringHash& semantic)
 {
 	_data.vertexAttributes.erase(semantic);
@@ -209,6 +209,18 @@ public:
 		void setData(const uint8_t* data, uint32_t size, const IndexType indexType = IndexType::IndexType16Bit);
 	};
 
+	/// <summary>A simplified version of the faces of a mesh, drawing a subset of the same vertices (see
+	/// utils::generateMeshLevelsOfDetail).</summary>
+	struct LevelOfDetail
+	{
+		FaceData faces; //!< The indices of the triangles of this level, of the same type as those of the mesh
+		uint32_t numFaces; //!< The number of triangles of this level
+		float error; //!< The largest distance, in model units, between the surface of this level and the full detail one
+
+		/// <summary>Constructor</summary>
+		LevelOfDetail() : numFaces(0), error(0.f) {}
+	};
+
 	/// <summary>Contains mesh information.</summary>
 	struct MeshInfo
 	{
@@ -248,6 +260,7 @@ public:
 		uint32_t numBones; //!< Faces information
 
 		FaceData faces; //!< Faces information
+		std::vector<LevelOfDetail> levelsOfDetail; //!< Simplified versions of the faces, from the most to the least detailed
 		MeshInfo primitiveData; //!< Primitive data information
 
 		int32_t skeleton;
@@ -255,7 +268,7 @@ public:
 		glm::mat4x4 unpackMatrix; //!< This matrix is used to move from an int16_t representation to a float
 		RefCountedResource<void> userDataPtr; //!< This is a pointer that is in complete control of the user, used for per-mesh data.
 
-		InternalData() : skeleton(-1) {}
+		InternalData() : skeleton(-1), unpackMatrix(1.f) {}
 	};
 
 private:
@@ -495,6 +508,28 @@ public:
 		return _data.faces;
 	}
 
+	/// <summary>Get the simplified versions of the faces of this mesh, from the most to the least detailed. The full
+	/// detail faces (getFaces) are not included, so level i + 1 of a selector such as utils::selectLevelOfDetail is
+	/// element i.</summary>
+	/// <returns>The levels of detail of this mesh. Empty if none were generated.</returns>
+	const std::vector<LevelOfDetail>& getLevelsOfDetail() const
+	{
+		return _data.levelsOfDetail;
+	}
+
+	/// <summary>Append a level of detail, less detailed than the existing ones, to the mesh.</summary>
+	/// <param name="data">The indices of the triangles of the level. Will be copied</param>
+	/// <param name="size">The size of the indices, in bytes</param>
+	/// <param name="indexType">The type of the indices (16/32 bit)</param>
+	/// <param name="error">The largest distance, in model units, between the level and the full detail surface</param>
+	void addLevelOfDetail(const uint8_t* data, uint32_t size, IndexType indexType, float error);
+
+	/// <summary>Remove all levels of detail of the mesh.</summary>
+	void clearLevelsOfDetail()
+	{
+		_data.levelsOfDetail.clear();
+	}
+
 	/// <summary>Get the information of a VertexAttribute by its SemanticName.</summary>
 	/// <returns>A VertexAttributeData object with information on this attribute. (layout, index etc.) Null if
 	/// failed</returns>
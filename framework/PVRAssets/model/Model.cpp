@@ -11,6 +11,15 @@
 #include "PVRAssets/model/Mesh.h"
 #include "PVRCore/stream/Stream.h"
 #include "../../../external/glm/gtx/quaternion.hpp"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_MODEL_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_MODEL_NEON
+#include <arm_neon.h>
+#endif
 namespace pvr {
 namespace assets {
 void Model::allocCameras(uint32_t no)
@@ -31,6 +40,13 @@ void Model::allocMeshes(uint32_t no)
 void Model::allocNodes(uint32_t no)
 {
 	_data.nodes.resize(no);
+	for (Node& node : _data.nodes)
+	{
+		node.getInternalData().modelTransformGeneration = _transformGeneration;
+	}
+	// Force the world matrix cache to be rebuilt
+	_nodeUpdateOrder.clear();
+	_worldMatrices.clear();
 }
 
 void Model::allocMeshNodes(uint32_t no)
@@ -39,14 +55,10 @@ void Model::allocMeshNodes(uint32_t no)
 	_data.numMeshNodes = no;
 }
 
-glm::mat4x4 Model::getBoneWorldMatrix(uint32_t skinNodeId, uint32_t boneIndex) const
+namespace {
+// The transformation of the skinned node itself, which getBoneWorldMatrix applies before the bone transformation.
+glm::mat4 getSkinNodeTransform(const Model::Node::InternalData& nodeData)
 {
-	// Back transform bone from frame 0 position using the skin's transformation
-	const Mesh& mesh = getMesh(getNode(skinNodeId).getObjectId());
-	debug_assertion(mesh.getSkeletonId() >= 0, "Invalid Skeleton index");
-	const Skeleton& skeleton = getSkeleton(mesh.getSkeletonId());
-
-	const Node::InternalData& nodeData = getNode(skinNodeId).getInternalData();
 	glm::mat4 nodeWorld(1.f);
 	if (nodeData.transformFlags & pvr::assets::Node::InternalData::TransformFlags::SRT)
 	{
@@ -56,56 +68,250 @@ glm::mat4x4 Model::getBoneWorldMatrix(uint32_t skinNodeId, uint32_t boneIndex) c
 	{
 		nodeWorld = *(glm::mat4*)nodeData.frameXform;
 	}
-	return getWorldMatrix(skeleton.bones[boneIndex]) * skeleton.invBindMatrices[boneIndex] * nodeWorld;
+	return nodeWorld;
 }
 
-inline glm::mat4 constructSRT(const glm::vec3& scale, const glm::quat& rotate, const glm::vec3& trans)
+// out = a * b. The sums are done in the same order as glm's operator*, so the result is identical to it.
+inline void multiplyMat4(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
 {
-	return glm::translate(trans) * glm::toMat4(rotate) * glm::scale(scale);
+#if defined(PVR_MODEL_SSE2)
+	const __m128 a0 = _mm_loadu_ps(&a[0][0]), a1 = _mm_loadu_ps(&a[1][0]), a2 = _mm_loadu_ps(&a[2][0]), a3 = _mm_loadu_ps(&a[3][0]);
+	for (int j = 0; j < 4; ++j)
+	{
+		const __m128 bj = _mm_loadu_ps(&b[j][0]);
+		__m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+		r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+		r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3))));
+		_mm_storeu_ps(&out[j][0], r);
+	}
+#elif defined(PVR_MODEL_NEON)
+	const float32x4_t a0 = vld1q_f32(&a[0][0]), a1 = vld1q_f32(&a[1][0]), a2 = vld1q_f32(&a[2][0]), a3 = vld1q_f32(&a[3][0]);
+	for (int j = 0; j < 4; ++j)
+	{
+		// Separate multiplies and adds (rather than vmlaq) to round the same way as the scalar code.
+		float32x4_t r = vmulq_n_f32(a0, b[j][0]);
+		r = vaddq_f32(r, vmulq_n_f32(a1, b[j][1]));
+		r = vaddq_f32(r, vmulq_n_f32(a2, b[j][2]));
+		r = vaddq_f32(r, vmulq_n_f32(a3, b[j][3]));
+		vst1q_f32(&out[j][0], r);
+	}
+#else
+	out = a * b;
+#endif
 }
+} // namespace
 
-glm::mat4x4 Model::getWorldMatrix(uint32_t id) const
+glm::mat4x4 Model::getBoneWorldMatrix(uint32_t skinNodeId, uint32_t boneIndex) const
 {
-	const Node& node = _data.nodes[id];
-	int32_t parentID = _data.nodes[id].getParentID();
-	const auto& nodeData = node.getInternalData();
+	// Back transform bone from frame 0 position using the skin's transformation
+	const Mesh& mesh = getMesh(getNode(skinNodeId).getObjectId());
+	debug_assertion(mesh.getSkeletonId() >= 0, "Invalid Skeleton index");
+	const Skeleton& skeleton = getSkeleton(mesh.getSkeletonId());
+
+	const glm::mat4 nodeWorld = getSkinNodeTransform(getNode(skinNodeId).getInternalData());
+	return getWorldMatrix(skeleton.bones[boneIndex]) * skeleton.invBindMatrices[boneIndex] * nodeWorld;
+}
+
+void Model::getBonePalette(uint32_t skinNodeId, BonePaletteFormat format, void* outPalette, size_t stride) const
+{
+	const Mesh& mesh = getMesh(getNode(skinNodeId).getObjectId());
+	debug_assertion(mesh.getSkeletonId() >= 0, "Invalid Skeleton index");
+	const Skeleton& skeleton = getSkeleton(mesh.getSkeletonId());
+
+	if (stride == 0)
+	{
+		stride = (format == BonePaletteFormat::Mat4x4 ? sizeof(glm::mat4) : format == BonePaletteFormat::Mat3x4 ? sizeof(glm::mat3x4) : 2 * sizeof(glm::vec4));
+	}
+
+	const glm::mat4 nodeWorld = getSkinNodeTransform(getNode(skinNodeId).getInternalData());
+	unsigned char* out = static_cast<unsigned char*>(outPalette);
+	const bool useCache = areWorldMatricesUpToDate();
+	glm::mat4 boneBind, bone;
+	for (size_t i = 0; i < skeleton.bones.size(); ++i, out += stride)
+	{
+		multiplyMat4(useCache ? _worldMatrices[skeleton.bones[i]] : getWorldMatrixNoCache(skeleton.bones[i]), skeleton.invBindMatrices[i], boneBind);
+		multiplyMat4(boneBind, nodeWorld, bone);
+		switch (format)
+		{
+		case BonePaletteFormat::Mat4x4:
+			memcpy(out, glm::value_ptr(bone), sizeof(glm::mat4));
+			break;
+		case BonePaletteFormat::Mat3x4:
+		{
+			const glm::mat3x4 rows(glm::transpose(bone));
+			memcpy(out, glm::value_ptr(rows), sizeof(glm::mat3x4));
+			break;
+		}
+		case BonePaletteFormat::DualQuaternion:
+		{
+			const glm::quat real = glm::normalize(glm::quat_cast(glm::mat3(bone)));
+			const glm::quat dual = glm::quat(0.f, bone[3][0], bone[3][1], bone[3][2]) * real * 0.5f;
+			const float dualQuaternion[8] = { real.x, real.y, real.z, real.w, dual.x, dual.y, dual.z, dual.w };
+			memcpy(out, dualQuaternion, sizeof(dualQuaternion));
+			break;
+		}
+		}
+	}
+}
 
+namespace {
+glm::mat4 getLocalMatrix(const Model::Node::InternalData& nodeData)
+{
 	glm::mat4 m = glm::mat4(1.0f);
-	if (nodeData.transformFlags == Node::InternalData::TransformFlags::Matrix)
+	if (nodeData.transformFlags == Model::Node::InternalData::TransformFlags::Matrix)
 	{
 		m = *(glm::mat4*)nodeData.frameXform;
 		debug_assertion(!nodeData.hasAnimation, "Node cannot have transformation matrix and animation data");
 	}
 	else if (nodeData.hasAnimation)
 	{
-		debug_assertion(nodeData.transformFlags & Node::InternalData::TransformFlags::SRT, "Animation data must be stores as SRT");
+		debug_assertion(nodeData.transformFlags & Model::Node::InternalData::TransformFlags::SRT, "Animation data must be stores as SRT");
 		pvr::math::constructSRT(&nodeData.getFrameScaleAnimation(), &nodeData.getFrameRotationAnimation(), &nodeData.getFrameTranslationAnimation(), m);
 	}
-	else if ((nodeData.transformFlags & Node::InternalData::TransformFlags::SRT))
+	else if ((nodeData.transformFlags & Model::Node::InternalData::TransformFlags::SRT))
 	{
-		if (nodeData.transformFlags & Node::InternalData::TransformFlags::Scale)
+		if (nodeData.transformFlags & Model::Node::InternalData::TransformFlags::Scale)
 		{
 			m = glm::scale(nodeData.getScale());
 		}
-		if (nodeData.transformFlags & Node::InternalData::TransformFlags::Rotate)
+		if (nodeData.transformFlags & Model::Node::InternalData::TransformFlags::Rotate)
 		{
 			m = glm::toMat4(nodeData.getRotate()) * m;
 		}
-		if (nodeData.transformFlags & Node::InternalData::TransformFlags::Translate)
+		if (nodeData.transformFlags & Model::Node::InternalData::TransformFlags::Translate)
 		{
 			m = glm::translate(nodeData.getTranslation()) * m;
 		}
 	}
+	return m;
+}
+} // namespace
+
+glm::mat4x4 Model::getWorldMatrixNoCache(uint32_t id) const
+{
+	const Node& node = _data.nodes[id];
+	uint32_t parentID = node.getParentID();
+	glm::mat4 m = getLocalMatrix(node.getInternalData());
 
 	// Concatenate with parent transformation if one exist.
-	if (parentID < 0)
+	if (parentID >= _data.nodes.size())
 	{
 		return m;
 	}
 	else
 	{
-		return getWorldMatrix(parentID) * m;
+		return getWorldMatrixNoCache(parentID) * m;
+	}
+}
+
+void Model::updateWorldMatrices()
+{
+	// Read the generation first: anything flagged while we are updating will trigger another update.
+	const uint32_t generation = *_transformGeneration;
+	const uint32_t numNodes = static_cast<uint32_t>(_data.nodes.size());
+
+	// Nodes allocated through the internal data (for example by the model readers) do not know their Model yet.
+	for (Node& node : _data.nodes)
+	{
+		if (node.getInternalData().modelTransformGeneration != _transformGeneration)
+		{
+			node.getInternalData().modelTransformGeneration = _transformGeneration;
+		}
+	}
+
+	bool hierarchyChanged = (_nodeUpdateOrder.size() != numNodes);
+	for (uint32_t i = 0; !hierarchyChanged && i < numNodes; ++i)
+	{
+		hierarchyChanged = (_cachedParentIds[i] != _data.nodes[i].getParentID());
+	}
+
+	if (hierarchyChanged)
+	{
+		// Sort the nodes parents-first: Bucket the children of each node (counting sort on the parent id), then
+		// walk the tree breadth-first starting from the roots.
+		_cachedParentIds.resize(numNodes);
+		_worldParentIds.resize(numNodes);
+		std::vector<uint32_t> firstChild(numNodes + 1, 0);
+		std::vector<uint32_t> children(numNodes);
+		for (uint32_t i = 0; i < numNodes; ++i)
+		{
+			_cachedParentIds[i] = _data.nodes[i].getParentID();
+			_worldParentIds[i] = _cachedParentIds[i];
+			if (_cachedParentIds[i] < numNodes)
+			{
+				++firstChild[_cachedParentIds[i] + 1];
+			}
+		}
+		for (uint32_t i = 0; i < numNodes; ++i)
+		{
+			firstChild[i + 1] += firstChild[i];
+		}
+		std::vector<uint32_t> insertPosition(firstChild.begin(), firstChild.end() - 1);
+		for (uint32_t i = 0; i < numNodes; ++i)
+		{
+			if (_cachedParentIds[i] < numNodes)
+			{
+				children[insertPosition[_cachedParentIds[i]]++] = i;
+			}
+		}
+
+		_nodeUpdateOrder.clear();
+		_nodeUpdateOrder.reserve(numNodes);
+		for (uint32_t i = 0; i < numNodes; ++i)
+		{
+			if (_cachedParentIds[i] >= numNodes)
+			{
+				_nodeUpdateOrder.push_back(i);
+			}
+		}
+		for (uint32_t next = 0; next < _nodeUpdateOrder.size(); ++next)
+		{
+			const uint32_t parent = _nodeUpdateOrder[next];
+			_nodeUpdateOrder.insert(_nodeUpdateOrder.end(), children.begin() + firstChild[parent], children.begin() + firstChild[parent + 1]);
+		}
+		// Nodes not reachable from a root are part of a parenting cycle, which is malformed data. Treat them as roots.
+		// _cachedParentIds keeps their actual parents, so that the hierarchy is not rebuilt (and the warning is not
+		// logged again) until it changes.
+		if (_nodeUpdateOrder.size() != numNodes)
+		{
+			Log(LogLevel::Warning, "Model::updateWorldMatrices: Node hierarchy contains cycles. Affected nodes will ignore their parents.");
+			std::vector<uint8_t> visited(numNodes, 0);
+			for (uint32_t id : _nodeUpdateOrder)
+			{
+				visited[id] = 1;
+			}
+			for (uint32_t i = 0; i < numNodes; ++i)
+			{
+				if (!visited[i])
+				{
+					_nodeUpdateOrder.push_back(i);
+					_worldParentIds[i] = static_cast<uint32_t>(-1);
+				}
+			}
+		}
+		_worldMatrices.resize(numNodes);
+		_worldMatrixChanged.resize(numNodes);
+	}
+
+	for (uint32_t nodeId : _nodeUpdateOrder)
+	{
+		Node::InternalData& nodeData = _data.nodes[nodeId].getInternalData();
+		const uint32_t parentId = _worldParentIds[nodeId];
+		const bool hasParent = parentId < numNodes;
+		if (hierarchyChanged || nodeData.transformDirty || (hasParent && _worldMatrixChanged[parentId]))
+		{
+			const glm::mat4 localMatrix = getLocalMatrix(nodeData);
+			_worldMatrices[nodeId] = hasParent ? _worldMatrices[parentId] * localMatrix : localMatrix;
+			_worldMatrixChanged[nodeId] = 1;
+			nodeData.transformDirty = false;
+		}
+		else
+		{
+			_worldMatrixChanged[nodeId] = 0;
+		}
 	}
+	_cachedTransformGeneration = generation;
 }
 
 glm::vec3 Model::getLightPosition(uint32_t lightNodeId) const
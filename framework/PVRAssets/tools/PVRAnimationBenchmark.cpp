@@ -0,0 +1,209 @@
+/*!
+\brief A command line tool timing the animation of a crowd of skeletons: Calling AnimationInstance::updateAnimation for
+every instance, and updating all of them with updateAnimations (see PVRAssets/model/Animation.h) on an increasing
+number of threads.
+\file PVRAssets/tools/PVRAnimationBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/Model.h"
+#include "PVRCore/Threading.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+typedef pvr::assets::Model::Node::InternalData NodeData;
+
+// A skeleton of numBones bones (a binary tree), with a rotation channel on every bone and a translation channel on every
+// third bone, numKeys linearly interpolated keyframes each at 30 frames per second, as the POD reader creates them. The
+// defaults are the size of the animated gnome (GnomeToy.pod: 15 nodes, 20 channels of 201 keyframes).
+void createAnimatedModel(pvr::assets::Model& model, uint32_t numBones, uint32_t numKeys, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> distribution(-.5f, .5f);
+	model.allocNodes(numBones);
+	model.allocateAnimationsData(1);
+	model.allocateAnimationInstances(1);
+	pvr::assets::AnimationData& animationData = model.getInternalData().animationsData[0];
+	pvr::assets::AnimationInstance& animationInstance = model.getAnimationInstance(0);
+	animationInstance.animationData = &animationData;
+	std::vector<float> timeInSeconds(numKeys);
+	for (uint32_t key = 0; key < numKeys; ++key)
+	{
+		timeInSeconds[key] = key / 30.f;
+	}
+	animationData.getInternalData().numFrames = numKeys;
+	animationData.getInternalData().durationTime = timeInSeconds.back();
+
+	for (uint32_t i = 0; i < numBones; ++i)
+	{
+		NodeData& data = model.getNode(i).getInternalData();
+		data.parentIndex = i ? (i - 1) / 2 : static_cast<uint32_t>(-1);
+		data.transformFlags = NodeData::SRT;
+		data.hasAnimation = true;
+		data.getFrameScaleAnimation() = glm::vec3(1.f);
+		data.getFrameRotationAnimation() = glm::quat();
+		data.getFrameTranslationAnimation() = glm::vec3(0.f, 1.f, 0.f);
+
+		pvr::assets::AnimationInstance::KeyframeChannel channel;
+		channel.nodes.push_back(&model.getNode(i));
+
+		pvr::assets::KeyFrameData rotation;
+		rotation.timeInSeconds = timeInSeconds;
+		rotation.interpolation = pvr::assets::KeyFrameData::InterpolationType::Linear;
+		for (uint32_t key = 0; key < numKeys; ++key)
+		{
+			rotation.rotate.push_back(glm::normalize(glm::quat(1.f, distribution(random), distribution(random), distribution(random))));
+		}
+		channel.keyFrame = static_cast<uint32_t>(animationData.getNumKeyFrames());
+		animationData.getInternalData().keyFrames.push_back(rotation);
+		animationInstance.keyframeChannels.push_back(channel);
+
+		if (i % 3 == 0)
+		{
+			pvr::assets::KeyFrameData translation;
+			translation.timeInSeconds = timeInSeconds;
+			translation.interpolation = pvr::assets::KeyFrameData::InterpolationType::Linear;
+			for (uint32_t key = 0; key < numKeys; ++key)
+			{
+				translation.translation.push_back(glm::vec3(distribution(random), 1.f + distribution(random), distribution(random)));
+			}
+			channel.keyFrame = static_cast<uint32_t>(animationData.getNumKeyFrames());
+			animationData.getInternalData().keyFrames.push_back(translation);
+			animationInstance.keyframeChannels.push_back(channel);
+		}
+	}
+}
+
+// The crowd does not move in step: each instance is a little ahead of the previous one.
+void getTimes(const std::vector<pvr::assets::AnimationInstance*>& instances, uint32_t frame, std::vector<float>& timesInMs)
+{
+	for (size_t i = 0; i < instances.size(); ++i)
+	{
+		timesInMs[i] = std::fmod(frame * (1000.f / 60.f) + i * 37.f, instances[i]->getTotalTimeInMs());
+	}
+}
+
+// The animated transformations of all the nodes, to check that every method produced the same.
+void getPose(std::vector<pvr::assets::Model>& models, std::vector<float>& pose)
+{
+	pose.clear();
+	for (pvr::assets::Model& model : models)
+	{
+		for (uint32_t i = 0; i < model.getNumNodes(); ++i)
+		{
+			const NodeData& data = model.getNode(i).getInternalData();
+			pose.insert(pose.end(), data.frameXform, data.frameXform + 10);
+		}
+	}
+}
+
+float getMaxDifference(const std::vector<float>& a, const std::vector<float>& b)
+{
+	float maxDifference = 0;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		maxDifference = std::max(maxDifference, std::abs(a[i] - b[i]));
+	}
+	return maxDifference;
+}
+
+// Play numFrames frames at 60 frames per second, numRepeats times, and return the fastest time per frame in milliseconds.
+template<typename Update>
+double timeBestPerFrame(const std::vector<pvr::assets::AnimationInstance*>& instances, uint32_t numFrames, uint32_t numRepeats, const Update& update)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	std::vector<float> timesInMs(instances.size());
+	double best = 0;
+	for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		double milliseconds = 0;
+		for (uint32_t frame = 0; frame < numFrames; ++frame)
+		{
+			getTimes(instances, frame, timesInMs);
+			const auto start = Clock::now();
+			update(timesInMs.data());
+			milliseconds += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+		best = repeat ? std::min(best, milliseconds) : milliseconds;
+	}
+	return best / numFrames;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numInstances = 1000;
+	uint32_t numBones = 15;
+	uint32_t numKeys = 201;
+	uint32_t numFrames = 600;
+	uint32_t numRepeats = 5;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-instances=", numInstances) && !readOption(argv[i], "-bones=", numBones) && !readOption(argv[i], "-keys=", numKeys) &&
+			!readOption(argv[i], "-frames=", numFrames) && !readOption(argv[i], "-repeat=", numRepeats))
+		{
+			printf("Usage: %s [-instances=<animated models, default 1000>] [-bones=<bones per skeleton, default 15>] [-keys=<keyframes per channel, default 201>] "
+				   "[-frames=<frames, default 600>] [-repeat=<runs, of which the fastest is reported>]\n",
+				argv[0]);
+			return 1;
+		}
+	}
+	if (!numInstances || !numBones || numKeys < 2 || !numFrames || !numRepeats)
+	{
+		printf("The number of instances, bones, frames and runs must be greater than zero, and there must be at least two keyframes\n");
+		return 1;
+	}
+
+	std::mt19937 random(1);
+	std::vector<pvr::assets::Model> models(numInstances);
+	std::vector<pvr::assets::AnimationInstance*> instances;
+	for (pvr::assets::Model& model : models)
+	{
+		createAnimatedModel(model, numBones, numKeys, random);
+		instances.push_back(&model.getAnimationInstance(0));
+	}
+
+	const uint32_t maxThreads = pvr::async::getSharedTaskScheduler().getNumWorkers() + 1;
+	printf("%u skeletons of %u bones, %u channels of %u keyframes each, %u frames, best of %u runs, up to %u threads (the calling thread and the shared TaskScheduler)\n",
+		numInstances, numBones, static_cast<uint32_t>(instances[0]->keyframeChannels.size()), numKeys, numFrames, numRepeats, maxThreads);
+
+	std::vector<float> expectedPose, pose;
+	const double loopMilliseconds = timeBestPerFrame(instances, numFrames, numRepeats, [&](const float* timesInMs) {
+		for (size_t i = 0; i < instances.size(); ++i)
+		{
+			instances[i]->updateAnimation(timesInMs[i]);
+		}
+	});
+	getPose(models, expectedPose);
+	printf("updateAnimation loop:              %8.3f ms/frame\n", loopMilliseconds);
+
+	// Also ask for more threads than there are, to check that it costs nothing.
+	for (uint32_t numThreads = 1; numThreads <= std::max(maxThreads, 4u); numThreads *= 2)
+	{
+		const double milliseconds = timeBestPerFrame(instances, numFrames, numRepeats,
+			[&](const float* timesInMs) { pvr::assets::updateAnimations(instances.data(), timesInMs, instances.size(), numThreads); });
+		getPose(models, pose);
+		printf("updateAnimations, %2u thread(s):    %8.3f ms/frame  speedup %5.2fx  (largest difference of the poses %g)\n", numThreads, milliseconds,
+			loopMilliseconds / milliseconds, getMaxDifference(expectedPose, pose));
+	}
+	return 0;
+}
+//!\endcond
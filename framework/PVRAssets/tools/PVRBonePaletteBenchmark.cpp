@@ -0,0 +1,183 @@
+/*!
+\brief A command line tool comparing evaluating the bones of a skeleton one at a time (Model::getBoneWorldMatrix, see
+PVRAssets/Model.h) with evaluating the whole skeleton at once (Model::getBonePalette), in each palette format, while a
+third of the bones are re-posed every frame.
+\file PVRAssets/tools/PVRBonePaletteBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/Model.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+typedef pvr::assets::Model::Node::InternalData NodeData;
+
+// A skinned mesh node (node 0) and a skeleton of numBones bones (nodes 1 to numBones) as a binary tree, posed at random.
+void createSkinnedModel(pvr::assets::Model& model, uint32_t numBones, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> distribution(-.5f, .5f);
+	model.allocNodes(numBones + 1);
+	model.getInternalData().numMeshNodes = 1;
+	model.allocMeshes(1);
+	model.getMesh(0).getInternalData().skeleton = 0;
+	pvr::assets::Skeleton skeleton;
+	for (uint32_t i = 0; i <= numBones; ++i)
+	{
+		NodeData& data = model.getNode(i).getInternalData();
+		data.objectIndex = 0;
+		data.parentIndex = i < 2 ? static_cast<uint32_t>(-1) : 1 + (i - 2) / 2;
+		data.transformFlags = NodeData::SRT;
+		data.scale = glm::vec3(1.f);
+		data.rotation = glm::normalize(glm::quat(1.f, distribution(random), distribution(random), distribution(random)));
+		data.translation = glm::vec3(distribution(random), distribution(random), distribution(random));
+		data.hasAnimation = false;
+		data.setTransformDirty();
+		if (i)
+		{
+			skeleton.bones.push_back(i);
+			skeleton.invBindMatrices.push_back(glm::inverse(model.getWorldMatrixNoCache(i)));
+		}
+	}
+	model.getInternalData().skeletons.push_back(skeleton);
+}
+
+// Re-pose every third bone, as an animation playing on part of the skeleton would.
+void animate(pvr::assets::Model& model, uint32_t numBones, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> distribution(-.5f, .5f);
+	for (uint32_t i = 1; i <= numBones; i += 3)
+	{
+		NodeData& data = model.getNode(i).getInternalData();
+		data.rotation = glm::normalize(glm::quat(1.f, distribution(random), distribution(random), distribution(random)));
+		data.setTransformDirty();
+	}
+}
+
+float getMaxDifference(const glm::mat4& a, const glm::mat4& b)
+{
+	float maxDifference = 0;
+	for (int column = 0; column < 4; ++column)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			maxDifference = std::max(maxDifference, std::abs(a[column][row] - b[column][row]));
+		}
+	}
+	return maxDifference;
+}
+
+void report(uint32_t numBones, uint32_t numFrames, std::mt19937& random)
+{
+	pvr::assets::Model model;
+	createSkinnedModel(model, numBones, random);
+	std::vector<glm::mat4> perBone(numBones), mat4Palette(numBones);
+	std::vector<glm::mat3x4> mat3x4Palette(numBones);
+	std::vector<float> dualQuaternionPalette(8 * numBones);
+	double perBoneMicroseconds = 0, mat4Microseconds = 0, mat3x4Microseconds = 0, dualQuaternionMicroseconds = 0;
+	float maxDifference = 0, maxTranslationError = 0;
+	typedef std::chrono::high_resolution_clock Clock;
+	for (uint32_t frame = 0; frame < numFrames; ++frame)
+	{
+		// Every method starts from the same amount of out of date world matrices, and is checked against
+		// getBoneWorldMatrix for the same pose. The per bone evaluation walks up the hierarchy of each bone, the palettes
+		// update the world matrix cache of the Model first, as a frame would.
+		animate(model, numBones, random);
+		auto start = Clock::now();
+		for (uint32_t i = 0; i < numBones; ++i)
+		{
+			perBone[i] = model.getBoneWorldMatrix(0, i);
+		}
+		perBoneMicroseconds += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+		animate(model, numBones, random);
+		start = Clock::now();
+		model.updateWorldMatrices();
+		model.getBonePalette(0, pvr::assets::BonePaletteFormat::Mat4x4, mat4Palette.data());
+		mat4Microseconds += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+		for (uint32_t i = 0; i < numBones; ++i)
+		{
+			maxDifference = std::max(maxDifference, getMaxDifference(model.getBoneWorldMatrix(0, i), mat4Palette[i]));
+		}
+
+		animate(model, numBones, random);
+		start = Clock::now();
+		model.updateWorldMatrices();
+		model.getBonePalette(0, pvr::assets::BonePaletteFormat::Mat3x4, mat3x4Palette.data());
+		mat3x4Microseconds += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+		for (uint32_t i = 0; i < numBones; ++i)
+		{
+			const glm::mat3x4& bone = mat3x4Palette[i];
+			maxDifference = std::max(maxDifference, getMaxDifference(model.getBoneWorldMatrix(0, i), glm::transpose(glm::mat4(bone[0], bone[1], bone[2], glm::vec4(0.f, 0.f, 0.f, 1.f)))));
+		}
+
+		animate(model, numBones, random);
+		start = Clock::now();
+		model.updateWorldMatrices();
+		model.getBonePalette(0, pvr::assets::BonePaletteFormat::DualQuaternion, dualQuaternionPalette.data());
+		dualQuaternionMicroseconds += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+		for (uint32_t i = 0; i < numBones; ++i)
+		{
+			const float* dualQuaternion = &dualQuaternionPalette[8 * i];
+			const glm::quat real(dualQuaternion[3], dualQuaternion[0], dualQuaternion[1], dualQuaternion[2]);
+			const glm::quat dual(dualQuaternion[7], dualQuaternion[4], dualQuaternion[5], dualQuaternion[6]);
+			const glm::quat translation = dual * glm::conjugate(real) * 2.f;
+			maxTranslationError = std::max(maxTranslationError, glm::length(glm::vec3(translation.x, translation.y, translation.z) - glm::vec3(model.getBoneWorldMatrix(0, i)[3])));
+		}
+	}
+	printf("%5u bones: per bone %8.2f us  mat4 %8.2f us  mat3x4 %8.2f us  dual quaternion %8.2f us  (largest difference of the matrices %g, of the dual quaternion translations %g)\n",
+		numBones, perBoneMicroseconds / numFrames, mat4Microseconds / numFrames, mat3x4Microseconds / numFrames, dualQuaternionMicroseconds / numFrames, maxDifference,
+		maxTranslationError);
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numFrames = 10000;
+	uint32_t numBones = 0;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-frames=", numFrames) && !readOption(argv[i], "-bones=", numBones))
+		{
+			printf("Usage: %s [-frames=<frames>] [-bones=<bones of the generated skeleton, default 30, 60 and 120>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!numFrames)
+	{
+		printf("The number of frames must be greater than zero\n");
+		return 1;
+	}
+
+	printf("%u frames, a third of the bones re-posed before every evaluation, time per evaluation of the whole skeleton\n", numFrames);
+	std::mt19937 random(1);
+	if (numBones)
+	{
+		report(numBones, numFrames, random);
+	}
+	else
+	{
+		report(30, numFrames, random);
+		report(60, numFrames, random);
+		report(120, numFrames, random);
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,395 @@
+/*!
+\brief A command line tool running the mesh optimizer (see PVRAssets/MeshOptimizer.h) and optionally the vertex
+quantizer (see PVRAssets/VertexQuantizer.h) and the level of detail generation (see PVRAssets/MeshSimplifier.h) over
+POD and glTF models and reporting the vertex cache efficiency, vertex counts and vertex data sizes of their meshes
+before and after, and the triangle counts, errors and simplification throughput of their levels of detail.
+\file PVRAssets/tools/PVRMeshOptimizer.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/Helper.h"
+#include "PVRAssets/MeshOptimizer.h"
+#include "PVRAssets/MeshSimplifier.h"
+#include "PVRAssets/VertexQuantizer.h"
+#include "PVRAssets/fileio/GltfReader.h"
+#include "PVRAssets/fileio/PODReader.h"
+#include "PVRCore/stream/FileStream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace {
+// Opens the files a model references relative to the directory of the model.
+class DirectoryAssetProvider : public pvr::IAssetProvider
+{
+public:
+	explicit DirectoryAssetProvider(const std::string& modelPath)
+	{
+		const size_t separator = modelPath.find_last_of("/\\");
+		_directory = separator == std::string::npos ? std::string() : modelPath.substr(0, separator + 1);
+	}
+
+	std::unique_ptr<pvr::Stream> getAssetStream(const std::string& filename, bool logErrorOnNotFound = true)
+	{
+		std::unique_ptr<pvr::Stream> stream(new pvr::FileStream(_directory + filename, "rb", logErrorOnNotFound));
+		stream->open();
+		return stream;
+	}
+
+private:
+	std::string _directory;
+};
+
+pvr::assets::ModelHandle loadModel(const std::string& path)
+{
+	DirectoryAssetProvider assetProvider(path);
+	std::unique_ptr<pvr::Stream> stream(new pvr::FileStream(path, "rb"));
+	stream->open();
+	if (pvr::assets::helper::isGltfFile(path))
+	{
+		return pvr::assets::Model::createWithReader(pvr::assets::GltfReader(std::move(stream), assetProvider));
+	}
+	return pvr::assets::Model::createWithReader(pvr::assets::PODReader(std::move(stream)));
+}
+
+void printUsage()
+{
+	printf("Usage: PVRMeshOptimizer [-cache=<vertices>] [-threshold=<ratio>] [-overdraw] [-nodeduplicate] [-nofetch] [-quantize] [-normal8] [-lod] [-lod-error=<ratio>] [-v] <model>...\n"
+		   "  Optimizes the meshes of POD and glTF models and reports their post-transform vertex cache efficiency\n"
+		   "  (ACMR: vertices transformed per triangle, ATVR: per distinct vertex) before and after.\n"
+		   "  -cache=<n>      The size of the simulated FIFO vertex cache. Default 16.\n"
+		   "  -threshold=<r>  How much the overdraw pass may degrade the ACMR. Default 1.05.\n"
+		   "  -overdraw       Also reorder the triangles to reduce overdraw.\n"
+		   "  -nodeduplicate  Do not merge identical vertices.\n"
+		   "  -nofetch        Do not renumber the vertices in the order they are used.\n"
+		   "  -quantize       Also quantize the vertex attributes, and report the vertex data sizes and largest errors\n"
+		   "                  (model units for positions, degrees for normals, absolute for the others).\n"
+		   "  -normal8        Quantize the normals, tangents and binormals to 8 instead of 16 bits.\n"
+		   "  -lod            Also generate levels of detail, and report the time to simplify every mesh to half its\n"
+		   "                  triangles and the triangle counts and largest errors (model units) of each level.\n"
+		   "  -lod-error=<r>  The largest error of the levels of detail, relative to the size of each mesh. Default 0.05.\n"
+		   "  -v              Report every mesh, not only the totals of each model.\n");
+}
+
+struct Totals
+{
+	uint64_t numTriangles;
+	uint64_t transformedBefore, transformedAfter;
+	uint64_t distinctBefore, distinctAfter;
+	uint64_t verticesBefore, verticesAfter;
+	Totals() : numTriangles(0), transformedBefore(0), transformedAfter(0), distinctBefore(0), distinctAfter(0), verticesBefore(0), verticesAfter(0) {}
+
+	void add(const pvr::assets::utils::MeshOptimizationStatistics& statistics)
+	{
+		numTriangles += statistics.before.numTriangles;
+		transformedBefore += statistics.before.numTransformedVertices;
+		transformedAfter += statistics.after.numTransformedVertices;
+		distinctBefore += statistics.before.numVertices;
+		distinctAfter += statistics.after.numVertices;
+		verticesBefore += statistics.numVerticesBefore;
+		verticesAfter += statistics.numVerticesAfter;
+	}
+
+	void add(const Totals& other)
+	{
+		numTriangles += other.numTriangles;
+		transformedBefore += other.transformedBefore;
+		transformedAfter += other.transformedAfter;
+		distinctBefore += other.distinctBefore;
+		distinctAfter += other.distinctAfter;
+		verticesBefore += other.verticesBefore;
+		verticesAfter += other.verticesAfter;
+	}
+
+	void print(const char* name, double milliseconds) const
+	{
+		const double triangles = static_cast<double>(std::max<uint64_t>(numTriangles, 1));
+		printf("%-40s %8llu triangles  ACMR %.3f -> %.3f  ATVR %.3f -> %.3f  vertices %llu -> %llu  %.2f ms\n", name, static_cast<unsigned long long>(numTriangles),
+			transformedBefore / triangles, transformedAfter / triangles, transformedBefore / static_cast<double>(std::max<uint64_t>(distinctBefore, 1)),
+			transformedAfter / static_cast<double>(std::max<uint64_t>(distinctAfter, 1)), static_cast<unsigned long long>(verticesBefore),
+			static_cast<unsigned long long>(verticesAfter), milliseconds);
+	}
+};
+struct QuantizationTotals
+{
+	uint64_t sizeBefore, sizeAfter;
+	std::map<std::string, float> maxErrors;
+	QuantizationTotals() : sizeBefore(0), sizeAfter(0) {}
+
+	void add(const pvr::assets::utils::VertexQuantizationStatistics& statistics)
+	{
+		sizeBefore += statistics.vertexDataSizeBefore;
+		sizeAfter += statistics.vertexDataSizeAfter;
+		for (const pvr::assets::utils::QuantizedAttributeStatistics& attribute : statistics.attributes)
+		{
+			float& maxError = maxErrors[attribute.semantic.str()];
+			maxError = std::max(maxError, attribute.maxError);
+		}
+	}
+
+	void add(const QuantizationTotals& other)
+	{
+		sizeBefore += other.sizeBefore;
+		sizeAfter += other.sizeAfter;
+		for (const std::pair<const std::string, float>& error : other.maxErrors)
+		{
+			float& maxError = maxErrors[error.first];
+			maxError = std::max(maxError, error.second);
+		}
+	}
+
+	void print(const char* name) const
+	{
+		printf("%-40s vertex data %.1f KB -> %.1f KB (%.1f%%)  max error", name, sizeBefore / 1024., sizeAfter / 1024., 100. * sizeAfter / std::max<uint64_t>(sizeBefore, 1));
+		for (const std::pair<const std::string, float>& error : maxErrors)
+		{
+			printf("  %s %g", error.first.c_str(), error.second);
+		}
+		printf("\n");
+	}
+};
+struct LevelOfDetailTotals
+{
+	uint64_t numSimplifiedTriangles; // Of the meshes simplified to half their triangles
+	double simplifyMilliseconds;
+	double generateMilliseconds;
+	std::vector<std::vector<uint32_t>> meshTriangles; // Of each level of each mesh, starting with the full detail one
+	std::vector<float> levelErrors;
+	LevelOfDetailTotals() : numSimplifiedTriangles(0), simplifyMilliseconds(0), generateMilliseconds(0) {}
+
+	void add(const pvr::assets::Mesh& mesh)
+	{
+		meshTriangles.push_back(std::vector<uint32_t>(1, mesh.getNumFaces()));
+		const std::vector<pvr::assets::Mesh::LevelOfDetail>& levels = mesh.getLevelsOfDetail();
+		if (levelErrors.size() < levels.size())
+		{
+			levelErrors.resize(levels.size(), 0.f);
+		}
+		for (size_t level = 0; level < levels.size(); ++level)
+		{
+			meshTriangles.back().push_back(levels[level].numFaces);
+			levelErrors[level] = std::max(levelErrors[level], levels[level].error);
+		}
+	}
+
+	void add(const LevelOfDetailTotals& other)
+	{
+		numSimplifiedTriangles += other.numSimplifiedTriangles;
+		simplifyMilliseconds += other.simplifyMilliseconds;
+		generateMilliseconds += other.generateMilliseconds;
+		meshTriangles.insert(meshTriangles.end(), other.meshTriangles.begin(), other.meshTriangles.end());
+		if (levelErrors.size() < other.levelErrors.size())
+		{
+			levelErrors.resize(other.levelErrors.size(), 0.f);
+		}
+		for (size_t level = 0; level < other.levelErrors.size(); ++level)
+		{
+			levelErrors[level] = std::max(levelErrors[level], other.levelErrors[level]);
+		}
+	}
+
+	// Meshes with fewer levels count with their least detailed one.
+	uint64_t getTriangles(size_t level) const
+	{
+		uint64_t triangles = 0;
+		for (const std::vector<uint32_t>& mesh : meshTriangles)
+		{
+			triangles += mesh[std::min(level, mesh.size() - 1)];
+		}
+		return triangles;
+	}
+
+	void print(const char* name) const
+	{
+		const uint64_t numTriangles = getTriangles(0);
+		printf("%-40s", name);
+		if (numSimplifiedTriangles)
+		{
+			printf(" simplify to 50%%: %llu -> %llu triangles in %.2f ms (%.2f M triangles/s) ", static_cast<unsigned long long>(numTriangles),
+				static_cast<unsigned long long>(numSimplifiedTriangles), simplifyMilliseconds, numTriangles / std::max(simplifyMilliseconds, 1e-3) / 1000.);
+		}
+		printf(" levels %llu", static_cast<unsigned long long>(numTriangles));
+		for (size_t level = 0; level < levelErrors.size(); ++level)
+		{
+			printf(" -> %llu (%g)", static_cast<unsigned long long>(getTriangles(level + 1)), levelErrors[level]);
+		}
+		printf(" in %.2f ms\n", generateMilliseconds);
+	}
+};
+} // namespace
+
+int main(int argc, char** argv)
+{
+	pvr::assets::utils::MeshOptimizerOptions options;
+	pvr::assets::utils::VertexQuantizationOptions quantizationOptions;
+	pvr::assets::utils::LevelOfDetailOptions levelOfDetailOptions;
+	bool quantize = false;
+	bool generateLevelsOfDetail = false;
+	bool verbose = false;
+	int firstModel = 1;
+	for (; firstModel < argc && argv[firstModel][0] == '-'; ++firstModel)
+	{
+		const char* arg = argv[firstModel];
+		if (strncmp(arg, "-cache=", 7) == 0)
+		{
+			options.cacheSize = static_cast<uint32_t>(std::max(3, atoi(arg + 7)));
+		}
+		else if (strncmp(arg, "-threshold=", 11) == 0)
+		{
+			options.overdrawThreshold = std::max(1.f, static_cast<float>(atof(arg + 11)));
+		}
+		else if (strcmp(arg, "-overdraw") == 0)
+		{
+			options.optimizeOverdraw = true;
+		}
+		else if (strcmp(arg, "-nodeduplicate") == 0)
+		{
+			options.deduplicateVertices = false;
+		}
+		else if (strcmp(arg, "-nofetch") == 0)
+		{
+			options.optimizeVertexFetch = false;
+		}
+		else if (strcmp(arg, "-quantize") == 0)
+		{
+			quantize = true;
+		}
+		else if (strcmp(arg, "-normal8") == 0)
+		{
+			quantizationOptions.normalType = pvr::DataType::Int8Norm;
+		}
+		else if (strcmp(arg, "-lod") == 0)
+		{
+			generateLevelsOfDetail = true;
+		}
+		else if (strncmp(arg, "-lod-error=", 11) == 0)
+		{
+			levelOfDetailOptions.maxError = std::max(0.f, static_cast<float>(atof(arg + 11)));
+		}
+		else if (strcmp(arg, "-v") == 0)
+		{
+			verbose = true;
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if (firstModel == argc)
+	{
+		printUsage();
+		return 1;
+	}
+
+	Totals allModels;
+	QuantizationTotals allModelsQuantization;
+	LevelOfDetailTotals allModelsLevelsOfDetail;
+	double allMilliseconds = 0;
+	int result = 0;
+	for (int i = firstModel; i < argc; ++i)
+	{
+		try
+		{
+			pvr::assets::ModelHandle model = loadModel(argv[i]);
+			const auto start = std::chrono::high_resolution_clock::now();
+			const std::vector<pvr::assets::utils::MeshOptimizationStatistics> statistics = pvr::assets::utils::optimizeModel(*model, options);
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+			Totals totals;
+			for (size_t mesh = 0; mesh < statistics.size(); ++mesh)
+			{
+				if (!statistics[mesh].optimized)
+				{
+					continue;
+				}
+				totals.add(statistics[mesh]);
+				if (verbose)
+				{
+					Totals meshTotals;
+					meshTotals.add(statistics[mesh]);
+					meshTotals.print(("  mesh " + std::to_string(mesh)).c_str(), 0.0);
+				}
+			}
+			totals.print(argv[i], milliseconds);
+			allModels.add(totals);
+			allMilliseconds += milliseconds;
+
+			// Before the quantization, so that the positions and normals are simplified at full precision.
+			if (generateLevelsOfDetail)
+			{
+				LevelOfDetailTotals levelOfDetailTotals;
+				pvr::assets::utils::SimplificationOptions simplificationOptions = levelOfDetailOptions.simplification;
+				simplificationOptions.targetError = levelOfDetailOptions.maxError;
+				std::vector<uint32_t> indices;
+				auto levelStart = std::chrono::high_resolution_clock::now();
+				for (uint32_t mesh = 0; mesh < model->getNumMeshes(); ++mesh)
+				{
+					if (!statistics[mesh].optimized)
+					{
+						continue;
+					}
+					simplificationOptions.targetIndexCount = model->getMesh(mesh).getNumFaces() / 2 * 3;
+					pvr::assets::utils::simplifyMesh(model->getMesh(mesh), simplificationOptions, indices);
+					levelOfDetailTotals.numSimplifiedTriangles += indices.size() / 3;
+				}
+				levelOfDetailTotals.simplifyMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - levelStart).count();
+
+				levelStart = std::chrono::high_resolution_clock::now();
+				pvr::assets::utils::generateModelLevelsOfDetail(*model, levelOfDetailOptions);
+				levelOfDetailTotals.generateMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - levelStart).count();
+				for (uint32_t mesh = 0; mesh < model->getNumMeshes(); ++mesh)
+				{
+					if (!statistics[mesh].optimized)
+					{
+						continue;
+					}
+					levelOfDetailTotals.add(model->getMesh(mesh));
+					if (verbose)
+					{
+						LevelOfDetailTotals meshTotals;
+						meshTotals.add(model->getMesh(mesh));
+						meshTotals.print(("  mesh " + std::to_string(mesh)).c_str());
+					}
+				}
+				levelOfDetailTotals.print("");
+				allModelsLevelsOfDetail.add(levelOfDetailTotals);
+			}
+
+			if (quantize)
+			{
+				QuantizationTotals quantizationTotals;
+				for (const pvr::assets::utils::VertexQuantizationStatistics& meshStatistics : pvr::assets::utils::quantizeModel(*model, quantizationOptions))
+				{
+					quantizationTotals.add(meshStatistics);
+				}
+				quantizationTotals.print("");
+				allModelsQuantization.add(quantizationTotals);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			printf("%s: %s\n", argv[i], e.what());
+			result = 1;
+		}
+	}
+	if (argc - firstModel > 1)
+	{
+		allModels.print("Total", allMilliseconds);
+		if (generateLevelsOfDetail)
+		{
+			allModelsLevelsOfDetail.print("Total");
+		}
+		if (quantize)
+		{
+			allModelsQuantization.print("Total");
+		}
+	}
+	return result;
+}
+//!\endcond
@@ -0,0 +1,151 @@
+/*!
+\brief A command line tool measuring how long an application takes to load its models at startup: One after the other
+on the calling thread, and with helper::loadModelsParallel (see PVRAssets/Helper.h) on an increasing number of threads.
+\file PVRAssets/tools/PVRModelLoadBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/Helper.h"
+#include "PVRAssets/fileio/GltfReader.h"
+#include "PVRAssets/fileio/PODReader.h"
+#include "PVRCore/stream/FileStream.h"
+#include "PVRCore/Threading.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+// Opens files as given, or else relative to the directory of any of the models, for the files that glTF models reference.
+class ModelDirectoriesAssetProvider : public pvr::IAssetProvider
+{
+public:
+	explicit ModelDirectoriesAssetProvider(const std::vector<std::string>& modelPaths)
+	{
+		for (const std::string& path : modelPaths)
+		{
+			const size_t separator = path.find_last_of("/\\");
+			const std::string directory = separator == std::string::npos ? std::string() : path.substr(0, separator + 1);
+			if (std::find(_directories.begin(), _directories.end(), directory) == _directories.end())
+			{
+				_directories.push_back(directory);
+			}
+		}
+	}
+
+	std::unique_ptr<pvr::Stream> getAssetStream(const std::string& filename, bool logErrorOnNotFound = true)
+	{
+		std::unique_ptr<pvr::Stream> stream = pvr::FileStream::createFileStream(filename.c_str(), "rb", false);
+		for (size_t i = 0; i < _directories.size() && !stream->isopen(); ++i)
+		{
+			stream = pvr::FileStream::createFileStream((_directories[i] + filename).c_str(), "rb", logErrorOnNotFound && i + 1 == _directories.size());
+		}
+		return stream;
+	}
+
+private:
+	std::vector<std::string> _directories;
+};
+
+// Load every model on the calling thread, as an application without loadModelsParallel does.
+void loadModelsSequentially(ModelDirectoriesAssetProvider& provider, const std::vector<std::string>& filenames, std::vector<pvr::assets::ModelHandle>& models)
+{
+	models.clear();
+	for (const std::string& filename : filenames)
+	{
+		pvr::Stream::ptr_type stream = provider.getAssetStream(filename);
+		if (pvr::assets::helper::isGltfFile(filename))
+		{
+			models.push_back(pvr::assets::Model::createWithReader(pvr::assets::GltfReader(std::move(stream), provider)));
+		}
+		else
+		{
+			models.push_back(pvr::assets::Model::createWithReader(pvr::assets::PODReader(std::move(stream))));
+		}
+	}
+}
+
+// The fastest of numRepeats runs of function, in milliseconds.
+template<typename Function>
+double timeBest(uint32_t numRepeats, const Function& function)
+{
+	double best = 0;
+	for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		function();
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		best = repeat ? std::min(best, milliseconds) : milliseconds;
+	}
+	return best;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numRepeats = 5;
+	std::vector<std::string> filenames;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i][0] != '-')
+		{
+			filenames.push_back(argv[i]);
+		}
+		else if (!readOption(argv[i], "-repeat=", numRepeats))
+		{
+			filenames.clear();
+			break;
+		}
+	}
+	if (filenames.empty() || !numRepeats)
+	{
+		printf("Usage: %s [-repeat=<runs, of which the fastest is reported>] <POD and glTF models...>\n", argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		ModelDirectoriesAssetProvider provider(filenames);
+		std::vector<pvr::assets::ModelHandle> models;
+		// Once to warm up the file cache and the workers of the shared TaskScheduler
+		loadModelsSequentially(provider, filenames, models);
+		pvr::assets::helper::loadModelsParallel(provider, filenames, models);
+
+		const uint32_t maxThreads = pvr::async::getSharedTaskScheduler().getNumWorkers() + 1;
+		printf("%u models, best of %u runs, up to %u threads (the calling thread and the shared TaskScheduler)\n", static_cast<uint32_t>(filenames.size()), numRepeats, maxThreads);
+		const double sequentialMilliseconds = timeBest(numRepeats, [&]() { loadModelsSequentially(provider, filenames, models); });
+		printf("sequential:                       %9.2f ms\n", sequentialMilliseconds);
+		for (uint32_t numThreads = 1;; numThreads = std::min(numThreads * 2, maxThreads))
+		{
+			const double milliseconds = timeBest(numRepeats, [&]() { pvr::assets::helper::loadModelsParallel(provider, filenames, models, numThreads); });
+			printf("loadModelsParallel, %2u thread(s): %9.2f ms  speedup %5.2fx\n", numThreads, milliseconds, sequentialMilliseconds / milliseconds);
+			if (numThreads == maxThreads)
+			{
+				break;
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		printf("Failed: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
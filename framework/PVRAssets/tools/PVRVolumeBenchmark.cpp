@@ -0,0 +1,100 @@
+/*!
+\brief A command line tool measuring how the time Volume::init (see PVRAssets/Volume.h) takes to weld the vertices and
+edges of a mesh grows with the number of triangles.
+\file PVRAssets/tools/PVRVolumeBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/Volume.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+// A closed surface (a torus) of about numTriangles triangles, flat shaded: every triangle has its own 3 vertices, as
+// meshes with per face normals do, so Volume::init has to weld 3 vertices per triangle back together.
+void createTorus(uint32_t numTriangles, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices)
+{
+	const uint32_t rings = std::max(3u, static_cast<uint32_t>(std::sqrt(numTriangles / 2.0)));
+	const uint32_t sides = std::max(3u, numTriangles / (2 * rings));
+	auto getPosition = [&](uint32_t ring, uint32_t side) {
+		const float u = 6.2831853f * (ring % rings) / rings;
+		const float v = 6.2831853f * (side % sides) / sides;
+		return glm::vec3((2.f + std::cos(v)) * std::cos(u), std::sin(v), (2.f + std::cos(v)) * std::sin(u));
+	};
+	positions.clear();
+	indices.clear();
+	for (uint32_t ring = 0; ring < rings; ++ring)
+	{
+		for (uint32_t side = 0; side < sides; ++side)
+		{
+			const glm::vec3 quad[4] = { getPosition(ring, side), getPosition(ring + 1, side), getPosition(ring + 1, side + 1), getPosition(ring, side + 1) };
+			const uint32_t corners[6] = { 0, 1, 2, 0, 2, 3 };
+			for (uint32_t corner : corners)
+			{
+				indices.push_back(static_cast<uint32_t>(positions.size()));
+				positions.push_back(quad[corner]);
+			}
+		}
+	}
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t minTriangles = 1024;
+	uint32_t maxTriangles = 1024 * 1024;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-min=", minTriangles) && !readOption(argv[i], "-max=", maxTriangles))
+		{
+			printf("Usage: %s [-min=<triangles of the smallest mesh>] [-max=<triangles of the largest mesh>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!minTriangles || maxTriangles < minTriangles)
+	{
+		printf("The smallest mesh must have at least one triangle, and no more than the largest one\n");
+		return 1;
+	}
+
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices;
+	for (uint32_t targetTriangles = minTriangles; targetTriangles <= maxTriangles; targetTriangles *= 2)
+	{
+		createTorus(targetTriangles, positions, indices);
+		const uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+
+		// Repeat small meshes, so that every measurement takes a similar time.
+		const uint32_t numRepeats = std::max(1u, maxTriangles / targetTriangles);
+		uint32_t numVertices = 0;
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+		{
+			pvr::Volume volume;
+			volume.init(reinterpret_cast<const uint8_t*>(positions.data()), static_cast<uint32_t>(positions.size()), sizeof(glm::vec3), pvr::DataType::Float32,
+				reinterpret_cast<const uint8_t*>(indices.data()), numTriangles, pvr::IndexType::IndexType32Bit);
+			numVertices = volume.getVertexDataSize() / (2 * volume.getVertexDataStride());
+		}
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / numRepeats;
+		printf("%8u triangles: %10.3f ms  %7.1f ns/triangle  (%u vertices welded to %u)\n", numTriangles, milliseconds, milliseconds * 1e6 / numTriangles,
+			static_cast<uint32_t>(positions.size()), numVertices);
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,158 @@
+/*!
+\brief A command line tool comparing the cached world matrices of a Model (Model::getWorldMatrix, see
+PVRAssets/Model.h) with walking up the hierarchy on every query (Model::getWorldMatrixNoCache), while every node is
+animated every frame.
+\file PVRAssets/tools/PVRWorldMatrixBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRAssets/fileio/PODReader.h"
+#include "PVRAssets/Model.h"
+#include "PVRCore/stream/FileStream.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+typedef pvr::assets::Model::Node::InternalData NodeData;
+
+// A skeleton of numNodes bones: Chains of 8 bones (like a spine, or the bones of a limb down to the fingers), each
+// chain hanging from the middle of an earlier one.
+void createSkeleton(pvr::assets::Model& model, uint32_t numNodes)
+{
+	model.allocNodes(numNodes);
+	for (uint32_t i = 0; i < numNodes; ++i)
+	{
+		model.getNode(i).setParentID(i % 8 ? i - 1 : (i ? i / 2 : static_cast<uint32_t>(-1)));
+		NodeData& data = model.getNode(i).getInternalData();
+		data.transformFlags = NodeData::TransformFlags::SRT;
+		data.translation = glm::vec3(0.f, 1.f, 0.f);
+	}
+}
+
+uint32_t getMaxDepth(const pvr::assets::Model& model)
+{
+	uint32_t maxDepth = 0;
+	for (uint32_t i = 0; i < model.getNumNodes(); ++i)
+	{
+		uint32_t depth = 0;
+		for (uint32_t parent = model.getNode(i).getParentID(); parent < model.getNumNodes(); parent = model.getNode(parent).getParentID())
+		{
+			++depth;
+		}
+		maxDepth = std::max(maxDepth, depth);
+	}
+	return maxDepth;
+}
+
+// Move every node a little, as an animation playing on all of them would.
+void animate(pvr::assets::Model& model, uint32_t frame)
+{
+	for (uint32_t i = 0; i < model.getNumNodes(); ++i)
+	{
+		NodeData& data = model.getNode(i).getInternalData();
+		if (data.transformFlags != NodeData::TransformFlags::Matrix)
+		{
+			data.transformFlags |= NodeData::TransformFlags::Rotate;
+			data.rotation = glm::angleAxis(0.001f * (frame % 1000), glm::vec3(0.f, 0.f, 1.f));
+		}
+		data.setTransformDirty();
+	}
+}
+
+// Query the world matrix of every node numQueries times per frame (for example for the bones of a skin, a light
+// position and a bounding box), and return the average time per frame in microseconds.
+template<bool Cached>
+double run(pvr::assets::Model& model, uint32_t numFrames, uint32_t numQueries, float& checksum)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t frame = 0; frame < numFrames; ++frame)
+	{
+		animate(model, frame);
+		if (Cached)
+		{
+			model.updateWorldMatrices();
+		}
+		for (uint32_t query = 0; query < numQueries; ++query)
+		{
+			for (uint32_t i = 0; i < model.getNumNodes(); ++i)
+			{
+				checksum += (Cached ? model.getWorldMatrix(i) : model.getWorldMatrixNoCache(i))[3][1];
+			}
+		}
+	}
+	return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / numFrames;
+}
+
+void report(const char* name, pvr::assets::Model& model, uint32_t numFrames, uint32_t numQueries)
+{
+	float cachedChecksum = 0, uncachedChecksum = 0;
+	const double uncached = run<false>(model, numFrames, numQueries, uncachedChecksum);
+	const double cached = run<true>(model, numFrames, numQueries, cachedChecksum);
+	printf("%-40s %5u nodes, depth %2u: no cache %9.2f us/frame, cached %9.2f us/frame, speedup %6.2fx%s\n", name, model.getNumNodes(), getMaxDepth(model), uncached,
+		cached, uncached / cached, std::abs(cachedChecksum - uncachedChecksum) > 1e-3f * std::abs(uncachedChecksum) + 1e-3f ? "  MISMATCH" : "");
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numFrames = 1000;
+	uint32_t numQueries = 3;
+	uint32_t numBones = 128;
+	std::vector<std::string> filenames;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i][0] != '-')
+		{
+			filenames.push_back(argv[i]);
+		}
+		else if (!readOption(argv[i], "-frames=", numFrames) && !readOption(argv[i], "-queries=", numQueries) && !readOption(argv[i], "-bones=", numBones))
+		{
+			printf("Usage: %s [-frames=<frames>] [-queries=<queries of each node per frame>] [-bones=<bones of the generated skeleton>] [POD files...]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!numFrames || !numQueries)
+	{
+		printf("The number of frames and of queries must be greater than zero\n");
+		return 1;
+	}
+
+	printf("%u frames, every node animated and queried %u times per frame\n", numFrames, numQueries);
+	if (numBones)
+	{
+		pvr::assets::Model skeleton;
+		createSkeleton(skeleton, numBones);
+		report("generated skeleton", skeleton, numFrames, numQueries);
+	}
+	for (const std::string& filename : filenames)
+	{
+		try
+		{
+			pvr::assets::PODReader reader(pvr::FileStream::createFileStream(filename.c_str(), "rb"));
+			pvr::assets::ModelHandle model = pvr::assets::Model::createWithReader(reader);
+			const size_t slash = filename.find_last_of("/\\");
+			report(filename.c_str() + (slash == std::string::npos ? 0 : slash + 1), *model, numFrames, numQueries);
+		}
+		catch (const std::exception& e)
+		{
+			printf("%s: %s\n", filename.c_str(), e.what());
+		}
+	}
+	return 0;
+}
+//!\endcond
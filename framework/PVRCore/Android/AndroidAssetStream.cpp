@@ -94,4 +94,21 @@ size_t AndroidAssetStream::getSize() const
 	}
 	return 0;
 }
+
+const void* AndroidAssetStream::getMappedView(size_t offset, size_t size) const
+{
+	if (!_asset)
+	{
+		return NULL;
+	}
+	const size_t assetSize = static_cast<size_t>(AAsset_getLength(_asset));
+	if (offset > assetSize || size > assetSize - offset)
+	{
+		return NULL;
+	}
+	// Uncompressed assets are mapped directly from the package, compressed ones are inflated once into a buffer
+	// owned by the asset.
+	const void* buffer = AAsset_getBuffer(_asset);
+	return buffer ? static_cast<const unsigned char*>(buffer) + offset : NULL;
+}
 } // namespace pvr
\ No newline at end of file
@@ -42,6 +42,7 @@ public:
 	virtual bool isopen() const;
 	virtual size_t getPosition() const;
 	virtual size_t getSize() const;
+	virtual const void* getMappedView(size_t offset, size_t size) const;
         
         AAssetManager* getAndroidAssetManager()
         {
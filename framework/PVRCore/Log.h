@@ -73,6 +73,10 @@ enum class LogLevel
 	None = 100,
 };
 
+#if !defined(__ANDROID__) && !defined(__QNXNTO__)
+#include "PVRCore/LogAsync.h"
+#endif
+
 /// <summary>Represents an object capable of providing Logging functionality. This class is normally instantiated and
 /// configured, not inherited from. The components providing the Logging capability are contained in this class
 /// through interfaces, and as such can be replaced with custom components.</summary>
@@ -181,7 +185,7 @@ private:
 class Logger : public ILogger
 {
 public:
-	Logger()
+	Logger() : _asynchronous(false), _overflowPolicy(pvr::LogOverflowPolicy::Block)
 	{
 #if defined(PVR_PLATFORM_IS_DESKTOP) && !defined(TARGET_OS_MAC)
 		FILE* truncateme = fopen("log.txt", "w");
@@ -193,6 +197,38 @@ public:
 #endif
 	}
 
+	/// <summary>Switch between synchronous and asynchronous logging. Synchronous logging writes each message out
+	/// before returning. Asynchronous logging only formats the message into a ring buffer of the calling thread, and
+	/// a background thread writes the messages out in batches, so that logging from hot loops or from many threads does
+	/// not stall on I/O. Messages of each thread are written in order. Critical messages flush the log before returning.
+	/// Has no effect on Android and QNX, where the system logger is used.</summary>
+	/// <param name="asynchronous">True to log asynchronously, false to log synchronously (default)</param>
+	/// <param name="overflowPolicy">What to do if a thread logs faster than the messages can be written out</param>
+	void setAsynchronous(bool asynchronous, pvr::LogOverflowPolicy overflowPolicy = pvr::LogOverflowPolicy::Block)
+	{
+		flush();
+		_overflowPolicy = overflowPolicy;
+		_asynchronous = asynchronous;
+	}
+
+	/// <summary>Query if this logger logs asynchronously.</summary>
+	/// <returns>True if logging asynchronously, otherwise false</returns>
+	bool isAsynchronous() const
+	{
+		return _asynchronous;
+	}
+
+	/// <summary>Block until all messages logged so far have been written out. Only needed with asynchronous logging.</summary>
+	void flush() const
+	{
+#if !defined(__ANDROID__) && !defined(__QNXNTO__)
+		if (_asynchronous)
+		{
+			pvr::impl::AsyncLogWriter::instance().flush();
+		}
+#endif
+	}
+
 	/// <summary>Varargs version of the "output" function.</summary>
 	/// <param name="severity">The severity of the message. Apart from being output into the message, the severity is
 	/// used by the logger to discard log events less than a specified threshold. See setVerbosity(...)</param>
@@ -211,15 +247,29 @@ public:
 #elif defined(__QNXNTO__)
 			vslogf(1, messageTypes[static_cast<uint32_t>(severity)], formatString, argumentList);
 #else // Not android Not QNX
-			static char buffer[4096];
+			char buffer[4096];
 			va_list tempList;
-			memset(buffer, 0, sizeof(buffer));
 #if (defined _MSC_VER) // Pre VS2013
 			tempList = argumentList;
 #else
 			va_copy(tempList, argumentList);
 #endif
-			vsnprintf(buffer, 4095, formatString, argumentList);
+			vsnprintf(buffer, sizeof(buffer), formatString, argumentList);
+			buffer[sizeof(buffer) - 1] = '\0'; // _vsnprintf does not terminate truncated output
+			const size_t length = strlen(buffer);
+
+			if (_asynchronous)
+			{
+				va_end(tempList);
+				// Never drop critical messages
+				pvr::impl::AsyncLogWriter::instance().push(static_cast<uint32_t>(severity), buffer, static_cast<uint32_t>(length),
+					severity == LogLevel::Critical ? pvr::LogOverflowPolicy::Block : _overflowPolicy.load());
+				if (severity == LogLevel::Critical)
+				{
+					flush();
+				}
+				return;
+			}
 
 #if defined(_WIN32) && !defined(_CONSOLE)
 			if (isDebuggerPresent())
@@ -232,21 +282,17 @@ public:
 			vprintf(formatString, tempList);
 			printf("\n");
 #endif
+			va_end(tempList);
 #if defined(PVR_PLATFORM_IS_DESKTOP) && !defined(TARGET_OS_MAC)
-			{
-				FILE* file = fopen("log.txt", "a");
-				if (file)
-				{
-					fwrite(messageTypes[static_cast<int>(severity)], 1, strlen(messageTypes[static_cast<int>(severity)]), file);
-					fwrite(buffer, 1, strlen(buffer), file);
-					fwrite("\n", 1, 1, file);
-					fclose(file);
-				}
-			}
+			pvr::impl::LogFile::instance().write(messageTypes[static_cast<int>(severity)], buffer);
 #endif
 #endif
 		}
 	}
+
+private:
+	std::atomic<bool> _asynchronous; // Read by every thread logging, while any thread may toggle it
+	std::atomic<pvr::LogOverflowPolicy> _overflowPolicy;
 };
 
 /// <summary>The default logger object. This is the only way to get that object. Is global.</summary>
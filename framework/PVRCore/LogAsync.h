@@ -0,0 +1,400 @@
+/*!
+\brief Contains the backend used by the Logger for asynchronous logging: per-thread lock-free ring buffers drained by a
+background thread that keeps the log file open and writes messages out in batches. Included by Log.h.
+\file PVRCore/LogAsync.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <cstdlib>
+
+namespace pvr {
+/// <summary>What an asynchronous Logger does when a thread produces messages faster than they can be written out,
+/// i.e. when the ring buffer of the thread is full.</summary>
+enum class LogOverflowPolicy
+{
+	Block, //!< Wait for the background thread to make room. No messages are lost.
+	Drop, //!< Discard the message. The number of discarded messages is reported in the log.
+};
+
+//!\cond NO_DOXYGEN
+namespace impl {
+/// <summary>The log file. Kept open for the lifetime of the application instead of being opened for each message.
+/// Shared by synchronous and asynchronous logging. Never destroyed, so that the destructors of other statics can
+/// still log: Every write is flushed, so nothing is lost by never closing it.</summary>
+class LogFile
+{
+public:
+	static LogFile& instance()
+	{
+		static LogFile* file = new LogFile();
+		return *file;
+	}
+
+	void write(const char* prefix, const char* message)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (open())
+		{
+			fputs(prefix, _file);
+			fputs(message, _file);
+			fputc('\n', _file);
+			fflush(_file);
+		}
+	}
+
+	void write(const char* data, size_t size)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (size && open())
+		{
+			fwrite(data, 1, size, _file);
+			fflush(_file);
+		}
+	}
+
+private:
+	LogFile() : _file(nullptr), _failed(false) {}
+	bool open()
+	{
+		if (!_file && !_failed)
+		{
+			_file = fopen("log.txt", "a");
+			_failed = (_file == nullptr);
+		}
+		return _file != nullptr;
+	}
+	std::mutex _mutex;
+	FILE* _file;
+	bool _failed;
+};
+
+/// <summary>A single-producer, single-consumer ring buffer of variable length log records. The producer is the thread
+/// that owns it, the consumer is the background writer thread.</summary>
+class LogRingBuffer
+{
+public:
+	explicit LogRingBuffer(uint32_t capacity) : dropped(0), orphaned(false), _data(capacity), _mask(capacity - 1), _head(0), _tail(0) {}
+
+	/// <summary>Capacity in bytes (power of two)</summary>
+	uint32_t capacity() const
+	{
+		return _mask + 1;
+	}
+
+	/// <summary>Approximate number of bytes in use</summary>
+	uint32_t size() const
+	{
+		return static_cast<uint32_t>(_head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed));
+	}
+
+	/// <summary>Producer: Append a record. Returns false if there is not enough room.</summary>
+	bool tryPush(uint32_t severity, const char* text, uint32_t length)
+	{
+		const uint64_t recordSize = sizeof(Header) + align(length);
+		const uint64_t head = _head.load(std::memory_order_relaxed);
+		const uint64_t tail = _tail.load(std::memory_order_acquire);
+		uint64_t offset = head & _mask;
+		const uint64_t toEnd = capacity() - offset;
+		// Records are contiguous: If it does not fit before the end of the buffer, pad to the end and wrap around.
+		const uint64_t padding = (toEnd < recordSize) ? toEnd : 0;
+		if (capacity() - (head - tail) < recordSize + padding)
+		{
+			return false;
+		}
+		if (padding)
+		{
+			writeHeader(offset, PaddingRecord, static_cast<uint32_t>(padding - sizeof(Header)));
+			offset = 0;
+		}
+		writeHeader(offset, severity, length);
+		memcpy(&_data[offset + sizeof(Header)], text, length);
+		_head.store(head + padding + recordSize, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>Consumer: Call func(severity, text, length) for every record, in order, and free them.</summary>
+	template<typename Function>
+	void drain(Function&& func)
+	{
+		uint64_t tail = _tail.load(std::memory_order_relaxed);
+		const uint64_t head = _head.load(std::memory_order_acquire);
+		while (tail != head)
+		{
+			const uint64_t offset = tail & _mask;
+			Header header;
+			memcpy(&header, &_data[offset], sizeof(Header));
+			if (header.severity != PaddingRecord)
+			{
+				func(header.severity, &_data[offset + sizeof(Header)], header.length);
+			}
+			tail += sizeof(Header) + align(header.length);
+		}
+		_tail.store(tail, std::memory_order_release);
+	}
+
+	/// <summary>The largest message that can ever fit</summary>
+	uint32_t maxMessageLength() const
+	{
+		return capacity() / 2 - static_cast<uint32_t>(sizeof(Header));
+	}
+
+	std::atomic<uint32_t> dropped; //!< Number of messages discarded since the consumer last checked
+	std::atomic<bool> orphaned; //!< Set when the producer thread exits. The consumer removes the ring once drained.
+
+private:
+	struct Header
+	{
+		uint32_t length;
+		uint32_t severity;
+	};
+	enum : uint32_t
+	{
+		PaddingRecord = 0xFFFFFFFFu
+	};
+	static uint64_t align(uint64_t size)
+	{
+		return (size + sizeof(Header) - 1) & ~static_cast<uint64_t>(sizeof(Header) - 1);
+	}
+	void writeHeader(uint64_t offset, uint32_t severity, uint32_t length)
+	{
+		Header header = { length, severity };
+		memcpy(&_data[offset], &header, sizeof(Header));
+	}
+
+	std::vector<char> _data;
+	uint32_t _mask;
+	std::atomic<uint64_t> _head; // Written by the producer
+	std::atomic<uint64_t> _tail; // Written by the consumer
+};
+
+/// <summary>The background writer of asynchronous logging. Each thread that logs gets its own ring buffer (so
+/// producers never contend with each other, and messages of each thread stay in order). A single background thread
+/// drains all ring buffers and writes the messages out in batches. Messages of different threads are written in
+/// the order they are collected, which only approximates the order in which they were logged.
+/// The writer is never destroyed, as the destructors of other statics (for example the shared TaskScheduler) may still
+/// log. Instead, the background thread is stopped by an atexit handler, after which messages are written out
+/// synchronously by the thread logging them.</summary>
+class AsyncLogWriter
+{
+public:
+	/// <summary>Size of the ring buffer of each thread, in bytes</summary>
+	static const uint32_t ThreadBufferSize = 64 * 1024;
+
+	static AsyncLogWriter& instance()
+	{
+		static AsyncLogWriter* writer = new AsyncLogWriter();
+		return *writer;
+	}
+
+	/// <summary>Queue a message from the calling thread.</summary>
+	void push(uint32_t severity, const char* text, uint32_t length, LogOverflowPolicy policy)
+	{
+		if (_stopped.load(std::memory_order_acquire))
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			appendMessage(severity, text, length);
+			writeBatch();
+			return;
+		}
+		LogRingBuffer& ring = threadRing();
+		length = std::min(length, ring.maxMessageLength());
+		while (!ring.tryPush(severity, text, length))
+		{
+			_wakeWriter.notify_one();
+			if (policy == LogOverflowPolicy::Drop)
+			{
+				ring.dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			std::this_thread::yield();
+		}
+		// Do not pay for a wake-up per message: The writer polls periodically. Only hurry it if the ring is filling up.
+		if (ring.size() > ring.capacity() / 2)
+		{
+			_wakeWriter.notify_one();
+		}
+	}
+
+	/// <summary>Block until all messages queued before this call have been written out.</summary>
+	void flush()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (!_thread.joinable())
+		{
+			return;
+		}
+		const uint64_t request = ++_flushRequested;
+		_wakeWriter.notify_one();
+		_flushed.wait(lock, [&] { return _flushCompleted >= request; });
+	}
+
+private:
+	struct ThreadRing
+	{
+		std::shared_ptr<LogRingBuffer> ring;
+		~ThreadRing()
+		{
+			if (ring)
+			{
+				ring->orphaned.store(true, std::memory_order_release);
+			}
+		}
+	};
+
+	AsyncLogWriter() : _stopped(false), _done(false), _flushRequested(0), _flushCompleted(0)
+	{
+		atexit(&AsyncLogWriter::stopAtExit);
+	}
+
+	// Write out everything queued, stop the background thread and log synchronously from then on.
+	static void stopAtExit()
+	{
+		AsyncLogWriter& writer = instance();
+		std::unique_lock<std::mutex> lock(writer._mutex);
+		writer._stopped.store(true, std::memory_order_release);
+		writer._done = true;
+		writer._wakeWriter.notify_one();
+		if (writer._thread.joinable())
+		{
+			lock.unlock();
+			writer._thread.join();
+			lock.lock();
+		}
+		// Messages pushed while the thread was stopping
+		for (auto& ring : writer._rings)
+		{
+			writer.collect(*ring);
+		}
+		writer._rings.clear();
+		writer.writeBatch();
+	}
+
+	LogRingBuffer& threadRing()
+	{
+		thread_local ThreadRing threadRing;
+		if (!threadRing.ring)
+		{
+			threadRing.ring = std::make_shared<LogRingBuffer>(static_cast<uint32_t>(ThreadBufferSize));
+			std::lock_guard<std::mutex> lock(_mutex);
+			_rings.push_back(threadRing.ring);
+			if (!_thread.joinable())
+			{
+				_thread = std::thread(&AsyncLogWriter::run, this);
+			}
+		}
+		return *threadRing.ring;
+	}
+
+	void collect(LogRingBuffer& ring)
+	{
+		ring.drain([&](uint32_t severity, const char* text, uint32_t length) { appendMessage(severity, text, length); });
+		const uint32_t dropped = ring.dropped.exchange(0, std::memory_order_relaxed);
+		if (dropped)
+		{
+			char message[128];
+			int length = snprintf(message, sizeof(message), "%s%u log messages were dropped because the log buffer was full\n",
+				messageTypes[static_cast<uint32_t>(LogLevel::Warning)], dropped);
+			_fileBatch.insert(_fileBatch.end(), message, message + length);
+			_consoleBatch.insert(_consoleBatch.end(), message, message + length);
+		}
+	}
+
+	void appendMessage(uint32_t severity, const char* text, uint32_t length)
+	{
+		const char* prefix = messageTypes[severity];
+		_fileBatch.insert(_fileBatch.end(), prefix, prefix + strlen(prefix));
+		_fileBatch.insert(_fileBatch.end(), text, text + length);
+		_fileBatch.push_back('\n');
+		_consoleBatch.insert(_consoleBatch.end(), text, text + length);
+		_consoleBatch.push_back('\n');
+	}
+
+	void writeBatch()
+	{
+		if (_consoleBatch.size())
+		{
+#if defined(_WIN32) && !defined(_CONSOLE)
+			_consoleBatch.push_back('\0');
+			OutputDebugString(_consoleBatch.data());
+#else
+			fwrite(_consoleBatch.data(), 1, _consoleBatch.size(), stdout);
+			fflush(stdout);
+#endif
+		}
+#if defined(PVR_PLATFORM_IS_DESKTOP) && !defined(TARGET_OS_MAC)
+		LogFile::instance().write(_fileBatch.data(), _fileBatch.size());
+#endif
+		_consoleBatch.clear();
+		_fileBatch.clear();
+	}
+
+	void run()
+	{
+		std::vector<std::shared_ptr<LogRingBuffer> > rings;
+		std::unique_lock<std::mutex> lock(_mutex);
+		for (;;)
+		{
+			_wakeWriter.wait_for(lock, std::chrono::milliseconds(10), [&] { return _done || _flushRequested != _flushCompleted; });
+			const bool done = _done;
+			const uint64_t flushRequest = _flushRequested;
+			rings = _rings;
+			lock.unlock();
+
+			for (auto& ring : rings)
+			{
+				// Read the orphaned flag before draining: Once set, the thread will not push anything more.
+				const bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+				collect(*ring);
+				if (!orphaned)
+				{
+					ring.reset();
+				}
+			}
+			writeBatch();
+
+			lock.lock();
+			// Rings still held in the local list are orphaned and fully drained
+			for (auto& ring : rings)
+			{
+				if (ring)
+				{
+					_rings.erase(std::find(_rings.begin(), _rings.end(), ring));
+				}
+			}
+			rings.clear();
+			_flushCompleted = flushRequest;
+			_flushed.notify_all();
+			if (done)
+			{
+				break;
+			}
+		}
+	}
+
+	std::atomic<bool> _stopped; // Set once the background thread is stopped at exit
+	std::mutex _mutex;
+	std::condition_variable _wakeWriter;
+	std::condition_variable _flushed;
+	std::vector<std::shared_ptr<LogRingBuffer> > _rings;
+	std::thread _thread;
+	bool _done;
+	uint64_t _flushRequested;
+	uint64_t _flushCompleted;
+	std::vector<char> _consoleBatch;
+	std::vector<char> _fileBatch;
+};
+} // namespace impl
+//!\endcond
+} // namespace pvr
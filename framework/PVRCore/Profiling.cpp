@@ -0,0 +1,268 @@
+/*!
+\brief Implementation of the profiler scopes and of the Chrome trace export.
+\file PVRCore/Profiling.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/Profiling.h"
+#include "PVRCore/stream/FileStream.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pvr {
+namespace profiling {
+namespace impl {
+std::atomic<bool> enabled(false);
+} // namespace impl
+
+namespace {
+struct Event
+{
+	const char* name;
+	const char* category;
+	uint64_t startNs;
+	uint64_t durationNs;
+	uint32_t depth;
+};
+
+// The events of a thread. Only its thread writes to it, appending events and then publishing them by incrementing
+// the count, so exporting can read every published event without stopping the thread. Its storage is allocated in chunks that are
+// never moved or freed while the application runs, and it outlives its thread so that the trace can be written after
+// worker threads have exited.
+struct ThreadBuffer
+{
+	static const uint32_t ChunkSize = 4096;
+	static const uint32_t MaxChunks = 64;
+
+	std::atomic<Event*> chunks[MaxChunks];
+	std::atomic<uint32_t> count; // The number of events published
+	std::atomic<uint32_t> begin; // The first event not discarded by clear()
+	uint32_t id;
+	std::string name; // Guarded by the mutex of the Registry
+
+	explicit ThreadBuffer(uint32_t id) : count(0), begin(0), id(id)
+	{
+		for (uint32_t i = 0; i < MaxChunks; ++i)
+		{
+			chunks[i].store(nullptr, std::memory_order_relaxed);
+		}
+	}
+	~ThreadBuffer()
+	{
+		for (uint32_t i = 0; i < MaxChunks; ++i)
+		{
+			delete[] chunks[i].load(std::memory_order_relaxed);
+		}
+	}
+};
+
+struct Registry
+{
+	std::mutex mutex; // Only taken when a thread records its first event, names itself, or on export
+	std::vector<std::unique_ptr<ThreadBuffer> > threads;
+	std::atomic<uint64_t> numDropped;
+	uint64_t originNs; // Trace timestamps are relative to this
+
+	Registry() : numDropped(0), originNs(now()) {}
+};
+
+Registry& registry()
+{
+	static Registry instance;
+	return instance;
+}
+
+thread_local ThreadBuffer* currentThreadBuffer = nullptr;
+thread_local uint32_t currentDepth = 0;
+
+ThreadBuffer& getThreadBuffer()
+{
+	if (!currentThreadBuffer)
+	{
+		Registry& reg = registry();
+		std::lock_guard<std::mutex> lock(reg.mutex);
+		reg.threads.emplace_back(new ThreadBuffer(static_cast<uint32_t>(reg.threads.size() + 1)));
+		currentThreadBuffer = reg.threads.back().get();
+	}
+	return *currentThreadBuffer;
+}
+
+void record(const char* name, const char* category, uint64_t startNs, uint64_t durationNs, uint32_t depth)
+{
+	ThreadBuffer& buffer = getThreadBuffer();
+	uint32_t index = buffer.count.load(std::memory_order_relaxed);
+	if (index != 0 && buffer.begin.load(std::memory_order_relaxed) == index)
+	{
+		// clear() discarded every event of this thread, so its storage is reused from the start. Exporting is the only
+		// other reader of the events, and holds the mutex while it reads them. begin only changes under the mutex, to
+		// count, which only this thread changes, so it is still equal.
+		std::lock_guard<std::mutex> lock(registry().mutex);
+		buffer.begin.store(0, std::memory_order_relaxed);
+		buffer.count.store(0, std::memory_order_relaxed);
+		index = 0;
+	}
+	if (index >= ThreadBuffer::ChunkSize * ThreadBuffer::MaxChunks)
+	{
+		registry().numDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	std::atomic<Event*>& chunk = buffer.chunks[index / ThreadBuffer::ChunkSize];
+	Event* events = chunk.load(std::memory_order_relaxed);
+	if (!events)
+	{
+		events = new Event[ThreadBuffer::ChunkSize];
+		chunk.store(events, std::memory_order_release);
+	}
+	Event& event = events[index % ThreadBuffer::ChunkSize];
+	event.name = name;
+	event.category = category;
+	event.startNs = startNs;
+	event.durationNs = durationNs;
+	event.depth = depth;
+	buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void appendFormat(std::string& out, const char* format, ...)
+{
+	char buffer[256];
+	va_list args;
+	va_start(args, format);
+	const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+	if (length > 0)
+	{
+		out.append(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+	}
+}
+
+void appendJsonString(std::string& out, const char* value)
+{
+	out += '"';
+	for (; value && *value; ++value)
+	{
+		const char c = *value;
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+			out += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			appendFormat(out, "\\u%04x", c);
+		}
+		else
+		{
+			out += c;
+		}
+	}
+	out += '"';
+}
+
+// Writes out what has been gathered so far once it gets large, so that long traces are not held in memory twice.
+void flush(Stream& stream, std::string& json, size_t threshold)
+{
+	if (json.size() >= threshold)
+	{
+		if (!json.empty())
+		{
+			stream.writeExact(1, json.size(), json.data());
+		}
+		json.clear();
+	}
+}
+} // namespace
+
+namespace impl {
+void enterScope()
+{
+	++currentDepth;
+}
+
+void leaveScope(const char* name, const char* category, uint64_t startNs)
+{
+	const uint64_t endNs = now();
+	record(name, category, startNs, endNs - startNs, --currentDepth);
+}
+} // namespace impl
+
+void setEnabled(bool enable)
+{
+	registry(); // Fixes the origin of the timestamps before anything is recorded
+	impl::enabled.store(enable, std::memory_order_relaxed);
+}
+
+void setThreadName(const std::string& name)
+{
+	ThreadBuffer& buffer = getThreadBuffer();
+	std::lock_guard<std::mutex> lock(registry().mutex);
+	buffer.name = name;
+}
+
+void clear()
+{
+	Registry& reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+	for (const std::unique_ptr<ThreadBuffer>& buffer : reg.threads)
+	{
+		buffer->begin.store(buffer->count.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+}
+
+uint64_t getNumDroppedEvents()
+{
+	return registry().numDropped.load(std::memory_order_relaxed);
+}
+
+void writeChromeTrace(Stream& stream)
+{
+	const size_t FlushThreshold = 1 << 16;
+	Registry& reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex);
+
+	std::string json;
+	json.reserve(FlushThreshold + 1024);
+	json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const std::unique_ptr<ThreadBuffer>& buffer : reg.threads)
+	{
+		if (!buffer->name.empty())
+		{
+			json += first ? "\n" : ",\n";
+			appendFormat(json, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", buffer->id);
+			appendJsonString(json, buffer->name.c_str());
+			json += "}}";
+			first = false;
+		}
+		const uint32_t end = buffer->count.load(std::memory_order_acquire);
+		for (uint32_t index = buffer->begin.load(std::memory_order_relaxed); index < end; ++index)
+		{
+			const Event& event = buffer->chunks[index / ThreadBuffer::ChunkSize].load(std::memory_order_acquire)[index % ThreadBuffer::ChunkSize];
+			json += first ? "\n{\"name\":" : ",\n{\"name\":";
+			appendJsonString(json, event.name);
+			json += ",\"cat\":";
+			appendJsonString(json, event.category);
+			// Timestamps are relative to the first call to setEnabled(), which precedes every event.
+			const uint64_t startNs = event.startNs > reg.originNs ? event.startNs - reg.originNs : 0;
+			appendFormat(json, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"depth\":%u}}", startNs * 1e-3, event.durationNs * 1e-3, buffer->id, event.depth);
+			first = false;
+			flush(stream, json, FlushThreshold);
+		}
+	}
+	appendFormat(json, "\n],\"otherData\":{\"droppedEvents\":%llu}}\n", static_cast<unsigned long long>(reg.numDropped.load(std::memory_order_relaxed)));
+	flush(stream, json, 0);
+}
+
+void writeChromeTrace(const std::string& path)
+{
+	FileStream stream(path, "w");
+	stream.open();
+	writeChromeTrace(stream);
+}
+} // namespace profiling
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,121 @@
+/*!
+\brief Contains a lightweight hierarchical CPU profiler: scoped timers recording into per-thread lock-free event
+buffers, exported as a Chrome trace (chrome://tracing, Perfetto).
+\file PVRCore/Profiling.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/stream/Stream.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace pvr {
+namespace profiling {
+//!\cond NO_DOXYGEN
+namespace impl {
+extern std::atomic<bool> enabled;
+void enterScope();
+void leaveScope(const char* name, const char* category, uint64_t startNs);
+} // namespace impl
+//!\endcond
+
+/// <summary>Get the current time of the profiler clock.</summary>
+/// <returns>A monotonic time in nanoseconds.</returns>
+inline uint64_t now()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// <summary>Check if scopes are being recorded.</summary>
+/// <returns>True if recording is enabled.</returns>
+inline bool isEnabled()
+{
+	return impl::enabled.load(std::memory_order_relaxed);
+}
+
+/// <summary>Start or stop recording scopes. Recording is disabled by default. Scopes already open when recording
+/// starts are not recorded.</summary>
+/// <param name="enable">True to record, false to stop.</param>
+void setEnabled(bool enable);
+
+/// <summary>Name the calling thread in the exported traces.</summary>
+/// <param name="name">The name of the thread.</param>
+void setThreadName(const std::string& name);
+
+/// <summary>Discard every event recorded so far, e.g. at the end of the startup of an application to trace only its
+/// frames. Events being recorded concurrently by other threads may or may not be discarded. Each thread keeps up to
+/// 262144 events and drops the rest. The space of its discarded events is reused when it next records one.</summary>
+void clear();
+
+/// <summary>Get the number of events that were discarded because the buffer of their thread was full.</summary>
+/// <returns>The number of events dropped since the start of the application.</returns>
+uint64_t getNumDroppedEvents();
+
+/// <summary>Write the recorded events of every thread as a Chrome trace JSON object. Can be called while other
+/// threads are recording, in which case it writes the events completed when it started.</summary>
+/// <param name="stream">The stream to write to.</param>
+void writeChromeTrace(Stream& stream);
+
+/// <summary>Write the recorded events of every thread to a Chrome trace JSON file.</summary>
+/// <param name="path">The path of the file to write.</param>
+void writeChromeTrace(const std::string& path);
+
+/// <summary>Times the code from its construction to its destruction as an event of the calling thread. Scopes nest:
+/// a scope opened while another is open on the same thread is recorded as its child. Only records if profiling is
+/// enabled when it is constructed. Normally used through the PVR_PROFILE_SCOPE macros, which compile to nothing
+/// unless PVR_ENABLE_PROFILING is defined.</summary>
+class Scope
+{
+public:
+	/// <summary>Constructor. Opens the scope.</summary>
+	/// <param name="name">The name of the scope. Must outlive the export of the trace, e.g. a string literal.</param>
+	/// <param name="category">The category of the scope. Must outlive the export of the trace, e.g. a string
+	/// literal.</param>
+	explicit Scope(const char* name, const char* category = "pvr") : _name(name), _category(category), _startNs(0)
+	{
+		if (isEnabled())
+		{
+			impl::enterScope();
+			_startNs = now();
+		}
+	}
+
+	/// <summary>Destructor. Closes the scope and records it.</summary>
+	~Scope()
+	{
+		if (_startNs)
+		{
+			impl::leaveScope(_name, _category, _startNs);
+		}
+	}
+
+private:
+	Scope(const Scope&);
+	Scope& operator=(const Scope&);
+	const char* _name;
+	const char* _category;
+	uint64_t _startNs;
+};
+} // namespace profiling
+} // namespace pvr
+
+//!\cond NO_DOXYGEN
+#define PVR_PROFILE_CONCAT_IMPL(a, b) a##b
+#define PVR_PROFILE_CONCAT(a, b) PVR_PROFILE_CONCAT_IMPL(a, b)
+//!\endcond
+
+#if defined(PVR_ENABLE_PROFILING)
+/// <summary>Time the rest of the enclosing block as a scope named name (a string literal).</summary>
+#define PVR_PROFILE_SCOPE(name) ::pvr::profiling::Scope PVR_PROFILE_CONCAT(pvrProfileScope, __LINE__)(name)
+/// <summary>Time the rest of the enclosing block as a scope named name in category (both string literals).</summary>
+#define PVR_PROFILE_SCOPE_CATEGORY(name, category) ::pvr::profiling::Scope PVR_PROFILE_CONCAT(pvrProfileScope, __LINE__)(name, category)
+/// <summary>Time the rest of the enclosing function as a scope named after it.</summary>
+#define PVR_PROFILE_FUNCTION() ::pvr::profiling::Scope PVR_PROFILE_CONCAT(pvrProfileScope, __LINE__)(__FUNCTION__)
+#else
+#define PVR_PROFILE_SCOPE(name) static_cast<void>(0)
+#define PVR_PROFILE_SCOPE_CATEGORY(name, category) static_cast<void>(0)
+#define PVR_PROFILE_FUNCTION() static_cast<void>(0)
+#endif
@@ -1,12 +1,13 @@
 /*!
-\brief MultiThreading tools, including abstract classes for tasks and scheduling, and adaptation of
-MoodyCamel's BlockingConcurrentQueue, and
+\brief MultiThreading tools, including abstract classes for tasks and scheduling, an adaptation of
+MoodyCamel's BlockingConcurrentQueue, and a fixed capacity, allocation free alternative to it.
 \file PVRCore/Threading.h
 \author PowerVR by Imagination, Developer Technology Team
 \copyright Copyright (c) Imagination Technologies Limited.
 */
 #pragma once
 #include "PVRCore/RefCounted.h"
+#include "PVRCore/Profiling.h"
 #include "../external/concurrent_queue/blockingconcurrentqueue.h"
 
 #include <thread>
@@ -15,6 +16,11 @@ MoodyCamel's BlockingConcurrentQueue, and
 #include <condition_variable>
 #include <sstream>
 #include <deque>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <exception>
 
 //  ASYNCHRONOUS FRAMEWORK: Framework async loader base etc //
 namespace pvr {
@@ -145,6 +151,21 @@ public:
 	{
 		return _successful;
 	}
+	/// <summary>Request that the task is not executed. Cancellation only succeeds if the task has not yet started:
+	/// a cancelled task is still completed (so get() will not block forever, and the callback is still called), but
+	/// without performing any work, and is never successful.</summary>
+	/// <returns>True if the task was cancelled, false if it had already started executing</returns>
+	bool cancel()
+	{
+		uint32_t expected = StatePending;
+		return _state.compare_exchange_strong(expected, StateCancelled);
+	}
+	/// <summary>Query if the task was cancelled before it started executing.</summary>
+	/// <returns>True if the task was cancelled, otherwise false</returns>
+	bool isCancelled() const
+	{
+		return _state == StateCancelled;
+	}
 
 protected:
 	Callback _completionCallback; //!< The callback that will be called on completion
@@ -170,10 +191,26 @@ protected:
 		}
 	}
 
-	IFrameworkAsyncResult() : _completionCallback(nullptr), _inCallback(false), _successful(false), _isComplete(false) {}
+	/// <summary>Implementations must call this function before performing the task. If it returns false, the task
+	/// was cancelled: skip the work, but still signal completion.</summary>
+	/// <returns>True if the work should be performed, false if the task was cancelled</returns>
+	bool beginExecution()
+	{
+		uint32_t expected = StatePending;
+		return _state.compare_exchange_strong(expected, StateRunning);
+	}
+
+	IFrameworkAsyncResult() : _completionCallback(nullptr), _inCallback(false), _successful(false), _isComplete(false), _state(StatePending) {}
 
 private:
+	enum
+	{
+		StatePending,
+		StateRunning,
+		StateCancelled
+	};
 	mutable bool _isComplete;
+	std::atomic<uint32_t> _state;
 
 	/// <summary>Implement this by returning true if the task is complete (successful or not). Return false
 	/// if the task is not complete (is still running). True should imply that, as far as practical, get()
@@ -187,11 +224,22 @@ private:
 	virtual T get_() const = 0;
 };
 
-/// <summary>The AsyncScheduler is an abstract Scheduling system of a homogeneous task queue running on a background
-/// thread, i.e. a queue of work of a particular type. It provides its child classes wioth access to the actual queue
-/// and the synchronization semaphores in order to facilitate easier implementation. Specifically, it is expected that
-/// the user will provide functions to enqueue and dequeue work, while this class provides the running loop (actually
-/// executing the tasks, calling the callbacks etc</summary>
+/// <summary>The priority with which a task is scheduled on an AsyncScheduler. Workers always pick the highest
+/// priority task available, first from their own queue and then by stealing from the other workers.</summary>
+enum class TaskPriority : uint32_t
+{
+	Low = 0, //!< Background work that can wait until everything else is done
+	Normal = 1, //!< Default priority
+	High = 2, //!< Work that the application is (or soon will be) blocked on
+	Count = 3 //!< Number of priority levels
+};
+
+/// <summary>The AsyncScheduler is an abstract Scheduling system of a homogeneous task queue running on a pool of
+/// background threads, i.e. a queue of work of a particular type. Each worker thread owns a queue (one deque per
+/// priority level). Work is distributed round-robin between the worker queues, and a worker that runs out of work
+/// steals from the back of the other workers' queues, so that the pool stays busy even if tasks have very different
+/// costs. Child classes are expected to provide functions that create the futures and schedule them with enqueue(),
+/// while this class provides the running loop (actually executing the tasks, calling the callbacks etc)</summary>
 /// <typeparam name="ValueType">The type of the return value that will be returned by the functions</typeparam>
 /// <typeparam name="FutureType">The type of the future (which will also be the input to the worker function)</typeparam>
 /// <typeparam name="worker">The function pointer that will be called to perform the work</typeparam>
@@ -206,7 +254,7 @@ public:
 	/// <returns>The number of queued items (currently visible to this thread)</returns>
 	uint32_t getNumApproxQueuedItem()
 	{
-		return static_cast<uint32_t>(_queue.size());
+		return _numQueued.load(std::memory_order_relaxed);
 	}
 
 	/// <summary>The precise number of queued items at the time of calling. Although it is poosible
@@ -216,118 +264,658 @@ public:
 	/// <returns>The number of queued items (access is synchronized)</returns>
 	uint32_t getNumQueuedItems()
 	{
-		_queueSemaphore.wait();
-		uint32_t retval = static_cast<uint32_t>(_queue.size());
-		_queueSemaphore.signal();
-		return retval;
+		std::vector<std::unique_lock<std::mutex> > locks;
+		locks.reserve(_numWorkers);
+		size_t retval = 0;
+		for (uint32_t i = 0; i < _numWorkers; ++i)
+		{
+			locks.emplace_back(_queues[i].mutex);
+			for (uint32_t priority = 0; priority < static_cast<uint32_t>(TaskPriority::Count); ++priority)
+			{
+				retval += _queues[i].tasks[priority].size();
+			}
+		}
+		return static_cast<uint32_t>(retval);
 	}
 
-	/// <summary>Destructor (virtual)</summary>
+	/// <summary>The number of worker threads executing the tasks of this scheduler.</summary>
+	/// <returns>The number of worker threads</returns>
+	uint32_t getNumWorkers() const
+	{
+		return _numWorkers;
+	}
+
+	/// <summary>Destructor (virtual). Waits for all queued work to complete, then joins the worker threads.</summary>
 	virtual ~AsyncScheduler()
 	{
-		bool didit = false;
-		_queueSemaphore.wait(); // protect the _done variable
-		if (!_done)
+		if (!_done.exchange(true)) // Only join if it was actually running.
 		{
-			didit = true;
-			_done = true;
-			_workSemaphore.signal();
+			// One extra signal per worker: A worker that is signalled but finds all the queues empty exits.
+			_workSemaphore.signal(static_cast<int>(_numWorkers));
+			for (std::thread& thread : _threads)
+			{
+				thread.join();
+			}
 		}
-		_queueSemaphore.signal();
-		if (didit) // Only join if it was actually running. Duh!
+		Log(LogLevel::Information, "%s: Asynchronous scheduler closing down. Freeing workers.", _myInfo.c_str());
+	}
+
+protected:
+	/// <summary>Constructor. Spawns the worker threads, which will be sleeping as long as no work is scheduled.</summary>
+	/// <param name="numWorkers">The number of worker threads. If 0, one worker per hardware thread is spawned.</param>
+	explicit AsyncScheduler(uint32_t numWorkers = 0)
+		: _numWorkers(numWorkers ? numWorkers : std::max(std::thread::hardware_concurrency(), 1u)), _queues(new WorkerQueue[_numWorkers]), _numQueued(0),
+		  _nextQueue(0), _done(false)
+	{
+		Log(LogLevel::Information,
+			"Asynchronous Scheduler starting. %u worker thread(s) spawned. The worker threads will be sleeping as long as no work is being performed, "
+			"and will be released when the async sheduler is destroyed.",
+			_numWorkers);
+		_threads.reserve(_numWorkers);
+		for (uint32_t i = 0; i < _numWorkers; ++i)
 		{
-			_thread.join();
+			_threads.emplace_back(&AsyncScheduler::run, this, i);
 		}
 	}
 
-protected:
-	/// <summary>Constructor (empty, spawns worker thread and waits)</summary>
-	AsyncScheduler()
+	/// <summary>Schedule a future to be processed by the worker function on one of the worker threads.</summary>
+	/// <param name="future">The future to schedule. Will be passed to the worker function.</param>
+	/// <param name="priority">The priority of the task</param>
+	void enqueue(const FutureType& future, TaskPriority priority = TaskPriority::Normal)
 	{
-		_done = false;
-		_thread = std::thread(&AsyncScheduler::run, this);
+		WorkerQueue& queue = _queues[_nextQueue.fetch_add(1, std::memory_order_relaxed) % _numWorkers];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks[static_cast<uint32_t>(priority)].push_back(future);
+		}
+		_numQueued.fetch_add(1, std::memory_order_relaxed);
+		_workSemaphore.signal(); // Exactly one signal per task.
 	}
 
-	/// <summary>This semaphore is the counter for enqueued work. Signal it once when adding work to the queue.</summary>
+	/// <summary>This semaphore is the counter for enqueued work. It is signalled once for each task enqueued.</summary>
 	Semaphore _workSemaphore;
-	/// <summary>This is basically a mutex for the queue. Wait on it to lock the queue, then signal it when done.</summary>
-	Semaphore _queueSemaphore;
-	/// <summary>This is the work queue. Each item enqueued will be processed by worker.</summary>
-	std::deque<FutureType> _queue;
 	/// <summary>String information regarding the tasks operations.</summary>
 	std::string _myInfo;
 
 private:
-	std::thread _thread;
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<FutureType> tasks[static_cast<uint32_t>(TaskPriority::Count)];
+	};
+
+	uint32_t _numWorkers;
+	std::unique_ptr<WorkerQueue[]> _queues;
+	std::vector<std::thread> _threads;
+	std::atomic<uint32_t> _numQueued;
+	std::atomic<uint32_t> _nextQueue;
 	std::atomic_bool _done;
-	void run()
+
+	// Take the highest priority task available. A worker first looks at its own queue (taking the oldest task) and then
+	// steals from the other workers (taking their newest task).
+	bool tryDequeue(uint32_t workerIndex, FutureType& future)
 	{
-		Log(LogLevel::Information,
-			"%s : Asynchronous Scheduler starting. "
-			"1 worker thread spawned. The worker thread will be sleeping as long as no work is being performed, "
-			"and will be released when the async sheduler is destroyed.",
-			_myInfo.c_str());
-
-		std::string _str_0_unlock_ = (_myInfo + " : LOOP ENTER: Unlocking the queue.");
-		std::string _str_1_wait_work_ = (_myInfo + " : Queue unlocked, waiting for work to be scheduled");
-		std::string _str_2_queuelock_ = (_myInfo + " : Work scheduled, Obtaining queue lock");
-		std::string _str_3_queueLocked_ = (_myInfo + " : Queue lock obtained, testing to determine work/exit");
-		std::string _str_4_exit_signal_ = (_myInfo + " : Queue was signalled without items - must be the exit signal. Exiting...");
-		std::string _str_5_obtaining_work_ = (_myInfo + " : Queue had items: Obtaining work!");
-		std::string _str_6_obtained_work_ = (_myInfo + " : Work obtained, Releasing the queue.");
-		std::string _str_7_executing_work_ = (_myInfo + " : Queue released, Executing work.");
-		std::string _str_8_execution_done_ = (_myInfo + " : Work execution done, locking the queue.");
-		std::string _str_9_looping_up_ = (_myInfo + " : Queue locked, LOOPING!");
-
-		// Are we done?
-		// a) The queue will be empty on the first iteration.
-		// b) Even if the queue is empty, consumers may be blocked on results.
-		// c) Even if done, consumers may be blocked on results.
-		while (!_done || _queue.size())
+		for (uint32_t priority = static_cast<uint32_t>(TaskPriority::Count); priority-- > 0;)
+		{
+			for (uint32_t i = 0; i < _numWorkers; ++i)
+			{
+				WorkerQueue& queue = _queues[(workerIndex + i) % _numWorkers];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				std::deque<FutureType>& tasks = queue.tasks[priority];
+				if (!tasks.empty())
+				{
+					if (i == 0)
+					{
+						future = std::move(tasks.front());
+						tasks.pop_front();
+					}
+					else
+					{
+						future = std::move(tasks.back());
+						tasks.pop_back();
+					}
+					_numQueued.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void run(uint32_t workerIndex)
+	{
+#if defined(PVR_ENABLE_PROFILING)
+		if (profiling::isEnabled())
+		{
+			profiling::setThreadName("AsyncScheduler worker " + std::to_string(workerIndex));
+		}
+#endif
+		for (;;)
 		{
-			DebugLog(_str_0_unlock_.c_str());
-			_queueSemaphore.signal(); // First iteration: Signal that we are actually waiting on the queue, essentially priming it,
-			// consumers to start adding items.
-			// Subsequent iterations: Release the check we are doing on the queue.
-			DebugLog(_str_1_wait_work_.c_str());
 			_workSemaphore.wait(); // Wait for work to arrive
-			DebugLog(_str_2_queuelock_.c_str());
-			_queueSemaphore.wait(); // Work has arrived! Or has it? Lock the queue, as we need to check that it is not empty,
-			DebugLog(_str_3_queueLocked_.c_str());
-			// and to unqueue items.
-			if (!_queue.size()) // Are we done? Was this a signal for work or for us to finish?
+
+			// Every signal before shutdown is matched by a task, so one is guaranteed to be available - but it may
+			// be in flight between queues while another worker steals. Only give up once shutting down and the
+			// queues are drained.
+			FutureType future;
+			bool hasWork;
+			while (!(hasWork = tryDequeue(workerIndex, future)) && !_done)
 			{
-				DebugLog(_str_4_exit_signal_.c_str());
-				// Someone signalled the queue without putting items in. This means we are finished.
-				assertion(_done); // duh?
-				break;
+				std::this_thread::yield();
 			}
-			else // Yay! Work to do!
+			if (!hasWork)
 			{
-				DebugLog(_str_5_obtaining_work_.c_str());
-
-				FutureType future = std::move(_queue.front()); // Get work.
-				_queue.pop_front();
-				DebugLog(_str_6_obtained_work_.c_str());
-				_queueSemaphore.signal(); // Release the krak... QUEUE.
-				DebugLog(_str_7_executing_work_.c_str());
-				worker(future); // Load a texture! Yay!
-				DebugLog(_str_8_execution_done_.c_str());
+				break;
 			}
-			_queueSemaphore.wait(); // Continue. Lock the queue to check it out.
-			DebugLog(_str_9_looping_up_.c_str());
+			PVR_PROFILE_SCOPE_CATEGORY("AsyncScheduler job", "async");
+			worker(future);
 		}
-		_queueSemaphore.signal(); // Finish. Release the queue.
-		Log(LogLevel::Information, "%s: Asynchronous asset loader closing down. Freeing workers.", _myInfo.c_str());
 	}
 };
+
+/// <summary>The worker function of a TaskScheduler: Calls the task.</summary>
+/// <param name="task">The task to execute</param>
+inline void executeTask(std::function<void()> task)
+{
+	task();
+}
+
+/// <summary>An AsyncScheduler executing arbitrary functions, for work that does not need futures, such as splitting
+/// a loop over the worker threads (see parallelFor).</summary>
+class TaskScheduler : public AsyncScheduler<void, std::function<void()>, &executeTask>
+{
+public:
+	/// <summary>Constructor. Spawns the worker threads.</summary>
+	/// <param name="numWorkers">The number of worker threads. If 0, one worker per hardware thread is spawned.</param>
+	explicit TaskScheduler(uint32_t numWorkers = 0) : AsyncScheduler(numWorkers)
+	{
+		_myInfo = "TaskScheduler";
+	}
+
+	/// <summary>Schedule a function to be called on one of the worker threads. Exceptions must not escape it.</summary>
+	/// <param name="task">The function to call</param>
+	/// <param name="priority">The priority of the task</param>
+	void submit(std::function<void()> task, TaskPriority priority = TaskPriority::Normal)
+	{
+		enqueue(task, priority);
+	}
+};
+
+/// <summary>Get the TaskScheduler shared by the whole application, with one worker per hardware thread. The workers
+/// are spawned on first use and joined when the application exits.</summary>
+/// <returns>The shared TaskScheduler</returns>
+inline TaskScheduler& getSharedTaskScheduler()
+{
+	static TaskScheduler scheduler;
+	return scheduler;
+}
+
+/// <summary>Call function(i) for every i in [0, numItems), spread over the calling thread and the workers of the
+/// shared TaskScheduler. Items are handed out one at a time, in order, so items should be large enough to be worth
+/// it (for example, a row of pixels or a chunk of objects). The calling thread works too, so parallelFor can safely be
+/// called from a task of the shared TaskScheduler. Returns when all the items are done. If any call throws, the first
+/// exception is rethrown once all the items are done.</summary>
+/// <param name="numItems">The number of items</param>
+/// <param name="function">The function to call for each item. Must be safe to call concurrently for different items.
+/// </param>
+/// <param name="maxThreads">The largest number of threads to use, including the calling thread. 0 for all the
+/// workers of the shared TaskScheduler and the calling thread. 1 to do all the work on the calling thread.</param>
+template<typename Function>
+void parallelFor(uint32_t numItems, const Function& function, uint32_t maxThreads = 0)
+{
+	if (numItems == 0)
+	{
+		return;
+	}
+	uint32_t numHelpers = std::min(maxThreads ? maxThreads - 1 : ~0u, numItems - 1);
+	if (numHelpers)
+	{
+		numHelpers = std::min(numHelpers, getSharedTaskScheduler().getNumWorkers());
+	}
+	if (numHelpers == 0)
+	{
+		for (uint32_t i = 0; i < numItems; ++i)
+		{
+			function(i);
+		}
+		return;
+	}
+
+	// Helpers may only start after all the items are done (even after this function has returned), so they share
+	// the state, and only touch the function once they have claimed an item.
+	struct State
+	{
+		const Function* function;
+		uint32_t numItems;
+		std::atomic<uint32_t> nextItem;
+		std::atomic<uint32_t> numRemaining;
+		std::mutex mutex;
+		std::condition_variable done;
+		std::exception_ptr error;
+	};
+	std::shared_ptr<State> state = std::make_shared<State>();
+	state->function = &function;
+	state->numItems = numItems;
+	state->nextItem = 0;
+	state->numRemaining = numItems;
+
+	auto work = [](State& state) {
+		for (uint32_t i = state.nextItem++; i < state.numItems; i = state.nextItem++)
+		{
+			try
+			{
+				(*state.function)(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(state.mutex);
+				if (!state.error)
+				{
+					state.error = std::current_exception();
+				}
+			}
+			if (--state.numRemaining == 0)
+			{
+				std::lock_guard<std::mutex> lock(state.mutex);
+				state.done.notify_all();
+			}
+		}
+	};
+	// The calling thread is blocked until the items are done.
+	for (uint32_t i = 0; i < numHelpers; ++i)
+	{
+		getSharedTaskScheduler().submit([state, work]() { work(*state); }, TaskPriority::High);
+	}
+	work(*state);
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->done.wait(lock, [&state]() { return state->numRemaining == 0; });
+	if (state->error)
+	{
+		std::rethrow_exception(state->error);
+	}
+}
 } // namespace async
 } // namespace pvr
 
 namespace pvr {
-/// <summary>A simple adapter for the BlockingConcurrentQueue that just simplifies the common case</summary>
-template<typename T>
+/// <summary>A multi-producer, multi-consumer blocking queue. With a Capacity of 0 (the default), an unbounded queue
+/// adapting MoodyCamel's BlockingConcurrentQueue, which allocates its storage in blocks as it grows. With a non-zero
+/// Capacity, a lock-free ring buffer of exactly Capacity items stored inside the queue object itself, which never
+/// allocates: producers block while the queue is full. Both have the same interface, so one can replace the other by
+/// only changing the Capacity.
+///
+/// The ring is a sequence of slots, each with a sequence number telling producers and consumers whose turn it is.
+/// Producers claim all the consecutive free slots they need, and consumers all the consecutive slots that are ready,
+/// with a single compare-and-swap, so produceMultiple and consumeMultiple cost a few atomic operations per batch rather
+/// than per item. Waiting for items (or for space in a full queue) spins for a short time before parking the thread on
+/// a semaphore.</summary>
+/// <typeparam name="T">The type of the items. Must be default constructible and copy assignable.</typeparam>
+/// <typeparam name="Capacity">The maximum number of items in the queue. A power of two, or 0 for an unbounded queue.
+/// </typeparam>
+template<typename T, uint32_t Capacity = 0>
 class LockedQueue
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "The capacity of a bounded LockedQueue must be a power of two");
+
+	struct Slot
+	{
+		std::atomic<size_t> sequence; // position when free, position + 1 when holding the item of that position
+		T value;
+	};
+	enum : size_t
+	{
+		Mask = Capacity - 1,
+		DoneUnblocks = 1 << 20,
+		CacheLineSize = 64,
+		SpinCount = 1024
+	};
+
+	Slot _slots[Capacity];
+	char _padding0[CacheLineSize];
+	std::atomic<size_t> _enqueuePos;
+	char _padding1[CacheLineSize];
+	std::atomic<size_t> _dequeuePos;
+	char _padding2[CacheLineSize];
+	async::Semaphore _items; // Counts the items produced (plus the unblocks), waited on by the consumers
+	async::Semaphore _space; // Signalled when slots are freed while producers are parked waiting for them
+	std::atomic<int32_t> _waitingProducers;
+	std::atomic<int32_t> _unblocking;
+	std::atomic<bool> _done;
+
+	// Claims up to maxItems consecutive free slots and fills them. Returns the number of items enqueued.
+	template<typename iterator>
+	uint32_t enqueueFree(iterator& items, uint32_t maxItems)
+	{
+		size_t position = _enqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			uint32_t count = 0;
+			while (count < maxItems && _slots[(position + count) & Mask].sequence.load(std::memory_order_acquire) == position + count)
+			{
+				++count;
+			}
+			if (count == 0)
+			{
+				const size_t current = _enqueuePos.load(std::memory_order_relaxed);
+				if (current == position)
+				{
+					return 0;
+				}
+				position = current;
+			}
+			else if (_enqueuePos.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+			{
+				for (uint32_t i = 0; i < count; ++i, ++items)
+				{
+					Slot& slot = _slots[(position + i) & Mask];
+					slot.value = *items;
+					slot.sequence.store(position + i + 1, std::memory_order_release);
+				}
+				_items.signal(count);
+				return count;
+			}
+		}
+	}
+
+	// False if the slot at the enqueue position still holds the item of the previous lap, i.e. the queue is full.
+	bool hasSpace() const
+	{
+		const size_t position = _enqueuePos.load(std::memory_order_seq_cst);
+		return static_cast<std::ptrdiff_t>(_slots[position & Mask].sequence.load(std::memory_order_seq_cst) - position) >= 0;
+	}
+
+	// Waits until a consumer frees a slot of a full queue: spins for a while, then parks on _space.
+	void waitForSpace()
+	{
+		for (uint32_t spin = 0; spin < SpinCount; ++spin)
+		{
+			if (hasSpace() || _done.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+			std::this_thread::yield();
+		}
+		_waitingProducers.fetch_add(1, std::memory_order_seq_cst);
+		if (!hasSpace() && !_done.load(std::memory_order_relaxed))
+		{
+			_space.wait();
+		}
+		_waitingProducers.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	// Claims up to maxItems consecutive items that are ready to be read. Returns the number of items dequeued.
+	template<typename iterator>
+	uint32_t dequeueReady(iterator& firstItem, uint32_t maxItems)
+	{
+		size_t position = _dequeuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			uint32_t count = 0;
+			while (count < maxItems && _slots[(position + count) & Mask].sequence.load(std::memory_order_acquire) == position + count + 1)
+			{
+				++count;
+			}
+			if (count == 0)
+			{
+				const size_t current = _dequeuePos.load(std::memory_order_relaxed);
+				if (current == position)
+				{
+					return 0;
+				}
+				position = current;
+			}
+			else if (_dequeuePos.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+			{
+				for (uint32_t i = 0; i < count; ++i, ++firstItem)
+				{
+					Slot& slot = _slots[(position + i) & Mask];
+					*firstItem = std::move(slot.value);
+					slot.sequence.store(position + i + Capacity, std::memory_order_release);
+				}
+				// Pairs with waitForSpace: either the producer sees the freed slots, or this sees the producer waiting.
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (_waitingProducers.load(std::memory_order_relaxed) > 0)
+				{
+					_space.signal(count);
+				}
+				return count;
+			}
+		}
+	}
+
+	// Takes one of the pending unblocks, if any.
+	bool takeUnblock()
+	{
+		int32_t unblocking = _unblocking.load(std::memory_order_relaxed);
+		while (unblocking > 0)
+		{
+			if (_unblocking.compare_exchange_weak(unblocking, unblocking - 1, std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Dequeues maxReserved items, already reserved on _items. If not all can be dequeued because some of the reservations
+	// were unblocks, returns what could be dequeued and gives the unused reservations back.
+	template<typename iterator>
+	size_t dequeueReserved(iterator firstItem, uint32_t maxReserved)
+	{
+		uint32_t count = 0;
+		for (;;)
+		{
+			count += dequeueReady(firstItem, maxReserved - count);
+			if (count == maxReserved)
+			{
+				return count;
+			}
+			if (_unblocking.load(std::memory_order_relaxed) > 0)
+			{
+				if (count)
+				{
+					_items.signal(maxReserved - count);
+					return count;
+				}
+				if (takeUnblock())
+				{
+					_items.signal(maxReserved - 1);
+					return 0;
+				}
+			}
+			std::this_thread::yield(); // An item is being written, or an unblock is being taken by another consumer
+		}
+	}
+
+public:
+	/// <summary>Producer token. The bounded queue does not need per-producer state, so tokens are empty and only
+	/// provided for interface compatibility with the unbounded queue.</summary>
+	struct ProducerToken
+	{};
+	/// <summary>Consumer token. Empty, only provided for interface compatibility with the unbounded queue.</summary>
+	struct ConsumerToken
+	{};
+	/// <summary>Constructor</summary>
+	LockedQueue() : _enqueuePos(0), _dequeuePos(0), _items(0), _space(0), _waitingProducers(0), _unblocking(0), _done(false)
+	{
+		for (size_t i = 0; i < Capacity; ++i)
+		{
+			_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	/// <summary>Get a consumer token for this queue</summary>
+	/// <returns>A consumer token</returns>
+	ConsumerToken getConsumerToken()
+	{
+		return ConsumerToken();
+	}
+	/// <summary>Get a producer token for this queue</summary>
+	/// <returns>A producer token</returns>
+	ProducerToken getProducerToken()
+	{
+		return ProducerToken();
+	}
+	/// <summary>Produce: Enqueue an item in the queue. Blocks while the queue is full.</summary>
+	/// <param name="item">The item that will be enqueued. Will be copied into the queue.</param>
+	void produce(const T& item)
+	{
+		produceMultiple(&item, 1);
+	}
+	/// <summary>Produce: Enqueue an item in the queue. Blocks while the queue is full.</summary>
+	/// <param name="token">The ProducerToken. Unused.</param>
+	/// <param name="item">The item that will be enqueued. Will be copied into the queue.</param>
+	void produce(ProducerToken& /*token*/, const T& item)
+	{
+		produceMultiple(&item, 1);
+	}
+	/// <summary>Produce: Enqueue multiple items in the queue, claiming as many slots at once as there is space for.
+	/// Blocks while the queue is full. Items produced after done() was called are discarded.</summary>
+	/// <param name="items">A type that will act as an iterator. Typically a C-pointer</param>
+	/// <param name="numItems">The number if items to enqueue from <paramRef name="items"/></param>
+	/// <typeparam name="iterator">Type Inferred: The type of the iterator <paramRef name="items"></typeparam>
+	template<typename iterator>
+	void produceMultiple(iterator items, uint32_t numItems)
+	{
+		while (numItems && !_done.load(std::memory_order_relaxed))
+		{
+			const uint32_t numEnqueued = enqueueFree(items, numItems);
+			if (numEnqueued)
+			{
+				numItems -= numEnqueued;
+			}
+			else
+			{
+				waitForSpace();
+			}
+		}
+	}
+	/// <summary>Produce: Enqueue multiple items in the queue. Blocks while the queue is full.</summary>
+	/// <param name="items">A type that will act as an iterator. Typically a C-pointer</param>
+	/// <param name="numItems">The number if items to enqueue from <paramRef name="items"/></param>
+	/// <param name="token">The ProducerToken. Unused.</param>
+	/// <typeparam name="iterator">Type Inferred: The type of the iterator <paramRef name="items"></typeparam>
+	template<typename iterator>
+	void produceMultiple(ProducerToken& /*token*/, iterator items, uint32_t numItems)
+	{
+		produceMultiple(items, numItems);
+	}
+
+	/// <summary>Blocking consume: Dequeue one item from the queue. If returns false, the queue was unblocked or finishing.
+	/// </summary>
+	/// <param name="item">Output variable: The item that was dequeued.</param>
+	/// <returns>True if an item was dequeued, otherwise false</returns>
+	bool consume(T& item)
+	{
+		return consumeMultiple(&item, 1) != 0;
+	}
+
+	/// <summary>Blocking consume: Dequeue one item from the queue. If returns false, the queue was unblocked or finishing.
+	/// </summary>
+	/// <param name="item">Output variable: The item that was dequeued.</param>
+	/// <param name="token">A ConsumerToken. Unused.</param>
+	/// <returns>True if an item was dequeued, otherwise false</returns>
+	bool consume(ConsumerToken& /*token*/, T& item)
+	{
+		return consumeMultiple(&item, 1) != 0;
+	}
+
+	/// <summary>Blocking consume multiple: Dequeue multiple items from the queue. Will return at least one item, unless the
+	/// queue was unblocked or closing down.</summary>
+	/// <param name="firstItem">Output iterator variable: The items will be dequeued using this iterator. Usually a C-pointer</param>
+	/// <param name="maxItems">The maximum number of items that will be dequeued</param>
+	/// <returns>The number of items dequeued. Will only be 0 if the queue was unblocked or finishing.</returns>
+	/// <typeparam name="iterator">Type Inferred: The type of the iterator <paramRef name="items"></typeparam>
+	template<typename iterator>
+	size_t consumeMultiple(iterator firstItem, uint32_t maxItems)
+	{
+		if (!maxItems)
+		{
+			return 0;
+		}
+		return dequeueReserved(firstItem, static_cast<uint32_t>(_items.waitMany(maxItems)));
+	}
+
+	/// <summary>Blocking consume multiple: Dequeue multiple items from the queue. Will return at least one item, unless the
+	/// queue was unblocked or closing down.</summary>
+	/// <param name="firstItem">Output iterator variable: The items will be dequeued using this iterator. Usually a C-pointer</param>
+	/// <param name="maxItems">The maximum number of items that will be dequeued</param>
+	/// <param name="token">A ConsumerToken. Unused.</param>
+	/// <returns>The number of items dequeued. Will only be 0 if the queue was unblocked or finishing.</returns>
+	/// <typeparam name="iterator">Type Inferred: The type of the iterator <paramRef name="items"></typeparam>
+	template<typename iterator>
+	size_t consumeMultiple(ConsumerToken& /*token*/, iterator firstItem, uint32_t maxItems)
+	{
+		return consumeMultiple(firstItem, maxItems);
+	}
+
+	/// <summary>Release one consumer from the queue. Used to release waiting threads when shutting down.</summary>
+	void unblockOne()
+	{
+		unblockMultiple(1);
+	}
+	/// <summary>Release multiple consumers from the queue. Used to release waiting threads when shutting down.</summary>
+	/// <param name="numUnblock">The number of consumers to unblock</param>
+	void unblockMultiple(uint32_t numUnblock)
+	{
+		_unblocking.fetch_add(static_cast<int32_t>(numUnblock), std::memory_order_relaxed);
+		_items.signal(numUnblock);
+	}
+	/// <summary>ONLY CALL ON EMPTY QUEUE, with no thread using it, otherwise behaviour is undefined. Discards pending
+	/// unblocks, and makes a queue on which done() was called usable again.</summary>
+	void reset()
+	{
+		_unblocking = 0;
+		_done = false;
+		while (_items.tryWaitMany(DoneUnblocks))
+		{
+		}
+		while (_space.tryWaitMany(DoneUnblocks))
+		{
+		}
+	}
+
+	/// <summary>Check if the queue is (tentatively) empty - this is an approximation due to multithreading.
+	/// (To get a precise number the queue should have be blocked for all access and until it was used.)</summary>
+	/// <returns>True if the thread is empty, otherwise false</returns>
+	bool isEmpty()
+	{
+		return itemsRemainingApprox() == 0;
+	}
+	/// <summary>Get the number of (tentative) items in the queue - this is an approximation due to multithreading.
+	/// (To get a precise number the queue should have be blocked for all access and until it was used.)</summary>
+	/// <returns>The number of produced items</returns>
+	size_t itemsRemainingApprox()
+	{
+		const size_t dequeuePos = _dequeuePos.load(std::memory_order_relaxed);
+		const size_t enqueuePos = _enqueuePos.load(std::memory_order_relaxed);
+		return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+	}
+	/// <summary>ALWAYS CALL ONLY AFTER YOU STOP ENQUEUEING ITEMS. Waits for all consumers to finish consuming,
+	/// and then signals the queue to finish (unblocks all consumers on an empty queue)</summary>
+	void drainEmpty()
+	{
+		while (itemsRemainingApprox())
+		{
+			std::this_thread::yield();
+		}
+		done();
+	}
+	/// <summary>Immediately signal all consumers to unblock and stop, and all blocked producers to return, discarding
+	/// any more items. Call reset() on the empty queue to use it again.</summary>
+	void done()
+	{
+		_done = true;
+		_unblocking.fetch_add(DoneUnblocks, std::memory_order_relaxed);
+		_items.signal(DoneUnblocks);
+		_space.signal(DoneUnblocks);
+	}
+};
+
+/// <summary>The unbounded LockedQueue: A simple adapter for the BlockingConcurrentQueue that just simplifies the common
+/// case</summary>
+template<typename T>
+class LockedQueue<T, 0>
 {
 	moodycamel::BlockingConcurrentQueue<T> queue;
 
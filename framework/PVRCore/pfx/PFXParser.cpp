@@ -11,6 +11,7 @@
 #include "PVRCore/stream/BufferStream.h"
 #include "PVRCore/texture/Texture.h"
 #include "PVRCore/Log.h"
+#include "PVRCore/Profiling.h"
 #include <set>
 
 namespace pvr {
@@ -1339,6 +1340,7 @@ PfxParser::PfxParser(Stream::ptr_type pfxStream, IAssetProvider* assetProvider)
 
 void PfxParser::readAsset_(effect::Effect& asset)
 {
+	PVR_PROFILE_SCOPE_CATEGORY("PfxParser::readAsset", "assets");
 	asset.clear();
 	std::vector<char> v = _assetStream->readToEnd<char>();
 
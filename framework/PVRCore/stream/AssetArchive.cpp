@@ -0,0 +1,220 @@
+/*!
+\brief Implementation of methods of the AssetArchive class.
+\file PVRCore/stream/AssetArchive.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/AssetArchive.h"
+#include "PVRCore/stream/BufferStream.h"
+#include "PVRCore/stream/MappedFileStream.h"
+#include "PVRCore/stream/Lz4.h"
+#include "PVRCore/Log.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+namespace pvr {
+static_assert(sizeof(asset_archive::Header) == 64, "The archive header must be 64 bytes");
+static_assert(sizeof(asset_archive::Entry) == 40, "The archive entries must be 40 bytes");
+
+struct AssetArchive::Storage
+{
+	std::unique_ptr<Stream> stream;
+	std::mutex mutex; // Serialises the reads of unmapped streams
+};
+
+namespace {
+// A read only BufferStream over memory owned by something else, which it keeps alive.
+template<typename Owner>
+class OwningBufferStream : public BufferStream
+{
+public:
+	OwningBufferStream(const std::string& fileName, const void* data, size_t size, const std::shared_ptr<Owner>& owner)
+		: BufferStream(fileName, data, size), _owner(owner)
+	{}
+
+private:
+	std::shared_ptr<Owner> _owner;
+};
+
+const char EmptyAsset = 0; // BufferStreams refuse to open over a NULL pointer
+
+inline bool entryLess(const asset_archive::Entry& lhs, const asset_archive::Entry& rhs, const char* names)
+{
+	if (lhs.nameHash != rhs.nameHash)
+	{
+		return lhs.nameHash < rhs.nameHash;
+	}
+	const int order = memcmp(names + lhs.nameOffset, names + rhs.nameOffset, std::min(lhs.nameLength, rhs.nameLength));
+	return order ? order < 0 : lhs.nameLength < rhs.nameLength;
+}
+} // namespace
+
+AssetArchive::AssetArchive(const std::string& archivePath) : _storage(std::make_shared<Storage>()), _mappedData(NULL)
+{
+	_storage->stream.reset(new MappedFileStream(archivePath));
+	_storage->stream->open();
+	readIndex();
+}
+
+AssetArchive::AssetArchive(std::unique_ptr<Stream> archiveStream) : _storage(std::make_shared<Storage>()), _mappedData(NULL)
+{
+	if (!archiveStream)
+	{
+		throw InvalidArgumentError("archiveStream", "[AssetArchive::AssetArchive] The stream was NULL");
+	}
+	_storage->stream = std::move(archiveStream);
+	if (!_storage->stream->isopen())
+	{
+		_storage->stream->open();
+	}
+	readIndex();
+}
+
+void AssetArchive::readIndex()
+{
+	const Stream& stream = *_storage->stream;
+	const uint64_t streamSize = stream.getSize();
+	const std::string& fileName = stream.getFileName();
+	if (streamSize < sizeof(asset_archive::Header) || streamSize > std::numeric_limits<size_t>::max())
+	{
+		throw InvalidDataError("[AssetArchive::readIndex] '" + fileName + "' is not an asset archive");
+	}
+	_mappedData = static_cast<const uint8_t*>(stream.getMappedView(0, static_cast<size_t>(streamSize)));
+
+	// Reads a range of the archive that has already been checked to lie within it.
+	auto readRange = [&](uint64_t offset, size_t size, void* out) {
+		if (!size)
+		{
+			return;
+		}
+		if (_mappedData)
+		{
+			memcpy(out, _mappedData + offset, size);
+		}
+		else
+		{
+			stream.seek(static_cast<long>(offset), Stream::SeekOriginFromStart);
+			stream.readExact(1, size, out);
+		}
+	};
+
+	asset_archive::Header header;
+	readRange(0, sizeof(header), &header);
+	if (header.magic != asset_archive::Magic)
+	{
+		throw InvalidDataError("[AssetArchive::readIndex] '" + fileName + "' is not an asset archive");
+	}
+	if (header.version != asset_archive::Version)
+	{
+		throw InvalidDataError("[AssetArchive::readIndex] '" + fileName + "' has unsupported version " + std::to_string(header.version));
+	}
+	const uint64_t archiveSize = header.archiveSize;
+	const uint64_t indexSize = static_cast<uint64_t>(header.numEntries) * sizeof(asset_archive::Entry);
+	if (archiveSize > streamSize || header.alignment == 0 || (header.alignment & (header.alignment - 1)) != 0 || header.indexOffset > archiveSize ||
+		indexSize > archiveSize - header.indexOffset || header.namesOffset > archiveSize || header.namesSize > archiveSize - header.namesOffset)
+	{
+		throw InvalidDataError("[AssetArchive::readIndex] '" + fileName + "' has a corrupt header");
+	}
+
+	_entries.resize(header.numEntries);
+	_names.resize(static_cast<size_t>(header.namesSize));
+	readRange(header.indexOffset, static_cast<size_t>(indexSize), _entries.data());
+	readRange(header.namesOffset, _names.size(), _names.data());
+
+	for (size_t i = 0; i < _entries.size(); ++i)
+	{
+		const asset_archive::Entry& entry = _entries[i];
+		const bool isCompressed = entry.compression == static_cast<uint8_t>(asset_archive::Compression::LZ4);
+		// LZ4 expands data at most 255 times, which bounds what a corrupt entry can make getAssetStream allocate.
+		if (entry.offset > archiveSize || entry.storedSize > archiveSize - entry.offset || static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header.namesSize ||
+			entry.size > std::numeric_limits<size_t>::max() || (!isCompressed && (entry.compression != 0 || entry.storedSize != entry.size)) ||
+			(isCompressed && entry.size / 255 > entry.storedSize) ||
+			entry.nameHash != asset_archive::hashName(_names.data() + entry.nameOffset, entry.nameLength) || (i && !entryLess(_entries[i - 1], entry, _names.data())))
+		{
+			throw InvalidDataError("[AssetArchive::readIndex] '" + fileName + "' has a corrupt index entry " + std::to_string(i));
+		}
+	}
+}
+
+const asset_archive::Entry* AssetArchive::findEntry(const std::string& normalizedName) const
+{
+	const uint64_t hash = asset_archive::hashName(normalizedName.data(), normalizedName.size());
+	std::vector<asset_archive::Entry>::const_iterator it =
+		std::lower_bound(_entries.begin(), _entries.end(), hash, [](const asset_archive::Entry& entry, uint64_t value) { return entry.nameHash < value; });
+	for (; it != _entries.end() && it->nameHash == hash; ++it)
+	{
+		if (it->nameLength == normalizedName.size() && memcmp(_names.data() + it->nameOffset, normalizedName.data(), normalizedName.size()) == 0)
+		{
+			return &*it;
+		}
+	}
+	return NULL;
+}
+
+AssetArchive::EntryInfo AssetArchive::getEntryInfo(uint32_t index) const
+{
+	if (index >= _entries.size())
+	{
+		throw IndexOutOfRange("[AssetArchive::getEntryInfo]", index, _entries.size() - 1);
+	}
+	const asset_archive::Entry& entry = _entries[index];
+	EntryInfo info;
+	info.name.assign(_names.data() + entry.nameOffset, entry.nameLength);
+	info.size = entry.size;
+	info.storedSize = entry.storedSize;
+	info.compression = static_cast<asset_archive::Compression>(entry.compression);
+	return info;
+}
+
+std::unique_ptr<Stream> AssetArchive::getAssetStream(const std::string& filename, bool logErrorOnNotFound)
+{
+	const asset_archive::Entry* entry = findEntry(asset_archive::normalizeName(filename));
+	if (!entry)
+	{
+		if (logErrorOnNotFound)
+		{
+			Log(LogLevel::Error, "AssetArchive: Asset '%s' not found in '%s'.", filename.c_str(), _storage->stream->getFileName().c_str());
+		}
+		return std::unique_ptr<Stream>();
+	}
+	const size_t size = static_cast<size_t>(entry->size);
+	const size_t storedSize = static_cast<size_t>(entry->storedSize);
+	const bool isCompressed = entry->compression == static_cast<uint8_t>(asset_archive::Compression::LZ4);
+
+	std::unique_ptr<Stream> stream;
+	if (_mappedData && !isCompressed)
+	{
+		stream.reset(new OwningBufferStream<Storage>(filename, _mappedData + entry->offset, size, _storage));
+	}
+	else
+	{
+		std::shared_ptr<std::vector<char> > data = std::make_shared<std::vector<char> >(size);
+		std::vector<char> payload;
+		const void* source = _mappedData ? _mappedData + entry->offset : NULL;
+		if (!source && storedSize)
+		{
+			char* destination = data->data();
+			if (isCompressed)
+			{
+				payload.resize(storedSize);
+				destination = payload.data();
+			}
+			std::lock_guard<std::mutex> lock(_storage->mutex);
+			_storage->stream->seek(static_cast<long>(entry->offset), Stream::SeekOriginFromStart);
+			_storage->stream->readExact(1, storedSize, destination);
+			source = destination;
+		}
+		if (isCompressed && !lz4::decompress(source, storedSize, data->data(), size))
+		{
+			throw InvalidDataError("[AssetArchive::getAssetStream] Asset '" + filename + "' of '" + _storage->stream->getFileName() + "' is corrupt");
+		}
+		stream.reset(new OwningBufferStream<std::vector<char> >(filename, size ? data->data() : &EmptyAsset, size, data));
+	}
+	stream->open();
+	return stream;
+}
+} // namespace pvr
+//!\endcond
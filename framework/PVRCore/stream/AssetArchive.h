@@ -0,0 +1,171 @@
+/*!
+\brief Contains the AssetArchive class, which serves assets packed into a single file, and the definitions of the
+archive format.
+\file PVRCore/stream/AssetArchive.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/IAssetProvider.h"
+#include "PVRCore/stream/Stream.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pvr {
+/// <summary>Definitions of the asset archive file format. All values are little endian.
+/// An archive is a Header, followed by the payloads of the entries (each starting at a multiple of the alignment of
+/// the archive), followed by the index (an array of Entry sorted by name hash, then name) and the name table (the names
+/// of the entries, not null terminated). Names are relative paths using '/' as the separator.</summary>
+namespace asset_archive {
+/// <summary>The first four bytes of an archive: "PVRA".</summary>
+static const uint32_t Magic = 0x41525650;
+/// <summary>The version of the format described here.</summary>
+static const uint32_t Version = 1;
+
+/// <summary>How the payload of an entry is stored.</summary>
+enum class Compression : uint8_t
+{
+	None = 0, //!< Stored as is
+	LZ4 = 1, //!< Stored as a single LZ4 block
+};
+
+/// <summary>The header at the start of an archive. 64 bytes.</summary>
+struct Header
+{
+	uint32_t magic; //!< Magic
+	uint32_t version; //!< Version
+	uint32_t numEntries; //!< The number of entries in the index
+	uint32_t alignment; //!< The alignment of the payloads, in bytes. A power of two.
+	uint64_t indexOffset; //!< The offset of the index from the start of the archive
+	uint64_t namesOffset; //!< The offset of the name table from the start of the archive
+	uint64_t namesSize; //!< The size of the name table, in bytes
+	uint64_t archiveSize; //!< The size of the whole archive, in bytes
+	uint8_t reserved[16]; //!< Zero
+};
+
+/// <summary>An entry of the index. 40 bytes.</summary>
+struct Entry
+{
+	uint64_t nameHash; //!< The hash of the name (see hashName)
+	uint64_t offset; //!< The offset of the payload from the start of the archive
+	uint64_t size; //!< The size of the asset, in bytes
+	uint64_t storedSize; //!< The size of the payload, in bytes
+	uint32_t nameOffset; //!< The offset of the name in the name table
+	uint16_t nameLength; //!< The length of the name, in bytes
+	uint8_t compression; //!< A Compression value
+	uint8_t reserved; //!< Zero
+};
+
+/// <summary>Hash of an entry name, as stored in the index (64 bit FNV-1a).</summary>
+/// <param name="name">The name.</param>
+/// <param name="length">The length of the name, in bytes.</param>
+/// <returns>The hash.</returns>
+inline uint64_t hashName(const char* name, size_t length)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < length; ++i)
+	{
+		hash ^= static_cast<uint8_t>(name[i]);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/// <summary>Turns an asset name into the form stored in archives: '/' separators, no leading "./".</summary>
+/// <param name="name">An asset name.</param>
+/// <returns>The name as stored in an archive.</returns>
+inline std::string normalizeName(const std::string& name)
+{
+	std::string retval(name);
+	for (size_t i = 0; i < retval.size(); ++i)
+	{
+		if (retval[i] == '\\')
+		{
+			retval[i] = '/';
+		}
+	}
+	size_t start = 0;
+	while (retval.compare(start, 2, "./") == 0)
+	{
+		start += 2;
+	}
+	return retval.substr(start);
+}
+} // namespace asset_archive
+
+/// <summary>An IAssetProvider serving the entries of an asset archive (see asset_archive). Lookups are a binary search
+/// of the index, so opening an asset never touches the filesystem. If the archive can be memory mapped, uncompressed
+/// entries are served in place, without copying, through Streams whose getMappedView covers the whole entry.
+/// Compressed entries are decompressed into memory owned by the returned Stream. The streams returned keep the
+/// archive data alive, and may outlive the AssetArchive. getAssetStream can be called concurrently from any number of
+/// threads.</summary>
+class AssetArchive : public IAssetProvider
+{
+public:
+	/// <summary>Information about an entry of the archive.</summary>
+	struct EntryInfo
+	{
+		std::string name; //!< The name of the entry
+		uint64_t size; //!< The size of the asset, in bytes
+		uint64_t storedSize; //!< The size of the asset in the archive, in bytes
+		asset_archive::Compression compression; //!< How the asset is stored
+	};
+
+	/// <summary>Constructor. Memory maps an archive file and validates its index. Throws a FileNotFoundError if the file
+	/// does not exist, an InvalidDataError if it is not a valid archive.</summary>
+	/// <param name="archivePath">The path of the archive file.</param>
+	explicit AssetArchive(const std::string& archivePath);
+
+	/// <summary>Constructor. Reads the index of an archive from a stream, for example one returned by another
+	/// IAssetProvider. If the stream offers a mapped view, entries are served from it in place, otherwise they are read
+	/// from it on request. Throws an InvalidDataError if it is not a valid archive.</summary>
+	/// <param name="archiveStream">The stream containing the archive. Ownership is taken.</param>
+	explicit AssetArchive(std::unique_ptr<Stream> archiveStream);
+
+	/// <summary>Create a Stream for an entry of the archive.</summary>
+	/// <param name="filename">The name of the entry. Backslashes and a leading "./" are ignored.</param>
+	/// <param name="logErrorOnNotFound">OPTIONAL. Set this to false to avoid logging an error when the entry is not
+	/// found.</param>
+	/// <returns>An open, read only Stream. NULL if the archive does not contain the entry.</returns>
+	std::unique_ptr<Stream> getAssetStream(const std::string& filename, bool logErrorOnNotFound = true);
+
+	/// <summary>Check if the archive contains an entry.</summary>
+	/// <param name="filename">The name of the entry.</param>
+	/// <returns>True if the archive contains the entry.</returns>
+	bool contains(const std::string& filename) const
+	{
+		return findEntry(asset_archive::normalizeName(filename)) != NULL;
+	}
+
+	/// <summary>Get the number of entries in the archive.</summary>
+	/// <returns>The number of entries.</returns>
+	uint32_t getNumEntries() const
+	{
+		return static_cast<uint32_t>(_entries.size());
+	}
+
+	/// <summary>Get information about an entry.</summary>
+	/// <param name="index">The index of the entry. Entries are ordered by name hash.</param>
+	/// <returns>Information about the entry.</returns>
+	EntryInfo getEntryInfo(uint32_t index) const;
+
+	/// <summary>Check if the entries are served from a memory mapping of the archive.</summary>
+	/// <returns>True if the archive is memory mapped.</returns>
+	bool isMapped() const
+	{
+		return _mappedData != NULL;
+	}
+
+private:
+	struct Storage;
+	void readIndex();
+	const asset_archive::Entry* findEntry(const std::string& normalizedName) const;
+
+	std::shared_ptr<Storage> _storage;
+	const uint8_t* _mappedData;
+	std::vector<asset_archive::Entry> _entries;
+	std::vector<char> _names;
+};
+} // namespace pvr
@@ -0,0 +1,179 @@
+/*!
+\brief Implementation of methods of the AssetArchiveWriter class.
+\file PVRCore/stream/AssetArchiveWriter.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/AssetArchiveWriter.h"
+#include "PVRCore/stream/FileStream.h"
+#include "PVRCore/stream/MappedFileStream.h"
+#include "PVRCore/stream/Lz4.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace pvr {
+namespace {
+void writeBytes(Stream& stream, const void* data, size_t size)
+{
+	if (size)
+	{
+		stream.writeExact(1, size, data);
+	}
+}
+} // namespace
+
+AssetArchiveWriter::AssetArchiveWriter(uint32_t alignment) : _alignment(alignment)
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+	{
+		throw InvalidArgumentError("alignment", "[AssetArchiveWriter::AssetArchiveWriter] Must be a power of two, but was " + std::to_string(alignment));
+	}
+}
+
+void AssetArchiveWriter::addEntry(PendingEntry& entry)
+{
+	entry.name = asset_archive::normalizeName(entry.name);
+	if (entry.name.empty() || entry.name.size() > std::numeric_limits<uint16_t>::max())
+	{
+		throw InvalidArgumentError("name", "[AssetArchiveWriter::addEntry] Asset names must be 1 to 65535 bytes long");
+	}
+	if (!_names.insert(entry.name).second)
+	{
+		throw InvalidArgumentError("name", "[AssetArchiveWriter::addEntry] Asset '" + entry.name + "' was already added");
+	}
+	_pending.push_back(std::move(entry));
+}
+
+void AssetArchiveWriter::addFile(const std::string& name, const std::string& filePath, asset_archive::Compression compression)
+{
+	PendingEntry entry;
+	entry.name = name;
+	entry.filePath = filePath;
+	entry.compression = compression;
+	addEntry(entry);
+}
+
+void AssetArchiveWriter::addData(const std::string& name, const void* data, size_t size, asset_archive::Compression compression)
+{
+	PendingEntry entry;
+	entry.name = name;
+	entry.data.assign(static_cast<const char*>(data), static_cast<const char*>(data) + size);
+	entry.compression = compression;
+	addEntry(entry);
+}
+
+void AssetArchiveWriter::write(Stream& stream) const
+{
+	std::vector<asset_archive::Entry> entries(_pending.size());
+	std::string names;
+	std::vector<char> compressed;
+	static const char padding[4096] = {};
+
+	// The header is written last, once the offsets are known.
+	asset_archive::Header header;
+	memset(&header, 0, sizeof(header));
+	stream.seek(0, Stream::SeekOriginFromStart);
+	writeBytes(stream, &header, sizeof(header));
+	uint64_t position = sizeof(header);
+
+	for (size_t i = 0; i < _pending.size(); ++i)
+	{
+		const PendingEntry& pending = _pending[i];
+		std::unique_ptr<Stream> file;
+		const char* data = pending.data.data();
+		size_t size = pending.data.size();
+		std::vector<char> fileData;
+		if (!pending.filePath.empty())
+		{
+			file.reset(new MappedFileStream(pending.filePath));
+			file->open();
+			size = file->getSize();
+			data = static_cast<const char*>(file->getMappedView(0, size));
+			if (!data && size)
+			{
+				fileData.resize(size);
+				file->readExact(1, size, fileData.data());
+				data = fileData.data();
+			}
+		}
+
+		asset_archive::Entry& entry = entries[i];
+		memset(&entry, 0, sizeof(entry));
+		entry.nameHash = asset_archive::hashName(pending.name.data(), pending.name.size());
+		entry.size = size;
+		entry.storedSize = size;
+		if (names.size() + pending.name.size() > std::numeric_limits<uint32_t>::max())
+		{
+			throw InvalidOperationError("[AssetArchiveWriter::write] The names of the assets exceed 4GB");
+		}
+		entry.nameOffset = static_cast<uint32_t>(names.size());
+		entry.nameLength = static_cast<uint16_t>(pending.name.size());
+		names += pending.name;
+
+		const char* payload = data;
+		if (pending.compression == asset_archive::Compression::LZ4 && size)
+		{
+			compressed.resize(lz4::compressBound(size));
+			const size_t compressedSize = lz4::compress(data, size, compressed.data(), compressed.size());
+			if (compressedSize && compressedSize < size - size / 16)
+			{
+				entry.compression = static_cast<uint8_t>(asset_archive::Compression::LZ4);
+				entry.storedSize = compressedSize;
+				payload = compressed.data();
+			}
+		}
+
+		const uint64_t aligned = (position + _alignment - 1) & ~static_cast<uint64_t>(_alignment - 1);
+		for (uint64_t remaining = aligned - position; remaining;)
+		{
+			const size_t chunk = static_cast<size_t>(std::min<uint64_t>(remaining, sizeof(padding)));
+			writeBytes(stream, padding, chunk);
+			remaining -= chunk;
+		}
+		entry.offset = aligned;
+		writeBytes(stream, payload, static_cast<size_t>(entry.storedSize));
+		position = aligned + entry.storedSize;
+	}
+
+	std::vector<uint32_t> order(entries.size());
+	for (uint32_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+		if (entries[lhs].nameHash != entries[rhs].nameHash)
+		{
+			return entries[lhs].nameHash < entries[rhs].nameHash;
+		}
+		return _pending[lhs].name < _pending[rhs].name;
+	});
+	header.indexOffset = (position + 7) & ~static_cast<uint64_t>(7);
+	writeBytes(stream, padding, static_cast<size_t>(header.indexOffset - position));
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		writeBytes(stream, &entries[order[i]], sizeof(asset_archive::Entry));
+	}
+	header.namesOffset = header.indexOffset + entries.size() * sizeof(asset_archive::Entry);
+	header.namesSize = names.size();
+	writeBytes(stream, names.data(), names.size());
+
+	header.magic = asset_archive::Magic;
+	header.version = asset_archive::Version;
+	header.numEntries = static_cast<uint32_t>(entries.size());
+	header.alignment = _alignment;
+	header.archiveSize = header.namesOffset + header.namesSize;
+	stream.seek(0, Stream::SeekOriginFromStart);
+	writeBytes(stream, &header, sizeof(header));
+	stream.seek(0, Stream::SeekOriginFromEnd);
+}
+
+void AssetArchiveWriter::writeToFile(const std::string& archivePath) const
+{
+	FileStream stream(archivePath, "wb");
+	stream.open();
+	write(stream);
+}
+} // namespace pvr
+//!\endcond
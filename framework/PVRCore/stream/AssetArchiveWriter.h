@@ -0,0 +1,67 @@
+/*!
+\brief Contains the AssetArchiveWriter class, which packs assets into a single archive file.
+\file PVRCore/stream/AssetArchiveWriter.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/stream/AssetArchive.h"
+#include <set>
+
+namespace pvr {
+/// <summary>Packs assets into an archive that can be read with AssetArchive. Assets are added by name, then the whole
+/// archive is written at once. Files added with addFile are only read while writing, so that archives of any size can be
+/// created without holding them in memory.</summary>
+class AssetArchiveWriter
+{
+public:
+	/// <summary>Constructor.</summary>
+	/// <param name="alignment">The alignment of the payloads in the archive, in bytes. A power of two. Aligning to the
+	/// page size lets individual assets be mapped on their own; the default keeps payloads suitable for SIMD access.
+	/// </param>
+	explicit AssetArchiveWriter(uint32_t alignment = 16);
+
+	/// <summary>Add a file to the archive. Throws an InvalidArgumentError if the name is already used or too long.
+	/// </summary>
+	/// <param name="name">The name of the asset in the archive, as it will be requested from getAssetStream.</param>
+	/// <param name="filePath">The path of the file to read when the archive is written.</param>
+	/// <param name="compression">How to store the asset. Compressed assets are stored uncompressed anyway if compressing
+	/// does not save at least 1/16th of their size.</param>
+	void addFile(const std::string& name, const std::string& filePath, asset_archive::Compression compression = asset_archive::Compression::None);
+
+	/// <summary>Add a block of memory to the archive. The data is copied. Throws an InvalidArgumentError if the name is
+	/// already used or too long.</summary>
+	/// <param name="name">The name of the asset in the archive, as it will be requested from getAssetStream.</param>
+	/// <param name="data">The contents of the asset.</param>
+	/// <param name="size">The size of the asset, in bytes.</param>
+	/// <param name="compression">How to store the asset.</param>
+	void addData(const std::string& name, const void* data, size_t size, asset_archive::Compression compression = asset_archive::Compression::None);
+
+	/// <summary>Get the number of assets added.</summary>
+	/// <returns>The number of assets.</returns>
+	size_t getNumEntries() const { return _pending.size(); }
+
+	/// <summary>Write the archive into a stream, starting at its beginning. The stream must be writable and seekable.
+	/// </summary>
+	/// <param name="stream">The stream to write the archive to.</param>
+	void write(Stream& stream) const;
+
+	/// <summary>Write the archive into a file, replacing it if it exists.</summary>
+	/// <param name="archivePath">The path of the archive file.</param>
+	void writeToFile(const std::string& archivePath) const;
+
+private:
+	struct PendingEntry
+	{
+		std::string name;
+		std::string filePath; // Empty if the data was given in memory
+		std::vector<char> data;
+		asset_archive::Compression compression;
+	};
+	void addEntry(PendingEntry& entry);
+
+	std::vector<PendingEntry> _pending;
+	std::set<std::string> _names;
+	uint32_t _alignment;
+};
+} // namespace pvr
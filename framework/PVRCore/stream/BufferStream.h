@@ -64,22 +64,12 @@ public:
 		{
 			throw InvalidOperationError("Attempted to read a null BufferStream");
 		}
-		char* dataCurrent = static_cast<char*>(buffer);
-		// Make sure we don't read too much
-		for (size_t realcount = 0; realcount < numElements; ++realcount)
-		{
-			size_t realsize = static_cast<size_t>(std::min(elementSize, _bufferSize - _bufferPosition));
-			memcpy(dataCurrent, _currentPointer, realsize);
-
-			_bufferPosition += realsize;
-			_currentPointer = static_cast<void*>(static_cast<char*>(_currentPointer) + realsize);
-			dataCurrent += realsize;
-
-			if (realsize == elementSize)
-			{
-				++dataRead;
-			}
-		}
+		// Make sure we don't read too much. A trailing partial element is copied, but not counted.
+		const size_t bytes = std::min(elementSize * numElements, _bufferSize - _bufferPosition);
+		memcpy(buffer, _currentPointer, bytes);
+		_bufferPosition += bytes;
+		_currentPointer = static_cast<void*>(static_cast<char*>(_currentPointer) + bytes);
+		dataRead = elementSize ? bytes / elementSize : numElements;
 		if (dataRead != numElements && _bufferPosition != _bufferSize)
 		{
 			throw FileIOError("Unknown error while reading BufferStream.");
@@ -106,22 +96,12 @@ public:
 		{
 			throw FileIOError("BufferStream::write: UnknownError: No data / Memory Pointer was NULL");
 		}
-		const unsigned char* dataCurrent = static_cast<const unsigned char*>(buffer);
-		// Make sure we don't read too much
-		for (size_t realcount = 0; realcount < numElements; ++realcount)
-		{
-			size_t realsize = static_cast<size_t>(std::min<uint64_t>(static_cast<uint64_t>(elementSize), _bufferSize - _bufferPosition));
-			memcpy(_currentPointer, dataCurrent, realsize);
-
-			_bufferPosition += realsize;
-			_currentPointer = static_cast<void*>(static_cast<char*>(_currentPointer) + realsize);
-			dataCurrent += realsize;
-
-			if (realsize == elementSize)
-			{
-				++dataWritten;
-			}
-		}
+		// Make sure we don't write too much. A trailing partial element is copied, but not counted.
+		const size_t bytes = std::min(elementSize * numElements, _bufferSize - _bufferPosition);
+		memcpy(_currentPointer, buffer, bytes);
+		_bufferPosition += bytes;
+		_currentPointer = static_cast<void*>(static_cast<char*>(_currentPointer) + bytes);
+		dataWritten = elementSize ? bytes / elementSize : numElements;
 		if (dataWritten != numElements)
 		{
 			throw FileIOError("BufferStream::write: Unknown error trying to write stream");
@@ -228,6 +208,19 @@ public:
 		return _bufferSize;
 	}
 
+	/// <summary>Get a pointer to a range of the wrapped memory.</summary>
+	/// <param name="offset">The offset of the range from the start of the stream</param>
+	/// <param name="size">The size of the range, in bytes</param>
+	/// <returns>A pointer to the range, or NULL if the stream is not open or the range does not fit in it.</returns>
+	virtual const void* getMappedView(size_t offset, size_t size) const
+	{
+		if (!isopen() || offset > _bufferSize || size > _bufferSize - offset)
+		{
+			return NULL;
+		}
+		return static_cast<const unsigned char*>(_originalData) + offset;
+	}
+
 protected:
 	/// <summary>Constructor. Constructs with a specified resource identifier.</summary>
 	/// <param name="resourceName">A resource identifier (conceptually, a "Filename" without a file)</param>
@@ -0,0 +1,476 @@
+/*!
+\brief Implementation of methods of the CachingAssetProvider class.
+\file PVRCore/stream/CachingAssetProvider.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/CachingAssetProvider.h"
+#include "PVRCore/stream/BufferStream.h"
+#include "PVRCore/stream/MappedFileStream.h"
+#include "PVRCore/Log.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <dirent.h>
+#endif
+
+namespace pvr {
+namespace {
+// A read only BufferStream sharing ownership of the cached data, so that clearing the cache does not invalidate it.
+class CachedAssetStream : public BufferStream
+{
+public:
+	CachedAssetStream(const std::string& fileName, const std::shared_ptr<const std::vector<char> >& data)
+		: BufferStream(fileName, static_cast<const void*>(data->data()), data->size()), _data(data)
+	{}
+
+private:
+	std::shared_ptr<const std::vector<char> > _data;
+};
+
+bool isAbsolutePath(const std::string& path)
+{
+#if defined(_WIN32)
+	return !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+#else
+	return !path.empty() && path[0] == '/';
+#endif
+}
+
+// Turns a relative asset name into the form used by the index. Returns false if the name cannot be found through
+// the index (it leaves its search path), in which case it must be probed.
+bool makeIndexKey(const std::string& filename, std::string& outKey)
+{
+	outKey = filename;
+#if defined(_WIN32) // The filesystem is case insensitive and accepts both separators
+	std::replace(outKey.begin(), outKey.end(), '\\', '/');
+	std::transform(outKey.begin(), outKey.end(), outKey.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+#endif
+	while (outKey.compare(0, 2, "./") == 0)
+	{
+		outKey.erase(0, 2);
+	}
+	if (outKey.empty() || outKey == ".." || outKey.compare(0, 3, "../") == 0 || outKey.find("/../") != std::string::npos ||
+		(outKey.size() >= 3 && outKey.compare(outKey.size() - 3, 3, "/..") == 0))
+	{
+		return false;
+	}
+	return true;
+}
+
+std::string resolveDirectory(const std::string& path)
+{
+	const std::string directory = path.empty() ? std::string(".") : path;
+#if defined(_WIN32)
+	char buffer[MAX_PATH];
+	DWORD length = GetFullPathNameA(directory.c_str(), MAX_PATH, buffer, NULL);
+	if (length == 0 || length >= MAX_PATH)
+	{
+		return directory;
+	}
+	std::string retval(buffer, length);
+	std::replace(retval.begin(), retval.end(), '/', '\\');
+	std::transform(retval.begin(), retval.end(), retval.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+	while (retval.size() > 3 && retval.back() == '\\')
+	{
+		retval.pop_back();
+	}
+	return retval;
+#else
+	char* resolved = realpath(directory.c_str(), NULL);
+	if (!resolved)
+	{
+		return directory;
+	}
+	std::string retval(resolved);
+	free(resolved);
+	return retval;
+#endif
+}
+
+// Adds the names of the entries of a directory to outEntries. Returns false if the directory could not be listed
+// completely, in which case it must be probed instead.
+bool listDirectory(const std::string& directory, size_t maxEntries, std::unordered_set<std::string>& outEntries)
+{
+#if defined(_WIN32)
+	WIN32_FIND_DATAA findData;
+	HANDLE handle = FindFirstFileA(((directory.empty() ? std::string(".\\") : directory) + "*").c_str(), &findData);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		DWORD error = GetLastError();
+		return error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND; // Nothing to find there.
+	}
+	bool retval = true;
+	do
+	{
+		std::string name(findData.cFileName);
+		if (name == "." || name == "..")
+		{
+			continue;
+		}
+		if (outEntries.size() == maxEntries)
+		{
+			retval = false;
+			break;
+		}
+		std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+		outEntries.insert(name);
+	} while (FindNextFileA(handle, &findData));
+	FindClose(handle);
+	return retval;
+#else
+	DIR* dir = opendir(directory.empty() ? "." : directory.c_str());
+	if (!dir)
+	{
+		return errno == ENOENT || errno == ENOTDIR; // Nothing to find there.
+	}
+	bool retval = true;
+	while (dirent* entry = readdir(dir))
+	{
+		if (entry->d_name[0] == '.' && (entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0')))
+		{
+			continue;
+		}
+		if (outEntries.size() == maxEntries)
+		{
+			retval = false;
+			break;
+		}
+		outEntries.insert(entry->d_name);
+	}
+	closedir(dir);
+	return retval;
+#endif
+}
+} // namespace
+
+CachingAssetProvider::CachingAssetProvider(const std::vector<std::string>& searchPaths, size_t maxCachedAssetSize, size_t maxCacheSize)
+	: _indexGeneration(0), _maxCachedAssetSize(maxCachedAssetSize), _maxCacheSize(maxCacheSize), _maxDirectoryEntries(65536), _cacheThreshold(2), _aliasesResolved(false)
+{
+	setSearchPaths(searchPaths);
+}
+
+void CachingAssetProvider::setSearchPaths(const std::vector<std::string>& searchPaths)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_searchPaths.clear();
+	_searchPaths.resize(searchPaths.size());
+	for (size_t i = 0; i < searchPaths.size(); ++i)
+	{
+		_searchPaths[i].path = searchPaths[i];
+		_searchPaths[i].aliasOf = i;
+	}
+	++_indexGeneration;
+	_cache.clear();
+	_numRequests.clear();
+	_statistics.numIndexedDirectories = 0;
+	_statistics.numIndexedFiles = 0;
+	_statistics.numCachedAssets = 0;
+	_statistics.numBytesCached = 0;
+	_aliasesResolved = false;
+}
+
+std::vector<std::string> CachingAssetProvider::getSearchPaths() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<std::string> retval;
+	for (size_t i = 0; i < _searchPaths.size(); ++i)
+	{
+		retval.push_back(_searchPaths[i].path);
+	}
+	return retval;
+}
+
+void CachingAssetProvider::setArchive(const std::shared_ptr<IAssetProvider>& archive)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_archive = archive;
+}
+
+void CachingAssetProvider::rebuildIndex()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (size_t i = 0; i < _searchPaths.size(); ++i)
+	{
+		_searchPaths[i].directories.clear();
+	}
+	++_indexGeneration;
+	_statistics.numIndexedDirectories = 0;
+	_statistics.numIndexedFiles = 0;
+	_aliasesResolved = false;
+}
+
+void CachingAssetProvider::clearCache()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_cache.clear();
+	_numRequests.clear();
+	_statistics.numCachedAssets = 0;
+	_statistics.numBytesCached = 0;
+}
+
+void CachingAssetProvider::setCacheThreshold(uint32_t numRequests)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_cacheThreshold = numRequests;
+}
+
+void CachingAssetProvider::setMaxDirectoryEntries(size_t maxEntries)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_maxDirectoryEntries = maxEntries;
+}
+
+size_t CachingAssetProvider::getMaxDirectoryEntries() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _maxDirectoryEntries;
+}
+
+AssetProviderStatistics CachingAssetProvider::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _statistics;
+}
+
+void CachingAssetProvider::resetStatistics()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	AssetProviderStatistics statistics;
+	statistics.numIndexedDirectories = _statistics.numIndexedDirectories;
+	statistics.numIndexedFiles = _statistics.numIndexedFiles;
+	statistics.numCachedAssets = _statistics.numCachedAssets;
+	statistics.numBytesCached = _statistics.numBytesCached;
+	_statistics = statistics;
+}
+
+void CachingAssetProvider::resolveAliases()
+{
+	std::vector<std::string> resolved(_searchPaths.size());
+	for (size_t i = 0; i < _searchPaths.size(); ++i)
+	{
+		SearchPath& searchPath = _searchPaths[i];
+		searchPath.aliasOf = i;
+		resolved[i] = resolveDirectory(searchPath.path);
+		for (size_t j = 0; j < i; ++j)
+		{
+			if (resolved[j] == resolved[i])
+			{
+				// Anything this path would find has already been found through the earlier one.
+				searchPath.aliasOf = _searchPaths[j].aliasOf;
+				break;
+			}
+		}
+	}
+	_aliasesResolved = true;
+}
+
+void CachingAssetProvider::indexDirectory(const std::string& directory, std::unique_lock<std::mutex>& lock)
+{
+	std::vector<size_t> unlisted; // The search paths that have not listed the directory yet
+	std::vector<std::string> paths;
+	for (size_t i = 0; i < _searchPaths.size(); ++i)
+	{
+		if (_searchPaths[i].aliasOf == i && !_searchPaths[i].directories.count(directory))
+		{
+			unlisted.push_back(i);
+			paths.push_back(_searchPaths[i].path + directory);
+		}
+	}
+	if (unlisted.empty())
+	{
+		return;
+	}
+
+	// Listing a directory can take a long time, so other requests are served meanwhile.
+	const size_t maxEntries = _maxDirectoryEntries;
+	const uint64_t generation = _indexGeneration;
+	lock.unlock();
+	std::vector<DirectoryListing> listings(unlisted.size());
+	for (size_t i = 0; i < listings.size(); ++i)
+	{
+		listings[i].complete = listDirectory(paths[i], maxEntries, listings[i].entries);
+		if (!listings[i].complete)
+		{
+			Log(LogLevel::Debug, "CachingAssetProvider: Directory '%s' was not indexed, and will be probed for each asset.", paths[i].c_str());
+			std::unordered_set<std::string>().swap(listings[i].entries);
+		}
+	}
+	lock.lock();
+
+	// If the index was dropped meanwhile, the listings may be out of date, or of other search paths.
+	if (generation != _indexGeneration)
+	{
+		return;
+	}
+	for (size_t i = 0; i < unlisted.size(); ++i)
+	{
+		// Another request may have listed the same directory meanwhile.
+		std::pair<std::unordered_map<std::string, DirectoryListing>::iterator, bool> inserted =
+			_searchPaths[unlisted[i]].directories.insert(std::make_pair(directory, DirectoryListing()));
+		if (inserted.second)
+		{
+			inserted.first->second.entries.swap(listings[i].entries);
+			inserted.first->second.complete = listings[i].complete;
+			++_statistics.numIndexedDirectories;
+			_statistics.numIndexedFiles += inserted.first->second.entries.size();
+		}
+	}
+}
+
+std::unique_ptr<Stream> CachingAssetProvider::openFile(const std::string& path, const std::string& key)
+{
+	std::unique_ptr<Stream> stream(new MappedFileStream(path, false));
+	stream->open();
+	if (!stream->isopen())
+	{
+		return std::unique_ptr<Stream>();
+	}
+	if (key.empty())
+	{
+		return stream;
+	}
+
+	const size_t size = stream->getSize();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_cacheThreshold == 0 || size == 0 || size > _maxCachedAssetSize || _statistics.numBytesCached + size > _maxCacheSize)
+		{
+			return stream;
+		}
+		// Only the assets that can be cached are counted, so that loading many large assets does not grow the counts.
+		if (_cacheThreshold > 1 && ++_numRequests[key] < _cacheThreshold)
+		{
+			return stream;
+		}
+	}
+
+	// Hot and small: copy it, so that the next requests do not touch the filesystem.
+	std::shared_ptr<std::vector<char> > data = std::make_shared<std::vector<char> >(size);
+	const void* mapped = stream->getMappedView(0, size);
+	if (mapped)
+	{
+		memcpy(data->data(), mapped, size);
+	}
+	else
+	{
+		stream->readExact(1, size, data->data());
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_numRequests.erase(key);
+		if (_statistics.numBytesCached + size <= _maxCacheSize && _cache.insert(std::make_pair(key, std::shared_ptr<const std::vector<char> >(data))).second)
+		{
+			++_statistics.numCachedAssets;
+			_statistics.numBytesCached += size;
+		}
+	}
+	std::unique_ptr<Stream> retval(new CachedAssetStream(path, data));
+	retval->open();
+	return retval;
+}
+
+std::unique_ptr<Stream> CachingAssetProvider::getAssetStream(const std::string& filename, bool logErrorOnNotFound)
+{
+	std::string key;
+	const bool indexable = !isAbsolutePath(filename) && makeIndexKey(filename, key);
+	std::vector<std::string> candidates; // Paths to try, in order
+	std::vector<bool> candidateIndexed; // Whether the candidate is known to exist
+	std::shared_ptr<IAssetProvider> archive;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		++_statistics.numRequests;
+		if (isAbsolutePath(filename))
+		{
+			candidates.push_back(filename);
+			candidateIndexed.push_back(false);
+		}
+		else
+		{
+			if (!_aliasesResolved)
+			{
+				resolveAliases();
+			}
+			const size_t separator = key.rfind('/');
+			const std::string directory = separator == std::string::npos ? std::string() : key.substr(0, separator + 1);
+			const std::string name = separator == std::string::npos ? key : key.substr(separator + 1);
+			if (indexable)
+			{
+				std::unordered_map<std::string, std::shared_ptr<const std::vector<char> > >::const_iterator it = _cache.find(key);
+				if (it != _cache.end())
+				{
+					++_statistics.numMemoryHits;
+					std::unique_ptr<Stream> stream(new CachedAssetStream(filename, it->second));
+					stream->open();
+					return stream;
+				}
+				indexDirectory(directory, lock);
+			}
+			for (size_t i = 0; i < _searchPaths.size(); ++i)
+			{
+				SearchPath& searchPath = _searchPaths[i];
+				if (searchPath.aliasOf != i)
+				{
+					continue;
+				}
+				// Probed if the name cannot be indexed, or if the index was dropped while the directory was being listed
+				std::unordered_map<std::string, DirectoryListing>::const_iterator listing = searchPath.directories.end();
+				if (indexable)
+				{
+					listing = searchPath.directories.find(directory);
+				}
+				const bool probe = listing == searchPath.directories.end() || !listing->second.complete;
+				if (probe || listing->second.entries.count(name))
+				{
+					candidates.push_back(searchPath.path + filename);
+					candidateIndexed.push_back(!probe);
+				}
+			}
+		}
+		archive = _archive;
+	}
+
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		std::unique_ptr<Stream> stream = openFile(candidates[i], indexable ? key : std::string());
+		if (stream)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			++(candidateIndexed[i] ? _statistics.numIndexHits : _statistics.numDirectOpens);
+			return stream;
+		}
+	}
+	if (archive)
+	{
+		std::unique_ptr<Stream> stream = archive->getAssetStream(filename, false);
+		if (stream)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			++_statistics.numArchiveHits;
+			return stream;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		++_statistics.numMisses;
+	}
+	if (logErrorOnNotFound)
+	{
+		Log(LogLevel::Error, "CachingAssetProvider: Asset '%s' not found.", filename.c_str());
+	}
+	return std::unique_ptr<Stream>();
+}
+} // namespace pvr
+//!\endcond
@@ -0,0 +1,137 @@
+/*!
+\brief An IAssetProvider that indexes its search paths once and keeps frequently requested small assets in memory.
+\file PVRCore/stream/CachingAssetProvider.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/IAssetProvider.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace pvr {
+/// <summary>Counters describing how the requests to a CachingAssetProvider were served.</summary>
+struct AssetProviderStatistics
+{
+	uint64_t numRequests; //!< The number of calls to getAssetStream
+	uint64_t numMemoryHits; //!< Requests served from the in-memory cache
+	uint64_t numIndexHits; //!< Requests found in the directory index and opened from the filesystem
+	uint64_t numArchiveHits; //!< Requests served by the archive provider
+	uint64_t numDirectOpens; //!< Requests served by probing a path (absolute names, directories that could not be indexed)
+	uint64_t numMisses; //!< Requests that could not be served
+	uint64_t numIndexedDirectories; //!< The number of directories listed into the index
+	uint64_t numIndexedFiles; //!< The number of directory entries in the index
+	uint64_t numCachedAssets; //!< The number of assets currently held in memory
+	uint64_t numBytesCached; //!< The number of bytes currently held in memory
+
+	/// <summary>Constructor. Zeroes all counters.</summary>
+	AssetProviderStatistics()
+		: numRequests(0), numMemoryHits(0), numIndexHits(0), numArchiveHits(0), numDirectOpens(0), numMisses(0), numIndexedDirectories(0), numIndexedFiles(0), numCachedAssets(0), numBytesCached(0)
+	{}
+};
+
+/// <summary>An IAssetProvider serving files from an ordered list of search paths, like the Shell does, without probing
+/// the filesystem for every request. Each directory is listed into an in-memory index the first time an asset in it is
+/// requested, so that a lookup costs a hash lookup per search path instead of a failed open, and missing assets are
+/// reported without touching the filesystem at all. Assets up to a configurable size are copied into memory once they
+/// have been requested a few times and are then served as BufferStreams. An optional archive provider (for example a
+/// packed asset file) is searched after the filesystem, so that loose files still override packed ones.
+/// All methods are thread safe.</summary>
+/// <remarks>Files created in a directory after it was listed are not found until rebuildIndex() is called.
+/// Directories containing more than getMaxDirectoryEntries() entries are not indexed, but probed per request instead.
+/// </remarks>
+class CachingAssetProvider : public IAssetProvider
+{
+public:
+	/// <summary>Constructor. Does not touch the filesystem: the index is built as assets are requested.</summary>
+	/// <param name="searchPaths">The directories to search, in priority order. Each must be empty (meaning the current
+	/// directory) or end with a directory separator, as the read paths of the Shell do.</param>
+	/// <param name="maxCachedAssetSize">Assets larger than this (in bytes) are never kept in memory.</param>
+	/// <param name="maxCacheSize">The maximum number of bytes kept in memory in total.</param>
+	explicit CachingAssetProvider(const std::vector<std::string>& searchPaths, size_t maxCachedAssetSize = 256 * 1024, size_t maxCacheSize = 32 * 1024 * 1024);
+
+	/// <summary>Create a Stream from the provided filename. Absolute names are opened directly. Relative names are
+	/// looked up in the in-memory cache, then in the search paths in order, then in the archive.</summary>
+	/// <param name="filename">The name of the asset, relative to the search paths, or absolute.</param>
+	/// <param name="logErrorOnNotFound">OPTIONAL. Set this to false to avoid logging an error when the file is not found.
+	/// </param>
+	/// <returns>An open Stream. NULL if the asset is not found.</returns>
+	std::unique_ptr<Stream> getAssetStream(const std::string& filename, bool logErrorOnNotFound = true);
+
+	/// <summary>Set a provider that is searched after the search paths, typically one serving a packed asset archive.
+	/// </summary>
+	/// <param name="archive">The provider. Pass NULL to remove the current one.</param>
+	void setArchive(const std::shared_ptr<IAssetProvider>& archive);
+
+	/// <summary>Replace the search paths. The index is rebuilt on the next request. The cache is cleared.</summary>
+	/// <param name="searchPaths">The new directories to search, in priority order.</param>
+	void setSearchPaths(const std::vector<std::string>& searchPaths);
+
+	/// <summary>Get the search paths.</summary>
+	/// <returns>The directories searched, in priority order.</returns>
+	std::vector<std::string> getSearchPaths() const;
+
+	/// <summary>Drops the index, so that directories are listed again. Call this after creating files in the search
+	/// paths. Does not clear the cache.</summary>
+	void rebuildIndex();
+
+	/// <summary>Drops every asset kept in memory. Streams already returned stay valid.</summary>
+	void clearCache();
+
+	/// <summary>Set how many times an asset must be requested before it is kept in memory. 1 caches every small
+	/// asset on its first load, 0 disables the cache. Default 2.</summary>
+	/// <param name="numRequests">The number of requests.</param>
+	void setCacheThreshold(uint32_t numRequests);
+
+	/// <summary>Set the maximum number of entries a directory may contain for it to be indexed. Default 65536.
+	/// </summary>
+	/// <param name="maxEntries">The maximum number of files and subdirectories.</param>
+	void setMaxDirectoryEntries(size_t maxEntries);
+
+	/// <summary>Get the maximum number of entries a directory may contain for it to be indexed.</summary>
+	/// <returns>The maximum number of files and subdirectories.</returns>
+	size_t getMaxDirectoryEntries() const;
+
+	/// <summary>Get a snapshot of the counters.</summary>
+	/// <returns>The statistics gathered since construction or the last resetStatistics().</returns>
+	AssetProviderStatistics getStatistics() const;
+
+	/// <summary>Zeroes the request counters. The counters describing the index and the cache are kept.</summary>
+	void resetStatistics();
+
+private:
+	struct DirectoryListing
+	{
+		std::unordered_set<std::string> entries;
+		bool complete; // False if the directory could not be listed, and must be probed
+		DirectoryListing() : complete(false) {}
+	};
+	struct SearchPath
+	{
+		std::string path;
+		std::unordered_map<std::string, DirectoryListing> directories; // Keyed by relative path, using '/' as the separator
+		size_t aliasOf; // Index of an earlier search path resolving to the same directory, or the own index
+	};
+
+	void resolveAliases();
+	void indexDirectory(const std::string& directory, std::unique_lock<std::mutex>& lock);
+	std::unique_ptr<Stream> openFile(const std::string& path, const std::string& key);
+
+	mutable std::mutex _mutex;
+	std::vector<SearchPath> _searchPaths;
+	uint64_t _indexGeneration; // Changes whenever the index is dropped, so that listings made meanwhile are discarded
+	std::unordered_map<std::string, std::shared_ptr<const std::vector<char> > > _cache; // Only the assets held in memory
+	std::unordered_map<std::string, uint32_t> _numRequests; // Requests of the assets small enough to be cached, until cached
+	std::shared_ptr<IAssetProvider> _archive;
+	AssetProviderStatistics _statistics;
+	size_t _maxCachedAssetSize;
+	size_t _maxCacheSize;
+	size_t _maxDirectoryEntries;
+	uint32_t _cacheThreshold;
+	bool _aliasesResolved;
+};
+} // namespace pvr
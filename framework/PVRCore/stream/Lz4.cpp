@@ -0,0 +1,268 @@
+/*!
+\brief Implementation of the LZ4 block encoder and decoder.
+\file PVRCore/stream/Lz4.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/Lz4.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace pvr {
+namespace lz4 {
+namespace {
+const size_t MinMatch = 4;
+const size_t LastLiterals = 5; // The last bytes of a block are always literals
+const size_t MatchFindLimit = 12; // No match may start closer than this to the end of a block
+const size_t MaxOffset = 65535;
+const uint32_t HashLog = 14;
+
+inline uint32_t read32(const uint8_t* ptr)
+{
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+inline uint32_t hashSequence(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HashLog);
+}
+
+// Writes a length that did not fit in its 4 bit field as a run of 255s and a remainder.
+inline uint8_t* writeLengthExtension(uint8_t* out, size_t length)
+{
+	for (; length >= 255; length -= 255)
+	{
+		*out++ = 255;
+	}
+	*out++ = static_cast<uint8_t>(length);
+	return out;
+}
+
+// Writes a sequence: literals followed by a match. A matchLength of 0 writes the last, literal only, sequence.
+inline uint8_t* writeSequence(uint8_t* out, const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength)
+{
+	uint8_t* token = out++;
+	*token = static_cast<uint8_t>((numLiterals >= 15 ? 15 : numLiterals) << 4);
+	if (numLiterals >= 15)
+	{
+		out = writeLengthExtension(out, numLiterals - 15);
+	}
+	memcpy(out, literals, numLiterals);
+	out += numLiterals;
+	if (matchLength)
+	{
+		*out++ = static_cast<uint8_t>(offset);
+		*out++ = static_cast<uint8_t>(offset >> 8);
+		const size_t length = matchLength - MinMatch;
+		*token |= static_cast<uint8_t>(length >= 15 ? 15 : length);
+		if (length >= 15)
+		{
+			out = writeLengthExtension(out, length - 15);
+		}
+	}
+	return out;
+}
+
+const size_t WildCopyLength = 16;
+
+// Copies length bytes in chunks of WildCopyLength, so may write (and read) up to WildCopyLength - 1 bytes past the
+// end. The source must be at least WildCopyLength bytes behind the destination, or not overlap it.
+inline void wildCopy(uint8_t* destination, const uint8_t* source, size_t length)
+{
+	uint8_t* const end = destination + length;
+	do
+	{
+		memcpy(destination, source, WildCopyLength);
+		destination += WildCopyLength;
+		source += WildCopyLength;
+	} while (destination < end);
+}
+
+// Reads the extension of a length field. Returns false if the input ends first.
+inline bool readLengthExtension(const uint8_t*& in, const uint8_t* inEnd, size_t& length)
+{
+	uint8_t byte;
+	do
+	{
+		if (in == inEnd)
+		{
+			return false;
+		}
+		byte = *in++;
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+} // namespace
+
+size_t compress(const void* source, size_t sourceSize, void* destination, size_t destinationCapacity)
+{
+	const uint8_t* const src = static_cast<const uint8_t*>(source);
+	uint8_t* const dstStart = static_cast<uint8_t*>(destination);
+	// The worst case of a sequence is never larger than its literals plus a header, so writing into a scratch buffer
+	// of compressBound bytes is always safe; only the final size needs checking against the real capacity.
+	std::vector<uint8_t> scratch;
+	uint8_t* dst = dstStart;
+	if (destinationCapacity < compressBound(sourceSize))
+	{
+		scratch.resize(compressBound(sourceSize));
+		dst = scratch.data();
+	}
+	uint8_t* out = dst;
+
+	size_t anchor = 0;
+	if (sourceSize > MatchFindLimit)
+	{
+		std::vector<uint32_t> table(size_t(1) << HashLog, 0xFFFFFFFFu);
+		const size_t matchStartLimit = sourceSize - MatchFindLimit;
+		const size_t matchEndLimit = sourceSize - LastLiterals;
+		size_t position = 0;
+		while (position < matchStartLimit)
+		{
+			const uint32_t sequence = read32(src + position);
+			uint32_t& slot = table[hashSequence(sequence)];
+			const size_t candidate = slot;
+			slot = static_cast<uint32_t>(position);
+			if (candidate == 0xFFFFFFFFu || position - candidate > MaxOffset || read32(src + candidate) != sequence)
+			{
+				// Skip faster through incompressible data.
+				position += 1 + ((position - anchor) >> 6);
+				continue;
+			}
+			size_t matchStart = position;
+			size_t reference = candidate;
+			while (matchStart > anchor && reference > 0 && src[matchStart - 1] == src[reference - 1])
+			{
+				--matchStart;
+				--reference;
+			}
+			size_t matchEnd = position + MinMatch;
+			while (matchEnd < matchEndLimit && src[matchEnd] == src[reference + (matchEnd - matchStart)])
+			{
+				++matchEnd;
+			}
+
+			out = writeSequence(out, src + anchor, matchStart - anchor, matchStart - reference, matchEnd - matchStart);
+			anchor = position = matchEnd;
+			if (position < matchStartLimit)
+			{
+				table[hashSequence(read32(src + position - 2))] = static_cast<uint32_t>(position - 2);
+			}
+		}
+	}
+	out = writeSequence(out, src + anchor, sourceSize - anchor, 0, 0);
+
+	const size_t compressedSize = static_cast<size_t>(out - dst);
+	if (compressedSize > destinationCapacity)
+	{
+		return 0;
+	}
+	if (dst != dstStart)
+	{
+		memcpy(dstStart, dst, compressedSize);
+	}
+	return compressedSize;
+}
+
+bool decompress(const void* source, size_t sourceSize, void* destination, size_t destinationSize)
+{
+	const uint8_t* in = static_cast<const uint8_t*>(source);
+	const uint8_t* const inEnd = in + sourceSize;
+	uint8_t* const outStart = static_cast<uint8_t*>(destination);
+	uint8_t* out = outStart;
+	uint8_t* const outEnd = out + destinationSize;
+
+	while (in < inEnd)
+	{
+		const uint8_t token = *in++;
+		size_t numLiterals = token >> 4;
+		if (numLiterals == 15 && !readLengthExtension(in, inEnd, numLiterals))
+		{
+			return false;
+		}
+		if (numLiterals > static_cast<size_t>(inEnd - in) || numLiterals > static_cast<size_t>(outEnd - out))
+		{
+			return false;
+		}
+		if (static_cast<size_t>(inEnd - in) >= numLiterals + WildCopyLength && static_cast<size_t>(outEnd - out) >= numLiterals + WildCopyLength)
+		{
+			wildCopy(out, in, numLiterals);
+		}
+		else
+		{
+			memcpy(out, in, numLiterals);
+		}
+		in += numLiterals;
+		out += numLiterals;
+		if (in == inEnd)
+		{
+			break; // The last sequence has no match.
+		}
+
+		if (inEnd - in < 2)
+		{
+			return false;
+		}
+		const size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+		in += 2;
+		if (offset == 0 || offset > static_cast<size_t>(out - outStart))
+		{
+			return false;
+		}
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLengthExtension(in, inEnd, matchLength))
+		{
+			return false;
+		}
+		matchLength += MinMatch;
+		if (matchLength > static_cast<size_t>(outEnd - out))
+		{
+			return false;
+		}
+
+		const uint8_t* match = out - offset;
+		uint8_t* const matchEnd = out + matchLength;
+		if (static_cast<size_t>(outEnd - out) >= matchLength + WildCopyLength)
+		{
+			if (offset < WildCopyLength)
+			{
+				// Repeat the pattern byte by byte until the distance to its source allows chunked copies. The data is
+				// periodic, so any multiple of the offset is as good a source as the offset itself.
+				const size_t period = ((WildCopyLength + offset - 1) / offset) * offset;
+				const size_t head = period < matchLength ? period : matchLength;
+				for (size_t i = 0; i < head; ++i)
+				{
+					out[i] = match[i];
+				}
+				if (head < matchLength)
+				{
+					wildCopy(out + head, out + head - period, matchLength - head);
+				}
+			}
+			else
+			{
+				wildCopy(out, match, matchLength);
+			}
+		}
+		else if (offset >= matchLength)
+		{
+			memcpy(out, match, matchLength);
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; ++i)
+			{
+				out[i] = match[i]; // Overlapping: repeats the last offset bytes
+			}
+		}
+		out = matchEnd;
+	}
+	return out == outEnd;
+}
+} // namespace lz4
+} // namespace pvr
+//!\endcond
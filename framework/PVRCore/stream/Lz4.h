@@ -0,0 +1,39 @@
+/*!
+\brief A small encoder and decoder for the LZ4 block format, used by the asset archives.
+\file PVRCore/stream/Lz4.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include <cstddef>
+
+namespace pvr {
+/// <summary>Encoder and decoder for raw LZ4 blocks (not the LZ4 frame format). The output of compress() can be decoded by
+/// any LZ4 implementation, and decompress() accepts any valid LZ4 block. The encoder is a single pass greedy matcher:
+/// it favours speed and simplicity over compression ratio.</summary>
+namespace lz4 {
+/// <summary>Get the largest size compress() can produce for an input of a given size.</summary>
+/// <param name="sourceSize">The size of the uncompressed data, in bytes.</param>
+/// <returns>The size the destination buffer of compress() must have to always succeed.</returns>
+inline size_t compressBound(size_t sourceSize)
+{
+	return sourceSize + sourceSize / 255 + 16;
+}
+
+/// <summary>Compress a block of data.</summary>
+/// <param name="source">The data to compress.</param>
+/// <param name="sourceSize">The size of the data to compress, in bytes.</param>
+/// <param name="destination">The buffer receiving the compressed block.</param>
+/// <param name="destinationCapacity">The size of the destination buffer, in bytes.</param>
+/// <returns>The size of the compressed block, or 0 if it did not fit in destinationCapacity bytes.</returns>
+size_t compress(const void* source, size_t sourceSize, void* destination, size_t destinationCapacity);
+
+/// <summary>Decompress a block of data. Never reads or writes out of the bounds given, whatever the input.</summary>
+/// <param name="source">The compressed block.</param>
+/// <param name="sourceSize">The size of the compressed block, in bytes.</param>
+/// <param name="destination">The buffer receiving the uncompressed data.</param>
+/// <param name="destinationSize">The size of the uncompressed data, in bytes.</param>
+/// <returns>True if the block was valid and decompressed to exactly destinationSize bytes, otherwise false.</returns>
+bool decompress(const void* source, size_t sourceSize, void* destination, size_t destinationSize);
+} // namespace lz4
+} // namespace pvr
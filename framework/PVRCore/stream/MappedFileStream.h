@@ -0,0 +1,282 @@
+/*!
+\brief Read-only streams that access files through memory mapping.
+\file PVRCore/stream/MappedFileStream.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/stream/Stream.h"
+#include <algorithm>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pvr {
+/// <summary>A MappedFileStream is a read-only Stream that maps a File of the filesystem of the platform into memory.
+/// Reads are plain memory copies out of the mapping, and getMappedView gives readers direct access to any range of
+/// the file, so that large payloads (texture data, vertex data) can be used in place instead of being copied into
+/// intermediate buffers.</summary>
+class MappedFileStream : public Stream
+{
+public:
+	/// <summary>Create a new mapped file stream of a specified file.</summary>
+	/// <param name="filePath">The path of the file. Can be in any format the operating system understands (absolute,
+	/// relative etc.)</param>
+	/// <param name="errorOnFileNotFound">OPTIONAL. Set this to false to avoid an error when the file is not found.</param>
+	explicit MappedFileStream(const std::string& filePath, bool errorOnFileNotFound = true)
+		: Stream(filePath), _data(NULL), _size(0), _position(0), _isOpen(false), _errorOnFileNotFound(errorOnFileNotFound)
+	{
+		_isReadable = true;
+	}
+
+	~MappedFileStream()
+	{
+		close();
+	}
+
+	/// <summary>Main read function. Read up to a specified amount of items into the provided buffer.</summary>
+	/// <param name="elementSize">The size of each element that will be read.</param>
+	/// <param name="numElements">The maximum number of elements to read.</param>
+	/// <param name="buffer">The buffer into which to write the data.</param>
+	/// <param name="dataRead">After returning, will contain the number of items that were actually read.</param>
+	virtual void read(size_t elementSize, size_t numElements, void* buffer, size_t& dataRead) const
+	{
+		dataRead = 0;
+		if (!_isOpen)
+		{
+			throw FileIOError(getFileName(), "[MappedFileStream::read] Attempted to read empty stream.");
+		}
+		if (!elementSize)
+		{
+			return;
+		}
+		dataRead = std::min(numElements, (_size - _position) / elementSize);
+		const size_t bytes = dataRead * elementSize;
+		if (bytes)
+		{
+			willNeed(_position, bytes);
+			memcpy(buffer, _data + _position, bytes);
+			_position += bytes;
+		}
+		if (dataRead != numElements)
+		{
+			throw FileIOError(getFileName(), "[MappedFileStream::read] Was attempting to read past the end of stream.");
+		}
+	}
+
+	/// <summary>Not supported: MappedFileStreams are read-only.</summary>
+	virtual void write(size_t, size_t, const void*, size_t& dataWritten)
+	{
+		dataWritten = 0;
+		throw FileIOError(getFileName(), "[MappedFileStream::write] Attempted to write a non-writable stream.");
+	}
+
+	/// <summary>Seek a specific point for random access streams. After successful call, subsequent operation will
+	/// happen in the specified point.</summary>
+	/// <param name="offset">The offset to seek from "origin".</param>
+	/// <param name="origin">Beginning of stream, End of stream or Current position.</param>
+	virtual void seek(long offset, SeekOrigin origin) const
+	{
+		if (!_isOpen)
+		{
+			if (offset)
+			{
+				throw FileIOError(getFileName(), "[MappedFileStream::seek] Attempt to seek in empty stream.");
+			}
+			return;
+		}
+		int64_t base = 0;
+		switch (origin)
+		{
+		case SeekOriginFromStart: base = 0; break;
+		case SeekOriginFromCurrent: base = static_cast<int64_t>(_position); break;
+		case SeekOriginFromEnd: base = static_cast<int64_t>(_size); break;
+		}
+		const int64_t newPosition = base + offset;
+		if (newPosition < 0 || newPosition > static_cast<int64_t>(_size))
+		{
+			throw FileIOError(getFileName(), "[MappedFileStream::seek] Attempt to seek  past the end of stream.");
+		}
+		_position = static_cast<size_t>(newPosition);
+	}
+
+	/// <summary>Maps the file and prepares the stream for read / seek operations.</summary>
+	virtual void open() const
+	{
+		if (_isOpen) // If file is mapped, just reset it.
+		{
+			_position = 0;
+			return;
+		}
+		if (_fileName.length() == 0)
+		{
+			throw InvalidOperationError("[MappedFileStream::open] Attempted to open a nonexistent file");
+		}
+		if (!map())
+		{
+			if (_errorOnFileNotFound)
+			{
+				throw FileNotFoundError(_fileName, "[MappedFileStream::open] Failed to open file.");
+			}
+			return;
+		}
+		_position = 0;
+		_isOpen = true;
+	}
+
+	/// <summary>Unmaps the file.</summary>
+	virtual void close()
+	{
+		if (_data)
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(_data);
+#else
+			munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+		}
+		_data = NULL;
+		_size = 0;
+		_position = 0;
+		_isOpen = false;
+	}
+
+	/// <summary>Query if the stream is open</summary>
+	/// <returns>True if the stream is open and ready for other operations.</returns>
+	virtual bool isopen() const
+	{
+		return _isOpen;
+	}
+
+	/// <summary>Query the current position in the stream</summary>
+	/// <returns>The current position in the stream.</returns>
+	virtual size_t getPosition() const
+	{
+		return _position;
+	}
+
+	/// <summary>Query the total amount of data in the stream.</summary>
+	/// <returns>The total amount of data in the stream.</returns>
+	virtual size_t getSize() const
+	{
+		return _size;
+	}
+
+	/// <summary>Get a pointer to a range of the mapped file.</summary>
+	/// <param name="offset">The offset of the range from the start of the file</param>
+	/// <param name="size">The size of the range, in bytes</param>
+	/// <returns>A pointer to the range, or NULL if the stream is not open or the range does not fit in the file.</returns>
+	virtual const void* getMappedView(size_t offset, size_t size) const
+	{
+		if (!_isOpen || offset > _size || size > _size - offset)
+		{
+			return NULL;
+		}
+		return _data + offset;
+	}
+
+	/// <summary>Create a new mapped file stream from a filename, and open it.</summary>
+	/// <param name="filename">The filename to create a stream for</param>
+	/// <param name="errorOnFileNotFound">OPTIONAL. Set this to false to avoid an error when the file is not found.</param>
+	/// <returns>Return a valid stream, else Return null if it fails</returns>
+	static Stream::ptr_type createMappedFileStream(const char* filename, bool errorOnFileNotFound = true)
+	{
+		Stream::ptr_type stream(new MappedFileStream(filename, errorOnFileNotFound));
+		stream->open();
+		return stream;
+	}
+
+private:
+	// Map the whole file. Returns false if it could not be opened. Empty files are opened without a mapping.
+	bool map() const
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileA(_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return false;
+		}
+		_size = static_cast<size_t>(fileSize.QuadPart);
+		if (_size)
+		{
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			_data = mapping ? static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : NULL;
+			if (mapping)
+			{
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		int file = ::open(_fileName.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+		struct stat fileStat;
+		if (fstat(file, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+		{
+			::close(file);
+			return false;
+		}
+		_size = static_cast<size_t>(fileStat.st_size);
+		if (_size)
+		{
+			// Pages are faulted in as they are used (see willNeed), so that opening a large file (e.g. an asset archive)
+			// to use a small part of it does not read all of it.
+			void* mapping = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, file, 0);
+			_data = (mapping == MAP_FAILED) ? NULL : static_cast<const unsigned char*>(mapping);
+		}
+		::close(file); // The mapping keeps the file alive
+#endif
+		if (_size && !_data)
+		{
+			_size = 0;
+			throw FileIOError(getFileName(), "[MappedFileStream::open] Failed to map file.");
+		}
+		return true;
+	}
+
+	// Ask the system to start reading a range that is about to be copied, so that a large read is not served one page
+	// fault at a time. Small reads are left to the read-ahead of the system.
+	void willNeed(size_t offset, size_t size) const
+	{
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+		if (size < 65536)
+		{
+			return;
+		}
+		const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		const size_t start = offset & ~(pageSize - 1);
+		madvise(const_cast<unsigned char*>(_data) + start, offset + size - start, MADV_WILLNEED);
+#else
+		(void)offset;
+		(void)size;
+#endif
+	}
+
+	mutable const unsigned char* _data; //!< The start of the mapping
+	mutable size_t _size; //!< The size of the file
+	mutable size_t _position; //!< Offset of the current position in the stream
+	mutable bool _isOpen; //!< True if the file is open (an empty file is open, but has no mapping)
+	bool _errorOnFileNotFound; //!< True to error when files are not found
+};
+
+} // namespace pvr
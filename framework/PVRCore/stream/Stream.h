@@ -168,6 +168,21 @@ public:
 	/// <returns>If suppored, returns the total amount of data in the stream. Otherwise, returns 0.</returns>
 	virtual size_t getSize() const = 0;
 
+	/// <summary>If supported, returns a pointer through which a range of the stream can be accessed directly in memory,
+	/// without copying it out with read (e.g. a memory mapped file, or the memory a BufferStream wraps). The pointer
+	/// stays valid until the stream is closed. Does not change the current position. Readers should fall back to read
+	/// if it returns NULL.</summary>
+	/// <param name="offset">The offset of the range from the start of the stream</param>
+	/// <param name="size">The size of the range, in bytes</param>
+	/// <returns>A pointer to the range. NULL if the stream cannot be accessed in place, is not open, or the range does
+	/// not fit in the stream.</returns>
+	virtual const void* getMappedView(size_t offset, size_t size) const
+	{
+		(void)offset;
+		(void)size;
+		return NULL;
+	}
+
 	/// <summary>Convenience functions that reads all data in the stream into a contiguous block of memory of a specified
 	/// element type. Requires random-access stream.</summary>
 	/// <typeparam name="Type_">The type of item that will be read into.</typeparam>
@@ -12,9 +12,22 @@
 #include <cmath>
 #include <algorithm>
 #include <cstring>
+#include <deque>
+#include <vector>
 #include "PVRTDecompress.h"
+#include "PVRCore/Errors.h"
+#include "PVRCore/Log.h"
+#include "PVRCore/Threading.h"
 #include <cassert>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_DECOMPRESS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_DECOMPRESS_NEON
+#include <arm_neon.h>
+#endif
+
 namespace pvr {
 enum
 {
@@ -29,22 +42,12 @@ struct Pixel32
 	uint8_t red, green, blue, alpha;
 };
 
-struct Pixel128S
-{
-	int32_t red, green, blue, alpha;
-};
-
 struct PVRTCWord
 {
 	uint32_t u32ModulationData;
 	uint32_t u32ColorData;
 };
 
-struct PVRTCWordIndices
-{
-	int P[2], Q[2], R[2], S[2];
-};
-
 static Pixel32 getColorA(uint32_t u32ColorData)
 {
 	Pixel32 color;
@@ -93,101 +96,6 @@ static Pixel32 getColorB(uint32_t u32ColorData)
 	return color;
 }
 
-static void interpolateColors(Pixel32 P, Pixel32 Q, Pixel32 R, Pixel32 S, Pixel128S* pPixel, uint8_t ui8Bpp)
-{
-	uint32_t ui32WordWidth = 4;
-	uint32_t ui32WordHeight = 4;
-	if (ui8Bpp == 2)
-	{
-		ui32WordWidth = 8;
-	}
-
-	// Convert to int 32.
-	Pixel128S hP = { static_cast<int32_t>(P.red), static_cast<int32_t>(P.green), static_cast<int32_t>(P.blue), static_cast<int32_t>(P.alpha) };
-	Pixel128S hQ = { static_cast<int32_t>(Q.red), static_cast<int32_t>(Q.green), static_cast<int32_t>(Q.blue), static_cast<int32_t>(Q.alpha) };
-	Pixel128S hR = { static_cast<int32_t>(R.red), static_cast<int32_t>(R.green), static_cast<int32_t>(R.blue), static_cast<int32_t>(R.alpha) };
-	Pixel128S hS = { static_cast<int32_t>(S.red), static_cast<int32_t>(S.green), static_cast<int32_t>(S.blue), static_cast<int32_t>(S.alpha) };
-
-	// Get vectors.
-	Pixel128S QminusP = { hQ.red - hP.red, hQ.green - hP.green, hQ.blue - hP.blue, hQ.alpha - hP.alpha };
-	Pixel128S SminusR = { hS.red - hR.red, hS.green - hR.green, hS.blue - hR.blue, hS.alpha - hR.alpha };
-
-	// Multiply colors.
-	hP.red *= ui32WordWidth;
-	hP.green *= ui32WordWidth;
-	hP.blue *= ui32WordWidth;
-	hP.alpha *= ui32WordWidth;
-	hR.red *= ui32WordWidth;
-	hR.green *= ui32WordWidth;
-	hR.blue *= ui32WordWidth;
-	hR.alpha *= ui32WordWidth;
-
-	if (ui8Bpp == 2)
-	{
-		// Loop through pixels to achieve results.
-		for (uint32_t x = 0; x < ui32WordWidth; x++)
-		{
-			Pixel128S result = { 4 * hP.red, 4 * hP.green, 4 * hP.blue, 4 * hP.alpha };
-			Pixel128S dY = { hR.red - hP.red, hR.green - hP.green, hR.blue - hP.blue, hR.alpha - hP.alpha };
-
-			for (uint32_t y = 0; y < ui32WordHeight; y++)
-			{
-				pPixel[y * ui32WordWidth + x].red = static_cast<int32_t>((result.red >> 7) + (result.red >> 2));
-				pPixel[y * ui32WordWidth + x].green = static_cast<int32_t>((result.green >> 7) + (result.green >> 2));
-				pPixel[y * ui32WordWidth + x].blue = static_cast<int32_t>((result.blue >> 7) + (result.blue >> 2));
-				pPixel[y * ui32WordWidth + x].alpha = static_cast<int32_t>((result.alpha >> 5) + (result.alpha >> 1));
-
-				result.red += dY.red;
-				result.green += dY.green;
-				result.blue += dY.blue;
-				result.alpha += dY.alpha;
-			}
-
-			hP.red += QminusP.red;
-			hP.green += QminusP.green;
-			hP.blue += QminusP.blue;
-			hP.alpha += QminusP.alpha;
-
-			hR.red += SminusR.red;
-			hR.green += SminusR.green;
-			hR.blue += SminusR.blue;
-			hR.alpha += SminusR.alpha;
-		}
-	}
-	else
-	{
-		// Loop through pixels to achieve results.
-		for (uint32_t y = 0; y < ui32WordHeight; y++)
-		{
-			Pixel128S result = { 4 * hP.red, 4 * hP.green, 4 * hP.blue, 4 * hP.alpha };
-			Pixel128S dY = { hR.red - hP.red, hR.green - hP.green, hR.blue - hP.blue, hR.alpha - hP.alpha };
-
-			for (uint32_t x = 0; x < ui32WordWidth; x++)
-			{
-				pPixel[y * ui32WordWidth + x].red = static_cast<int32_t>((result.red >> 6) + (result.red >> 1));
-				pPixel[y * ui32WordWidth + x].green = static_cast<int32_t>((result.green >> 6) + (result.green >> 1));
-				pPixel[y * ui32WordWidth + x].blue = static_cast<int32_t>((result.blue >> 6) + (result.blue >> 1));
-				pPixel[y * ui32WordWidth + x].alpha = static_cast<int32_t>((result.alpha >> 4) + (result.alpha));
-
-				result.red += dY.red;
-				result.green += dY.green;
-				result.blue += dY.blue;
-				result.alpha += dY.alpha;
-			}
-
-			hP.red += QminusP.red;
-			hP.green += QminusP.green;
-			hP.blue += QminusP.blue;
-			hP.alpha += QminusP.alpha;
-
-			hR.red += SminusR.red;
-			hR.green += SminusR.green;
-			hR.blue += SminusR.blue;
-			hR.alpha += SminusR.alpha;
-		}
-	}
-}
-
 static void unpackModulations(const PVRTCWord& word, int offsetX, int offsetY, int32_t i32ModulationValues[16][8], int32_t i32ModulationModes[16][8], uint8_t ui8Bpp)
 {
 	uint32_t WordModMode = word.u32ColorData & 0x1;
@@ -377,82 +285,7 @@ static int32_t getModulationValues(int32_t i32ModulationValues[16][8], int32_t i
 	return 0;
 }
 
-static void pvrtcGetDecompressedPixels(const PVRTCWord& P, const PVRTCWord& Q, const PVRTCWord& R, const PVRTCWord& S, Pixel32* pColorData, uint8_t ui8Bpp)
-{
-	// 4bpp only needs 8*8 values, but 2bpp needs 16*8, so rather than wasting processor time we just statically allocate 16*8.
-	int32_t i32ModulationValues[16][8];
-	// Only 2bpp needs this.
-	int32_t i32ModulationModes[16][8];
-	// 4bpp only needs 16 values, but 2bpp needs 32, so rather than wasting processor time we just statically allocate 32.
-	Pixel128S upscaledColorA[32];
-	Pixel128S upscaledColorB[32];
-
-	uint32_t ui32WordWidth = 4;
-	uint32_t ui32WordHeight = 4;
-	if (ui8Bpp == 2)
-	{
-		ui32WordWidth = 8;
-	}
-
-	// Get the modulations from each word.
-	unpackModulations(P, 0, 0, i32ModulationValues, i32ModulationModes, ui8Bpp);
-	unpackModulations(Q, ui32WordWidth, 0, i32ModulationValues, i32ModulationModes, ui8Bpp);
-	unpackModulations(R, 0, ui32WordHeight, i32ModulationValues, i32ModulationModes, ui8Bpp);
-	unpackModulations(S, ui32WordWidth, ui32WordHeight, i32ModulationValues, i32ModulationModes, ui8Bpp);
-
-	// Bilinear upscale image data from 2x2 -> 4x4
-	interpolateColors(getColorA(P.u32ColorData), getColorA(Q.u32ColorData), getColorA(R.u32ColorData), getColorA(S.u32ColorData), upscaledColorA, ui8Bpp);
-	interpolateColors(getColorB(P.u32ColorData), getColorB(Q.u32ColorData), getColorB(R.u32ColorData), getColorB(S.u32ColorData), upscaledColorB, ui8Bpp);
-
-	for (uint32_t y = 0; y < ui32WordHeight; y++)
-	{
-		for (uint32_t x = 0; x < ui32WordWidth; x++)
-		{
-			int32_t mod = getModulationValues(i32ModulationValues, i32ModulationModes, x + ui32WordWidth / 2, y + ui32WordHeight / 2, ui8Bpp);
-			bool punchthroughAlpha = false;
-			if (mod > 10)
-			{
-				punchthroughAlpha = true;
-				mod -= 10;
-			}
-
-			Pixel128S result;
-			result.red = (upscaledColorA[y * ui32WordWidth + x].red * (8 - mod) + upscaledColorB[y * ui32WordWidth + x].red * mod) / 8;
-			result.green = (upscaledColorA[y * ui32WordWidth + x].green * (8 - mod) + upscaledColorB[y * ui32WordWidth + x].green * mod) / 8;
-			result.blue = (upscaledColorA[y * ui32WordWidth + x].blue * (8 - mod) + upscaledColorB[y * ui32WordWidth + x].blue * mod) / 8;
-			if (punchthroughAlpha)
-			{
-				result.alpha = 0;
-			}
-			else
-			{
-				result.alpha = (upscaledColorA[y * ui32WordWidth + x].alpha * (8 - mod) + upscaledColorB[y * ui32WordWidth + x].alpha * mod) / 8;
-			}
-
-			// Convert the 32bit precision Result to 8 bit per channel color.
-			if (ui8Bpp == 2)
-			{
-				pColorData[y * ui32WordWidth + x].red = static_cast<uint8_t>(result.red);
-				pColorData[y * ui32WordWidth + x].green = static_cast<uint8_t>(result.green);
-				pColorData[y * ui32WordWidth + x].blue = static_cast<uint8_t>(result.blue);
-				pColorData[y * ui32WordWidth + x].alpha = static_cast<uint8_t>(result.alpha);
-			}
-			else if (ui8Bpp == 4)
-			{
-				pColorData[y + x * ui32WordHeight].red = static_cast<uint8_t>(result.red);
-				pColorData[y + x * ui32WordHeight].green = static_cast<uint8_t>(result.green);
-				pColorData[y + x * ui32WordHeight].blue = static_cast<uint8_t>(result.blue);
-				pColorData[y + x * ui32WordHeight].alpha = static_cast<uint8_t>(result.alpha);
-			}
-		}
-	}
-}
-
-static uint32_t wrapWordIndex(uint32_t numWords, int word)
-{
-	return ((word + numWords) % numWords);
-}
-
+#ifndef NDEBUG // Only used by the assertions
 static bool isPowerOf2(uint32_t input)
 {
 	uint32_t minus1;
@@ -465,6 +298,7 @@ static bool isPowerOf2(uint32_t input)
 	minus1 = input - 1;
 	return ((input | minus1) == (input ^ minus1));
 }
+#endif
 
 static uint32_t TwiddleUV(uint32_t XSize, uint32_t YSize, uint32_t XPos, uint32_t YPos)
 {
@@ -514,185 +348,420 @@ static uint32_t TwiddleUV(uint32_t XSize, uint32_t YSize, uint32_t XPos, uint32_
 	return Twiddled;
 }
 
-static void mapDecompressedData(Pixel32* pOutput, int width, const Pixel32* pWord, const PVRTCWordIndices& words, uint8_t ui8Bpp)
+// Eight 16 bit lanes, i.e. two RGBA pixels at 16 bit precision. All the arithmetic used by the PVRTC decoder (colour
+// interpolation and modulation) fits in 16 bits, so it is done two pixels at a time with SSE2 or NEON where available.
+struct Lanes16
 {
-	uint32_t ui32WordWidth = 4;
-	uint32_t ui32WordHeight = 4;
-	if (ui8Bpp == 2)
+#if defined(PVR_DECOMPRESS_SSE2)
+	__m128i v;
+#elif defined(PVR_DECOMPRESS_NEON)
+	int16x8_t v;
+#else
+	int16_t v[8];
+#endif
+};
+
+inline Lanes16 loadLanes(const int16_t* values)
+{
+	Lanes16 result;
+#if defined(PVR_DECOMPRESS_SSE2)
+	result.v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+#elif defined(PVR_DECOMPRESS_NEON)
+	result.v = vld1q_s16(values);
+#else
+	memcpy(result.v, values, sizeof(result.v));
+#endif
+	return result;
+}
+
+inline Lanes16 operator+(const Lanes16& a, const Lanes16& b)
+{
+	Lanes16 result;
+#if defined(PVR_DECOMPRESS_SSE2)
+	result.v = _mm_add_epi16(a.v, b.v);
+#elif defined(PVR_DECOMPRESS_NEON)
+	result.v = vaddq_s16(a.v, b.v);
+#else
+	for (int i = 0; i < 8; ++i)
 	{
-		ui32WordWidth = 8;
+		result.v[i] = static_cast<int16_t>(a.v[i] + b.v[i]);
 	}
+#endif
+	return result;
+}
 
-	for (uint32_t y = 0; y < ui32WordHeight / 2; y++)
+inline Lanes16 operator-(const Lanes16& a, const Lanes16& b)
+{
+	Lanes16 result;
+#if defined(PVR_DECOMPRESS_SSE2)
+	result.v = _mm_sub_epi16(a.v, b.v);
+#elif defined(PVR_DECOMPRESS_NEON)
+	result.v = vsubq_s16(a.v, b.v);
+#else
+	for (int i = 0; i < 8; ++i)
 	{
-		for (uint32_t x = 0; x < ui32WordWidth / 2; x++)
-		{
-			pOutput[(((words.P[1] * ui32WordHeight) + y + ui32WordHeight / 2) * width + words.P[0] * ui32WordWidth + x + ui32WordWidth / 2)] = pWord[y * ui32WordWidth + x]; // map P
-
-			pOutput[(((words.Q[1] * ui32WordHeight) + y + ui32WordHeight / 2) * width + words.Q[0] * ui32WordWidth + x)] = pWord[y * ui32WordWidth + x + ui32WordWidth / 2]; // map Q
-
-			pOutput[(((words.R[1] * ui32WordHeight) + y) * width + words.R[0] * ui32WordWidth + x + ui32WordWidth / 2)] = pWord[(y + ui32WordHeight / 2) * ui32WordWidth + x]; // map R
-
-			pOutput[(((words.S[1] * ui32WordHeight) + y) * width + words.S[0] * ui32WordWidth + x)] = pWord[(y + ui32WordHeight / 2) * ui32WordWidth + x + ui32WordWidth / 2]; // map S
-		}
+		result.v[i] = static_cast<int16_t>(a.v[i] - b.v[i]);
 	}
+#endif
+	return result;
 }
-static int pvrtcDecompress(uint8_t* pCompressedData, Pixel32* pDecompressedData, uint32_t ui32Width, uint32_t ui32Height, uint8_t ui8Bpp)
+
+inline Lanes16 operator*(const Lanes16& a, const Lanes16& b)
 {
-	uint32_t ui32WordWidth = 4;
-	uint32_t ui32WordHeight = 4;
-	if (ui8Bpp == 2)
+	Lanes16 result;
+#if defined(PVR_DECOMPRESS_SSE2)
+	result.v = _mm_mullo_epi16(a.v, b.v);
+#elif defined(PVR_DECOMPRESS_NEON)
+	result.v = vmulq_s16(a.v, b.v);
+#else
+	for (int i = 0; i < 8; ++i)
 	{
-		ui32WordWidth = 8;
+		result.v[i] = static_cast<int16_t>(a.v[i] * b.v[i]);
 	}
+#endif
+	return result;
+}
 
-	uint32_t* pWordMembers = (uint32_t*)pCompressedData;
-	Pixel32* pOutData = pDecompressedData;
-
-	// Calculate number of words
-	int i32NumXWords = static_cast<int>(ui32Width / ui32WordWidth);
-	int i32NumYWords = static_cast<int>(ui32Height / ui32WordHeight);
-
-	// Structs used for decompression
-	PVRTCWordIndices indices;
-	Pixel32* pPixels;
-	pPixels = static_cast<Pixel32*>(malloc(ui32WordWidth * ui32WordHeight * sizeof(Pixel32)));
+// Arithmetic shift right of every lane by a different amount for the colour (lanes 0-2, 4-6) and alpha (lanes 3, 7)
+inline Lanes16 shiftRight(const Lanes16& a, int colorShift, int alphaShift)
+{
+	Lanes16 result;
+#if defined(PVR_DECOMPRESS_SSE2)
+	const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+	const __m128i color = _mm_sra_epi16(a.v, _mm_cvtsi32_si128(colorShift));
+	const __m128i alpha = _mm_sra_epi16(a.v, _mm_cvtsi32_si128(alphaShift));
+	result.v = _mm_or_si128(_mm_andnot_si128(alphaMask, color), _mm_and_si128(alphaMask, alpha));
+#elif defined(PVR_DECOMPRESS_NEON)
+	const int16_t shifts[8] = { static_cast<int16_t>(-colorShift), static_cast<int16_t>(-colorShift), static_cast<int16_t>(-colorShift),
+		static_cast<int16_t>(-alphaShift), static_cast<int16_t>(-colorShift), static_cast<int16_t>(-colorShift), static_cast<int16_t>(-colorShift),
+		static_cast<int16_t>(-alphaShift) };
+	result.v = vshlq_s16(a.v, vld1q_s16(shifts));
+#else
+	for (int i = 0; i < 8; ++i)
+	{
+		result.v[i] = static_cast<int16_t>(a.v[i] >> ((i & 3) == 3 ? alphaShift : colorShift));
+	}
+#endif
+	return result;
+}
 
-	// For each row of words
-	for (int wordY = -1; wordY < i32NumYWords - 1; wordY++)
+// Narrow 4 pixels to 8 bits per channel. All values are known to be in [0..255].
+inline void storePixels(uint8_t* out, const Lanes16& lo, const Lanes16& hi)
+{
+#if defined(PVR_DECOMPRESS_SSE2)
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(lo.v, hi.v));
+#elif defined(PVR_DECOMPRESS_NEON)
+	vst1q_u8(out, vcombine_u8(vqmovun_s16(lo.v), vqmovun_s16(hi.v)));
+#else
+	for (int i = 0; i < 8; ++i)
 	{
-		// for each column of words
-		for (int wordX = -1; wordX < i32NumXWords - 1; wordX++)
-		{
-			indices.P[0] = wrapWordIndex(i32NumXWords, wordX);
-			indices.P[1] = wrapWordIndex(i32NumYWords, wordY);
-			indices.Q[0] = wrapWordIndex(i32NumXWords, wordX + 1);
-			indices.Q[1] = wrapWordIndex(i32NumYWords, wordY);
-			indices.R[0] = wrapWordIndex(i32NumXWords, wordX);
-			indices.R[1] = wrapWordIndex(i32NumYWords, wordY + 1);
-			indices.S[0] = wrapWordIndex(i32NumXWords, wordX + 1);
-			indices.S[1] = wrapWordIndex(i32NumYWords, wordY + 1);
-
-			// Work out the offsets into the twiddle structs, multiply by two as there are two members per word.
-			uint32_t WordOffsets[4] = {
-				TwiddleUV(i32NumXWords, i32NumYWords, indices.P[0], indices.P[1]) * 2,
-				TwiddleUV(i32NumXWords, i32NumYWords, indices.Q[0], indices.Q[1]) * 2,
-				TwiddleUV(i32NumXWords, i32NumYWords, indices.R[0], indices.R[1]) * 2,
-				TwiddleUV(i32NumXWords, i32NumYWords, indices.S[0], indices.S[1]) * 2,
-			};
-
-			// Access individual elements to fill out PVRTCWord
-			PVRTCWord P, Q, R, S;
-			P.u32ColorData = static_cast<uint32_t>(pWordMembers[WordOffsets[0] + 1]);
-			P.u32ModulationData = static_cast<uint32_t>(pWordMembers[WordOffsets[0]]);
-			Q.u32ColorData = static_cast<uint32_t>(pWordMembers[WordOffsets[1] + 1]);
-			Q.u32ModulationData = static_cast<uint32_t>(pWordMembers[WordOffsets[1]]);
-			R.u32ColorData = static_cast<uint32_t>(pWordMembers[WordOffsets[2] + 1]);
-			R.u32ModulationData = static_cast<uint32_t>(pWordMembers[WordOffsets[2]]);
-			S.u32ColorData = static_cast<uint32_t>(pWordMembers[WordOffsets[3] + 1]);
-			S.u32ModulationData = static_cast<uint32_t>(pWordMembers[WordOffsets[3]]);
-
-			// assemble 4 words into struct to get decompressed pixels from
-			pvrtcGetDecompressedPixels(P, Q, R, S, pPixels, ui8Bpp);
-			mapDecompressedData(pOutData, ui32Width, pPixels, indices, ui8Bpp);
-
-		} // for each word
-	} // for each row of words
-
-	free(pPixels);
-	// Return the data size
-	return ui32Width * ui32Height / static_cast<uint32_t>((ui32WordWidth / 2));
+		out[i] = static_cast<uint8_t>(lo.v[i]);
+		out[i + 8] = static_cast<uint8_t>(hi.v[i]);
+	}
+#endif
 }
 
-uint32_t PVRTDecompressPVRTC(const void* pCompressedData, uint32_t Do2bitMode, uint32_t XDim, uint32_t YDim, uint8_t* pResultImage)
+// A PVRTC surface being decompressed. Decompression works on windows of 2x2 words (P Q / R S), each producing one
+// word's worth of pixels centred between the four words. A row of windows writes a distinct set of output rows, so
+// rows of windows are decompressed independently (and in parallel).
+class PvrtcSurface
 {
-	// Cast the output buffer to a Pixel32 pointer.
-	Pixel32* pDecompressedData = (Pixel32*)pResultImage;
+public:
+	// width and height must be at least the minimum PVRTC surface size
+	PvrtcSurface(const void* compressedData, uint8_t bpp, uint32_t width, uint32_t height, Pixel32* output)
+		: _words(static_cast<const uint32_t*>(compressedData)), _output(output), _width(width), _height(height), _bpp(bpp), _wordWidth(bpp == 2 ? 8 : 4),
+		  _wordHeight(4), _numXWords(width / _wordWidth), _numYWords(height / _wordHeight), _twiddleX(_numXWords), _twiddleY(_numYWords)
+	{
+		// The twiddled (Morton order) index of a word is the bitwise OR of the contributions of its x and its y.
+		for (uint32_t x = 0; x < _numXWords; ++x)
+		{
+			_twiddleX[x] = TwiddleUV(_numXWords, _numYWords, x, 0) * 2;
+		}
+		for (uint32_t y = 0; y < _numYWords; ++y)
+		{
+			_twiddleY[y] = TwiddleUV(_numXWords, _numYWords, 0, y) * 2;
+		}
+	}
 
-	// Check the X and Y values are at least the minimum size.
-	uint32_t XTrueDim = std::max(XDim, ((Do2bitMode == 1u) ? 16u : 8u));
-	uint32_t YTrueDim = std::max(YDim, 8u);
+	uint32_t getNumRows() const
+	{
+		return _numYWords;
+	}
 
-	// If the dimensions aren't correct, we need to create a new buffer instead of just using the provided one, as the buffer will overrun otherwise.
-	if (XTrueDim != XDim || YTrueDim != YDim)
+	uint64_t getNumPixels() const
 	{
-		pDecompressedData = static_cast<Pixel32*>(malloc(XTrueDim * YTrueDim * sizeof(Pixel32)));
+		return static_cast<uint64_t>(_width) * _height;
 	}
 
-	// Decompress the surface.
-	int retval = pvrtcDecompress((uint8_t*)pCompressedData, pDecompressedData, XTrueDim, YTrueDim, (Do2bitMode == 1 ? 2 : 4));
+	// Decompress the row of windows whose top words (P, Q) are in word row wordY
+	void decompressRow(uint32_t wordY) const
+	{
+		const uint32_t wordYR = (wordY + 1) % _numYWords;
+		uint8_t* outputRows[4];
+		for (uint32_t y = 0; y < _wordHeight; ++y)
+		{
+			outputRows[y] = reinterpret_cast<uint8_t*>(_output + static_cast<size_t>((wordY * _wordHeight + _wordHeight / 2 + y) % _height) * _width);
+		}
+		for (uint32_t wordX = 0; wordX < _numXWords; ++wordX)
+		{
+			const uint32_t wordXQ = (wordX + 1) % _numXWords;
+			const PVRTCWord P = getWord(wordX, wordY), Q = getWord(wordXQ, wordY), R = getWord(wordX, wordYR), S = getWord(wordXQ, wordYR);
+			const uint32_t firstX = wordX * _wordWidth + _wordWidth / 2;
+			decompressWindow(P, Q, R, S, outputRows, firstX);
+		}
+	}
+
+private:
+	PVRTCWord getWord(uint32_t x, uint32_t y) const
+	{
+		const uint32_t offset = _twiddleX[x] | _twiddleY[y];
+		PVRTCWord word;
+		word.u32ModulationData = _words[offset];
+		word.u32ColorData = _words[offset + 1];
+		return word;
+	}
 
-	// If the dimensions were too small, then copy the new buffer back into the output buffer.
-	if (XTrueDim != XDim || YTrueDim != YDim)
+	// Modulation values (0-8, +10 for punch-through alpha) of the pixels of the window, row by row
+	void getWindowModulation(const PVRTCWord& P, const PVRTCWord& Q, const PVRTCWord& R, const PVRTCWord& S, int16_t modulation[4][8]) const
 	{
-		// Loop through all the required pixels.
-		for (uint32_t x = 0; x < XDim; ++x)
+		if (_bpp == 4)
 		{
-			for (uint32_t y = 0; y < YDim; ++y)
+			// Each pixel only depends on its own word, so there is no need to unpack the four words.
+			static const int16_t modulationTable[2][4] = { { 0, 3, 5, 8 }, { 0, 4, 14, 8 } };
+			const PVRTCWord* words[4] = { &P, &Q, &R, &S };
+			for (uint32_t y = 0; y < 4; ++y)
 			{
-				((Pixel32*)pResultImage)[x + y * XDim] = pDecompressedData[x + y * XTrueDim];
+				for (uint32_t x = 0; x < 4; ++x)
+				{
+					const uint32_t xPos = x + 2, yPos = y + 2; // Position in the 8x8 block of the four words
+					const PVRTCWord& word = *words[(xPos >> 2) + ((yPos >> 2) << 1)];
+					const uint32_t bits = (word.u32ModulationData >> (((yPos & 3) * 4 + (xPos & 3)) * 2)) & 3;
+					modulation[y][x] = modulationTable[word.u32ColorData & 1][bits];
+				}
+			}
+			return;
+		}
+		int32_t i32ModulationValues[16][8];
+		int32_t i32ModulationModes[16][8];
+		unpackModulations(P, 0, 0, i32ModulationValues, i32ModulationModes, _bpp);
+		unpackModulations(Q, _wordWidth, 0, i32ModulationValues, i32ModulationModes, _bpp);
+		unpackModulations(R, 0, _wordHeight, i32ModulationValues, i32ModulationModes, _bpp);
+		unpackModulations(S, _wordWidth, _wordHeight, i32ModulationValues, i32ModulationModes, _bpp);
+		for (uint32_t y = 0; y < _wordHeight; ++y)
+		{
+			for (uint32_t x = 0; x < _wordWidth; ++x)
+			{
+				modulation[y][x] =
+					static_cast<int16_t>(getModulationValues(i32ModulationValues, i32ModulationModes, x + _wordWidth / 2, y + _wordHeight / 2, _bpp));
 			}
 		}
+	}
 
-		// Free the temporary buffer.
-		free(pDecompressedData);
+	void decompressWindow(const PVRTCWord& P, const PVRTCWord& Q, const PVRTCWord& R, const PVRTCWord& S, uint8_t* const outputRows[4], uint32_t firstX) const
+	{
+		int16_t modulation[4][8];
+		getWindowModulation(P, Q, R, S, modulation);
+
+		// The two colours of the four words, bilinearly upscaled over the window: For pixel (x, y),
+		//   hP = wordWidth * P + x * (Q - P), hR = wordWidth * R + x * (S - R), value = 4 * hP + y * (hR - hP)
+		// Two pixels per Lanes16, so that hP and (hR - hP) for each pair of pixels are computed once for all rows.
+		const uint32_t numPairs = _wordWidth / 2;
+		Lanes16 topA[4], deltaA[4], topB[4], deltaB[4];
+		upscaleSetup(getColorA(P.u32ColorData), getColorA(Q.u32ColorData), getColorA(R.u32ColorData), getColorA(S.u32ColorData), topA, deltaA);
+		upscaleSetup(getColorB(P.u32ColorData), getColorB(Q.u32ColorData), getColorB(R.u32ColorData), getColorB(S.u32ColorData), topB, deltaB);
+
+		// Convert the upscaled (fixed point, 5 bit colour / 4 bit alpha) values to 8 bits per channel.
+		const int colorShift1 = (_bpp == 2) ? 7 : 6, colorShift2 = colorShift1 - 5;
+		const int alphaShift1 = (_bpp == 2) ? 5 : 4, alphaShift2 = alphaShift1 - 4;
+		static const int16_t four[8] = { 4, 4, 4, 4, 4, 4, 4, 4 };
+		static const int16_t eight[8] = { 8, 8, 8, 8, 8, 8, 8, 8 };
+		const Lanes16 scale4 = loadLanes(four);
+		const Lanes16 scale8 = loadLanes(eight);
+
+		uint8_t pixels[8 * 4];
+		// Zeroed once: The compiler cannot tell that numPairs is even, so that every result stored below is computed.
+		Lanes16 results[4] = {};
+		for (uint32_t y = 0; y < _wordHeight; ++y)
+		{
+			int16_t yValues[8] = { int16_t(y), int16_t(y), int16_t(y), int16_t(y), int16_t(y), int16_t(y), int16_t(y), int16_t(y) };
+			const Lanes16 row = loadLanes(yValues);
+			for (uint32_t pair = 0; pair < numPairs; ++pair)
+			{
+				Lanes16 a = scale4 * topA[pair] + row * deltaA[pair];
+				Lanes16 b = scale4 * topB[pair] + row * deltaB[pair];
+				a = shiftRight(a, colorShift1, alphaShift1) + shiftRight(a, colorShift2, alphaShift2);
+				b = shiftRight(b, colorShift1, alphaShift1) + shiftRight(b, colorShift2, alphaShift2);
+
+				// Modulate: (A * (8 - mod) + B * mod) / 8. Punch-through pixels have their alpha (but not their colour) zeroed.
+				int16_t modValues[8], alphaMask[8];
+				for (uint32_t i = 0; i < 2; ++i)
+				{
+					int16_t mod = modulation[y][pair * 2 + i];
+					const bool punchthroughAlpha = mod > 10;
+					mod = punchthroughAlpha ? static_cast<int16_t>(mod - 10) : mod;
+					modValues[i * 4] = modValues[i * 4 + 1] = modValues[i * 4 + 2] = modValues[i * 4 + 3] = mod;
+					alphaMask[i * 4] = alphaMask[i * 4 + 1] = alphaMask[i * 4 + 2] = 1;
+					alphaMask[i * 4 + 3] = punchthroughAlpha ? 0 : 1;
+				}
+				const Lanes16 modulationLanes = loadLanes(modValues);
+				Lanes16 result = shiftRight(a * (scale8 - modulationLanes) + b * modulationLanes, 3, 3);
+				results[pair] = result * loadLanes(alphaMask);
+			}
+			for (uint32_t pair = 0; pair < numPairs; pair += 2)
+			{
+				storePixels(pixels + pair * 8, results[pair], results[pair + 1]);
+			}
+
+			// Write the row, wrapping around the right edge of the surface
+			const uint32_t x = firstX % _width;
+			const uint32_t firstPart = std::min(_wordWidth, _width - x);
+			memcpy(outputRows[y] + x * 4, pixels, firstPart * 4);
+			if (firstPart < _wordWidth)
+			{
+				memcpy(outputRows[y], pixels + firstPart * 4, (_wordWidth - firstPart) * 4);
+			}
+		}
 	}
-	return retval;
-}
 
-////////////////////////////////////// ETC Compression //////////////////////////////////////
+	void upscaleSetup(Pixel32 P, Pixel32 Q, Pixel32 R, Pixel32 S, Lanes16* top, Lanes16* delta) const
+	{
+		const int16_t p[4] = { P.red, P.green, P.blue, P.alpha }, q[4] = { Q.red, Q.green, Q.blue, Q.alpha };
+		const int16_t r[4] = { R.red, R.green, R.blue, R.alpha }, s[4] = { S.red, S.green, S.blue, S.alpha };
+		for (uint32_t pair = 0; pair < _wordWidth / 2; ++pair)
+		{
+			int16_t hP[8], hRminusP[8];
+			for (uint32_t i = 0; i < 8; ++i)
+			{
+				const int16_t x = static_cast<int16_t>(pair * 2 + i / 4);
+				const int16_t c = i & 3;
+				hP[i] = static_cast<int16_t>(_wordWidth * p[c] + x * (q[c] - p[c]));
+				hRminusP[i] = static_cast<int16_t>(_wordWidth * r[c] + x * (s[c] - r[c]) - hP[i]);
+			}
+			top[pair] = loadLanes(hP);
+			delta[pair] = loadLanes(hRminusP);
+		}
+	}
 
-#define _CLAMP_(X, Xmin, Xmax) ((X) < (Xmax) ? ((X) < (Xmin) ? (Xmin) : (X)) : (Xmax))
+	const uint32_t* _words;
+	Pixel32* _output;
+	uint32_t _width, _height;
+	uint8_t _bpp;
+	uint32_t _wordWidth, _wordHeight, _numXWords, _numYWords;
+	std::vector<uint32_t> _twiddleX, _twiddleY;
+};
 
-uint32_t ETC_FLIP = 0x01000000;
-uint32_t ETC_DIFF = 0x02000000;
-const int mod[8][4] = { { 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 }, { 18, 60, -18, -60 }, { 24, 80, -24, -80 }, { 33, 106, -33, -106 },
-	{ 47, 183, -47, -183 } };
+// Decompress a set of surfaces of the same kind, spreading the rows of all of them over the available threads.
+template<typename Surface>
+void decompressSurfaces(const std::vector<Surface>& surfaces)
+{
+	std::vector<uint32_t> firstRows(surfaces.size() + 1, 0);
+	uint64_t numPixels = 0;
+	for (size_t i = 0; i < surfaces.size(); ++i)
+	{
+		firstRows[i + 1] = firstRows[i] + surfaces[i].getNumRows();
+		numPixels += surfaces[i].getNumPixels();
+	}
+	// Only use as many threads as there is enough work for to pay off
+	const uint64_t minPixelsPerThread = 32 * 1024;
+	const uint32_t maxThreads = static_cast<uint32_t>(std::max<uint64_t>(std::min<uint64_t>(numPixels / minPixelsPerThread, UINT32_MAX), 1));
+	async::parallelFor(
+		firstRows.back(),
+		[&](uint32_t row) {
+			const size_t surface = static_cast<size_t>(std::upper_bound(firstRows.begin(), firstRows.end(), row) - firstRows.begin()) - 1;
+			surfaces[surface].decompressRow(row - firstRows[surface]);
+		},
+		maxThreads);
+}
 
-static uint32_t modifyPixel(int red, int green, int blue, int x, int y, uint32_t modBlock, int modTable)
+// A decompression target that may be smaller than the minimum size the decompressor works with. Small surfaces are
+// decompressed into a temporary buffer of the minimum size and cropped into place afterwards.
+struct DecompressionTarget
 {
-	int index = x * 4 + y, pixelMod;
-	uint32_t mostSig = modBlock << 1;
+	DecompressionTarget(uint8_t* output, uint32_t width, uint32_t height, uint32_t minWidth, uint32_t minHeight)
+		: output(output), width(width), height(height), trueWidth(std::max(width, minWidth)), trueHeight(std::max(height, minHeight))
+	{
+		if (trueWidth != width || trueHeight != height)
+		{
+			temporary.resize(static_cast<size_t>(trueWidth) * trueHeight * sizeof(Pixel32));
+		}
+	}
 
-	if (index < 8)
+	Pixel32* getPixels()
 	{
-		pixelMod = mod[modTable][((modBlock >> (index + 24)) & 0x1) + ((mostSig >> (index + 8)) & 0x2)];
+		return reinterpret_cast<Pixel32*>(temporary.empty() ? output : temporary.data());
 	}
-	else
+
+	void crop() const
 	{
-		pixelMod = mod[modTable][((modBlock >> (index + 8)) & 0x1) + ((mostSig >> (index - 8)) & 0x2)];
+		for (uint32_t y = 0; !temporary.empty() && y < height; ++y)
+		{
+			memcpy(output + static_cast<size_t>(y) * width * sizeof(Pixel32), temporary.data() + static_cast<size_t>(y) * trueWidth * sizeof(Pixel32), width * sizeof(Pixel32));
+		}
 	}
 
-	red = _CLAMP_(red + pixelMod, 0, 255);
-	green = _CLAMP_(green + pixelMod, 0, 255);
-	blue = _CLAMP_(blue + pixelMod, 0, 255);
+	uint8_t* output;
+	uint32_t width, height, trueWidth, trueHeight;
+	std::vector<uint8_t> temporary;
+};
 
-	return ((red << 16) + (green << 8) + blue) | 0xff000000;
+uint32_t PVRTDecompressPVRTC(const void* pCompressedData, uint32_t Do2bitMode, uint32_t XDim, uint32_t YDim, uint8_t* pResultImage)
+{
+	const uint8_t bpp = (Do2bitMode == 1 ? 2 : 4);
+
+	// Check the X and Y values are at least the minimum size. If not, decompress into a temporary buffer, as the buffer will overrun otherwise.
+	DecompressionTarget target(pResultImage, XDim, YDim, (bpp == 2) ? 16u : 8u, 8u);
+	std::vector<PvrtcSurface> surfaces(1, PvrtcSurface(pCompressedData, bpp, target.trueWidth, target.trueHeight, target.getPixels()));
+	decompressSurfaces(surfaces);
+	target.crop();
+
+	// Return the data size
+	return target.trueWidth * target.trueHeight / ((bpp == 2) ? 4u : 2u);
 }
 
-static uint32_t ETCTextureDecompress(const void* pSrcData, uint32_t x, uint32_t y, void* pDestData, uint32_t /*nMode*/)
+////////////////////////////////////// ETC Compression //////////////////////////////////////
+
+static const uint32_t ETC_FLIP = 0x01000000;
+static const uint32_t ETC_DIFF = 0x02000000;
+static const int etcModifiers[8][4] = { { 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 }, { 18, 60, -18, -60 }, { 24, 80, -24, -80 },
+	{ 33, 106, -33, -106 }, { 47, 183, -47, -183 } };
+
+inline uint8_t clampToByte(int value)
 {
-	uint32_t* output;
-	uint32_t blockTop, blockBot;
-	const uint32_t* input = static_cast<const uint32_t*>(pSrcData);
-	unsigned char red1, green1, blue1, red2, green2, blue2;
-	bool bFlip, bDiff;
-	int modtable1, modtable2;
+	return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// An ETC1 surface being decompressed. Each row of 4x4 blocks is decompressed independently, straight into the (RGBA)
+// output. Blocks that hang over the right or bottom edge of the surface are cropped.
+class EtcSurface
+{
+public:
+	EtcSurface(const void* compressedData, uint32_t width, uint32_t height, uint8_t* output)
+		: _blocks(static_cast<const uint32_t*>(compressedData)), _output(output), _width(width), _height(height), _numXBlocks((width + 3) / 4), _numYBlocks((height + 3) / 4)
+	{}
 
-	for (uint32_t i = 0; i < y; i += 4)
+	uint32_t getNumRows() const
 	{
-		for (uint32_t m = 0; m < x; m += 4)
-		{
-			blockTop = *(input++);
-			blockBot = *(input++);
+		return _numYBlocks;
+	}
 
-			output = (uint32_t*)pDestData + i * x + m;
+	uint64_t getNumPixels() const
+	{
+		return static_cast<uint64_t>(_width) * _height;
+	}
 
-			// check flipbit
-			bFlip = (blockTop & ETC_FLIP) != 0;
-			bDiff = (blockTop & ETC_DIFF) != 0;
+	void decompressRow(uint32_t blockY) const
+	{
+		const uint32_t* input = _blocks + static_cast<size_t>(blockY) * _numXBlocks * 2;
+		const uint32_t numPixelRows = std::min(4u, _height - blockY * 4);
+		for (uint32_t blockX = 0; blockX < _numXBlocks; ++blockX)
+		{
+			const uint32_t blockTop = *(input++);
+			const uint32_t blockBot = *(input++);
+			const uint32_t numPixelColumns = std::min(4u, _width - blockX * 4);
 
-			if (bDiff)
+			// The base colours of the two sub-blocks
+			unsigned char red1, green1, blue1, red2, green2, blue2;
+			if (blockTop & ETC_DIFF)
 			{
 				// differential mode 5 color bits + 3 difference bits
 				// get base color for subblock 1
@@ -736,80 +805,98 @@ static uint32_t ETCTextureDecompress(const void* pSrcData, uint32_t x, uint32_t
 				red2 = static_cast<unsigned char>((blockTop & 0xf) << 4);
 				red2 = red2 + (red2 >> 4); // copy bits to lower sig
 			}
-			// get the modtables for each subblock
-			modtable1 = (blockTop >> 29) & 0x7;
-			modtable2 = (blockTop >> 26) & 0x7;
+			const int* modifiers1 = etcModifiers[(blockTop >> 29) & 0x7];
+			const int* modifiers2 = etcModifiers[(blockTop >> 26) & 0x7];
+			const bool flip = (blockTop & ETC_FLIP) != 0;
 
-			if (!bFlip)
+			for (uint32_t y = 0; y < numPixelRows; ++y)
 			{
-				// 2 2x4 blocks side by side
-
-				for (int j = 0; j < 4; j++) // vertical
+				uint8_t* output = _output + ((static_cast<size_t>(blockY) * 4 + y) * _width + blockX * 4) * 4;
+				for (uint32_t x = 0; x < numPixelColumns; ++x)
 				{
-					for (int k = 0; k < 2; k++) // horizontal
-					{
-						*(output + j * x + k) = modifyPixel(red1, green1, blue1, k, j, blockBot, modtable1);
-						*(output + j * x + k + 2) = modifyPixel(red2, green2, blue2, k + 2, j, blockBot, modtable2);
-					}
-				}
-			}
-			else
-			{
-				// 2 4x2 blocks on top of each other
-				for (int j = 0; j < 2; j++)
-				{
-					for (int k = 0; k < 4; k++)
-					{
-						*(output + j * x + k) = modifyPixel(red1, green1, blue1, k, j, blockBot, modtable1);
-						*(output + (j + 2) * x + k) = modifyPixel(red2, green2, blue2, k, j + 2, blockBot, modtable2);
-					}
+					// Without the flip bit the sub-blocks are two 2x4 blocks side by side, otherwise two 4x2 blocks on top of each other
+					const bool firstSubBlock = flip ? (y < 2) : (x < 2);
+					const uint32_t index = x * 4 + y;
+					// The pixel index bits are stored big-endian: the low bits in the upper half of the word, the high bits in the lower half
+					const uint32_t lowBit = (blockBot >> (index < 8 ? index + 24 : index + 8)) & 0x1;
+					const uint32_t highBit = (blockBot >> (index < 8 ? index + 8 : index - 8)) & 0x1;
+					const int modifier = (firstSubBlock ? modifiers1 : modifiers2)[lowBit | (highBit << 1)];
+					output[x * 4 + 0] = clampToByte((firstSubBlock ? red1 : red2) + modifier);
+					output[x * 4 + 1] = clampToByte((firstSubBlock ? green1 : green2) + modifier);
+					output[x * 4 + 2] = clampToByte((firstSubBlock ? blue1 : blue2) + modifier);
+					output[x * 4 + 3] = 0xff;
 				}
 			}
 		}
 	}
 
-	return x * y / 2;
-}
+private:
+	const uint32_t* _blocks;
+	uint8_t* _output;
+	uint32_t _width, _height, _numXBlocks, _numYBlocks;
+};
 
-uint32_t PVRTDecompressETC(const void* pSrcData, uint32_t x, uint32_t y, void* pDestData, uint32_t nMode)
+uint32_t PVRTDecompressETC(const void* pSrcData, uint32_t x, uint32_t y, void* pDestData, uint32_t /*nMode*/)
 {
-	uint32_t i32read;
+	std::vector<EtcSurface> surfaces(1, EtcSurface(pSrcData, x, y, static_cast<uint8_t*>(pDestData)));
+	decompressSurfaces(surfaces);
+	return std::max<uint32_t>(x, ETC_MIN_TEXWIDTH) * std::max<uint32_t>(y, ETC_MIN_TEXHEIGHT) / 2;
+}
 
-	if (x < ETC_MIN_TEXWIDTH || y < ETC_MIN_TEXHEIGHT)
+Texture PVRTDecompressTexture(const Texture& texture)
+{
+	const PixelFormat format = texture.getPixelFormat();
+	const bool isPvrtc = format.getPixelTypeId() >= static_cast<uint64_t>(CompressedPixelFormat::PVRTCI_2bpp_RGB) &&
+		format.getPixelTypeId() <= static_cast<uint64_t>(CompressedPixelFormat::PVRTCI_4bpp_RGBA);
+	const bool isEtc = format.getPixelTypeId() == static_cast<uint64_t>(CompressedPixelFormat::ETC1);
+	if (!isPvrtc && !isEtc)
 	{
-		// decompress into a buffer big enough to take the minimum size
-		char* pTempBuffer = static_cast<char*>(malloc(std::max<uint32_t>(x, ETC_MIN_TEXWIDTH) * std::max<uint32_t>(y, ETC_MIN_TEXHEIGHT) * 4));
-		i32read = ETCTextureDecompress(pSrcData, std::max<uint32_t>(x, ETC_MIN_TEXWIDTH), std::max<uint32_t>(y, ETC_MIN_TEXHEIGHT), pTempBuffer, nMode);
-
-		for (uint32_t i = 0; i < y; i++)
-		{
-			// copy from larger temp buffer to output data
-			memcpy(static_cast<char*>(pDestData) + i * x * 4, pTempBuffer + std::max<uint32_t>(x, ETC_MIN_TEXWIDTH) * 4 * i, x * 4);
-		}
-
-		if (pTempBuffer)
+		throw InvalidArgumentError("texture", "[PVRTDecompressTexture] Only PVRTC1 and ETC1 textures can be decompressed.");
+	}
+	const uint8_t bpp = static_cast<uint8_t>(format.getPixelTypeId() <= static_cast<uint64_t>(CompressedPixelFormat::PVRTCI_2bpp_RGBA) ? 2 : 4);
+
+	// Set up the new texture and header.
+	TextureHeader decompressedHeader(texture);
+	decompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID);
+	decompressedHeader.setChannelType(VariableType::UnsignedByteNorm);
+	Texture decompressedTexture(decompressedHeader);
+
+	// Gather every depth slice of every face, array member and MIP level, so that they are all decompressed in one go.
+	std::deque<DecompressionTarget> targets; // A deque, as the surfaces point into the temporary buffers of the targets
+	std::vector<PvrtcSurface> pvrtcSurfaces;
+	std::vector<EtcSurface> etcSurfaces;
+	// Both textures share dimensions and surface counts, so their surfaces are visited in lockstep.
+	TextureHeader::SurfaceRange sourceSurfaces = texture.getSurfaces();
+	TextureHeader::SurfaceRange destinationSurfaces = decompressedTexture.getSurfaces();
+	TextureHeader::SurfaceIterator destinationSurface = destinationSurfaces.begin();
+	for (TextureHeader::SurfaceIterator sourceSurface = sourceSurfaces.begin(); sourceSurface != sourceSurfaces.end(); ++sourceSurface, ++destinationSurface)
+	{
+		const TextureSurface& surface = *sourceSurface;
+		const uint32_t width = texture.getWidth(surface.mipLevel), height = texture.getHeight(surface.mipLevel), depth = texture.getDepth(surface.mipLevel);
+		const uint32_t sliceSize = surface.dataSize / depth;
+		const uint8_t* sourceData = texture.getDataPointer() + surface.offset;
+		uint8_t* destinationData = decompressedTexture.getDataPointer() + destinationSurface->offset;
+		for (uint32_t slice = 0; slice < depth; ++slice)
 		{
-			free(pTempBuffer);
+			const uint8_t* source = sourceData + static_cast<size_t>(slice) * sliceSize;
+			uint8_t* destination = destinationData + static_cast<size_t>(slice) * width * height * sizeof(Pixel32);
+			if (isEtc)
+			{
+				etcSurfaces.push_back(EtcSurface(source, width, height, destination));
+				continue;
+			}
+			targets.push_back(DecompressionTarget(destination, width, height, (bpp == 2) ? 16u : 8u, 8u));
+			DecompressionTarget& target = targets.back();
+			pvrtcSurfaces.push_back(PvrtcSurface(source, bpp, target.trueWidth, target.trueHeight, target.getPixels()));
 		}
 	}
-	else // decompress larger MIP levels straight into the output data
+	decompressSurfaces(pvrtcSurfaces);
+	decompressSurfaces(etcSurfaces);
+	for (const DecompressionTarget& target : targets)
 	{
-		i32read = ETCTextureDecompress(pSrcData, x, y, pDestData, nMode);
+		target.crop();
 	}
-
-	// swap r and b channels
-	unsigned char *pSwap = static_cast<unsigned char*>(pDestData), swap;
-
-	for (uint32_t i = 0; i < y; i++)
-		for (uint32_t j = 0; j < x; j++)
-		{
-			swap = pSwap[0];
-			pSwap[0] = pSwap[2];
-			pSwap[2] = swap;
-			pSwap += 4;
-		}
-
-	return i32read;
+	return decompressedTexture;
 }
 } // namespace pvr
 //!\endcond
@@ -6,6 +6,7 @@
 */
 #pragma once
 #include <stdint.h>
+#include "PVRCore/texture/Texture.h"
 namespace pvr {
 
 /// <summary>Decompresses PVRTC to RGBA 8888.</summary>
@@ -25,4 +26,11 @@ uint32_t PVRTDecompressPVRTC(const void* compressedData, uint32_t do2bitMode, ui
 /// <param name="mode">The format of the data</param>
 /// <returns>Return The number of bytes of ETC data decompressed</returns>
 uint32_t PVRTDecompressETC(const void* srcData, uint32_t xDim, uint32_t yDim, void* dstData, uint32_t mode);
+
+/// <summary>Decompresses all MIP levels, array members, faces and depth slices of a PVRTC1 (2/4bpp, RGB/RGBA) or ETC1
+/// texture to RGBA 8888 in a single call. The rows of all surfaces are decompressed in parallel on all available
+/// hardware threads, using SSE2/NEON where available.</summary>
+/// <param name="texture">The compressed texture</param>
+/// <returns>A new texture with the same dimensions and layout, with an RGBA8888 (UnsignedByteNorm) pixel format.</returns>
+Texture PVRTDecompressTexture(const Texture& texture);
 } // namespace pvr
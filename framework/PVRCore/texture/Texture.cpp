@@ -32,6 +32,10 @@ TextureFileFormat getTextureFormatFromFilename(const char* assetname)
 		{
 			return TextureFileFormat::KTX;
 		}
+		if (!s.compare("ktx2"))
+		{
+			return TextureFileFormat::KTX2;
+		}
 		if (!s.compare("bmp"))
 		{
 			return TextureFileFormat::BMP;
@@ -92,40 +96,12 @@ const unsigned char* Texture::getDataPointer(uint32_t mipMapLevel /*= 0*/, uint3
 		throw InvalidArgumentError("face", "Texture::getDataPointer: Specified face did not exist");
 	}
 
-	uint32_t offSet = 0;
-	// File is organised by MIP Map levels, then surfaces, then faces.
-
-	// Get the start of the MIP level.
-	if (mipMapLevel != 0)
-	{
-		// Get the size for all MIP Map levels up to this one.
-		for (uint32_t uiCurrentMipMap = 0; uiCurrentMipMap < mipMapLevel; ++uiCurrentMipMap)
-		{
-			offSet += getDataSize(uiCurrentMipMap, true, true);
-		}
-	}
-
-	// Get the start of the array.
-	if (arrayMember != 0)
-	{
-		offSet += arrayMember * getDataSize(mipMapLevel, false, true);
-	}
-
-	// Get the start of the face.
-	if (face != 0)
-	{
-		offSet += face * getDataSize(mipMapLevel, false, false);
-	}
-
-	// Return the data pointer plus whatever offSet has been specified.
-	return &_pTextureData[offSet];
+	// File is organised by MIP Map levels, then surfaces, then faces. The offsets come from the header's layout table.
+	return &_pTextureData[static_cast<size_t>(getDataOffset(mipMapLevel, arrayMember, face))];
 }
 
 unsigned char* Texture::getDataPointer(uint32_t mipMapLevel /*= 0*/, uint32_t arrayMember /*= 0*/, uint32_t face /*= 0*/)
 {
-	// Initialize the offSet value.
-	uint32_t offSet = 0;
-
 	// Error checking
 	if ((static_cast<int32_t>(mipMapLevel) == pvrTextureAllMipMaps) || mipMapLevel >= getNumMipMapLevels())
 	{
@@ -140,32 +116,8 @@ unsigned char* Texture::getDataPointer(uint32_t mipMapLevel /*= 0*/, uint32_t ar
 		throw InvalidArgumentError("face", "Texture::getDataPointer: Specified face did not exist");
 	}
 
-	// File is organised by MIP Map levels, then surfaces, then faces.
-
-	// Get the start of the MIP level.
-	if (mipMapLevel != 0)
-	{
-		// Get the size for all MIP Map levels up to this one.
-		for (uint32_t uiCurrentMipMap = 0; uiCurrentMipMap < mipMapLevel; ++uiCurrentMipMap)
-		{
-			offSet += getDataSize(uiCurrentMipMap, true, true);
-		}
-	}
-
-	// Get the start of the array.
-	if (arrayMember != 0)
-	{
-		offSet += arrayMember * getDataSize(mipMapLevel, false, true);
-	}
-
-	// Get the start of the face.
-	if (face != 0)
-	{
-		offSet += face * getDataSize(mipMapLevel, false, false);
-	}
-
-	// Return the data pointer plus whatever offSet has been specified.
-	return &_pTextureData[offSet];
+	// File is organised by MIP Map levels, then surfaces, then faces. The offsets come from the header's layout table.
+	return &_pTextureData[static_cast<size_t>(getDataOffset(mipMapLevel, arrayMember, face))];
 }
 
 void Texture::addPaddingMetaData(uint32_t paddingAlignment)
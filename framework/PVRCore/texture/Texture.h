@@ -384,7 +384,8 @@ enum class TextureFileFormat
 	TGA,
 	BMP,
 	DDS,
-	JPEG
+	JPEG,
+	KTX2
 };
 
 /// <summary>A 2D Texture asset, together with Information, Metadata and actual Pixel data. Only represents the
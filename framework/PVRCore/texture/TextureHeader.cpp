@@ -30,12 +30,17 @@ TextureHeader::TextureHeader()
 	_header.numFaces = 1;
 	_header.numMipMaps = 1;
 	_header.metaDataSize = 0;
+	updateDataLayout();
 }
 
-TextureHeader::TextureHeader(TextureHeader::Header& header) : _header(header) {}
+TextureHeader::TextureHeader(TextureHeader::Header& header) : _header(header)
+{
+	updateDataLayout();
+}
 
 TextureHeader::TextureHeader(Header fileHeader, uint32_t numMetaData, TextureMetaData* metaData) : _header(fileHeader)
 {
+	updateDataLayout();
 	if (metaData)
 	{
 		for (uint32_t i = 0; i < numMetaData; ++i)
@@ -56,6 +61,7 @@ TextureHeader::TextureHeader(PixelFormat pixelFormat, uint32_t width, uint32_t h
 	_header.numSurfaces = numSurfaces;
 	_header.numFaces = numFaces;
 	_header.flags = flags;
+	updateDataLayout();
 	if (metaData)
 	{
 		for (uint32_t i = 0; i < metaDataSize; ++i)
@@ -1003,7 +1009,7 @@ bool TextureHeader::getDirect3DFormat(uint32_t& d3dFormat) const
 	return false;
 }
 
-uint32_t TextureHeader::getDataSize(int32_t iMipLevel, bool bAllSurfaces, bool bAllFaces) const
+uint64_t TextureHeader::calculateDataSize(int32_t iMipLevel, bool bAllSurfaces, bool bAllFaces) const
 {
 	// The smallest divisible sizes for a pixel format
 	uint32_t uiSmallestWidth = 1;
@@ -1036,7 +1042,7 @@ uint32_t TextureHeader::getDataSize(int32_t iMipLevel, bool bAllSurfaces, bool b
 			// Add the current MIP Map's data size to the total.
 			if (getPixelFormat().getPixelTypeId() >= (uint64_t)CompressedPixelFormat::ASTC_4x4 && getPixelFormat().getPixelTypeId() <= (uint64_t)CompressedPixelFormat::ASTC_6x6x6)
 			{
-				uiDataSize += (uiWidth / uiSmallestWidth) * (uiHeight / uiSmallestHeight) * (uiDepth / uiSmallestDepth) * 128;
+				uiDataSize += static_cast<uint64_t>(uiWidth / uiSmallestWidth) * (uiHeight / uiSmallestHeight) * (uiDepth / uiSmallestDepth) * 128;
 			}
 			else
 			{
@@ -1068,14 +1074,61 @@ uint32_t TextureHeader::getDataSize(int32_t iMipLevel, bool bAllSurfaces, bool b
 	uint32_t numsurfs = (bAllSurfaces ? getNumArrayMembers() : 1);
 
 	// Multiply the data size by number of faces and surfaces specified, and return.
-	return static_cast<uint32_t>(uiDataSize / 8) * numsurfs * numfaces;
+	return (uiDataSize / 8) * numsurfs * numfaces;
 }
 
-ptrdiff_t TextureHeader::getDataOffset(uint32_t mipMapLevel /*= 0*/, uint32_t arrayMember /*= 0*/, uint32_t face /*= 0*/) const
+void TextureHeader::updateDataLayout()
 {
-	// Initialize the offSet value.
-	uint32_t uiOffSet = 0;
+	_layout.pixelFormat = _header.pixelFormat.getPixelTypeId();
+	_layout.channelType = _header.channelType;
+	_layout.width = _header.width;
+	_layout.height = _header.height;
+	_layout.depth = _header.depth;
+	_layout.numSurfaces = _header.numSurfaces;
+	_layout.numFaces = _header.numFaces;
+	_layout.numMipMaps = _header.numMipMaps;
+
+	// File is organised by MIP Map levels, then surfaces, then faces.
+	_layout.mipLevels.resize(_header.numMipMaps);
+	uint64_t offset = 0;
+	for (uint32_t mipLevel = 0; mipLevel < _header.numMipMaps; ++mipLevel)
+	{
+		MipLevelLayout& mip = _layout.mipLevels[mipLevel];
+		mip.offset = offset;
+		mip.faceSize = calculateDataSize(static_cast<int32_t>(mipLevel), false, false);
+		mip.arrayMemberSize = mip.faceSize * _header.numFaces;
+		mip.totalSize = mip.arrayMemberSize * _header.numSurfaces;
+		offset += mip.totalSize;
+	}
+
+	// The size of all MIP levels is not the sum of the sizes above for every format, so it is calculated as such.
+	for (uint32_t allSurfaces = 0; allSurfaces < 2; ++allSurfaces)
+	{
+		for (uint32_t allFaces = 0; allFaces < 2; ++allFaces)
+		{
+			_layout.totalSizes[allSurfaces][allFaces] = calculateDataSize(pvrTextureAllMipMaps, allSurfaces != 0, allFaces != 0);
+		}
+	}
+}
+
+uint32_t TextureHeader::getDataSize(int32_t mipLevel, bool allSurfaces, bool allFaces) const
+{
+	const DataLayout& layout = getDataLayout();
+	if (mipLevel == pvrTextureAllMipMaps)
+	{
+		return static_cast<uint32_t>(layout.totalSizes[allSurfaces ? 1 : 0][allFaces ? 1 : 0]);
+	}
+	if (static_cast<uint32_t>(mipLevel) >= layout.numMipMaps)
+	{
+		// Not part of the texture, but its size is still well defined.
+		return static_cast<uint32_t>(calculateDataSize(mipLevel, allSurfaces, allFaces));
+	}
+	const MipLevelLayout& mip = layout.mipLevels[mipLevel];
+	return static_cast<uint32_t>(allSurfaces ? (allFaces ? mip.totalSize : mip.faceSize * layout.numSurfaces) : (allFaces ? mip.arrayMemberSize : mip.faceSize));
+}
 
+ptrdiff_t TextureHeader::getDataOffset(uint32_t mipMapLevel /*= 0*/, uint32_t arrayMember /*= 0*/, uint32_t face /*= 0*/) const
+{
 	// Error checking
 	if ((static_cast<int32_t>(mipMapLevel) == pvrTextureAllMipMaps) || mipMapLevel >= getNumMipMapLevels())
 	{
@@ -1091,31 +1144,8 @@ ptrdiff_t TextureHeader::getDataOffset(uint32_t mipMapLevel /*= 0*/, uint32_t ar
 	}
 
 	// File is organised by MIP Map levels, then surfaces, then faces.
-
-	// Get the start of the MIP level.
-	if (mipMapLevel != 0)
-	{
-		// Get the size for all MIP Map levels up to this one.
-		for (uint32_t uiCurrentMipMap = 0; uiCurrentMipMap < mipMapLevel; ++uiCurrentMipMap)
-		{
-			uiOffSet += getDataSize(uiCurrentMipMap, true, true);
-		}
-	}
-
-	// Get the start of the array.
-	if (arrayMember != 0)
-	{
-		uiOffSet += arrayMember * getDataSize(mipMapLevel, false, true);
-	}
-
-	// Get the start of the face.
-	if (face != 0)
-	{
-		uiOffSet += face * getDataSize(mipMapLevel, false, false);
-	}
-
-	// Return the data pointer plus whatever offSet has been specified.
-	return uiOffSet;
+	const MipLevelLayout& mip = getDataLayout().mipLevels[mipMapLevel];
+	return static_cast<ptrdiff_t>(mip.offset + static_cast<uint64_t>(arrayMember) * mip.arrayMemberSize + static_cast<uint64_t>(face) * mip.faceSize);
 }
 
 void TextureHeader::setOrientation(TextureMetaData::AxisOrientation eAxisOrientation)
@@ -11,6 +11,7 @@
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <cassert>
 #include <cstdint>
 #include <cstddef>
 
@@ -21,6 +22,17 @@ enum
 	pvrTextureAllMipMaps = -1
 };
 
+/// <summary>The location of a single surface (one face of one array member of one MIP level) in the data of a
+/// texture.</summary>
+struct TextureSurface
+{
+	uint32_t mipLevel; //!< The MIP level of the surface
+	uint32_t arrayMember; //!< The array member of the surface
+	uint32_t face; //!< The face of the surface
+	ptrdiff_t offset; //!< The offset of the surface from the start of the texture data, in bytes
+	uint32_t dataSize; //!< The size of the surface, in bytes (all depth slices)
+};
+
 /// <summary>A class mirroring the PVR Texture container format header, and which can in general represent any
 /// Texture asset. Contains accessors functions to facilitate using the Texture data in application code.
 /// </summary>
@@ -65,6 +77,149 @@ public:
 protected:
 	Header _header; //!< Texture header as laid out in a file.
 	std::map<uint32_t, std::map<uint32_t, TextureMetaData> > _metaDataMap; //!< Map of all the meta data stored for a texture.
+
+private:
+	// Offsets and sizes of a single MIP level, from which the offset of any of its surfaces follows directly.
+	struct MipLevelLayout
+	{
+		uint64_t offset; // Offset of the MIP level from the start of the data
+		uint64_t faceSize; // getDataSize(mipLevel, false, false)
+		uint64_t arrayMemberSize; // getDataSize(mipLevel, false, true)
+		uint64_t totalSize; // getDataSize(mipLevel, true, true)
+	};
+
+	// The layout is rebuilt by the constructors and by every setter of a header field it depends on, so that the const
+	// getters only ever read it, and can be called from any number of threads. It records the fields it was built from
+	// to catch changes made through getHeaderAccess() without a call to updateDataLayout().
+	struct DataLayout
+	{
+		uint64_t pixelFormat;
+		VariableType channelType;
+		uint32_t width, height, depth, numSurfaces, numFaces, numMipMaps;
+		uint64_t totalSizes[2][2]; // getDataSize(pvrTextureAllMipMaps, allSurfaces, allFaces)
+		std::vector<MipLevelLayout> mipLevels;
+	};
+	DataLayout _layout;
+
+	bool isDataLayoutCurrent() const
+	{
+		return _layout.pixelFormat == _header.pixelFormat.getPixelTypeId() && _layout.channelType == _header.channelType && _layout.width == _header.width &&
+			_layout.height == _header.height && _layout.depth == _header.depth && _layout.numSurfaces == _header.numSurfaces && _layout.numFaces == _header.numFaces &&
+			_layout.numMipMaps == _header.numMipMaps;
+	}
+	const DataLayout& getDataLayout() const
+	{
+		assert(isDataLayoutCurrent() && "TextureHeader: The header was changed through getHeaderAccess() without a call to updateDataLayout()");
+		return _layout;
+	}
+	uint64_t calculateDataSize(int32_t mipLevel, bool allSurfaces, bool allFaces) const;
+
+public:
+	/// <summary>Iterates the surfaces of a texture in the order they are laid out in its data: by MIP level, then array
+	/// member, then face.</summary>
+	class SurfaceIterator
+	{
+	public:
+		/// <summary>Gets the current surface.</summary>
+		/// <returns>The location of the current surface.</returns>
+		const TextureSurface& operator*() const
+		{
+			return _surface;
+		}
+		/// <summary>Gets the current surface.</summary>
+		/// <returns>The location of the current surface.</returns>
+		const TextureSurface* operator->() const
+		{
+			return &_surface;
+		}
+		/// <summary>Moves to the next surface.</summary>
+		/// <returns>This iterator.</returns>
+		SurfaceIterator& operator++()
+		{
+			// Surfaces of a MIP level are contiguous, so only moving to a new MIP level needs the table.
+			_surface.offset += _surface.dataSize;
+			if (++_surface.face == _layout->numFaces)
+			{
+				_surface.face = 0;
+				if (++_surface.arrayMember == _layout->numSurfaces)
+				{
+					_surface.arrayMember = 0;
+					setMipLevel(_surface.mipLevel + 1);
+				}
+			}
+			return *this;
+		}
+		/// <summary>Equality.</summary>
+		/// <param name="rhs">The iterator to compare to</param>
+		/// <returns>True if both iterators point to the same surface.</returns>
+		bool operator==(const SurfaceIterator& rhs) const
+		{
+			return _surface.mipLevel == rhs._surface.mipLevel && _surface.arrayMember == rhs._surface.arrayMember && _surface.face == rhs._surface.face;
+		}
+		/// <summary>Inequality.</summary>
+		/// <param name="rhs">The iterator to compare to</param>
+		/// <returns>True if the iterators point to different surfaces.</returns>
+		bool operator!=(const SurfaceIterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+
+	private:
+		friend class TextureHeader;
+		SurfaceIterator(const DataLayout& layout, uint32_t mipLevel) : _layout(&layout)
+		{
+			_surface.arrayMember = 0;
+			_surface.face = 0;
+			setMipLevel(mipLevel);
+		}
+		void setMipLevel(uint32_t mipLevel)
+		{
+			_surface.mipLevel = mipLevel;
+			if (mipLevel < _layout->numMipMaps)
+			{
+				_surface.offset = static_cast<ptrdiff_t>(_layout->mipLevels[mipLevel].offset);
+				_surface.dataSize = static_cast<uint32_t>(_layout->mipLevels[mipLevel].faceSize);
+			}
+			else
+			{
+				_surface.offset = 0;
+				_surface.dataSize = 0;
+			}
+		}
+		const DataLayout* _layout;
+		TextureSurface _surface;
+	};
+
+	/// <summary>A range over all surfaces of a texture, as returned by getSurfaces().</summary>
+	class SurfaceRange
+	{
+	public:
+		/// <summary>Gets an iterator to the first surface.</summary>
+		/// <returns>An iterator to the first surface.</returns>
+		SurfaceIterator begin() const
+		{
+			return SurfaceIterator(*_layout, 0);
+		}
+		/// <summary>Gets an iterator past the last surface.</summary>
+		/// <returns>An iterator past the last surface.</returns>
+		SurfaceIterator end() const
+		{
+			return SurfaceIterator(*_layout, _layout->numSurfaces && _layout->numFaces ? _layout->numMipMaps : 0);
+		}
+		/// <summary>Gets the number of surfaces.</summary>
+		/// <returns>The number of surfaces in the range.</returns>
+		size_t size() const
+		{
+			return static_cast<size_t>(_layout->numMipMaps) * _layout->numSurfaces * _layout->numFaces;
+		}
+
+	private:
+		friend class TextureHeader;
+		explicit SurfaceRange(const DataLayout& layout) : _layout(&layout)
+		{}
+		const DataLayout* _layout;
+	};
+
 public:
 	/// <summary>Default constructor for a TextureHeader. Returns an empty header.</summary>
 	TextureHeader();
@@ -76,6 +231,7 @@ public:
 		// Copy the header over.
 		_header = rhs._header;
 		_metaDataMap = rhs._metaDataMap;
+		updateDataLayout();
 	}
 
 	/// <summary>Construct this from the given file header</summary>
@@ -112,13 +268,18 @@ public:
 		return _header;
 	}
 
-	/// <summary>Gets the file header access.</summary>
+	/// <summary>Gets the file header access. After changing the format, dimensions or surface counts through it, call
+	/// updateDataLayout() before getting data sizes, offsets or surfaces. The setters do so themselves.</summary>
 	/// <returns>Return the file header.</returns>
 	Header& getHeaderAccess()
 	{
 		return _header;
 	}
 
+	/// <summary>Rebuild the table of data offsets and sizes used by getDataSize, getDataOffset and getSurfaces. Only
+	/// needed after changing the header through getHeaderAccess().</summary>
+	void updateDataLayout();
+
 	/// <summary>Gets the pixel type ID of the texture.</summary>
 	/// <returns>Return a 64-bit pixel type ID.</returns>
 	PixelFormat getPixelFormat() const
@@ -216,7 +377,8 @@ public:
 	/// <param name="allFaces">The Size of all faces is calculated if true, only a single face if false.</param>
 	/// <returns>Return the size in BYTES of the specified texture area.</returns>
 	/// <remarks>User can retrieve the size of either all surfaces or a single surface, all faces or a single face and
-	/// all MIP-Maps or a single specified MIP level.</remarks>
+	/// all MIP-Maps or a single specified MIP level. Sizes of 4 GiB or more do not fit the return value, but the
+	/// offsets returned by getDataOffset and getSurfaces are exact for them.</remarks>
 	uint32_t getDataSize(int32_t mipLevel = pvrTextureAllMipMaps, bool allSurfaces = true, bool allFaces = true) const;
 
 	/// <summary>Get a offset in the data</summary>
@@ -226,6 +388,16 @@ public:
 	/// <returns>Return data offset</returns>
 	ptrdiff_t getDataOffset(uint32_t mipMapLevel = 0, uint32_t arrayMember = 0, uint32_t face = 0) const;
 
+	/// <summary>Gets all surfaces (one face of one array member of one MIP level) of the texture, in the order they
+	/// are laid out in its data, with their offsets and sizes. Offsets and sizes come from a table that is built once
+	/// per layout, so iterating the surfaces is linear in their number. The range is invalidated by any change to
+	/// the dimensions, format or surface counts of this header.</summary>
+	/// <returns>An iterable range of TextureSurface.</returns>
+	SurfaceRange getSurfaces() const
+	{
+		return SurfaceRange(getDataLayout());
+	}
+
 	/// <summary>Gets the number of array members stored in this texture.</summary>
 	/// <returns>Return the number of array members in this texture.</returns>
 	uint32_t getNumArrayMembers() const
@@ -299,6 +471,7 @@ public:
 	void setPixelFormat(PixelFormat uPixelFormat)
 	{
 		_header.pixelFormat = uPixelFormat.getPixelTypeId();
+		updateDataLayout();
 	}
 
 	/// <summary>Sets the color space for this texture. Default is lRGB.</summary>
@@ -313,6 +486,7 @@ public:
 	void setChannelType(VariableType channelType)
 	{
 		_header.channelType = channelType;
+		updateDataLayout();
 	}
 
 	/// <summary>Sets a texture's bump map data.</summary>
@@ -337,6 +511,7 @@ public:
 	void setWidth(uint32_t newWidth)
 	{
 		_header.width = newWidth;
+		updateDataLayout();
 	}
 
 	/// <summary>Sets the texture height.</summary>
@@ -344,6 +519,7 @@ public:
 	void setHeight(uint32_t newHeight)
 	{
 		_header.height = newHeight;
+		updateDataLayout();
 	}
 
 	/// <summary>Sets the texture depth.</summary>
@@ -351,6 +527,7 @@ public:
 	void setDepth(uint32_t newDepth)
 	{
 		_header.depth = newDepth;
+		updateDataLayout();
 	}
 
 	/// <summary>Sets the number of arrays in this texture</summary>
@@ -358,6 +535,7 @@ public:
 	void setNumArrayMembers(uint32_t numNewMembers)
 	{
 		_header.numSurfaces = numNewMembers;
+		updateDataLayout();
 	}
 
 	/// <summary>Sets the number of MIP-Map levels in this texture.</summary>
@@ -365,6 +543,7 @@ public:
 	void setNumMipMapLevels(uint32_t numNewMipMapLevels)
 	{
 		_header.numMipMaps = numNewMipMapLevels;
+		updateDataLayout();
 	}
 
 	/// <summary>Sets the number of faces stored in this texture.</summary>
@@ -372,6 +551,7 @@ public:
 	void setNumFaces(uint32_t numNewFaces)
 	{
 		_header.numFaces = numNewFaces;
+		updateDataLayout();
 	}
 
 	/// <summary>Sets the data orientation for a given axis in this texture.</summary>
@@ -9,9 +9,11 @@
 #include "PVRCore/textureio/TextureReaderPVR.h"
 #include "PVRCore/textureio/TextureReaderBMP.h"
 #include "PVRCore/textureio/TextureReaderKTX.h"
+#include "PVRCore/textureio/TextureReaderKTX2.h"
 #include "PVRCore/textureio/TextureReaderDDS.h"
 #include "PVRCore/textureio/TextureReaderXNB.h"
 #include "PVRCore/textureio/TextureReaderTGA.h"
+#include "PVRCore/Profiling.h"
 
 namespace pvr {
 
@@ -21,6 +23,7 @@ namespace pvr {
 /// <returns>True if successful, otherwise false</returns>
 inline Texture textureLoad(Stream::ptr_type&& textureStream, TextureFileFormat type)
 {
+	PVR_PROFILE_SCOPE_CATEGORY("textureLoad", "assets");
 	if (!textureStream.get())
 	{
 		throw InvalidArgumentError("textureStream", "[textureLoad] Attempted to load from a NULL stream");
@@ -33,6 +36,9 @@ inline Texture textureLoad(Stream::ptr_type&& textureStream, TextureFileFormat t
 	case TextureFileFormat::KTX:
 		assetRd.reset(new assetReaders::TextureReaderKTX(std::move(textureStream)));
 		break;
+	case TextureFileFormat::KTX2:
+		assetRd.reset(new assetReaders::TextureReaderKTX2(std::move(textureStream)));
+		break;
 	case TextureFileFormat::PVR:
 		assetRd.reset(new assetReaders::TextureReaderPVR(std::move(textureStream)));
 		break;
@@ -40,6 +40,13 @@ public:
 	/// <summary>Load the texture synchronously and signal the result semaphore. Normally called by the worker thread</summary>
 	void loadNow()
 	{
+		if (!beginExecution()) // Cancelled before we got to it
+		{
+			_successful = false;
+			resultSema->signal();
+			executeCallBack(getReference());
+			return;
+		}
 		Stream::ptr_type stream = loader->getAssetStream(filename);
 		_successful = false;
 		try
@@ -107,14 +114,18 @@ inline void textureLoadAsyncWorker(TextureLoadFuture params)
 } // namespace impl
 //!\endcond
 
-/// <summary> A class that loads Textures in a (single) different thread and provides futures to them.
+/// <summary> A class that loads Textures on a pool of worker threads and provides futures to them.
 /// Create an instance of it, and then just call loadTextureAsync foreach texture to load. When each texture
 /// has completed loading, a callback may be called, otherwise you can use all the typical functionality
-/// of futures, such as querying if loading is comlete, or using a blocking wait to get the result </summary>
+/// of futures, such as querying if loading is comlete, or using a blocking wait to get the result.
+/// As several textures may be decoded concurrently, callbacks may be called from different threads and
+/// in a different order than the textures were requested.</summary>
 class TextureAsyncLoader : public AsyncScheduler<TexturePtr, TextureLoadFuture, &impl::textureLoadAsyncWorker>
 {
 public:
-	TextureAsyncLoader()
+	/// <summary>Constructor. Spawns the worker threads.</summary>
+	/// <param name="numWorkers">The number of textures that can be loaded concurrently. If 0 (default), one per hardware thread.</param>
+	explicit TextureAsyncLoader(uint32_t numWorkers = 0) : AsyncScheduler(numWorkers)
 	{
 		_myInfo = "TextureAsyncLoader";
 	}
@@ -124,8 +135,10 @@ public:
 	/// <param name="loader">A class that provides a "getAssetStream" function to get a Stream from the filename (usually, the application class itself)</param>
 	/// <param name="fmt">The texture format as which to load the texture.</param>
 	/// <param name="callback">An optional callback to call immediately after texture loading is complete.</param>
+	/// <param name="priority">The priority of this load relative to the other textures queued on this loader.</param>
 	/// <returns> A future to a texture : TextureLoadFuture </returns>
-	AsyncResult loadTextureAsync(const std::string& filename, IAssetProvider* loader, TextureFileFormat fmt, AsyncResult::ElementType::Callback callback = NULL)
+	AsyncResult loadTextureAsync(const std::string& filename, IAssetProvider* loader, TextureFileFormat fmt, AsyncResult::ElementType::Callback callback = NULL,
+		TaskPriority priority = TaskPriority::Normal)
 	{
 		auto future = TextureLoadFuture::ElementType::createNew();
 		auto& params = *future;
@@ -136,10 +149,7 @@ public:
 		params.resultSema.construct();
 		params.workSema = &_workSemaphore;
 		params.setCallBack(callback);
-		_queueSemaphore.wait();
-		_queue.push_back(future);
-		_queueSemaphore.signal();
-		_workSemaphore.signal();
+		enqueue(future, priority);
 		return future;
 	}
 };
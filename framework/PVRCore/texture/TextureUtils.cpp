@@ -0,0 +1,559 @@
+/*!
+\brief Implementation of the Texture utility helpers.
+\file PVRCore/texture/TextureUtils.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/texture/TextureUtils.h"
+#include "../../../external/glm/glm.hpp"
+#include "../../../external/glm/detail/type_half.hpp"
+#include "../../../external/glm/gtc/constants.hpp"
+#include "PVRCore/Errors.h"
+#include "PVRCore/Log.h"
+#include "PVRCore/Threading.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_TEXTUREUTILS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_TEXTUREUTILS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace pvr {
+namespace assets {
+namespace {
+
+glm::vec2 hammersley(uint32_t i, uint32_t N)
+{
+	// Radical inverse based on http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html
+	uint32_t bits = (i << 16u) | (i >> 16u);
+	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+	float rdi = float(bits) * static_cast<float>(2.3283064365386963e-10);
+	return glm::vec2(float(i) / float(N), rdi);
+}
+
+float G1(float k, float NoV)
+{
+	return NoV / (NoV * (1.0f - k) + k);
+}
+
+// Sample a half-vector in world space
+// Based on http://blog.selfshadow.com/publications/s2013-shading-course/karis/s2013_pbs_epic_slides.pdf
+glm::vec3 importanceSampleGGX(glm::vec2 Xi, float roughness, glm::vec3 N)
+{
+	// Maps a 2D point to a hemisphere with spread based on roughness
+	float a = roughness * roughness;
+	float phi = 2.0f * glm::pi<float>() * Xi.x;
+	float cosTheta = sqrt(glm::clamp((1.0f - Xi.y) / (1.0f + (a * a - 1.0f) * Xi.y), 0.0f, 1.0f));
+	float sinTheta = sqrt(glm::clamp(1.0f - cosTheta * cosTheta, 0.0f, 1.0f));
+
+	glm::vec3 H = glm::vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+
+	glm::vec3 up = glm::abs(N.z) < 0.999 ? glm::vec3(0, 0, 1) : glm::vec3(1, 0, 0);
+	glm::vec3 tangent = glm::normalize(glm::cross(up, N));
+	glm::vec3 bitangent = glm::cross(N, tangent);
+
+	return glm::normalize(tangent * H.x + bitangent * H.y + N * H.z);
+}
+
+// Integrates the BRDF (see http://blog.selfshadow.com/publications/s2013-shading-course/karis/s2013_pbs_epic_notes_v2.pdf)
+// for a whole row of the LUT (a single roughness): the half vectors only depend on the roughness, so they are generated
+// once per row, and the per texel loop is reduced to arithmetic, 4 samples at a time where SIMD is available.
+void integrateBRDFRow(float roughness, uint32_t mapDim, uint32_t numSamples, std::vector<float>& hx, std::vector<float>& hz, glm::vec2* outRow)
+{
+	const glm::vec3 N = glm::vec3(0.0, 0.0, 1.0);
+	// Pad to a multiple of 4 with samples that are rejected (NoL <= 0).
+	const uint32_t paddedSamples = (numSamples + 3u) & ~3u;
+	hx.assign(paddedSamples, 0.0f);
+	hz.assign(paddedSamples, -1.0f);
+	for (uint32_t i = 0u; i < numSamples; ++i)
+	{
+		glm::vec3 H = importanceSampleGGX(hammersley(i, numSamples), roughness, N);
+		hx[i] = H.x;
+		hz[i] = H.z;
+	}
+	const float k = (roughness * roughness) * 0.5f;
+
+	for (uint32_t x = 0; x < mapDim; ++x)
+	{
+		const float NoV = (static_cast<float>(x) + .5f) / static_cast<float>(mapDim);
+		const float Vx = static_cast<float>(sqrt(glm::clamp(1.0 - NoV * NoV, 0.0, 1.0)));
+		const float Vz = NoV;
+		const float clampedNoV = glm::max(Vz, 0.001f);
+		const float G1V = G1(k, clampedNoV);
+		float A = 0.0f;
+		float B = 0.0f;
+		uint32_t i = 0;
+#if defined(PVR_TEXTUREUTILS_SSE2)
+		{
+			const __m128 vx = _mm_set1_ps(Vx), vz = _mm_set1_ps(Vz), vk = _mm_set1_ps(k), oneMinusK = _mm_set1_ps(1.0f - k), g1v = _mm_set1_ps(G1V);
+			const __m128 noVs = _mm_set1_ps(clampedNoV), minValue = _mm_set1_ps(0.001f), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+			__m128 sumA = zero, sumB = zero;
+			for (; i < paddedSamples; i += 4)
+			{
+				const __m128 Hx = _mm_loadu_ps(&hx[i]), Hz = _mm_loadu_ps(&hz[i]);
+				const __m128 rawVoH = _mm_add_ps(_mm_mul_ps(vx, Hx), _mm_mul_ps(vz, Hz));
+				const __m128 NoL = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(rawVoH, rawVoH), Hz), vz);
+				const __m128 mask = _mm_cmpgt_ps(NoL, zero);
+				const __m128 NoH = _mm_max_ps(Hz, minValue);
+				const __m128 VoH = _mm_max_ps(rawVoH, minValue);
+				const __m128 G1L = _mm_div_ps(NoL, _mm_add_ps(_mm_mul_ps(NoL, oneMinusK), vk));
+				const __m128 G = _mm_mul_ps(G1L, g1v);
+				const __m128 GVis = _mm_and_ps(mask, _mm_div_ps(_mm_mul_ps(G, VoH), _mm_mul_ps(NoH, noVs)));
+				const __m128 f = _mm_sub_ps(one, VoH);
+				const __m128 f2 = _mm_mul_ps(f, f);
+				const __m128 Fc = _mm_mul_ps(_mm_mul_ps(f2, f2), f);
+				sumA = _mm_add_ps(sumA, _mm_mul_ps(_mm_sub_ps(one, Fc), GVis));
+				sumB = _mm_add_ps(sumB, _mm_mul_ps(Fc, GVis));
+			}
+			float lanesA[4], lanesB[4];
+			_mm_storeu_ps(lanesA, sumA);
+			_mm_storeu_ps(lanesB, sumB);
+			A = (lanesA[0] + lanesA[1]) + (lanesA[2] + lanesA[3]);
+			B = (lanesB[0] + lanesB[1]) + (lanesB[2] + lanesB[3]);
+		}
+#elif defined(PVR_TEXTUREUTILS_NEON)
+		{
+			const float32x4_t vx = vdupq_n_f32(Vx), vz = vdupq_n_f32(Vz), vk = vdupq_n_f32(k), oneMinusK = vdupq_n_f32(1.0f - k), g1v = vdupq_n_f32(G1V);
+			const float32x4_t noVs = vdupq_n_f32(clampedNoV), minValue = vdupq_n_f32(0.001f), one = vdupq_n_f32(1.0f), zero = vdupq_n_f32(0.0f);
+			float32x4_t sumA = zero, sumB = zero;
+			for (; i < paddedSamples; i += 4)
+			{
+				const float32x4_t Hx = vld1q_f32(&hx[i]), Hz = vld1q_f32(&hz[i]);
+				const float32x4_t rawVoH = vaddq_f32(vmulq_f32(vx, Hx), vmulq_f32(vz, Hz));
+				const float32x4_t NoL = vsubq_f32(vmulq_f32(vaddq_f32(rawVoH, rawVoH), Hz), vz);
+				const uint32x4_t mask = vcgtq_f32(NoL, zero);
+				const float32x4_t NoH = vmaxq_f32(Hz, minValue);
+				const float32x4_t VoH = vmaxq_f32(rawVoH, minValue);
+				// No vector divide on ARMv7: reciprocal estimate and two Newton-Raphson steps.
+				float32x4_t denominator = vaddq_f32(vmulq_f32(NoL, oneMinusK), vk);
+				float32x4_t reciprocal = vrecpeq_f32(denominator);
+				reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+				reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+				const float32x4_t G = vmulq_f32(vmulq_f32(NoL, reciprocal), g1v);
+				denominator = vmulq_f32(NoH, noVs);
+				reciprocal = vrecpeq_f32(denominator);
+				reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+				reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+				const float32x4_t GVis = vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(vmulq_f32(vmulq_f32(G, VoH), reciprocal))));
+				const float32x4_t f = vsubq_f32(one, VoH);
+				const float32x4_t f2 = vmulq_f32(f, f);
+				const float32x4_t Fc = vmulq_f32(vmulq_f32(f2, f2), f);
+				sumA = vaddq_f32(sumA, vmulq_f32(vsubq_f32(one, Fc), GVis));
+				sumB = vaddq_f32(sumB, vmulq_f32(Fc, GVis));
+			}
+			float lanesA[4], lanesB[4];
+			vst1q_f32(lanesA, sumA);
+			vst1q_f32(lanesB, sumB);
+			A = (lanesA[0] + lanesA[1]) + (lanesA[2] + lanesA[3]);
+			B = (lanesB[0] + lanesB[1]) + (lanesB[2] + lanesB[3]);
+		}
+#endif
+		for (; i < numSamples; ++i)
+		{
+			const float rawVoH = Vx * hx[i] + Vz * hz[i];
+			const float NoL = 2.0f * rawVoH * hz[i] - Vz;
+			if (NoL > 0.0f)
+			{
+				const float NoH = glm::max(hz[i], 0.001f);
+				const float VoH = glm::max(rawVoH, 0.001f);
+				const float G_Vis = (G1(k, NoL) * G1V * VoH) / (NoH * clampedNoV);
+				const float f = 1.0f - VoH;
+				const float Fc = (f * f) * (f * f) * f;
+				A += (1.0f - Fc) * G_Vis;
+				B += Fc * G_Vis;
+			}
+		}
+		outRow[x] = glm::vec2(A, B) / float(numSamples);
+	}
+}
+
+// Cube face directions, in the usual +X, -X, +Y, -Y, +Z, -Z order. u and v are in [-1, 1], v increasing downwards.
+glm::vec3 cubeFaceDirection(uint32_t face, float u, float v)
+{
+	switch (face)
+	{
+	case 0: return glm::vec3(1.0f, -v, -u);
+	case 1: return glm::vec3(-1.0f, -v, u);
+	case 2: return glm::vec3(u, 1.0f, v);
+	case 3: return glm::vec3(u, -1.0f, -v);
+	case 4: return glm::vec3(u, -v, 1.0f);
+	default: return glm::vec3(-u, -v, -1.0f);
+	}
+}
+
+// Linear float RGB copy of a cube map and its full MIP chain, for sampling on the CPU.
+struct CubeMapSampler
+{
+	struct Level
+	{
+		uint32_t size;
+		std::vector<glm::vec3> texels; // 6 faces of size x size, face after face
+	};
+	std::vector<Level> levels;
+
+	explicit CubeMapSampler(const Texture& cubeMap)
+	{
+		if (cubeMap.getNumFaces() != 6 || cubeMap.getWidth() != cubeMap.getHeight() || cubeMap.getDepth() != 1)
+		{
+			throw InvalidArgumentError("cubeMap", "[CubeMapSampler] Texture must be a square cube map with 6 faces");
+		}
+		const PixelFormat format = cubeMap.getPixelFormat();
+		const VariableType channelType = cubeMap.getChannelType();
+		const uint8_t numChannels = format.getNumChannels();
+		const uint8_t channelBits = format.getChannelBits(0);
+		const bool isFloat = (channelType == VariableType::SignedFloat || channelType == VariableType::UnsignedFloat);
+		bool supported = !format.isCompressedFormat() && numChannels >= 3 && ((isFloat && (channelBits == 32 || channelBits == 16)) || (channelType == VariableType::UnsignedByteNorm && channelBits == 8));
+		int8_t channelIndices[3] = { -1, -1, -1 };
+		for (uint8_t channel = 0; channel < numChannels; ++channel)
+		{
+			supported = supported && format.getChannelBits(channel) == channelBits;
+			const char content = format.getChannelContent(channel);
+			if (content == 'r')
+			{
+				channelIndices[0] = static_cast<int8_t>(channel);
+			}
+			if (content == 'g')
+			{
+				channelIndices[1] = static_cast<int8_t>(channel);
+			}
+			if (content == 'b')
+			{
+				channelIndices[2] = static_cast<int8_t>(channel);
+			}
+		}
+		if (!supported || channelIndices[0] < 0 || channelIndices[1] < 0 || channelIndices[2] < 0)
+		{
+			throw InvalidArgumentError("cubeMap", "[CubeMapSampler] Only uncompressed RGB(A) cube maps with 8 bit normalised, 16 bit or 32 bit float channels are supported");
+		}
+
+		// Copy the levels the texture has, then box filter the rest of the chain.
+		const uint32_t bytesPerChannel = channelBits / 8;
+		const uint32_t bytesPerPixel = bytesPerChannel * numChannels;
+		for (uint32_t size = cubeMap.getWidth(); size; size /= 2)
+		{
+			Level level;
+			level.size = size;
+			level.texels.resize(6 * size * size);
+			const uint32_t mipLevel = static_cast<uint32_t>(levels.size());
+			if (mipLevel < cubeMap.getNumMipMapLevels())
+			{
+				for (uint32_t face = 0; face < 6; ++face)
+				{
+					const uint8_t* faceData = cubeMap.getDataPointer(mipLevel, 0, face);
+					for (uint32_t i = 0; i < size * size; ++i)
+					{
+						glm::vec3& texel = level.texels[face * size * size + i];
+						for (uint32_t c = 0; c < 3; ++c)
+						{
+							const uint8_t* channelData = faceData + i * bytesPerPixel + channelIndices[c] * bytesPerChannel;
+							if (bytesPerChannel == 4)
+							{
+								memcpy(&texel[c], channelData, 4);
+							}
+							else if (bytesPerChannel == 2)
+							{
+								glm::detail::hdata halfValue;
+								memcpy(&halfValue, channelData, 2);
+								texel[c] = glm::detail::toFloat32(halfValue);
+							}
+							else
+							{
+								texel[c] = *channelData / 255.0f;
+							}
+						}
+					}
+				}
+			}
+			else
+			{
+				const Level& parent = levels.back();
+				for (uint32_t face = 0; face < 6; ++face)
+				{
+					for (uint32_t y = 0; y < size; ++y)
+					{
+						for (uint32_t x = 0; x < size; ++x)
+						{
+							const glm::vec3* p = &parent.texels[(face * parent.size + 2 * y) * parent.size + 2 * x];
+							level.texels[(face * size + y) * size + x] = (p[0] + p[1] + p[parent.size] + p[parent.size + 1]) * 0.25f;
+						}
+					}
+				}
+			}
+			levels.push_back(std::move(level));
+		}
+	}
+
+	// Nearest texel of a single level.
+	const glm::vec3& fetch(const glm::vec3& dir, uint32_t mipLevel) const
+	{
+		const Level& level = levels[mipLevel];
+		const glm::vec3 a = glm::abs(dir);
+		uint32_t face;
+		float sc, tc, ma;
+		if (a.x >= a.y && a.x >= a.z)
+		{
+			face = dir.x >= 0.0f ? 0 : 1;
+			sc = dir.x >= 0.0f ? -dir.z : dir.z;
+			tc = -dir.y;
+			ma = a.x;
+		}
+		else if (a.y >= a.z)
+		{
+			face = dir.y >= 0.0f ? 2 : 3;
+			sc = dir.x;
+			tc = dir.y >= 0.0f ? dir.z : -dir.z;
+			ma = a.y;
+		}
+		else
+		{
+			face = dir.z >= 0.0f ? 4 : 5;
+			sc = dir.z >= 0.0f ? dir.x : -dir.x;
+			tc = -dir.y;
+			ma = a.z;
+		}
+		const float scale = 0.5f * static_cast<float>(level.size) / ma;
+		const uint32_t maxCoord = level.size - 1;
+		const uint32_t x = std::min(static_cast<uint32_t>(std::max((sc * scale) + 0.5f * level.size, 0.0f)), maxCoord);
+		const uint32_t y = std::min(static_cast<uint32_t>(std::max((tc * scale) + 0.5f * level.size, 0.0f)), maxCoord);
+		return level.texels[(face * level.size + y) * level.size + x];
+	}
+
+	// Nearest texel, linearly blended between the two closest levels.
+	glm::vec3 sample(const glm::vec3& dir, float mipLevel) const
+	{
+		const float maxLevel = static_cast<float>(levels.size() - 1);
+		mipLevel = glm::clamp(mipLevel, 0.0f, maxLevel);
+		const uint32_t level0 = static_cast<uint32_t>(mipLevel);
+		const float blend = mipLevel - static_cast<float>(level0);
+		if (blend == 0.0f)
+		{
+			return fetch(dir, level0);
+		}
+		return glm::mix(fetch(dir, level0), fetch(dir, level0 + 1), blend);
+	}
+};
+
+// Creates an RGBA 32 bit float cube map and writes the texels produced by function(face, mipLevel, x, y) into it, one
+// row of one face of one level per job.
+template<typename Function>
+void generateCubeMap(pvr::Texture& outTexture, uint32_t mapDim, uint32_t numMipLevels, uint32_t maxThreads, const Function& function)
+{
+	pvr::TextureHeader header;
+	header.setWidth(mapDim);
+	header.setHeight(mapDim);
+	header.setChannelType(pvr::VariableType::SignedFloat);
+	header.setNumFaces(6);
+	header.setNumMipMapLevels(numMipLevels);
+	header.setPixelFormat(pvr::PixelFormat::RGBA_32323232());
+	outTexture = pvr::Texture(header);
+
+	std::vector<uint32_t> firstRowOfLevel(numMipLevels + 1, 0);
+	for (uint32_t mipLevel = 0; mipLevel < numMipLevels; ++mipLevel)
+	{
+		firstRowOfLevel[mipLevel + 1] = firstRowOfLevel[mipLevel] + 6 * outTexture.getHeight(mipLevel);
+	}
+
+	async::parallelFor(
+		firstRowOfLevel[numMipLevels],
+		[&](uint32_t row) {
+			uint32_t mipLevel = 0;
+			while (row >= firstRowOfLevel[mipLevel + 1])
+			{
+				++mipLevel;
+			}
+			const uint32_t levelDim = outTexture.getWidth(mipLevel);
+			const uint32_t face = (row - firstRowOfLevel[mipLevel]) / levelDim;
+			const uint32_t y = (row - firstRowOfLevel[mipLevel]) % levelDim;
+			glm::vec4* outRow = reinterpret_cast<glm::vec4*>(outTexture.getDataPointer(mipLevel, 0, face)) + y * levelDim;
+			for (uint32_t x = 0; x < levelDim; ++x)
+			{
+				outRow[x] = glm::vec4(function(face, mipLevel, x, y), 1.0f);
+			}
+		},
+		maxThreads);
+}
+
+// Direction through the centre of a texel of a cube map face.
+glm::vec3 cubeTexelDirection(uint32_t face, uint32_t x, uint32_t y, uint32_t faceDim)
+{
+	const float u = 2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(faceDim) - 1.0f;
+	const float v = 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(faceDim) - 1.0f;
+	return glm::normalize(cubeFaceDirection(face, u, v));
+}
+} // namespace
+
+void generateBRDFLUT(pvr::Texture& outTexture, uint32_t mapDim, uint32_t maxThreads)
+{
+	const uint32_t stride = sizeof(glm::detail::hdata);
+	const uint32_t formatStride = stride * 2;
+	std::vector<char> data(mapDim * mapDim * formatStride);
+	async::parallelFor(
+		mapDim,
+		[&](uint32_t j) { // y
+			std::vector<float> hx, hz;
+			std::vector<glm::vec2> row(mapDim);
+			integrateBRDFRow((static_cast<float>(j) + .5f) / static_cast<float>(mapDim), mapDim, 1024u, hx, hz, row.data());
+			uint32_t offset = j * mapDim * formatStride;
+			for (uint32_t i = 0; i < mapDim; ++i) // x
+			{
+				glm::detail::hdata halfR = glm::detail::toFloat16(row[i].r);
+				glm::detail::hdata halfG = glm::detail::toFloat16(row[i].g);
+
+				memcpy(data.data() + offset, &halfR, stride);
+				memcpy(data.data() + offset + stride, &halfG, stride);
+				offset += formatStride;
+			}
+		},
+		maxThreads);
+
+	pvr::TextureHeader header;
+	header.setWidth(mapDim);
+	header.setHeight(mapDim);
+	header.setChannelType(pvr::VariableType::SignedFloat);
+	header.setNumFaces(1);
+	header.setNumMipMapLevels(1);
+	header.setPixelFormat(pvr::PixelFormat::RG_1616());
+	outTexture = pvr::Texture(header, (const char*)data.data());
+}
+
+void generateIrradianceMap(const pvr::Texture& environmentMap, pvr::Texture& outTexture, uint32_t mapDim, uint32_t maxThreads)
+{
+	// Irradiance is very low frequency, so integrating over a small level of the environment loses nothing.
+	CubeMapSampler sampler(environmentMap);
+	uint32_t sourceLevel = 0;
+	while (sourceLevel + 1 < sampler.levels.size() && sampler.levels[sourceLevel].size > 32)
+	{
+		++sourceLevel;
+	}
+	const CubeMapSampler::Level& source = sampler.levels[sourceLevel];
+
+	// Direction and radiance times solid angle of every source texel, as structures of arrays for the inner loop.
+	const uint32_t numTexels = 6 * source.size * source.size;
+	std::vector<float> dirX(numTexels), dirY(numTexels), dirZ(numTexels), red(numTexels), green(numTexels), blue(numTexels);
+	for (uint32_t face = 0; face < 6; ++face)
+	{
+		for (uint32_t y = 0; y < source.size; ++y)
+		{
+			for (uint32_t x = 0; x < source.size; ++x)
+			{
+				const uint32_t index = (face * source.size + y) * source.size + x;
+				const float u = 2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(source.size) - 1.0f;
+				const float v = 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(source.size) - 1.0f;
+				const glm::vec3 dir = cubeFaceDirection(face, u, v);
+				const float lengthSquared = glm::dot(dir, dir);
+				// Solid angle of the texel, divided by PI so that a constant environment maps to itself.
+				const float texelArea = 4.0f / static_cast<float>(source.size * source.size);
+				const float weight = texelArea / (lengthSquared * sqrtf(lengthSquared)) / glm::pi<float>();
+				const glm::vec3 normalized = dir / sqrtf(lengthSquared);
+				dirX[index] = normalized.x;
+				dirY[index] = normalized.y;
+				dirZ[index] = normalized.z;
+				red[index] = source.texels[index].r * weight;
+				green[index] = source.texels[index].g * weight;
+				blue[index] = source.texels[index].b * weight;
+			}
+		}
+	}
+
+	generateCubeMap(outTexture, mapDim, 1, maxThreads, [&](uint32_t face, uint32_t /*mipLevel*/, uint32_t x, uint32_t y) {
+		const glm::vec3 N = cubeTexelDirection(face, x, y, mapDim);
+		float r = 0.0f, g = 0.0f, b = 0.0f;
+		for (uint32_t i = 0; i < numTexels; ++i)
+		{
+			const float cosine = std::max(N.x * dirX[i] + N.y * dirY[i] + N.z * dirZ[i], 0.0f);
+			r += red[i] * cosine;
+			g += green[i] * cosine;
+			b += blue[i] * cosine;
+		}
+		return glm::vec3(r, g, b);
+	});
+}
+
+void generatePrefilteredMap(const pvr::Texture& environmentMap, pvr::Texture& outTexture, uint32_t mapDim, uint32_t numMipLevels, uint32_t numSamples, uint32_t maxThreads)
+{
+	uint32_t fullChain = 1;
+	while ((mapDim >> fullChain) != 0)
+	{
+		++fullChain;
+	}
+	numMipLevels = numMipLevels ? std::min(numMipLevels, fullChain) : fullChain;
+
+	CubeMapSampler sampler(environmentMap);
+	const float sourceDim = static_cast<float>(sampler.levels[0].size);
+	// Solid angle covered by one texel of the top level of the environment.
+	const float omegaP = 4.0f * glm::pi<float>() / (6.0f * sourceDim * sourceDim);
+	// The level of the environment with the resolution of the top level of the output.
+	const float topLevelMip = std::max(log2f(sourceDim / static_cast<float>(mapDim)), 0.0f);
+
+	// The samples only depend on the roughness, so they are generated once per level, in tangent space.
+	struct Sample
+	{
+		glm::vec3 L;
+		float NoL;
+		float mipLevel;
+	};
+	std::vector<std::vector<Sample> > samplesPerLevel(numMipLevels);
+	std::vector<float> weightPerLevel(numMipLevels, 0.0f);
+	for (uint32_t mipLevel = 1; mipLevel < numMipLevels; ++mipLevel)
+	{
+		const float roughness = static_cast<float>(mipLevel) / static_cast<float>(numMipLevels - 1);
+		const float a = roughness * roughness;
+		const float a2 = a * a;
+		for (uint32_t i = 0; i < numSamples; ++i)
+		{
+			const glm::vec2 Xi = hammersley(i, numSamples);
+			const float phi = 2.0f * glm::pi<float>() * Xi.x;
+			const float cosTheta = sqrtf(glm::clamp((1.0f - Xi.y) / (1.0f + (a2 - 1.0f) * Xi.y), 0.0f, 1.0f));
+			const float sinTheta = sqrtf(glm::clamp(1.0f - cosTheta * cosTheta, 0.0f, 1.0f));
+			const glm::vec3 H(sinTheta * cosf(phi), sinTheta * sinf(phi), cosTheta);
+			// V = N = (0, 0, 1)
+			const glm::vec3 L = 2.0f * H.z * H - glm::vec3(0.0f, 0.0f, 1.0f);
+			if (L.z <= 0.0f)
+			{
+				continue;
+			}
+			// Probability Distribution Function, and the solid angle this sample stands for
+			const float NoH = H.z;
+			const float denominator = NoH * NoH * (a2 - 1.0f) + 1.0f;
+			const float D = a2 / (glm::pi<float>() * denominator * denominator);
+			const float pdf = D * NoH / (4.0f * H.z + 0.0001f);
+			const float omegaS = 1.0f / (static_cast<float>(numSamples) * pdf);
+			// Biased by one level, as suggested in the original paper
+			Sample sample;
+			sample.L = L;
+			sample.NoL = L.z;
+			sample.mipLevel = std::max(0.5f * log2f(omegaS / omegaP) + 1.0f, 0.0f);
+			samplesPerLevel[mipLevel].push_back(sample);
+			weightPerLevel[mipLevel] += L.z;
+		}
+	}
+
+	generateCubeMap(outTexture, mapDim, numMipLevels, maxThreads, [&](uint32_t face, uint32_t mipLevel, uint32_t x, uint32_t y) {
+		const glm::vec3 N = cubeTexelDirection(face, x, y, mapDim >> mipLevel);
+		if (mipLevel == 0)
+		{
+			return sampler.sample(N, topLevelMip); // Roughness 0 is a mirror
+		}
+		const glm::vec3 up = glm::abs(N.z) < 0.999f ? glm::vec3(0, 0, 1) : glm::vec3(1, 0, 0);
+		const glm::vec3 tangent = glm::normalize(glm::cross(up, N));
+		const glm::vec3 bitangent = glm::cross(N, tangent);
+		glm::vec3 result(0.0f);
+		for (const Sample& sample : samplesPerLevel[mipLevel])
+		{
+			const glm::vec3 L = tangent * sample.L.x + bitangent * sample.L.y + N * sample.L.z;
+			result += sampler.sample(L, sample.mipLevel) * sample.NoL;
+		}
+		return weightPerLevel[mipLevel] > 0.0f ? result / weightPerLevel[mipLevel] : result;
+	});
+}
+} // namespace assets
+} // namespace pvr
+//!\endcond
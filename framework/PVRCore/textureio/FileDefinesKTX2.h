@@ -0,0 +1,210 @@
+/*!
+\brief Defines used internally by the KTX2 reader.
+\file PVRCore/textureio/FileDefinesKTX2.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include <cstdint>
+
+//!\cond NO_DOXYGEN
+namespace pvr {
+namespace texture_ktx2 {
+// Khronos texture 2.0 file header
+struct FileHeader
+{
+	uint8_t identifier[12];
+	uint32_t vkFormat;
+	uint32_t typeSize;
+	uint32_t pixelWidth;
+	uint32_t pixelHeight;
+	uint32_t pixelDepth;
+	uint32_t layerCount;
+	uint32_t faceCount;
+	uint32_t levelCount;
+	uint32_t supercompressionScheme;
+
+	// Index
+	uint32_t dfdByteOffset;
+	uint32_t dfdByteLength;
+	uint32_t kvdByteOffset;
+	uint32_t kvdByteLength;
+	uint64_t sgdByteOffset;
+	uint64_t sgdByteLength;
+};
+
+// One entry of the level index, which immediately follows the header
+struct LevelIndexEntry
+{
+	uint64_t byteOffset;
+	uint64_t byteLength;
+	uint64_t uncompressedByteLength;
+};
+
+// Magic identifier
+static const uint8_t c_identifier[] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+// Expected size of a header in file
+static const uint32_t c_expectedHeaderSize = 80;
+
+// Identifier for the orientation meta data
+static const char c_orientationMetaDataKey[] = "KTXorientation";
+
+// Supercompression schemes
+enum class SupercompressionScheme : uint32_t
+{
+	None = 0,
+	BasisLZ = 1,
+	Zstandard = 2,
+	ZLIB = 3,
+	Count
+};
+
+// Data Format Descriptor: Offsets (in 32 bit words, from the start of the basic descriptor block) and values of the
+// fields we are interested in
+static const uint32_t c_dfdModelWord = 2; // colorModel: bits 0-7, colorPrimaries: bits 8-15, transferFunction: bits 16-23, flags: bits 24-31
+static const uint32_t c_dfdColorModelETC1S = 163;
+static const uint32_t c_dfdColorModelUASTC = 166;
+static const uint32_t c_dfdTransferSRGB = 2;
+static const uint32_t c_dfdFlagAlphaPremultiplied = 1;
+
+// The Vulkan formats that the reader understands. Values match VkFormat.
+namespace VulkanFormats {
+enum Enum : uint32_t
+{
+	VK_FORMAT_UNDEFINED = 0,
+	VK_FORMAT_R4G4B4A4_UNORM_PACK16 = 2,
+	VK_FORMAT_R5G6B5_UNORM_PACK16 = 4,
+	VK_FORMAT_R5G5B5A1_UNORM_PACK16 = 6,
+	VK_FORMAT_R8_UNORM = 9,
+	VK_FORMAT_R8_SNORM = 10,
+	VK_FORMAT_R8_UINT = 13,
+	VK_FORMAT_R8_SINT = 14,
+	VK_FORMAT_R8_SRGB = 15,
+	VK_FORMAT_R8G8_UNORM = 16,
+	VK_FORMAT_R8G8_SNORM = 17,
+	VK_FORMAT_R8G8_UINT = 20,
+	VK_FORMAT_R8G8_SINT = 21,
+	VK_FORMAT_R8G8_SRGB = 22,
+	VK_FORMAT_R8G8B8_UNORM = 23,
+	VK_FORMAT_R8G8B8_SNORM = 24,
+	VK_FORMAT_R8G8B8_UINT = 27,
+	VK_FORMAT_R8G8B8_SINT = 28,
+	VK_FORMAT_R8G8B8_SRGB = 29,
+	VK_FORMAT_B8G8R8_UNORM = 30,
+	VK_FORMAT_B8G8R8_SRGB = 36,
+	VK_FORMAT_R8G8B8A8_UNORM = 37,
+	VK_FORMAT_R8G8B8A8_SNORM = 38,
+	VK_FORMAT_R8G8B8A8_UINT = 41,
+	VK_FORMAT_R8G8B8A8_SINT = 42,
+	VK_FORMAT_R8G8B8A8_SRGB = 43,
+	VK_FORMAT_B8G8R8A8_UNORM = 44,
+	VK_FORMAT_B8G8R8A8_SRGB = 50,
+	VK_FORMAT_A2B10G10R10_UNORM_PACK32 = 64,
+	VK_FORMAT_A2B10G10R10_UINT_PACK32 = 68,
+	VK_FORMAT_R16_UNORM = 70,
+	VK_FORMAT_R16_SNORM = 71,
+	VK_FORMAT_R16_UINT = 74,
+	VK_FORMAT_R16_SINT = 75,
+	VK_FORMAT_R16_SFLOAT = 76,
+	VK_FORMAT_R16G16_UNORM = 77,
+	VK_FORMAT_R16G16_SNORM = 78,
+	VK_FORMAT_R16G16_UINT = 81,
+	VK_FORMAT_R16G16_SINT = 82,
+	VK_FORMAT_R16G16_SFLOAT = 83,
+	VK_FORMAT_R16G16B16_UNORM = 84,
+	VK_FORMAT_R16G16B16_SNORM = 85,
+	VK_FORMAT_R16G16B16_UINT = 88,
+	VK_FORMAT_R16G16B16_SINT = 89,
+	VK_FORMAT_R16G16B16_SFLOAT = 90,
+	VK_FORMAT_R16G16B16A16_UNORM = 91,
+	VK_FORMAT_R16G16B16A16_SNORM = 92,
+	VK_FORMAT_R16G16B16A16_UINT = 95,
+	VK_FORMAT_R16G16B16A16_SINT = 96,
+	VK_FORMAT_R16G16B16A16_SFLOAT = 97,
+	VK_FORMAT_R32_UINT = 98,
+	VK_FORMAT_R32_SINT = 99,
+	VK_FORMAT_R32_SFLOAT = 100,
+	VK_FORMAT_R32G32_UINT = 101,
+	VK_FORMAT_R32G32_SINT = 102,
+	VK_FORMAT_R32G32_SFLOAT = 103,
+	VK_FORMAT_R32G32B32_UINT = 104,
+	VK_FORMAT_R32G32B32_SINT = 105,
+	VK_FORMAT_R32G32B32_SFLOAT = 106,
+	VK_FORMAT_R32G32B32A32_UINT = 107,
+	VK_FORMAT_R32G32B32A32_SINT = 108,
+	VK_FORMAT_R32G32B32A32_SFLOAT = 109,
+	VK_FORMAT_B10G11R11_UFLOAT_PACK32 = 122,
+	VK_FORMAT_E5B9G9R9_UFLOAT_PACK32 = 123,
+	VK_FORMAT_D16_UNORM = 124,
+	VK_FORMAT_D32_SFLOAT = 126,
+	VK_FORMAT_S8_UINT = 127,
+	VK_FORMAT_D24_UNORM_S8_UINT = 129,
+	VK_FORMAT_D32_SFLOAT_S8_UINT = 130,
+	VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131,
+	VK_FORMAT_BC1_RGB_SRGB_BLOCK = 132,
+	VK_FORMAT_BC1_RGBA_UNORM_BLOCK = 133,
+	VK_FORMAT_BC1_RGBA_SRGB_BLOCK = 134,
+	VK_FORMAT_BC2_UNORM_BLOCK = 135,
+	VK_FORMAT_BC2_SRGB_BLOCK = 136,
+	VK_FORMAT_BC3_UNORM_BLOCK = 137,
+	VK_FORMAT_BC3_SRGB_BLOCK = 138,
+	VK_FORMAT_BC4_UNORM_BLOCK = 139,
+	VK_FORMAT_BC4_SNORM_BLOCK = 140,
+	VK_FORMAT_BC5_UNORM_BLOCK = 141,
+	VK_FORMAT_BC5_SNORM_BLOCK = 142,
+	VK_FORMAT_BC6H_UFLOAT_BLOCK = 143,
+	VK_FORMAT_BC6H_SFLOAT_BLOCK = 144,
+	VK_FORMAT_BC7_UNORM_BLOCK = 145,
+	VK_FORMAT_BC7_SRGB_BLOCK = 146,
+	VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK = 147,
+	VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK = 148,
+	VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK = 149,
+	VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK = 150,
+	VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK = 151,
+	VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK = 152,
+	VK_FORMAT_EAC_R11_UNORM_BLOCK = 153,
+	VK_FORMAT_EAC_R11_SNORM_BLOCK = 154,
+	VK_FORMAT_EAC_R11G11_UNORM_BLOCK = 155,
+	VK_FORMAT_EAC_R11G11_SNORM_BLOCK = 156,
+	VK_FORMAT_ASTC_4x4_UNORM_BLOCK = 157,
+	VK_FORMAT_ASTC_4x4_SRGB_BLOCK = 158,
+	VK_FORMAT_ASTC_5x4_UNORM_BLOCK = 159,
+	VK_FORMAT_ASTC_5x4_SRGB_BLOCK = 160,
+	VK_FORMAT_ASTC_5x5_UNORM_BLOCK = 161,
+	VK_FORMAT_ASTC_5x5_SRGB_BLOCK = 162,
+	VK_FORMAT_ASTC_6x5_UNORM_BLOCK = 163,
+	VK_FORMAT_ASTC_6x5_SRGB_BLOCK = 164,
+	VK_FORMAT_ASTC_6x6_UNORM_BLOCK = 165,
+	VK_FORMAT_ASTC_6x6_SRGB_BLOCK = 166,
+	VK_FORMAT_ASTC_8x5_UNORM_BLOCK = 167,
+	VK_FORMAT_ASTC_8x5_SRGB_BLOCK = 168,
+	VK_FORMAT_ASTC_8x6_UNORM_BLOCK = 169,
+	VK_FORMAT_ASTC_8x6_SRGB_BLOCK = 170,
+	VK_FORMAT_ASTC_8x8_UNORM_BLOCK = 171,
+	VK_FORMAT_ASTC_8x8_SRGB_BLOCK = 172,
+	VK_FORMAT_ASTC_10x5_UNORM_BLOCK = 173,
+	VK_FORMAT_ASTC_10x5_SRGB_BLOCK = 174,
+	VK_FORMAT_ASTC_10x6_UNORM_BLOCK = 175,
+	VK_FORMAT_ASTC_10x6_SRGB_BLOCK = 176,
+	VK_FORMAT_ASTC_10x8_UNORM_BLOCK = 177,
+	VK_FORMAT_ASTC_10x8_SRGB_BLOCK = 178,
+	VK_FORMAT_ASTC_10x10_UNORM_BLOCK = 179,
+	VK_FORMAT_ASTC_10x10_SRGB_BLOCK = 180,
+	VK_FORMAT_ASTC_12x10_UNORM_BLOCK = 181,
+	VK_FORMAT_ASTC_12x10_SRGB_BLOCK = 182,
+	VK_FORMAT_ASTC_12x12_UNORM_BLOCK = 183,
+	VK_FORMAT_ASTC_12x12_SRGB_BLOCK = 184,
+	VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG = 1000054000,
+	VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG = 1000054001,
+	VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG = 1000054002,
+	VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG = 1000054003,
+	VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG = 1000054004,
+	VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG = 1000054005,
+	VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG = 1000054006,
+	VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG = 1000054007,
+};
+} // namespace VulkanFormats
+} // namespace texture_ktx2
+} // namespace pvr
+//!\endcond
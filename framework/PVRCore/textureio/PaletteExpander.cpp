@@ -9,7 +9,103 @@
 #include "PaletteExpander.h"
 #include "PVRCore/Errors.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PVR_PALETTE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PVR_PALETTE_NEON
+#include <arm_neon.h>
+#endif
+
 namespace pvr {
+namespace {
+// Returns the largest of a run of 8 bit indices, 16 at a time where SIMD is available.
+uint8_t findMaxIndex(const uint8_t* indices, uint32_t numIndices)
+{
+	uint32_t i = 0;
+	uint8_t maxIndex = 0;
+#if defined(PVR_PALETTE_SSE2)
+	if (numIndices >= 16)
+	{
+		__m128i maxVec = _mm_setzero_si128();
+		for (; i + 16 <= numIndices; i += 16)
+		{
+			maxVec = _mm_max_epu8(maxVec, _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)));
+		}
+		maxVec = _mm_max_epu8(maxVec, _mm_srli_si128(maxVec, 8));
+		maxVec = _mm_max_epu8(maxVec, _mm_srli_si128(maxVec, 4));
+		maxVec = _mm_max_epu8(maxVec, _mm_srli_si128(maxVec, 2));
+		maxVec = _mm_max_epu8(maxVec, _mm_srli_si128(maxVec, 1));
+		maxIndex = static_cast<uint8_t>(_mm_cvtsi128_si32(maxVec) & 0xff);
+	}
+#elif defined(PVR_PALETTE_NEON)
+	if (numIndices >= 16)
+	{
+		uint8x16_t maxVec = vdupq_n_u8(0);
+		for (; i + 16 <= numIndices; i += 16)
+		{
+			maxVec = vmaxq_u8(maxVec, vld1q_u8(indices + i));
+		}
+		uint8x8_t maxHalf = vmax_u8(vget_low_u8(maxVec), vget_high_u8(maxVec));
+		maxHalf = vpmax_u8(maxHalf, maxHalf);
+		maxHalf = vpmax_u8(maxHalf, maxHalf);
+		maxHalf = vpmax_u8(maxHalf, maxHalf);
+		maxIndex = vget_lane_u8(maxHalf, 0);
+	}
+#endif
+	for (; i < numIndices; ++i)
+	{
+		maxIndex = indices[i] > maxIndex ? indices[i] : maxIndex;
+	}
+	return maxIndex;
+}
+
+template<uint32_t BytesPerEntry>
+void expandIndices8(const uint8_t* palette, const uint8_t* indices, uint32_t numIndices, unsigned char* outputData)
+{
+	for (uint32_t i = 0; i < numIndices; ++i)
+	{
+		memcpy(outputData + i * BytesPerEntry, palette + indices[i] * BytesPerEntry, BytesPerEntry);
+	}
+}
+
+template<>
+void expandIndices8<1>(const uint8_t* palette, const uint8_t* indices, uint32_t numIndices, unsigned char* outputData)
+{
+	for (uint32_t i = 0; i < numIndices; ++i)
+	{
+		outputData[i] = palette[indices[i]];
+	}
+}
+
+template<>
+void expandIndices8<4>(const uint8_t* palette, const uint8_t* indices, uint32_t numIndices, unsigned char* outputData)
+{
+	uint32_t i = 0;
+#if defined(PVR_PALETTE_SSE2) || defined(PVR_PALETTE_NEON)
+	// Gather four colors at a time and write them with a single 16 byte store.
+	for (; i + 4 <= numIndices; i += 4)
+	{
+		uint32_t colors[4];
+		memcpy(&colors[0], palette + indices[i] * 4, 4);
+		memcpy(&colors[1], palette + indices[i + 1] * 4, 4);
+		memcpy(&colors[2], palette + indices[i + 2] * 4, 4);
+		memcpy(&colors[3], palette + indices[i + 3] * 4, 4);
+#if defined(PVR_PALETTE_SSE2)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputData + i * 4), _mm_set_epi32(static_cast<int>(colors[3]), static_cast<int>(colors[2]),
+																			   static_cast<int>(colors[1]), static_cast<int>(colors[0])));
+#else
+		vst1q_u32(reinterpret_cast<uint32_t*>(outputData + i * 4), vld1q_u32(colors));
+#endif
+	}
+#endif
+	for (; i < numIndices; ++i)
+	{
+		memcpy(outputData + i * 4, palette + indices[i] * 4, 4);
+	}
+}
+} // namespace
+
 PaletteExpander::PaletteExpander(const uint8_t* paletteData, uint32_t paletteSize, uint32_t bytesPerEntry)
 	: _paletteData(paletteData), _paletteSize(paletteSize), _bytesPerEntry(bytesPerEntry)
 {}
@@ -26,5 +122,72 @@ void PaletteExpander::getColorFromIndex(uint32_t index, unsigned char* outputDat
 	}
 	memcpy(outputData, &(_paletteData[index * _bytesPerEntry]), _bytesPerEntry);
 }
+
+void PaletteExpander::expandIndices(const uint8_t* indices, uint32_t bytesPerIndex, uint32_t numIndices, unsigned char* outputData) const
+{
+	if (!(_paletteData != 0 && _paletteSize != 0 && _bytesPerEntry != 0))
+	{
+		throw InvalidOperationError("[PaletteExpander::expandIndices]: Palette Expander was invalid.");
+	}
+	const uint32_t numEntries = _paletteSize / _bytesPerEntry;
+
+	if (bytesPerIndex != 1)
+	{
+		for (uint32_t i = 0; i < numIndices; ++i)
+		{
+			uint32_t index = indices[i * bytesPerIndex] | (indices[i * bytesPerIndex + 1] << 8);
+			if (bytesPerIndex == 4)
+			{
+				index |= (indices[i * bytesPerIndex + 2] << 16) | (static_cast<uint32_t>(indices[i * bytesPerIndex + 3]) << 24);
+			}
+			getColorFromIndex(index, outputData + i * _bytesPerEntry);
+		}
+		return;
+	}
+
+	// Validate the whole run up front, so that the expansion loops below need no checks.
+	if (numEntries < 256 && findMaxIndex(indices, numIndices) >= numEntries)
+	{
+		for (uint32_t i = 0; i < numIndices; ++i)
+		{
+			if (indices[i] >= numEntries)
+			{
+				throw IndexOutOfRange("[PaletteExpander::expandIndices]", indices[i], numEntries);
+			}
+		}
+	}
+
+	switch (_bytesPerEntry)
+	{
+	case 1: expandIndices8<1>(_paletteData, indices, numIndices, outputData); break;
+	case 2: expandIndices8<2>(_paletteData, indices, numIndices, outputData); break;
+	case 3: expandIndices8<3>(_paletteData, indices, numIndices, outputData); break;
+	case 4: expandIndices8<4>(_paletteData, indices, numIndices, outputData); break;
+	default:
+		for (uint32_t i = 0; i < numIndices; ++i)
+		{
+			memcpy(outputData + i * _bytesPerEntry, _paletteData + indices[i] * _bytesPerEntry, _bytesPerEntry);
+		}
+		break;
+	}
+}
+
+void PaletteExpander::fillColorFromIndex(uint32_t index, uint32_t count, unsigned char* outputData) const
+{
+	if (count == 0)
+	{
+		return;
+	}
+	getColorFromIndex(index, outputData);
+	// Double the filled region on every copy.
+	size_t filled = _bytesPerEntry;
+	const size_t total = static_cast<size_t>(count) * _bytesPerEntry;
+	while (filled < total)
+	{
+		size_t toCopy = filled < total - filled ? filled : total - filled;
+		memcpy(outputData + filled, outputData, toCopy);
+		filled += toCopy;
+	}
+}
 } // namespace pvr
 //!\endcond
@@ -24,6 +24,21 @@ public:
 	/// <param name="outputData">A pointer to the palette color for the specified index is returned here</param>
 	void getColorFromIndex(uint32_t index, unsigned char* outputData) const;
 
+	/// <summary>Expands a run of tightly packed little endian indices into consecutive colors. Equivalent to calling
+	/// getColorFromIndex for each index, but validates and expands the whole run with tight (and where available, SIMD)
+	/// loops.</summary>
+	/// <param name="indices">The indices to expand</param>
+	/// <param name="bytesPerIndex">The size of each index. Must be 1, 2 or 4</param>
+	/// <param name="numIndices">The number of indices to expand</param>
+	/// <param name="outputData">numIndices palette colors are written here. Throws if any index overruns the palette</param>
+	void expandIndices(const uint8_t* indices, uint32_t bytesPerIndex, uint32_t numIndices, unsigned char* outputData) const;
+
+	/// <summary>Writes the color of a single index a number of times.</summary>
+	/// <param name="index">The index of the entry to repeat. Throws if overruns the palette</param>
+	/// <param name="count">The number of times to write the color</param>
+	/// <param name="outputData">count palette colors are written here</param>
+	void fillColorFromIndex(uint32_t index, uint32_t count, unsigned char* outputData) const;
+
 private:
 	const uint8_t* _paletteData;
 	const uint32_t _paletteSize;
@@ -0,0 +1,166 @@
+/*!
+\brief Internally used by some texture readers.
+\file PVRCore/textureio/StreamChunkReader.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+
+#include "PVRCore/stream/Stream.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace pvr {
+/// <summary>Internally used by some texture readers. Serves the remainder of a stream from memory, so that formats made
+/// of many tiny fields (run length packets, palette indices) can be decoded with tight loops instead of a stream read per
+/// field. Uses the stream's mapped view if it offers one, otherwise refills an internal buffer in large chunks.
+/// The position of the stream is undefined until release() is called.</summary>
+class StreamChunkReader
+{
+public:
+	/// <summary>Constructor. Starts reading at the current position of the stream.</summary>
+	/// <param name="stream">The stream to read from. Must outlive this object, and not be used directly until release().</param>
+	/// <param name="chunkSize">The number of bytes to pull from the stream per refill, if it cannot be mapped.</param>
+	explicit StreamChunkReader(const Stream& stream, size_t chunkSize = 64 * 1024)
+		: _stream(stream), _startPosition(stream.getPosition()), _consumedBefore(0), _streamRemaining(0), _base(NULL), _current(NULL), _end(NULL), _chunkSize(chunkSize), _mapped(false)
+	{
+		size_t streamSize = stream.getSize();
+		size_t remaining = streamSize > _startPosition ? streamSize - _startPosition : 0;
+		_streamRemaining = remaining;
+		const uint8_t* mappedData = remaining ? static_cast<const uint8_t*>(stream.getMappedView(_startPosition, remaining)) : NULL;
+		if (mappedData)
+		{
+			_base = _current = mappedData;
+			_end = mappedData + remaining;
+			_mapped = true;
+		}
+	}
+
+	/// <summary>Returns a pointer to the next numBytes bytes and consumes them. The pointer is only valid until the next
+	/// call to a method of this object. Throws a FileIOError if the stream ends before numBytes could be provided.</summary>
+	/// <param name="numBytes">The number of contiguous bytes required.</param>
+	/// <returns>A pointer to numBytes bytes.</returns>
+	const uint8_t* acquire(size_t numBytes)
+	{
+		if (static_cast<size_t>(_end - _current) < numBytes)
+		{
+			refill(numBytes);
+		}
+		const uint8_t* retval = _current;
+		_current += numBytes;
+		return retval;
+	}
+
+	/// <summary>Reads a single byte.</summary>
+	/// <returns>The next byte of the stream.</returns>
+	uint8_t readByte()
+	{
+		if (_current == _end)
+		{
+			refill(1);
+		}
+		return *_current++;
+	}
+
+	/// <summary>Copies numBytes bytes into outData. Large reads from an unmapped stream bypass the internal buffer.</summary>
+	/// <param name="numBytes">The number of bytes to read.</param>
+	/// <param name="outData">The destination of the data.</param>
+	void read(size_t numBytes, void* outData)
+	{
+		uint8_t* out = static_cast<uint8_t*>(outData);
+		size_t buffered = std::min(numBytes, static_cast<size_t>(_end - _current));
+		memcpy(out, _current, buffered);
+		_current += buffered;
+		numBytes -= buffered;
+		if (numBytes == 0)
+		{
+			return;
+		}
+		if (!_mapped && numBytes >= _chunkSize)
+		{
+			// The window is empty here, and the stream is positioned right after it.
+			_stream.readExact(1, numBytes, out + buffered);
+			_streamRemaining -= std::min(_streamRemaining, numBytes);
+			_consumedBefore += static_cast<size_t>(_current - _base) + numBytes;
+			_base = _current = _end = _buffer.data();
+			return;
+		}
+		memcpy(out + buffered, acquire(numBytes), numBytes);
+	}
+
+	/// <summary>Skips numBytes bytes.</summary>
+	/// <param name="numBytes">The number of bytes to skip.</param>
+	void skip(size_t numBytes)
+	{
+		size_t buffered = std::min(numBytes, static_cast<size_t>(_end - _current));
+		_current += buffered;
+		numBytes -= buffered;
+		if (numBytes)
+		{
+			acquire(numBytes);
+		}
+	}
+
+	/// <summary>Gets the number of bytes consumed since construction.</summary>
+	/// <returns>The number of bytes consumed.</returns>
+	size_t getNumConsumed() const { return _consumedBefore + static_cast<size_t>(_current - _base); }
+
+	/// <summary>Moves the position of the stream to just after the last byte consumed through this object, so that the
+	/// stream can be used directly again.</summary>
+	void release() const { _stream.seek(static_cast<long>(_startPosition + getNumConsumed()), Stream::SeekOriginFromStart); }
+
+private:
+	void refill(size_t minBytes)
+	{
+		size_t leftover = static_cast<size_t>(_end - _current);
+		if (_mapped)
+		{
+			throw FileIOError(_stream,
+				"StreamChunkReader: Unexpected end of stream. Attempted to read [" + std::to_string(minBytes) + "] bytes but only [" + std::to_string(leftover) + "] remain");
+		}
+		_consumedBefore += static_cast<size_t>(_current - _base);
+		size_t requiredSize = std::max(_chunkSize, minBytes);
+		if (_buffer.size() < requiredSize)
+		{
+			std::vector<uint8_t> newBuffer(requiredSize);
+			memcpy(newBuffer.data(), _current, leftover);
+			_buffer.swap(newBuffer);
+		}
+		else
+		{
+			memmove(_buffer.data(), _current, leftover);
+		}
+		// Some streams throw rather than return a short read, so never ask for more than the stream holds.
+		size_t dataRead = 0;
+		size_t toRead = std::min(_buffer.size() - leftover, _streamRemaining);
+		if (toRead)
+		{
+			_stream.read(1, toRead, _buffer.data() + leftover, dataRead);
+		}
+		_streamRemaining -= dataRead;
+		_base = _current = _buffer.data();
+		_end = _base + leftover + dataRead;
+		if (leftover + dataRead < minBytes)
+		{
+			throw FileIOError(_stream,
+				"StreamChunkReader: Unexpected end of stream. Attempted to read [" + std::to_string(minBytes) + "] bytes but only [" + std::to_string(leftover + dataRead) +
+					"] remain");
+		}
+	}
+
+	const Stream& _stream;
+	size_t _startPosition;
+	size_t _consumedBefore;
+	size_t _streamRemaining;
+	const uint8_t* _base;
+	const uint8_t* _current;
+	const uint8_t* _end;
+	size_t _chunkSize;
+	bool _mapped;
+	std::vector<uint8_t> _buffer;
+
+	// Declare this as private to avoid warnings - the compiler can't generate it because of the reference member
+	const StreamChunkReader& operator=(const StreamChunkReader&);
+};
+} // namespace pvr
@@ -9,6 +9,7 @@
 #include "PVRCore/Log.h"
 #include "PVRCore/textureio/TextureReaderBMP.h"
 #include "PVRCore/textureio/PaletteExpander.h"
+#include "PVRCore/textureio/StreamChunkReader.h"
 #include "PVRCore/texture/MetaData.h"
 using std::string;
 using std::vector;
@@ -461,16 +462,18 @@ void TextureReaderBMP::loadRowAligned(Texture& asset, uint32_t bytesPerDataEntry
 	// Start reading data
 	unsigned char* outputPixel = asset.getDataPointer() + bytesPerScanline * (asset.getHeight() - 1);
 
+	StreamChunkReader reader(*_assetStream);
 	for (uint32_t y = 0; y < (asset.getHeight()); ++y)
 	{
 		// Read the next scan line
-		_assetStream->readExact(bytesPerDataEntry, asset.getWidth(), outputPixel);
+		reader.read(bytesPerScanline, outputPixel);
 		// Increment the pixel
 		outputPixel -= bytesPerScanline;
 
-		// seek past the scan line padding
-		_assetStream->seek(scanlinePadding, Stream::SeekOriginFromCurrent);
+		// skip past the scan line padding
+		reader.skip(scanlinePadding);
 	}
+	reader.release();
 }
 
 void TextureReaderBMP::loadIndexed(Texture& asset, uint32_t bytesPerPaletteEntry, uint32_t bitsPerDataEntry, uint32_t numPaletteEntries, uint32_t rowAlignment)
@@ -507,38 +510,42 @@ void TextureReaderBMP::loadIndexed(Texture& asset, uint32_t bytesPerPaletteEntry
 	// Work out the bit mask of the index value
 	uint8_t indexMask = 0xffu >> (8 - bitsPerDataEntry);
 
+	// Indices of the current row, unpacked to one per byte when they are packed more tightly in the file
+	vector<uint8_t> rowIndices;
+	if (indicesPerByte > 1)
+	{
+		rowIndices.resize(bytesPerScanline * indicesPerByte);
+	}
+
 	// Start reading data
 	unsigned char* outputPixel = asset.getDataPointer();
-	uint8_t currentIndexData = 0;
+	StreamChunkReader reader(*_assetStream);
 	for (uint32_t y = 0; y < (asset.getHeight()); ++y)
 	{
-		for (uint32_t x = 0; x < (asset.getWidth()); x += indicesPerByte)
+		const uint8_t* indexData = reader.acquire(bytesPerScanline);
+		if (indicesPerByte > 1)
 		{
-			// Read the next char of indices
-			_assetStream->readExact(1, 1, &currentIndexData);
-
-			// Loop through all the indices in the char
-			for (uint32_t indexPosition = 0; indexPosition < indicesPerByte; ++indexPosition)
+			// Unpack the indices, most significant bits first
+			for (uint32_t byteIndex = 0; byteIndex < bytesPerScanline; ++byteIndex)
 			{
-				if ((x + indexPosition) < asset.getWidth())
+				uint8_t currentIndexData = indexData[byteIndex];
+				for (uint32_t indexPosition = 0; indexPosition < indicesPerByte; ++indexPosition)
 				{
-					// Mask out the actual index from the current index data
 					uint8_t bitShift = static_cast<uint8_t>(8 - (bitsPerDataEntry * (indexPosition + 1)));
-
-					uint8_t actualIndex = static_cast<uint8_t>((currentIndexData & (indexMask << (bitShift))) >> (bitShift));
-
-					// Get the color output - don't need to check for errors, as the out of bounds condition is impossible due to the mask.
-					paletteLookup.getColorFromIndex(actualIndex, outputPixel);
-
-					// Increment the pixel
-					outputPixel += bytesPerPaletteEntry;
+					rowIndices[byteIndex * indicesPerByte + indexPosition] = static_cast<uint8_t>((currentIndexData >> bitShift) & indexMask);
 				}
 			}
+			indexData = rowIndices.data();
 		}
 
-		// seek past the scan line padding
-		_assetStream->seek(scanlinePadding, Stream::SeekOriginFromCurrent);
+		// Expand the whole row
+		paletteLookup.expandIndices(indexData, 1, asset.getWidth(), outputPixel);
+		outputPixel += asset.getWidth() * bytesPerPaletteEntry;
+
+		// skip past the scan line padding
+		reader.skip(scanlinePadding);
 	}
+	reader.release();
 }
 } // namespace assetReaders
 } // namespace pvr
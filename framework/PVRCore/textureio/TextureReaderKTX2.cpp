@@ -0,0 +1,420 @@
+/*!
+\brief Implementation of methods of the TextureReaderKTX2 class.
+\file PVRCore/textureio/TextureReaderKTX2.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/textureio/TextureReaderKTX2.h"
+#include "PVRCore/texture/TextureDefines.h"
+#include "PVRCore/textureio/ZstdDecoder.h"
+#include "PVRCore/Log.h"
+#include <algorithm>
+
+namespace {
+using namespace pvr;
+using namespace pvr::texture_ktx2;
+
+static_assert(sizeof(FileHeader) == c_expectedHeaderSize, "KTX2 file header must be tightly packed");
+static_assert(sizeof(LevelIndexEntry) == 24, "KTX2 level index entries must be tightly packed");
+
+inline bool setFormat(TextureHeader& hd, PixelFormat format, VariableType channelType, ColorSpace colorSpace)
+{
+	hd.setPixelFormat(format);
+	hd.setChannelType(channelType);
+	hd.setColorSpace(colorSpace);
+	return true;
+}
+
+bool setVulkanFormat(TextureHeader& hd, uint32_t vkFormat)
+{
+	switch (vkFormat)
+	{
+	case VulkanFormats::VK_FORMAT_R4G4B4A4_UNORM_PACK16: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 4, 4, 4, 4), VariableType::UnsignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R5G6B5_UNORM_PACK16: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 5, 6, 5, 0), VariableType::UnsignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R5G5B5A1_UNORM_PACK16: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 5, 5, 5, 1), VariableType::UnsignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8_UNORM: return setFormat(hd, PixelFormat('r', 0, 0, 0, 8, 0, 0, 0), VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8_SNORM: return setFormat(hd, PixelFormat('r', 0, 0, 0, 8, 0, 0, 0), VariableType::SignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8_UINT: return setFormat(hd, PixelFormat('r', 0, 0, 0, 8, 0, 0, 0), VariableType::UnsignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8_SINT: return setFormat(hd, PixelFormat('r', 0, 0, 0, 8, 0, 0, 0), VariableType::SignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8_SRGB: return setFormat(hd, PixelFormat('r', 0, 0, 0, 8, 0, 0, 0), VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_R8G8_UNORM: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 8, 8, 0, 0), VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8_SNORM: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 8, 8, 0, 0), VariableType::SignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8_UINT: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 8, 8, 0, 0), VariableType::UnsignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8_SINT: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 8, 8, 0, 0), VariableType::SignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8_SRGB: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 8, 8, 0, 0), VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8_UNORM: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 8, 8, 8, 0), VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8_SNORM: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 8, 8, 8, 0), VariableType::SignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8_UINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 8, 8, 8, 0), VariableType::UnsignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8_SINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 8, 8, 8, 0), VariableType::SignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8_SRGB: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 8, 8, 8, 0), VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_B8G8R8_UNORM: return setFormat(hd, PixelFormat('b', 'g', 'r', 0, 8, 8, 8, 0), VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_B8G8R8_SRGB: return setFormat(hd, PixelFormat('b', 'g', 'r', 0, 8, 8, 8, 0), VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8A8_UNORM: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 8, 8, 8, 8), VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8A8_SNORM: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 8, 8, 8, 8), VariableType::SignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8A8_UINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 8, 8, 8, 8), VariableType::UnsignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8A8_SINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 8, 8, 8, 8), VariableType::SignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R8G8B8A8_SRGB: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 8, 8, 8, 8), VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_B8G8R8A8_UNORM: return setFormat(hd, PixelFormat('b', 'g', 'r', 'a', 8, 8, 8, 8), VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_B8G8R8A8_SRGB: return setFormat(hd, PixelFormat('b', 'g', 'r', 'a', 8, 8, 8, 8), VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_A2B10G10R10_UNORM_PACK32: return setFormat(hd, PixelFormat('a', 'b', 'g', 'r', 2, 10, 10, 10), VariableType::UnsignedIntegerNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_A2B10G10R10_UINT_PACK32: return setFormat(hd, PixelFormat('a', 'b', 'g', 'r', 2, 10, 10, 10), VariableType::UnsignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16_UNORM: return setFormat(hd, PixelFormat('r', 0, 0, 0, 16, 0, 0, 0), VariableType::UnsignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16_SNORM: return setFormat(hd, PixelFormat('r', 0, 0, 0, 16, 0, 0, 0), VariableType::SignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16_UINT: return setFormat(hd, PixelFormat('r', 0, 0, 0, 16, 0, 0, 0), VariableType::UnsignedShort, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16_SINT: return setFormat(hd, PixelFormat('r', 0, 0, 0, 16, 0, 0, 0), VariableType::SignedShort, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16_SFLOAT: return setFormat(hd, PixelFormat('r', 0, 0, 0, 16, 0, 0, 0), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16_UNORM: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 16, 16, 0, 0), VariableType::UnsignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16_SNORM: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 16, 16, 0, 0), VariableType::SignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16_UINT: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 16, 16, 0, 0), VariableType::UnsignedShort, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16_SINT: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 16, 16, 0, 0), VariableType::SignedShort, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16_SFLOAT: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 16, 16, 0, 0), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16_UNORM: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 16, 16, 16, 0), VariableType::UnsignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16_SNORM: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 16, 16, 16, 0), VariableType::SignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16_UINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 16, 16, 16, 0), VariableType::UnsignedShort, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16_SINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 16, 16, 16, 0), VariableType::SignedShort, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16_SFLOAT: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 16, 16, 16, 0), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16A16_UNORM: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 16, 16, 16, 16), VariableType::UnsignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16A16_SNORM: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 16, 16, 16, 16), VariableType::SignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16A16_UINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 16, 16, 16, 16), VariableType::UnsignedShort, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16A16_SINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 16, 16, 16, 16), VariableType::SignedShort, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R16G16B16A16_SFLOAT: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 16, 16, 16, 16), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32_UINT: return setFormat(hd, PixelFormat('r', 0, 0, 0, 32, 0, 0, 0), VariableType::UnsignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32_SINT: return setFormat(hd, PixelFormat('r', 0, 0, 0, 32, 0, 0, 0), VariableType::SignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32_SFLOAT: return setFormat(hd, PixelFormat('r', 0, 0, 0, 32, 0, 0, 0), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32_UINT: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 32, 32, 0, 0), VariableType::UnsignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32_SINT: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 32, 32, 0, 0), VariableType::SignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32_SFLOAT: return setFormat(hd, PixelFormat('r', 'g', 0, 0, 32, 32, 0, 0), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32B32_UINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 32, 32, 32, 0), VariableType::UnsignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32B32_SINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 32, 32, 32, 0), VariableType::SignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32B32_SFLOAT: return setFormat(hd, PixelFormat('r', 'g', 'b', 0, 32, 32, 32, 0), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32B32A32_UINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 32, 32, 32, 32), VariableType::UnsignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32B32A32_SINT: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 32, 32, 32, 32), VariableType::SignedInteger, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_R32G32B32A32_SFLOAT: return setFormat(hd, PixelFormat('r', 'g', 'b', 'a', 32, 32, 32, 32), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_B10G11R11_UFLOAT_PACK32: return setFormat(hd, PixelFormat('b', 'g', 'r', 0, 10, 11, 11, 0), VariableType::UnsignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_E5B9G9R9_UFLOAT_PACK32: return setFormat(hd, CompressedPixelFormat::SharedExponentR9G9B9E5, VariableType::UnsignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_D16_UNORM: return setFormat(hd, PixelFormat('d', 0, 0, 0, 16, 0, 0, 0), VariableType::UnsignedShortNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_D32_SFLOAT: return setFormat(hd, PixelFormat('d', 0, 0, 0, 32, 0, 0, 0), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_S8_UINT: return setFormat(hd, PixelFormat('s', 0, 0, 0, 8, 0, 0, 0), VariableType::UnsignedByte, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_D24_UNORM_S8_UINT: return setFormat(hd, PixelFormat('d', 's', 0, 0, 24, 8, 0, 0), VariableType::UnsignedIntegerNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_D32_SFLOAT_S8_UINT: return setFormat(hd, PixelFormat('d', 's', 0, 0, 32, 8, 0, 0), VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC1_RGB_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC1, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC1_RGB_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::BC1, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_BC1_RGBA_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC1, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC1_RGBA_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::BC1, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_BC2_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC2, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC2_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::BC2, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_BC3_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC3, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC3_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::BC3, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_BC7_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC7, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC7_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::BC7, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_BC4_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC4, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC4_SNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC4, VariableType::SignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC5_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC5, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC5_SNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::BC5, VariableType::SignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_EAC_R11_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::EAC_R11, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_EAC_R11_SNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::EAC_R11, VariableType::SignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_EAC_R11G11_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::EAC_RG11, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_EAC_R11G11_SNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::EAC_RG11, VariableType::SignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC6H_UFLOAT_BLOCK: return setFormat(hd, CompressedPixelFormat::BC6, VariableType::UnsignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_BC6H_SFLOAT_BLOCK: return setFormat(hd, CompressedPixelFormat::BC6, VariableType::SignedFloat, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ETC2_RGB, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ETC2_RGB, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ETC2_RGB_A1, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ETC2_RGB_A1, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ETC2_RGBA, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ETC2_RGBA, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_4x4_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_4x4, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_4x4_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_4x4, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_5x4_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_5x4, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_5x4_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_5x4, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_5x5_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_5x5, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_5x5_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_5x5, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_6x5_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_6x5, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_6x5_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_6x5, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_6x6_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_6x6, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_6x6_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_6x6, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_8x5_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_8x5, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_8x5_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_8x5, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_8x6_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_8x6, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_8x6_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_8x6, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_8x8_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_8x8, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_8x8_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_8x8, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_10x5_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_10x5, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_10x5_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_10x5, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_10x6_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_10x6, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_10x6_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_10x6, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_10x8_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_10x8, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_10x8_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_10x8, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_10x10_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_10x10, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_10x10_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_10x10, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_12x10_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_12x10, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_12x10_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_12x10, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_12x12_UNORM_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_12x12, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_ASTC_12x12_SRGB_BLOCK: return setFormat(hd, CompressedPixelFormat::ASTC_12x12, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG: return setFormat(hd, CompressedPixelFormat::PVRTCI_2bpp_RGBA, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG: return setFormat(hd, CompressedPixelFormat::PVRTCI_2bpp_RGBA, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG: return setFormat(hd, CompressedPixelFormat::PVRTCI_4bpp_RGBA, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG: return setFormat(hd, CompressedPixelFormat::PVRTCI_4bpp_RGBA, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG: return setFormat(hd, CompressedPixelFormat::PVRTCII_2bpp, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG: return setFormat(hd, CompressedPixelFormat::PVRTCII_2bpp, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	case VulkanFormats::VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG: return setFormat(hd, CompressedPixelFormat::PVRTCII_4bpp, VariableType::UnsignedByteNorm, ColorSpace::lRGB);
+	case VulkanFormats::VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG: return setFormat(hd, CompressedPixelFormat::PVRTCII_4bpp, VariableType::UnsignedByteNorm, ColorSpace::sRGB);
+	}
+
+	// Return false if format isn't found/valid.
+	return false;
+}
+} // namespace
+
+namespace pvr {
+namespace assetReaders {
+TextureReaderKTX2::TextureReaderKTX2() : _supercompressionScheme(texture_ktx2::SupercompressionScheme::None), _headerRead(false) {}
+TextureReaderKTX2::TextureReaderKTX2(Stream::ptr_type assetStream)
+	: AssetReader<Texture>(std::move(assetStream)), _supercompressionScheme(texture_ktx2::SupercompressionScheme::None), _headerRead(false)
+{}
+
+const TextureHeader& TextureReaderKTX2::readHeader()
+{
+	if (_headerRead)
+	{
+		return _header;
+	}
+	if (!_assetStream.get())
+	{
+		throw InvalidOperationError("[TextureReaderKTX2::readHeader]: Attempted to read without an asset stream");
+	}
+	openAssetStream();
+	if (_assetStream->getSize() < texture_ktx2::c_expectedHeaderSize)
+	{
+		throw InvalidDataError("[TextureReaderKTX2::readHeader]: File stream was shorter than KTX2 header length");
+	}
+
+	texture_ktx2::FileHeader fileHeader;
+	_assetStream->seek(0, Stream::SeekOriginFromStart);
+	_assetStream->readExact(sizeof(fileHeader), 1, &fileHeader);
+
+	// Check that the identifier matches
+	if (memcmp(fileHeader.identifier, texture_ktx2::c_identifier, sizeof(fileHeader.identifier)) != 0)
+	{
+		throw InvalidDataError("[TextureReaderKTX2::readHeader]: Stream did not contain a valid KTX2 file identifier");
+	}
+	if (fileHeader.supercompressionScheme >= static_cast<uint32_t>(texture_ktx2::SupercompressionScheme::Count))
+	{
+		throw UnsupportedOperationError("[TextureReaderKTX2::readHeader]: Unknown supercompression scheme " + std::to_string(fileHeader.supercompressionScheme));
+	}
+	_supercompressionScheme = static_cast<texture_ktx2::SupercompressionScheme>(fileHeader.supercompressionScheme);
+	if (_supercompressionScheme == texture_ktx2::SupercompressionScheme::BasisLZ)
+	{
+		throw UnsupportedOperationError("[TextureReaderKTX2::readHeader]: BasisLZ supercompressed textures must be transcoded, which is not supported");
+	}
+	if (_supercompressionScheme == texture_ktx2::SupercompressionScheme::ZLIB)
+	{
+		throw UnsupportedOperationError("[TextureReaderKTX2::readHeader]: ZLIB supercompressed textures are not supported");
+	}
+	if (!setVulkanFormat(_header, fileHeader.vkFormat))
+	{
+		throw UnsupportedOperationError("[TextureReaderKTX2::readHeader]: Unsupported Vulkan format " + std::to_string(fileHeader.vkFormat));
+	}
+
+	// Validate the counts before anything is allocated from them
+	if (fileHeader.faceCount != 1 && fileHeader.faceCount != 6)
+	{
+		throw InvalidDataError("[TextureReaderKTX2::readHeader]: Face count must be 1 or 6, but was " + std::to_string(fileHeader.faceCount));
+	}
+	if (fileHeader.pixelWidth == 0)
+	{
+		throw InvalidDataError("[TextureReaderKTX2::readHeader]: Width must not be zero");
+	}
+	uint32_t maxNumLevels = 1;
+	for (uint32_t size = std::max(std::max(fileHeader.pixelWidth, fileHeader.pixelHeight), fileHeader.pixelDepth); size > 1; size >>= 1)
+	{
+		++maxNumLevels;
+	}
+	if (fileHeader.levelCount > maxNumLevels)
+	{
+		throw InvalidDataError("[TextureReaderKTX2::readHeader]: Level count " + std::to_string(fileHeader.levelCount) + " is more than the " +
+			std::to_string(maxNumLevels) + " levels of a full MIP chain");
+	}
+
+	// A count of zero means "not an array" (layers), "one dimension fewer" (height, depth) or "generate the MIP chain at
+	// load time" (levels). In every case a single one is stored in the file.
+	const uint32_t numLevels = std::max(fileHeader.levelCount, 1u);
+	if (texture_ktx2::c_expectedHeaderSize + static_cast<uint64_t>(numLevels) * sizeof(texture_ktx2::LevelIndexEntry) > _assetStream->getSize())
+	{
+		throw InvalidDataError("[TextureReaderKTX2::readHeader]: Level index extends past the end of the file");
+	}
+	_header.setWidth(fileHeader.pixelWidth);
+	_header.setHeight(std::max(fileHeader.pixelHeight, 1u));
+	_header.setDepth(std::max(fileHeader.pixelDepth, 1u));
+	_header.setNumArrayMembers(std::max(fileHeader.layerCount, 1u));
+	_header.setNumFaces(fileHeader.faceCount);
+	_header.setNumMipMapLevels(numLevels);
+
+	// The level index immediately follows the header
+	_levelIndex.resize(numLevels);
+	_assetStream->readExact(sizeof(texture_ktx2::LevelIndexEntry), numLevels, _levelIndex.data());
+
+	readDataFormatDescriptor(fileHeader);
+	readKeyValueData(fileHeader);
+
+	// Validate the level index now, so that readMipLevel can trust it
+	const uint64_t fileSize = _assetStream->getSize();
+	for (uint32_t level = 0; level < numLevels; ++level)
+	{
+		const texture_ktx2::LevelIndexEntry& entry = _levelIndex[level];
+		if (entry.byteOffset > fileSize || entry.byteLength > fileSize - entry.byteOffset)
+		{
+			throw InvalidDataError("[TextureReaderKTX2::readHeader]: Level " + std::to_string(level) + " extends past the end of the file");
+		}
+		if (entry.uncompressedByteLength != _header.getDataSize(level, true, true))
+		{
+			throw InvalidDataError("[TextureReaderKTX2::readHeader]: Level " + std::to_string(level) + " size was not the expected size");
+		}
+		if (_supercompressionScheme == texture_ktx2::SupercompressionScheme::None && entry.byteLength != entry.uncompressedByteLength)
+		{
+			throw InvalidDataError("[TextureReaderKTX2::readHeader]: Level " + std::to_string(level) + " size was not the expected size");
+		}
+	}
+	_headerRead = true;
+	return _header;
+}
+
+void TextureReaderKTX2::readDataFormatDescriptor(const texture_ktx2::FileHeader& fileHeader)
+{
+	// Only the first words of the basic descriptor block are needed. They follow the total size of the descriptor.
+	const uint32_t modelWord = 1 + texture_ktx2::c_dfdModelWord;
+	if (fileHeader.dfdByteLength < (modelWord + 1) * sizeof(uint32_t))
+	{
+		return;
+	}
+	uint32_t dfd[modelWord + 1];
+	_assetStream->seek(fileHeader.dfdByteOffset, Stream::SeekOriginFromStart);
+	_assetStream->readExact(sizeof(uint32_t), modelWord + 1, dfd);
+
+	const uint32_t colorModel = dfd[modelWord] & 0xFF;
+	const uint32_t transferFunction = (dfd[modelWord] >> 16) & 0xFF;
+	const uint32_t flags = (dfd[modelWord] >> 24) & 0xFF;
+	if (colorModel == texture_ktx2::c_dfdColorModelETC1S || colorModel == texture_ktx2::c_dfdColorModelUASTC)
+	{
+		throw UnsupportedOperationError("[TextureReaderKTX2::readHeader]: Basis Universal textures must be transcoded, which is not supported");
+	}
+	if (transferFunction == texture_ktx2::c_dfdTransferSRGB)
+	{
+		_header.setColorSpace(ColorSpace::sRGB);
+	}
+	_header.setIsPreMultiplied((flags & texture_ktx2::c_dfdFlagAlphaPremultiplied) != 0);
+}
+
+void TextureReaderKTX2::readKeyValueData(const texture_ktx2::FileHeader& fileHeader)
+{
+	if (fileHeader.kvdByteLength == 0)
+	{
+		return;
+	}
+	std::vector<uint8_t> keyValueData(fileHeader.kvdByteLength);
+	_assetStream->seek(fileHeader.kvdByteOffset, Stream::SeekOriginFromStart);
+	_assetStream->readExact(1, keyValueData.size(), keyValueData.data());
+
+	uint32_t position = 0;
+	while (position + sizeof(uint32_t) <= keyValueData.size())
+	{
+		uint32_t keyAndValueSize;
+		memcpy(&keyAndValueSize, keyValueData.data() + position, sizeof(keyAndValueSize));
+		position += sizeof(keyAndValueSize);
+		if (keyAndValueSize > keyValueData.size() - position)
+		{
+			throw InvalidDataError("[TextureReaderKTX2::readHeader]: Stream metadata were invalid");
+		}
+		const char* key = reinterpret_cast<const char*>(keyValueData.data() + position);
+		const size_t keyLength = strnlen(key, keyAndValueSize);
+
+		// Search for KTX orientation. This is the only meta data currently supported
+		if (keyLength < keyAndValueSize && strcmp(key, texture_ktx2::c_orientationMetaDataKey) == 0)
+		{
+			std::string orientationString(key + keyLength + 1, keyAndValueSize - keyLength - 1);
+			uint32_t orientation = 0;
+			if (orientationString.size() > 1 && orientationString[1] == 'u')
+			{
+				orientation |= TextureMetaData::AxisOrientationUp;
+			}
+			if (orientationString.size() > 0 && orientationString[0] == 'l')
+			{
+				orientation |= TextureMetaData::AxisOrientationLeft;
+			}
+			if (orientationString.size() > 2 && orientationString[2] == 'o')
+			{
+				orientation |= TextureMetaData::AxisOrientationOut;
+			}
+			_header.setOrientation(static_cast<TextureMetaData::AxisOrientation>(orientation));
+		}
+		// Entries are padded to 4 bytes
+		position += (keyAndValueSize + 3) & ~3u;
+	}
+}
+
+void TextureReaderKTX2::readMipLevel(uint32_t mipMapLevel, Texture& texture)
+{
+	readHeader();
+	if (mipMapLevel >= _levelIndex.size())
+	{
+		throw InvalidArgumentError("mipMapLevel", "[TextureReaderKTX2::readMipLevel]: Specified mipmap level did not exist");
+	}
+	const texture_ktx2::LevelIndexEntry& entry = _levelIndex[mipMapLevel];
+	if (texture.getDataSize(mipMapLevel, true, true) != entry.uncompressedByteLength)
+	{
+		throw InvalidArgumentError("texture", "[TextureReaderKTX2::readMipLevel]: Texture does not match the header of the file");
+	}
+	// Levels, array members, faces and depth slices are laid out exactly like a Texture, with no padding: one read per level.
+	uint8_t* destination = texture.getDataPointer(mipMapLevel);
+	_assetStream->seek(static_cast<long>(entry.byteOffset), Stream::SeekOriginFromStart);
+	if (_supercompressionScheme == texture_ktx2::SupercompressionScheme::None)
+	{
+		_assetStream->readExact(1, static_cast<size_t>(entry.byteLength), destination);
+		return;
+	}
+
+	// Zstandard: the only other scheme that readHeader accepts
+	std::vector<uint8_t> compressed(static_cast<size_t>(entry.byteLength));
+	_assetStream->readExact(1, compressed.size(), compressed.data());
+	const size_t decompressedSize = zstd::decompress(compressed.data(), compressed.size(), destination, static_cast<size_t>(entry.uncompressedByteLength));
+	if (decompressedSize != entry.uncompressedByteLength)
+	{
+		throw InvalidDataError("[TextureReaderKTX2::readMipLevel]: Decompressed level is smaller than its uncompressed size in the level index");
+	}
+}
+
+void TextureReaderKTX2::readAsset_(Texture& asset)
+{
+	asset = Texture(readHeader(), NULL);
+
+	// Levels are stored smallest first: read them in file order.
+	for (uint32_t mipMapLevel = asset.getNumMipMapLevels(); mipMapLevel-- > 0;)
+	{
+		readMipLevel(mipMapLevel, asset);
+	}
+}
+
+bool TextureReaderKTX2::isSupportedFile(Stream& assetStream)
+{
+	// Try to open the stream
+	assetStream.open();
+
+	size_t dataRead;
+	// Read the magic identifier
+	char magic[12];
+	assetStream.read(1, sizeof(magic), &magic, dataRead);
+	assetStream.close();
+
+	// Make sure it read ok, if not it's probably not a usable stream.
+	if (dataRead != sizeof(magic))
+	{
+		return false;
+	}
+	// Check that the identifier matches
+	return memcmp(magic, texture_ktx2::c_identifier, sizeof(magic)) == 0;
+}
+
+} // namespace assetReaders
+} // namespace pvr
+//!\endcond
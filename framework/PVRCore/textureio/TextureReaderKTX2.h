@@ -0,0 +1,51 @@
+/*!
+\brief A KTX2 texture reader.
+\file PVRCore/textureio/TextureReaderKTX2.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+
+#pragma once
+#include "PVRCore/texture/Texture.h"
+#include "PVRCore/stream/AssetReader.h"
+#include "PVRCore/textureio/FileDefinesKTX2.h"
+
+//!\cond NO_DOXYGEN
+namespace pvr {
+namespace assetReaders {
+/// <summary>KTX2 Texture reader. Uses the level index of the file to read each MIP level with a single read, in any
+/// order, so that a texture can be streamed in one level at a time (e.g. smallest levels first). Zstandard
+/// supercompressed levels are inflated as they are read. ZLIB supercompression and formats that need transcoding
+/// (BasisLZ/ETC1S, UASTC) are not supported.</summary>
+class TextureReaderKTX2 : public AssetReader<Texture>
+{
+public:
+	TextureReaderKTX2();
+	TextureReaderKTX2(Stream::ptr_type assetStream);
+
+	virtual bool isSupportedFile(Stream& assetStream);
+
+	/// <summary>Read the header, data format descriptor, metadata and level index of the file. Does not read any
+	/// texture data. Called automatically by readMipLevel if needed.</summary>
+	/// <returns>The header of the texture. Construct a Texture from it to allocate room for readMipLevel.</returns>
+	const TextureHeader& readHeader();
+
+	/// <summary>Read (and, if needed, decompress) a single MIP level, for all array members and faces, directly into
+	/// its place in the texture.</summary>
+	/// <param name="mipMapLevel">The MIP level to read</param>
+	/// <param name="texture">A texture created from the header returned by readHeader</param>
+	void readMipLevel(uint32_t mipMapLevel, Texture& texture);
+
+private:
+	virtual void readAsset_(Texture& asset);
+	void readDataFormatDescriptor(const texture_ktx2::FileHeader& fileHeader);
+	void readKeyValueData(const texture_ktx2::FileHeader& fileHeader);
+	TextureHeader _header;
+	std::vector<texture_ktx2::LevelIndexEntry> _levelIndex;
+	texture_ktx2::SupercompressionScheme _supercompressionScheme;
+	bool _headerRead;
+};
+} // namespace assetReaders
+
+} // namespace pvr
+//!\endcond
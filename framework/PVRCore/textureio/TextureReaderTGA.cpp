@@ -10,6 +10,7 @@
 
 #include "PVRCore/textureio/TextureReaderTGA.h"
 #include "PVRCore/textureio/PaletteExpander.h"
+#include "PVRCore/textureio/StreamChunkReader.h"
 #include <algorithm>
 using std::vector;
 namespace pvr {
@@ -227,6 +228,25 @@ void TextureReaderTGA::loadImageFromFile(Texture& asset)
 	_texturesToLoad = false;
 }
 
+namespace {
+// Number of indices decoded per batch from the chunked reader.
+const uint32_t IndexBatchSize = 16 * 1024;
+
+// Writes bytesPerDataEntry bytes from value count times, doubling the written region on every copy.
+void fillRepeated(unsigned char* outputPixel, const uint8_t* value, uint32_t bytesPerDataEntry, uint32_t count)
+{
+	memcpy(outputPixel, value, bytesPerDataEntry);
+	size_t filled = bytesPerDataEntry;
+	const size_t total = static_cast<size_t>(count) * bytesPerDataEntry;
+	while (filled < total)
+	{
+		size_t toCopy = std::min(filled, total - filled);
+		memcpy(outputPixel + filled, outputPixel, toCopy);
+		filled += toCopy;
+	}
+}
+} // namespace
+
 void TextureReaderTGA::loadIndexed(Texture& asset, uint32_t bytesPerPaletteEntry, uint32_t bytesPerDataEntry)
 {
 	// Check that a palette is present.
@@ -253,68 +273,55 @@ void TextureReaderTGA::loadIndexed(Texture& asset, uint32_t bytesPerPaletteEntry
 	// Create the palette helper class
 	PaletteExpander paletteLookup(paletteData.data(), paletteSize, bytesPerPaletteEntry);
 
-	// Start reading data
+	// Expand the indices in large batches straight out of the chunked reader
+	StreamChunkReader reader(*_assetStream);
 	unsigned char* outputPixel = asset.getDataPointer();
-	uint32_t currentIndex = 0;
-	for (uint32_t texturePosition = 0; texturePosition < (asset.getTextureSize()); ++texturePosition)
+	uint32_t remainingPixels = asset.getTextureSize();
+	while (remainingPixels)
 	{
-		// Read the index
-		_assetStream->readExact(bytesPerDataEntry, 1, &currentIndex);
-		// Get the color output
-		paletteLookup.getColorFromIndex(currentIndex, outputPixel);
-
-		// Increment the pixel
-		outputPixel += bytesPerPaletteEntry;
+		uint32_t batchSize = std::min(remainingPixels, IndexBatchSize);
+		paletteLookup.expandIndices(reader.acquire(batchSize * bytesPerDataEntry), bytesPerDataEntry, batchSize, outputPixel);
+		outputPixel += batchSize * bytesPerPaletteEntry;
+		remainingPixels -= batchSize;
 	}
+	reader.release();
 }
 
 void TextureReaderTGA::loadRunLength(Texture& asset, uint32_t bytesPerDataEntry)
 {
-	// Buffer for any repeated values come across
-	vector<char> repeatedValue;
-	repeatedValue.resize(bytesPerDataEntry);
+	StreamChunkReader reader(*_assetStream);
 
 	// Read the run length encoded data, and decode it.
 	unsigned char* outputPixel = asset.getDataPointer();
-	while (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
+	uint32_t remainingPixels = static_cast<uint32_t>(asset.getDataSize() / bytesPerDataEntry);
+	while (remainingPixels)
 	{
 		// Read the leading character for this block
-		int8_t leadingCharacter;
-		_assetStream->readExact(1, 1, &leadingCharacter);
+		int8_t leadingCharacter = static_cast<int8_t>(reader.readByte());
+		// Character -128 is a "no op", so there's nothing to do for it. It's used as padding basically.
+		if (leadingCharacter == -128)
+		{
+			continue;
+		}
+
+		// Runs that overflow the texture are truncated.
+		uint32_t runLength = std::min(static_cast<uint32_t>(1 + (leadingCharacter & 0x7f)), remainingPixels);
+
 		// Check if it's a run of differing values or a run of the same value multiple times
 		if (leadingCharacter >= 0)
 		{
-			// Read each value in turn
-			for (int runIndex = 0; runIndex < (1 + (leadingCharacter & 0x7f)); ++runIndex)
-			{
-				if (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
-				{
-					// Read in the value
-					_assetStream->readExact(bytesPerDataEntry, 1, outputPixel);
-					// Increment the output location
-					outputPixel += bytesPerDataEntry;
-				}
-			}
+			// Copy the values across in one go
+			reader.read(runLength * bytesPerDataEntry, outputPixel);
 		}
-		else if (leadingCharacter > -128)
+		else
 		{
-			// Read a repeated value
-			_assetStream->readExact(bytesPerDataEntry, 1, repeatedValue.data());
 			// Write the repeated value the appropriate number of times
-			for (int runIndex = 0; runIndex < (1 + (leadingCharacter & 0x7f)); ++runIndex)
-			{
-				if (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
-				{
-					// Copy the data across
-					memcpy(outputPixel, repeatedValue.data(), bytesPerDataEntry);
-
-					// Increment the output location
-					outputPixel += bytesPerDataEntry;
-				}
-			}
+			fillRepeated(outputPixel, reader.acquire(bytesPerDataEntry), bytesPerDataEntry, runLength);
 		}
-		// Character -128 is a "no op", so there's nothing to do for it. It's used as padding basically.
+		outputPixel += runLength * bytesPerDataEntry;
+		remainingPixels -= runLength;
 	}
+	reader.release();
 }
 
 void TextureReaderTGA::loadRunLengthIndexed(Texture& asset, uint32_t bytesPerPaletteEntry, uint32_t bytesPerDataEntry)
@@ -341,53 +348,46 @@ void TextureReaderTGA::loadRunLengthIndexed(Texture& asset, uint32_t bytesPerPal
 	// Create the palette helper class
 	PaletteExpander paletteLookup(paletteData.data(), paletteSize, bytesPerPaletteEntry);
 
-	// Index value into the palette
-	uint32_t currentIndex = 0;
+	StreamChunkReader reader(*_assetStream);
 
 	// Read the run length encoded data, and decode it.
 	uint8_t* outputPixel = asset.getDataPointer();
-	while (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
+	uint32_t remainingPixels = static_cast<uint32_t>(asset.getDataSize() / bytesPerPaletteEntry);
+	while (remainingPixels)
 	{
 		// Read the leading character for this block
-		int8_t leadingCharacter;
-		_assetStream->readExact(1, 1, &leadingCharacter);
+		int8_t leadingCharacter = static_cast<int8_t>(reader.readByte());
+		// Character -128 is a "no op", so there's nothing to do for it. It's used as padding basically.
+		if (leadingCharacter == -128)
+		{
+			continue;
+		}
+
+		// Runs that overflow the texture are truncated.
+		uint32_t runLength = std::min(static_cast<uint32_t>(1 + (leadingCharacter & 0x7f)), remainingPixels);
+
 		// Check if it's a run of differing values or a run of the same value multiple times
 		if (leadingCharacter >= 0)
 		{
-			// Read each index value in turn
-			for (int runIndex = 0; runIndex < (1 + (leadingCharacter & 0x7f)); ++runIndex)
-			{
-				if (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
-				{
-					// Read in the value
-					_assetStream->readExact(bytesPerDataEntry, 1, &currentIndex);
-					// Get the color output
-					paletteLookup.getColorFromIndex(currentIndex, outputPixel);
-
-					// Increment the output location
-					outputPixel += bytesPerDataEntry;
-				}
-			}
+			// Expand the whole packet of indices
+			paletteLookup.expandIndices(reader.acquire(runLength * bytesPerDataEntry), bytesPerDataEntry, runLength, outputPixel);
 		}
-		else if (leadingCharacter > -128)
+		else
 		{
-			// Read in the repeated value
-			_assetStream->readExact(bytesPerDataEntry, 1, &currentIndex);
-			// Write the repeated value the appropriate number of times
-			for (int runIndex = 0; runIndex < (1 + (leadingCharacter & 0x7f)); ++runIndex)
+			// Read in the repeated index
+			const uint8_t* indexData = reader.acquire(bytesPerDataEntry);
+			uint32_t currentIndex = indexData[0];
+			if (bytesPerDataEntry > 1)
 			{
-				if (outputPixel < (asset.getDataPointer() + asset.getDataSize()))
-				{
-					// Get the color output
-					paletteLookup.getColorFromIndex(currentIndex, outputPixel);
-
-					// Increment the output location
-					outputPixel += bytesPerDataEntry;
-				}
+				currentIndex |= indexData[1] << 8;
 			}
+			// Write the repeated color the appropriate number of times
+			paletteLookup.fillColorFromIndex(currentIndex, runLength, outputPixel);
 		}
-		// Character -128 is a "no op", so there's nothing to do for it. It's used as padding basically.
+		outputPixel += runLength * bytesPerPaletteEntry;
+		remainingPixels -= runLength;
 	}
+	reader.release();
 }
 
 } // namespace assetReaders
@@ -0,0 +1,936 @@
+/*!
+\brief Implementation of the Zstandard decoder used by the KTX2 texture reader.
+\file PVRCore/textureio/ZstdDecoder.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/textureio/ZstdDecoder.h"
+#include "PVRCore/Errors.h"
+#include <cstring>
+#include <vector>
+
+// The format is described in RFC 8878 ("Zstandard Compression and the 'application/zstd' Media Type"), which the
+// section numbers below refer to.
+namespace pvr {
+namespace zstd {
+namespace {
+const uint32_t FrameMagic = 0xFD2FB528;
+const uint32_t SkippableFrameMagic = 0x184D2A50; // The low 4 bits may take any value
+const uint32_t MaxBlockSize = 128 * 1024;
+const uint32_t MaxHuffmanBits = 11;
+const uint32_t MaxFseAccuracyLog = 9;
+
+void corrupted(const char* message)
+{
+	throw InvalidDataError(std::string("[zstd::decompress]: ") + message);
+}
+
+void require(bool condition, const char* message)
+{
+	if (!condition)
+	{
+		corrupted(message);
+	}
+}
+
+uint32_t highestBit(uint32_t value)
+{
+	uint32_t bit = 0;
+	while (value >>= 1)
+	{
+		++bit;
+	}
+	return bit;
+}
+
+uint64_t readLittleEndian(const uint8_t* data, uint32_t numBytes)
+{
+	uint64_t value = 0;
+	for (uint32_t i = 0; i < numBytes; ++i)
+	{
+		value |= static_cast<uint64_t>(data[i]) << (8 * i);
+	}
+	return value;
+}
+
+// Loads up to 8 bytes from data + offset, without reading past size. Missing bytes read as zero.
+uint64_t loadBits(const uint8_t* data, size_t size, size_t offset)
+{
+	uint64_t value = 0;
+	if (offset + sizeof(value) <= size)
+	{
+		memcpy(&value, data + offset, sizeof(value));
+	}
+	else
+	{
+		value = readLittleEndian(data + offset, static_cast<uint32_t>(size - offset));
+	}
+	return value;
+}
+
+// Reads the bits of an FSE table description, lowest bit first (4.1.1).
+class ForwardBitReader
+{
+public:
+	ForwardBitReader(const uint8_t* data, size_t size) : _data(data), _size(size), _position(0) {}
+
+	uint32_t read(uint32_t numBits)
+	{
+		const size_t offset = _position >> 3;
+		const uint64_t bits = offset < _size ? loadBits(_data, _size, offset) : 0;
+		_position += numBits;
+		return static_cast<uint32_t>((bits >> (_position - numBits - offset * 8)) & ((1ull << numBits) - 1));
+	}
+
+	void rewind(uint32_t numBits)
+	{
+		_position -= numBits;
+	}
+
+	size_t bytesConsumed() const
+	{
+		require((_position + 7) / 8 <= _size, "FSE table description is truncated");
+		return (_position + 7) / 8;
+	}
+
+private:
+	const uint8_t* _data;
+	size_t _size;
+	size_t _position;
+};
+
+// Reads a bitstream backwards, from its last bit to its first, as the entropy coded streams are written (4.1, 4.2).
+// Reading past the beginning of the stream produces zeros and makes bitsLeft negative.
+class BackwardBitReader
+{
+public:
+	BackwardBitReader(const uint8_t* data, size_t size) : _data(data), _size(size)
+	{
+		// The highest set bit of the last byte marks the end of the stream
+		require(size && data[size - 1], "Bitstream does not have an end mark");
+		_bitsLeft = static_cast<int64_t>(8 * (size - 1) + highestBit(data[size - 1]));
+	}
+
+	uint32_t peek(uint32_t numBits) const
+	{
+		const int64_t low = _bitsLeft - numBits;
+		if (low >= 0)
+		{
+			return static_cast<uint32_t>((loadBits(_data, _size, static_cast<size_t>(low >> 3)) >> (low & 7)) & ((1ull << numBits) - 1));
+		}
+		if (_bitsLeft <= 0)
+		{
+			return 0;
+		}
+		return static_cast<uint32_t>((loadBits(_data, _size, 0) & ((1ull << _bitsLeft) - 1)) << -low);
+	}
+
+	void consume(uint32_t numBits)
+	{
+		_bitsLeft -= numBits;
+	}
+
+	uint32_t read(uint32_t numBits)
+	{
+		const uint32_t value = peek(numBits);
+		consume(numBits);
+		return value;
+	}
+
+	int64_t bitsLeft() const
+	{
+		return _bitsLeft;
+	}
+
+private:
+	const uint8_t* _data;
+	size_t _size;
+	int64_t _bitsLeft;
+};
+
+// A decoding table of Finite State Entropy (4.1)
+class FseTable
+{
+public:
+	struct Entry
+	{
+		uint8_t symbol;
+		uint8_t numBits;
+		uint16_t baseline;
+	};
+
+	// Builds the table from the normalized probabilities of the symbols, -1 standing for "less than 1" (4.1.1).
+	void build(const int16_t* probabilities, uint32_t numSymbols, uint32_t accuracyLog)
+	{
+		_accuracyLog = accuracyLog;
+		const uint32_t tableSize = 1u << accuracyLog;
+		uint16_t symbolNext[256];
+
+		// Symbols with a "less than 1" probability take a single cell each, at the end of the table
+		uint32_t highThreshold = tableSize;
+		for (uint32_t symbol = 0; symbol < numSymbols; ++symbol)
+		{
+			if (probabilities[symbol] == -1)
+			{
+				_entries[--highThreshold].symbol = static_cast<uint8_t>(symbol);
+				symbolNext[symbol] = 1;
+			}
+		}
+		// The others are spread over the rest of the table
+		const uint32_t step = (tableSize >> 1) + (tableSize >> 3) + 3;
+		uint32_t position = 0;
+		for (uint32_t symbol = 0; symbol < numSymbols; ++symbol)
+		{
+			if (probabilities[symbol] <= 0)
+			{
+				continue;
+			}
+			symbolNext[symbol] = static_cast<uint16_t>(probabilities[symbol]);
+			for (int16_t i = 0; i < probabilities[symbol]; ++i)
+			{
+				_entries[position].symbol = static_cast<uint8_t>(symbol);
+				do
+				{
+					position = (position + step) & (tableSize - 1);
+				} while (position >= highThreshold);
+			}
+		}
+		require(position == 0, "FSE probabilities do not fill the table");
+
+		for (uint32_t state = 0; state < tableSize; ++state)
+		{
+			Entry& entry = _entries[state];
+			const uint32_t next = symbolNext[entry.symbol]++;
+			entry.numBits = static_cast<uint8_t>(accuracyLog - highestBit(next));
+			entry.baseline = static_cast<uint16_t>((next << entry.numBits) - tableSize);
+		}
+	}
+
+	// A table always producing the same symbol, without reading any bits
+	void buildRle(uint8_t symbol)
+	{
+		_accuracyLog = 0;
+		_entries[0].symbol = symbol;
+		_entries[0].numBits = 0;
+		_entries[0].baseline = 0;
+	}
+
+	// Reads a table description (4.1.1) and builds the table. Returns the number of bytes of the description.
+	size_t read(const uint8_t* data, size_t size, uint32_t maxAccuracyLog, uint32_t maxSymbol)
+	{
+		ForwardBitReader bits(data, size);
+		const uint32_t accuracyLog = bits.read(4) + 5;
+		require(accuracyLog <= maxAccuracyLog, "FSE accuracy log is too large");
+
+		int16_t probabilities[256];
+		int32_t remaining = 1 << accuracyLog;
+		uint32_t numSymbols = 0;
+		while (remaining > 0 && numSymbols <= maxSymbol)
+		{
+			// Small values take one bit fewer than large ones
+			const uint32_t numBits = highestBit(remaining + 1) + 1;
+			uint32_t value = bits.read(numBits);
+			const uint32_t lowerMask = (1u << (numBits - 1)) - 1;
+			const uint32_t threshold = (1u << numBits) - 1 - (remaining + 1);
+			if ((value & lowerMask) < threshold)
+			{
+				bits.rewind(1);
+				value &= lowerMask;
+			}
+			else if (value > lowerMask)
+			{
+				value -= threshold;
+			}
+			const int16_t probability = static_cast<int16_t>(value) - 1;
+			remaining -= probability < 0 ? -probability : probability;
+			probabilities[numSymbols++] = probability;
+			if (probability == 0)
+			{
+				// Followed by the number of further symbols with a zero probability, 2 bits at a time
+				uint32_t repeat;
+				do
+				{
+					repeat = bits.read(2);
+					for (uint32_t i = 0; i < repeat && numSymbols <= maxSymbol; ++i)
+					{
+						probabilities[numSymbols++] = 0;
+					}
+				} while (repeat == 3);
+			}
+		}
+		require(remaining == 0, "FSE probabilities do not add up");
+		build(probabilities, numSymbols, accuracyLog);
+		return bits.bytesConsumed();
+	}
+
+	uint32_t getAccuracyLog() const
+	{
+		return _accuracyLog;
+	}
+
+	const Entry& getEntry(uint32_t state) const
+	{
+		return _entries[state];
+	}
+
+private:
+	Entry _entries[1 << MaxFseAccuracyLog];
+	uint32_t _accuracyLog;
+};
+
+class FseState
+{
+public:
+	FseState(const FseTable& table, BackwardBitReader& bits) : _table(&table), _state(bits.read(table.getAccuracyLog())) {}
+
+	uint8_t getSymbol() const
+	{
+		return _table->getEntry(_state).symbol;
+	}
+
+	void update(BackwardBitReader& bits)
+	{
+		const FseTable::Entry& entry = _table->getEntry(_state);
+		_state = entry.baseline + bits.read(entry.numBits);
+	}
+
+private:
+	const FseTable* _table;
+	uint32_t _state;
+};
+
+// The default distributions of the sequence codes (3.1.1.3.2.2)
+const int16_t PredefinedLiteralLengths[36] = { 4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1, -1, -1, -1, -1 };
+const int16_t PredefinedMatchLengths[53] = { 1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1 };
+const int16_t PredefinedOffsets[29] = { 1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1 };
+
+// The value and extra bits of each literal length and match length code (3.1.1.3.2.1.1)
+const uint32_t LiteralLengthBaselines[36] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512,
+	1024, 2048, 4096, 8192, 16384, 32768, 65536 };
+const uint8_t LiteralLengthBits[36] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+const uint32_t MatchLengthBaselines[53] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33,
+	34, 35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051, 4099, 8195, 16387, 32771, 65539 };
+const uint8_t MatchLengthBits[53] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 4, 4,
+	5, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+enum SequenceTable
+{
+	LiteralLengths,
+	Offsets,
+	MatchLengths,
+	NumSequenceTables
+};
+
+struct PredefinedTables
+{
+	FseTable tables[NumSequenceTables];
+	PredefinedTables()
+	{
+		tables[LiteralLengths].build(PredefinedLiteralLengths, 36, 6);
+		tables[Offsets].build(PredefinedOffsets, 29, 5);
+		tables[MatchLengths].build(PredefinedMatchLengths, 53, 6);
+	}
+};
+
+const PredefinedTables& getPredefinedTables()
+{
+	static const PredefinedTables tables;
+	return tables;
+}
+
+// A decoding table of Huffman coded literals (4.2)
+class HuffmanTable
+{
+public:
+	// Reads a tree description (4.2.1) and builds the table. Returns the number of bytes of the description.
+	size_t read(const uint8_t* data, size_t size)
+	{
+		require(size > 0, "Huffman tree description is missing");
+		const uint32_t header = data[0];
+		uint8_t weights[260]; // Room for the implied weight, and for the last steps of decodeWeights to overshoot
+		uint32_t numWeights;
+		size_t descriptionSize;
+		if (header < 128)
+		{
+			// The weights are FSE compressed, in header bytes
+			require(header > 0 && header < size, "Huffman tree description is truncated");
+			numWeights = decodeWeights(data + 1, header, weights);
+			descriptionSize = 1 + header;
+		}
+		else
+		{
+			// The weights are stored directly, 4 bits each
+			numWeights = header - 127;
+			descriptionSize = 1 + (numWeights + 1) / 2;
+			require(descriptionSize <= size, "Huffman tree description is truncated");
+			for (uint32_t i = 0; i < numWeights; ++i)
+			{
+				weights[i] = (i & 1) ? (data[1 + i / 2] & 15) : (data[1 + i / 2] >> 4);
+			}
+		}
+		build(weights, numWeights);
+		return descriptionSize;
+	}
+
+	// Decodes one or more streams of literals (4.2.2), each of numSymbols[i] literals. Independent streams are decoded
+	// together, so that the table lookups of one stream overlap with those of the others.
+	void decodeStreams(const uint8_t* const* streams, const size_t* streamSizes, uint8_t* output, const size_t* numSymbols, uint32_t numStreams) const
+	{
+		uint8_t* outputs[4];
+		uint8_t* outputEnds[4];
+		int64_t positions[4];
+		for (uint32_t i = 0; i < numStreams; ++i)
+		{
+			positions[i] = BackwardBitReader(streams[i], streamSizes[i]).bitsLeft();
+			outputs[i] = output;
+			output += numSymbols[i];
+			outputEnds[i] = output;
+		}
+
+		// A 64 bit load has at least 56 bits below the read position: Enough for 5 codes of up to 11 bits.
+		const uint32_t mask = (1u << _maxBits) - 1;
+		for (;;)
+		{
+			bool ready = true;
+			for (uint32_t i = 0; i < numStreams; ++i)
+			{
+				ready = ready && positions[i] >= 64 && outputEnds[i] - outputs[i] >= 5;
+			}
+			if (!ready)
+			{
+				break;
+			}
+			for (uint32_t i = 0; i < numStreams; ++i)
+			{
+				const size_t byteOffset = static_cast<size_t>(positions[i] >> 3) - 7;
+				const uint64_t word = loadBits(streams[i], streamSizes[i], byteOffset);
+				const int64_t wordStart = static_cast<int64_t>(byteOffset * 8) + _maxBits;
+				for (uint32_t j = 0; j < 5; ++j)
+				{
+					const Entry& entry = _entries[(word >> (positions[i] - wordStart)) & mask];
+					*outputs[i]++ = entry.symbol;
+					positions[i] -= entry.numBits;
+				}
+			}
+		}
+
+		// The ends of the streams, one code at a time
+		for (uint32_t i = 0; i < numStreams; ++i)
+		{
+			BackwardBitReader bits(streams[i], streamSizes[i]);
+			bits.consume(static_cast<uint32_t>(bits.bitsLeft() - positions[i]));
+			for (; outputs[i] < outputEnds[i]; ++outputs[i])
+			{
+				const Entry& entry = _entries[bits.peek(_maxBits)];
+				*outputs[i] = entry.symbol;
+				bits.consume(entry.numBits);
+			}
+			require(bits.bitsLeft() == 0, "Huffman stream size does not match its literals");
+		}
+	}
+
+private:
+	struct Entry
+	{
+		uint8_t symbol;
+		uint8_t numBits;
+	};
+
+	// The weights are compressed with FSE, decoded by two interleaved states (4.2.1.2).
+	static uint32_t decodeWeights(const uint8_t* data, size_t size, uint8_t* weights)
+	{
+		FseTable table;
+		const size_t tableSize = table.read(data, size, 6, MaxHuffmanBits);
+		BackwardBitReader bits(data + tableSize, size - tableSize);
+		FseState state1(table, bits);
+		FseState state2(table, bits);
+		uint32_t numWeights = 0;
+		for (;;)
+		{
+			require(numWeights < 255, "Too many Huffman weights");
+			weights[numWeights++] = state1.getSymbol();
+			state1.update(bits);
+			if (bits.bitsLeft() < 0)
+			{
+				weights[numWeights++] = state2.getSymbol();
+				break;
+			}
+			weights[numWeights++] = state2.getSymbol();
+			state2.update(bits);
+			if (bits.bitsLeft() < 0)
+			{
+				weights[numWeights++] = state1.getSymbol();
+				break;
+			}
+		}
+		require(numWeights <= 255, "Too many Huffman weights");
+		return numWeights;
+	}
+
+	void build(uint8_t* weights, uint32_t numWeights)
+	{
+		// The weight of the last symbol is implied: It completes the sum of 2^(weight-1) to a power of two.
+		uint32_t weightSum = 0;
+		for (uint32_t i = 0; i < numWeights; ++i)
+		{
+			require(weights[i] <= MaxHuffmanBits, "Huffman weight is too large");
+			weightSum += weights[i] ? 1u << (weights[i] - 1) : 0;
+		}
+		require(weightSum > 0, "Huffman weights are all zero");
+		_maxBits = highestBit(weightSum) + 1;
+		require(_maxBits <= MaxHuffmanBits, "Huffman codes are too long");
+		const uint32_t leftOver = (1u << _maxBits) - weightSum;
+		require((leftOver & (leftOver - 1)) == 0, "Huffman weights do not add up");
+		weights[numWeights] = static_cast<uint8_t>(highestBit(leftOver) + 1);
+		const uint32_t numSymbols = numWeights + 1;
+
+		// Codes are assigned by increasing weight, then by symbol. A code of n bits fills 2^(maxBits-n) entries.
+		uint32_t position = 0;
+		for (uint32_t weight = 1; weight <= _maxBits; ++weight)
+		{
+			for (uint32_t symbol = 0; symbol < numSymbols; ++symbol)
+			{
+				if (weights[symbol] != weight)
+				{
+					continue;
+				}
+				const Entry entry = { static_cast<uint8_t>(symbol), static_cast<uint8_t>(_maxBits + 1 - weight) };
+				for (uint32_t i = 0; i < (1u << (weight - 1)); ++i)
+				{
+					_entries[position++] = entry;
+				}
+			}
+		}
+	}
+
+	Entry _entries[1 << MaxHuffmanBits];
+	uint32_t _maxBits;
+};
+
+// What a block may reuse from the previous blocks of the frame
+struct FrameState
+{
+	HuffmanTable huffmanTable;
+	bool hasHuffmanTable;
+	FseTable sequenceTables[NumSequenceTables];
+	const FseTable* currentSequenceTables[NumSequenceTables];
+	uint32_t repeatOffsets[3];
+	std::vector<uint8_t> literals;
+
+	FrameState() : literals(MaxBlockSize) {}
+
+	void reset()
+	{
+		hasHuffmanTable = false;
+		for (uint32_t i = 0; i < NumSequenceTables; ++i)
+		{
+			currentSequenceTables[i] = nullptr;
+		}
+		repeatOffsets[0] = 1;
+		repeatOffsets[1] = 4;
+		repeatOffsets[2] = 8;
+	}
+};
+
+// Reads the literals section of a block (3.1.1.3.1). Returns the number of bytes of the section.
+size_t readLiterals(const uint8_t* data, size_t size, FrameState& state, const uint8_t*& literals, size_t& numLiterals)
+{
+	require(size > 0, "Literals section is missing");
+	const uint32_t type = data[0] & 3;
+	const uint32_t sizeFormat = (data[0] >> 2) & 3;
+	if (type < 2)
+	{
+		// Raw or RLE literals
+		const uint32_t headerSize = sizeFormat == 1 ? 2 : sizeFormat == 3 ? 3 : 1;
+		require(headerSize <= size, "Literals section is truncated");
+		const uint64_t header = readLittleEndian(data, headerSize);
+		numLiterals = static_cast<size_t>(header >> (headerSize == 1 ? 3 : 4));
+		require(numLiterals <= MaxBlockSize, "Too many literals");
+		if (type == 0)
+		{
+			require(headerSize + numLiterals <= size, "Literals section is truncated");
+			literals = data + headerSize;
+			return headerSize + numLiterals;
+		}
+		require(headerSize < size, "Literals section is truncated");
+		memset(state.literals.data(), data[headerSize], numLiterals);
+		literals = state.literals.data();
+		return headerSize + 1;
+	}
+
+	// Huffman coded literals, with a new tree or with the tree of the previous block
+	const uint32_t headerSize = sizeFormat < 2 ? 3 : sizeFormat + 2;
+	const uint32_t sizeBits = sizeFormat < 2 ? 10 : sizeFormat == 2 ? 14 : 18;
+	require(headerSize <= size, "Literals section is truncated");
+	const uint64_t header = readLittleEndian(data, headerSize);
+	numLiterals = static_cast<size_t>((header >> 4) & ((1u << sizeBits) - 1));
+	size_t compressedSize = static_cast<size_t>((header >> (4 + sizeBits)) & ((1u << sizeBits) - 1));
+	require(numLiterals <= MaxBlockSize, "Too many literals");
+	require(headerSize + compressedSize <= size, "Literals section is truncated");
+	const uint8_t* compressed = data + headerSize;
+	if (type == 2)
+	{
+		const size_t treeSize = state.huffmanTable.read(compressed, compressedSize);
+		require(treeSize <= compressedSize, "Huffman tree description is truncated");
+		compressed += treeSize;
+		compressedSize -= treeSize;
+		state.hasHuffmanTable = true;
+	}
+	else
+	{
+		require(state.hasHuffmanTable, "Literals reuse a Huffman tree, but no previous block had one");
+	}
+
+	uint8_t* output = state.literals.data();
+	if (sizeFormat == 0)
+	{
+		state.huffmanTable.decodeStreams(&compressed, &compressedSize, output, &numLiterals, 1);
+	}
+	else
+	{
+		// Four streams, each of a quarter of the literals, after a jump table of the sizes of the first three
+		require(compressedSize >= 6, "Literals jump table is truncated");
+		size_t streamSizes[4];
+		size_t totalSize = 6;
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			streamSizes[i] = static_cast<size_t>(readLittleEndian(compressed + 2 * i, 2));
+			totalSize += streamSizes[i];
+		}
+		require(totalSize <= compressedSize, "Literals streams are truncated");
+		streamSizes[3] = compressedSize - totalSize;
+		const size_t segmentSize = (numLiterals + 3) / 4;
+		require(3 * segmentSize <= numLiterals, "Too few literals for four streams");
+		const uint8_t* streams[4] = { compressed + 6 };
+		size_t numSymbols[4] = { segmentSize, segmentSize, segmentSize, numLiterals - 3 * segmentSize };
+		for (uint32_t i = 1; i < 4; ++i)
+		{
+			streams[i] = streams[i - 1] + streamSizes[i - 1];
+		}
+		state.huffmanTable.decodeStreams(streams, streamSizes, output, numSymbols, 4);
+	}
+	literals = output;
+	return static_cast<size_t>(compressed + compressedSize - data);
+}
+
+// Selects the table of one of the sequence codes, reading its description if there is one (3.1.1.3.2.1). Returns the
+// number of bytes read.
+size_t readSequenceTable(FrameState& state, SequenceTable table, uint32_t mode, const uint8_t* data, size_t size, uint32_t maxAccuracyLog, uint32_t maxSymbol)
+{
+	switch (mode)
+	{
+	case 0: // Predefined
+		state.currentSequenceTables[table] = &getPredefinedTables().tables[table];
+		return 0;
+	case 1: // RLE
+		require(size > 0 && data[0] <= maxSymbol, "Invalid RLE sequence code");
+		state.sequenceTables[table].buildRle(data[0]);
+		state.currentSequenceTables[table] = &state.sequenceTables[table];
+		return 1;
+	case 2: // FSE compressed
+	{
+		const size_t tableSize = state.sequenceTables[table].read(data, size, maxAccuracyLog, maxSymbol);
+		state.currentSequenceTables[table] = &state.sequenceTables[table];
+		return tableSize;
+	}
+	default: // Repeat the table of the previous block
+		require(state.currentSequenceTables[table] != nullptr, "Sequences reuse a table, but no previous block had one");
+		return 0;
+	}
+}
+
+// Copies length bytes from offset bytes back. The source may overlap the destination.
+void copyMatch(uint8_t* output, uint8_t* outputEnd, size_t offset, size_t length)
+{
+	const uint8_t* match = output - offset;
+	if (offset >= 8 && length + 8 <= static_cast<size_t>(outputEnd - output))
+	{
+		// Copy 8 bytes at a time, possibly past the end of the match: Those bytes are overwritten later.
+		for (size_t i = 0; i < length; i += 8)
+		{
+			memcpy(output + i, match + i, 8);
+		}
+		return;
+	}
+	if (offset >= length)
+	{
+		memcpy(output, match, length);
+		return;
+	}
+	for (size_t i = 0; i < length; ++i)
+	{
+		output[i] = match[i];
+	}
+}
+
+// Decodes the sequences section of a block (3.1.1.3.2) and executes the sequences (3.1.1.4).
+void decodeSequences(const uint8_t* data, size_t size, FrameState& state, const uint8_t* literals, size_t numLiterals, uint8_t*& output,
+	uint8_t* outputEnd, const uint8_t* frameStart)
+{
+	const uint8_t* literalsEnd = literals + numLiterals;
+	require(size > 0, "Sequences section is missing");
+	uint32_t numSequences = data[0];
+	size_t position = 1;
+	if (numSequences >= 128)
+	{
+		if (numSequences < 255)
+		{
+			require(size >= 2, "Sequences section is truncated");
+			numSequences = ((numSequences - 128) << 8) + data[1];
+			position = 2;
+		}
+		else
+		{
+			require(size >= 3, "Sequences section is truncated");
+			numSequences = data[1] + (data[2] << 8) + 0x7F00;
+			position = 3;
+		}
+	}
+
+	if (numSequences)
+	{
+		require(position < size, "Sequences section is truncated");
+		const uint32_t modes = data[position++];
+		require((modes & 3) == 0, "Reserved sequence compression mode bits are set");
+		position += readSequenceTable(state, LiteralLengths, modes >> 6, data + position, size - position, 9, 35);
+		require(position <= size, "Sequences section is truncated");
+		position += readSequenceTable(state, Offsets, (modes >> 4) & 3, data + position, size - position, 8, 31);
+		require(position <= size, "Sequences section is truncated");
+		position += readSequenceTable(state, MatchLengths, (modes >> 2) & 3, data + position, size - position, 9, 52);
+		require(position <= size, "Sequences section is truncated");
+
+		BackwardBitReader bits(data + position, size - position);
+		FseState literalLengthState(*state.currentSequenceTables[LiteralLengths], bits);
+		FseState offsetState(*state.currentSequenceTables[Offsets], bits);
+		FseState matchLengthState(*state.currentSequenceTables[MatchLengths], bits);
+		uint32_t* repeatOffsets = state.repeatOffsets;
+		for (uint32_t sequence = 0; sequence < numSequences; ++sequence)
+		{
+			const uint32_t offsetCode = offsetState.getSymbol();
+			const uint32_t matchLengthCode = matchLengthState.getSymbol();
+			const uint32_t literalLengthCode = literalLengthState.getSymbol();
+			const uint32_t offsetValue = (1u << offsetCode) + bits.read(offsetCode);
+			const size_t matchLength = MatchLengthBaselines[matchLengthCode] + bits.read(MatchLengthBits[matchLengthCode]);
+			const size_t literalLength = LiteralLengthBaselines[literalLengthCode] + bits.read(LiteralLengthBits[literalLengthCode]);
+			if (sequence + 1 < numSequences)
+			{
+				literalLengthState.update(bits);
+				matchLengthState.update(bits);
+				offsetState.update(bits);
+			}
+
+			// Offset values 1 to 3 refer to the recent offsets (3.1.2.5)
+			uint32_t offset;
+			if (offsetValue > 3)
+			{
+				offset = offsetValue - 3;
+				repeatOffsets[2] = repeatOffsets[1];
+				repeatOffsets[1] = repeatOffsets[0];
+				repeatOffsets[0] = offset;
+			}
+			else
+			{
+				const uint32_t index = offsetValue - (literalLength ? 1 : 0);
+				offset = index == 0 ? repeatOffsets[0] : index == 3 ? repeatOffsets[0] - 1 : repeatOffsets[index];
+				if (index > 0)
+				{
+					if (index > 1)
+					{
+						repeatOffsets[2] = repeatOffsets[1];
+					}
+					repeatOffsets[1] = repeatOffsets[0];
+					repeatOffsets[0] = offset;
+				}
+			}
+
+			require(literalLength <= static_cast<size_t>(literalsEnd - literals), "Sequence uses more literals than the block has");
+			require(literalLength + matchLength <= static_cast<size_t>(outputEnd - output), "Decompressed data does not fit in the destination");
+			memcpy(output, literals, literalLength);
+			output += literalLength;
+			literals += literalLength;
+			require(offset > 0 && offset <= static_cast<size_t>(output - frameStart), "Match offset is out of range");
+			copyMatch(output, outputEnd, offset, matchLength);
+			output += matchLength;
+		}
+		require(bits.bitsLeft() == 0, "Sequences bitstream size does not match its sequences");
+	}
+
+	// The literals left over after the last sequence
+	const size_t lastLiterals = static_cast<size_t>(literalsEnd - literals);
+	require(lastLiterals <= static_cast<size_t>(outputEnd - output), "Decompressed data does not fit in the destination");
+	memcpy(output, literals, lastLiterals);
+	output += lastLiterals;
+}
+
+// XXH64 with a seed of zero, of which the content checksum of a frame keeps the low 32 bits (3.1.1)
+uint64_t rotateLeft(uint64_t value, uint32_t bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+const uint64_t Prime64_1 = 11400714785074694791ull;
+const uint64_t Prime64_2 = 14029467366897019727ull;
+const uint64_t Prime64_3 = 1609587929392839161ull;
+const uint64_t Prime64_4 = 9650029242287828579ull;
+const uint64_t Prime64_5 = 2870177450012600261ull;
+
+uint64_t xxh64Round(uint64_t accumulator, uint64_t lane)
+{
+	return rotateLeft(accumulator + lane * Prime64_2, 31) * Prime64_1;
+}
+
+uint64_t xxh64(const uint8_t* data, size_t size)
+{
+	const uint8_t* end = data + size;
+	uint64_t hash;
+	if (size >= 32)
+	{
+		uint64_t accumulators[4] = { Prime64_1 + Prime64_2, Prime64_2, 0, 0 - Prime64_1 };
+		for (; end - data >= 32; data += 32)
+		{
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				accumulators[i] = xxh64Round(accumulators[i], loadBits(data, 32, 8 * i));
+			}
+		}
+		hash = rotateLeft(accumulators[0], 1) + rotateLeft(accumulators[1], 7) + rotateLeft(accumulators[2], 12) + rotateLeft(accumulators[3], 18);
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			hash = (hash ^ xxh64Round(0, accumulators[i])) * Prime64_1 + Prime64_4;
+		}
+	}
+	else
+	{
+		hash = Prime64_5;
+	}
+	hash += size;
+	for (; end - data >= 8; data += 8)
+	{
+		hash = rotateLeft(hash ^ xxh64Round(0, readLittleEndian(data, 8)), 27) * Prime64_1 + Prime64_4;
+	}
+	if (end - data >= 4)
+	{
+		hash = rotateLeft(hash ^ (readLittleEndian(data, 4) * Prime64_1), 23) * Prime64_2 + Prime64_3;
+		data += 4;
+	}
+	for (; data < end; ++data)
+	{
+		hash = rotateLeft(hash ^ (*data * Prime64_5), 11) * Prime64_1;
+	}
+	hash ^= hash >> 33;
+	hash *= Prime64_2;
+	hash ^= hash >> 29;
+	hash *= Prime64_3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+// Decodes a frame after its magic number (3.1.1). Returns the position after the frame.
+const uint8_t* decodeFrame(const uint8_t* input, const uint8_t* inputEnd, uint8_t*& output, uint8_t* outputEnd, FrameState& state)
+{
+	require(input < inputEnd, "Frame header is truncated");
+	const uint32_t descriptor = *input++;
+	const uint32_t contentSizeFlag = descriptor >> 6;
+	const bool singleSegment = (descriptor & 0x20) != 0;
+	const bool hasChecksum = (descriptor & 0x04) != 0;
+	const uint32_t dictionaryIdFlag = descriptor & 3;
+	require((descriptor & 0x08) == 0, "Reserved frame header bit is set");
+
+	// The window descriptor is not needed: The whole output is in memory.
+	const uint32_t windowDescriptorSize = singleSegment ? 0 : 1;
+	const uint32_t dictionaryIdSize = dictionaryIdFlag == 3 ? 4 : dictionaryIdFlag;
+	const uint32_t contentSizeSize = contentSizeFlag ? 1u << contentSizeFlag : (singleSegment ? 1 : 0);
+	require(static_cast<size_t>(inputEnd - input) >= windowDescriptorSize + dictionaryIdSize + contentSizeSize, "Frame header is truncated");
+	input += windowDescriptorSize;
+	if (readLittleEndian(input, dictionaryIdSize) != 0)
+	{
+		throw InvalidDataError("[zstd::decompress]: Frames compressed with a dictionary are not supported");
+	}
+	input += dictionaryIdSize;
+	const bool hasContentSize = contentSizeSize > 0;
+	const uint64_t contentSize = readLittleEndian(input, contentSizeSize) + (contentSizeSize == 2 ? 256 : 0);
+	input += contentSizeSize;
+	require(!hasContentSize || contentSize <= static_cast<uint64_t>(outputEnd - output), "Decompressed data does not fit in the destination");
+
+	state.reset();
+	uint8_t* frameStart = output;
+	for (bool lastBlock = false; !lastBlock;)
+	{
+		require(inputEnd - input >= 3, "Block header is truncated");
+		const uint32_t header = static_cast<uint32_t>(readLittleEndian(input, 3));
+		input += 3;
+		lastBlock = (header & 1) != 0;
+		const uint32_t blockType = (header >> 1) & 3;
+		const size_t blockSize = header >> 3;
+		switch (blockType)
+		{
+		case 0: // Raw
+			require(blockSize <= static_cast<size_t>(inputEnd - input), "Block is truncated");
+			require(blockSize <= static_cast<size_t>(outputEnd - output), "Decompressed data does not fit in the destination");
+			memcpy(output, input, blockSize);
+			input += blockSize;
+			output += blockSize;
+			break;
+		case 1: // RLE
+			require(input < inputEnd, "Block is truncated");
+			require(blockSize <= static_cast<size_t>(outputEnd - output), "Decompressed data does not fit in the destination");
+			memset(output, *input, blockSize);
+			input += 1;
+			output += blockSize;
+			break;
+		case 2: // Compressed
+		{
+			require(blockSize <= MaxBlockSize, "Block is too large");
+			require(blockSize <= static_cast<size_t>(inputEnd - input), "Block is truncated");
+			const uint8_t* literals;
+			size_t numLiterals;
+			const size_t literalsSize = readLiterals(input, blockSize, state, literals, numLiterals);
+			decodeSequences(input + literalsSize, blockSize - literalsSize, state, literals, numLiterals, output, outputEnd, frameStart);
+			input += blockSize;
+			break;
+		}
+		default: corrupted("Reserved block type");
+		}
+	}
+	require(!hasContentSize || static_cast<uint64_t>(output - frameStart) == contentSize, "Decompressed size does not match the frame header");
+	if (hasChecksum)
+	{
+		require(inputEnd - input >= 4, "Content checksum is truncated");
+		require(readLittleEndian(input, 4) == (xxh64(frameStart, static_cast<size_t>(output - frameStart)) & 0xFFFFFFFFu), "Content checksum does not match");
+		input += 4;
+	}
+	return input;
+}
+} // namespace
+
+size_t decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize)
+{
+	FrameState state;
+	const uint8_t* input = source;
+	const uint8_t* inputEnd = source + sourceSize;
+	uint8_t* output = destination;
+	uint8_t* outputEnd = destination + destinationSize;
+	while (input < inputEnd)
+	{
+		require(inputEnd - input >= 4, "Frame magic number is truncated");
+		const uint32_t magic = static_cast<uint32_t>(readLittleEndian(input, 4));
+		input += 4;
+		if ((magic & 0xFFFFFFF0u) == SkippableFrameMagic)
+		{
+			require(inputEnd - input >= 4, "Skippable frame is truncated");
+			const uint64_t frameSize = readLittleEndian(input, 4);
+			input += 4;
+			require(frameSize <= static_cast<uint64_t>(inputEnd - input), "Skippable frame is truncated");
+			input += frameSize;
+			continue;
+		}
+		require(magic == FrameMagic, "Not a Zstandard frame");
+		input = decodeFrame(input, inputEnd, output, outputEnd, state);
+	}
+	return static_cast<size_t>(output - destination);
+}
+} // namespace zstd
+} // namespace pvr
+//!\endcond
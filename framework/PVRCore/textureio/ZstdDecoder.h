@@ -0,0 +1,24 @@
+/*!
+\brief Internally used by the KTX2 texture reader to inflate Zstandard supercompressed levels.
+\file PVRCore/textureio/ZstdDecoder.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pvr {
+namespace zstd {
+/// <summary>Decompress Zstandard data (RFC 8878): One or more frames, possibly interleaved with skippable frames. Frames
+/// that need a dictionary are not supported. The content checksum of a frame is verified if it has one.</summary>
+/// <param name="source">The compressed data</param>
+/// <param name="sourceSize">The size of the compressed data, in bytes</param>
+/// <param name="destination">The decompressed data is written here</param>
+/// <param name="destinationSize">The size of the destination, in bytes</param>
+/// <returns>The size of the decompressed data. Throws InvalidDataError if the data is corrupted or does not fit in the
+/// destination.</returns>
+size_t decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+} // namespace zstd
+} // namespace pvr
@@ -0,0 +1,214 @@
+/*!
+\brief A command line tool comparing loading every asset of an application from loose files (through the
+CachingAssetProvider, see PVRCore/stream/CachingAssetProvider.h) and from asset archives (see
+PVRCore/stream/AssetArchive.h), with a cold and with a warm file cache.
+\file PVRCore/tools/PVRAssetArchiveBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/AssetArchive.h"
+#include "PVRCore/stream/CachingAssetProvider.h"
+#include "PVRCore/stream/MappedFileStream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Drop a file from the file cache, so that the next read comes from the storage. Returns false if not supported.
+bool evictFromFileCache(const std::string& path)
+{
+#if defined(_WIN32) || defined(__APPLE__)
+	(void)path;
+	return false;
+#else
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	const bool evicted = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(file);
+	return evicted;
+#endif
+}
+
+// Open every asset and copy it out, as a loader would, and return a checksum of the data.
+uint64_t loadAll(pvr::IAssetProvider& provider, const std::vector<std::string>& names, std::vector<char>& data)
+{
+	uint64_t checksum = 0;
+	for (const std::string& name : names)
+	{
+		std::unique_ptr<pvr::Stream> stream = provider.getAssetStream(name, false);
+		if (!stream)
+		{
+			throw pvr::FileNotFoundError(name, "PVRAssetArchiveBenchmark: Asset not found");
+		}
+		data.resize(stream->getSize());
+		stream->readExact(1, data.size(), data.data());
+		for (size_t i = 0; i < data.size(); i += 4096)
+		{
+			checksum = checksum * 31 + static_cast<unsigned char>(data[i]);
+		}
+	}
+	return checksum;
+}
+
+// Check every entry of the archive against the loose file it was packed from.
+bool verifyArchive(pvr::AssetArchive& archive, const std::string& assetDirectory, const std::vector<std::string>& names)
+{
+	for (const std::string& name : names)
+	{
+		pvr::MappedFileStream file(assetDirectory + name);
+		file.open();
+		std::unique_ptr<pvr::Stream> entry = archive.getAssetStream(name, false);
+		std::vector<char> fileData(file.getSize()), entryData(entry ? entry->getSize() : 0);
+		if (!entry || entryData.size() != fileData.size())
+		{
+			printf("%s: Different size\n", name.c_str());
+			return false;
+		}
+		file.readExact(1, fileData.size(), fileData.data());
+		entry->readExact(1, entryData.size(), entryData.data());
+		if (fileData != entryData)
+		{
+			printf("%s: Different data\n", name.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numRepeats = 3;
+	std::vector<std::string> positional;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i][0] != '-')
+		{
+			positional.push_back(argv[i]);
+		}
+		else if (!readOption(argv[i], "-repeat=", numRepeats))
+		{
+			positional.clear();
+			break;
+		}
+	}
+	if (positional.size() < 2 || !numRepeats)
+	{
+		printf("Usage: %s [-repeat=<runs, of which the fastest is reported>] <asset directory> <archives of the directory made with PVRAssetPacker...>\n", argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		std::string assetDirectory = positional[0];
+		if (assetDirectory[assetDirectory.size() - 1] != '/' && assetDirectory[assetDirectory.size() - 1] != '\\')
+		{
+			assetDirectory += '/';
+		}
+		const std::vector<std::string> archivePaths(positional.begin() + 1, positional.end());
+
+		// Every entry of the first archive, checked against the loose files in every archive.
+		std::vector<std::string> names;
+		uint64_t totalSize = 0;
+		{
+			pvr::AssetArchive archive(archivePaths[0]);
+			for (uint32_t i = 0; i < archive.getNumEntries(); ++i)
+			{
+				names.push_back(archive.getEntryInfo(i).name);
+				totalSize += archive.getEntryInfo(i).size;
+			}
+		}
+		for (const std::string& archivePath : archivePaths)
+		{
+			pvr::AssetArchive archive(archivePath);
+			if (!verifyArchive(archive, assetDirectory, names))
+			{
+				printf("%s does not match %s\n", archivePath.c_str(), assetDirectory.c_str());
+				return 1;
+			}
+		}
+
+		std::vector<std::string> labels(1, "loose files");
+		std::vector<std::function<uint64_t(std::vector<char>&)> > loads(1, [&](std::vector<char>& data) {
+			pvr::CachingAssetProvider provider(std::vector<std::string>(1, assetDirectory));
+			provider.setCacheThreshold(0);
+			return loadAll(provider, names, data);
+		});
+		for (const std::string& archivePath : archivePaths)
+		{
+			labels.push_back(archivePath);
+			loads.push_back([&archivePath, &names](std::vector<char>& data) {
+				pvr::AssetArchive archive(archivePath);
+				return loadAll(archive, names, data);
+			});
+		}
+
+		// The file cache can only be dropped on some platforms, and only for files it is allowed to read.
+		bool canEvict = true;
+		for (const std::string& archivePath : archivePaths)
+		{
+			canEvict = evictFromFileCache(archivePath) && canEvict;
+		}
+		printf("%u assets, %.1f MB, best of %u runs. Every asset is opened and copied out.%s\n", static_cast<uint32_t>(names.size()), totalSize / 1e6, numRepeats,
+			canEvict ? " Cold: the files are dropped from the file cache first." : " The file cache cannot be dropped here, so only warm loads are timed.");
+		std::vector<char> data;
+		for (int cold = canEvict ? 1 : 0; cold >= 0; --cold)
+		{
+			for (size_t i = 0; i < loads.size(); ++i)
+			{
+				double bestMilliseconds = 0;
+				for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+				{
+					if (cold)
+					{
+						for (const std::string& name : names)
+						{
+							evictFromFileCache(assetDirectory + name);
+						}
+						for (const std::string& archivePath : archivePaths)
+						{
+							evictFromFileCache(archivePath);
+						}
+					}
+					const auto start = std::chrono::high_resolution_clock::now();
+					loads[i](data);
+					const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+					bestMilliseconds = repeat ? std::min(bestMilliseconds, milliseconds) : milliseconds;
+				}
+				printf("%s %-40s %9.2f ms\n", cold ? "cold" : "warm", labels[i].c_str(), bestMilliseconds);
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		printf("Failed: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,188 @@
+/*!
+\brief A command line tool packing directories of assets into an asset archive (see PVRCore/stream/AssetArchive.h).
+\file PVRCore/tools/PVRAssetPacker.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/AssetArchiveWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+bool isDirectory(const std::string& path)
+{
+#if defined(_WIN32)
+	DWORD attributes = GetFileAttributesA(path.c_str());
+	return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+	struct stat info;
+	return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+// Appends (name in the archive, path) pairs for every file under directory.
+void listFiles(const std::string& directory, const std::string& prefix, std::vector<std::pair<std::string, std::string> >& outFiles)
+{
+	std::vector<std::string> names;
+#if defined(_WIN32)
+	WIN32_FIND_DATAA findData;
+	HANDLE handle = FindFirstFileA((directory + "\\*").c_str(), &findData);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	do
+	{
+		names.push_back(findData.cFileName);
+	} while (FindNextFileA(handle, &findData));
+	FindClose(handle);
+	const char separator = '\\';
+#else
+	DIR* dir = opendir(directory.c_str());
+	if (!dir)
+	{
+		return;
+	}
+	while (dirent* entry = readdir(dir))
+	{
+		names.push_back(entry->d_name);
+	}
+	closedir(dir);
+	const char separator = '/';
+#endif
+	std::sort(names.begin(), names.end());
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		if (names[i] == "." || names[i] == "..")
+		{
+			continue;
+		}
+		const std::string path = directory + separator + names[i];
+		if (isDirectory(path))
+		{
+			listFiles(path, prefix + names[i] + "/", outFiles);
+		}
+		else
+		{
+			outFiles.push_back(std::make_pair(prefix + names[i], path));
+		}
+	}
+}
+
+void printUsage()
+{
+	printf("Usage: PVRAssetPacker [-lz4] [-align=<bytes>] [-v] <output archive> <input>...\n"
+		   "  Packs the inputs into an asset archive. Directories are packed recursively, with names relative to them;\n"
+		   "  files are packed under their own name.\n"
+		   "  -lz4           Compress the assets that shrink by at least 1/16th with LZ4.\n"
+		   "  -align=<bytes> Align the assets to a power of two (default 16).\n"
+		   "  -v             List the assets packed.\n");
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	pvr::asset_archive::Compression compression = pvr::asset_archive::Compression::None;
+	uint32_t alignment = 16;
+	bool verbose = false;
+	std::vector<std::string> positional;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-lz4"))
+		{
+			compression = pvr::asset_archive::Compression::LZ4;
+		}
+		else if (!strncmp(argv[i], "-align=", 7))
+		{
+			alignment = static_cast<uint32_t>(strtoul(argv[i] + 7, NULL, 10));
+		}
+		else if (!strcmp(argv[i], "-v"))
+		{
+			verbose = true;
+		}
+		else if (argv[i][0] == '-')
+		{
+			printUsage();
+			return 1;
+		}
+		else
+		{
+			positional.push_back(argv[i]);
+		}
+	}
+	if (positional.size() < 2)
+	{
+		printUsage();
+		return 1;
+	}
+
+	try
+	{
+		std::vector<std::pair<std::string, std::string> > files;
+		for (size_t i = 1; i < positional.size(); ++i)
+		{
+			std::string input = positional[i];
+			while (input.size() > 1 && (input[input.size() - 1] == '/' || input[input.size() - 1] == '\\'))
+			{
+				input.erase(input.size() - 1);
+			}
+			if (isDirectory(input))
+			{
+				listFiles(input, std::string(), files);
+			}
+			else
+			{
+				const size_t separator = input.find_last_of("/\\");
+				files.push_back(std::make_pair(separator == std::string::npos ? input : input.substr(separator + 1), input));
+			}
+		}
+
+		pvr::AssetArchiveWriter writer(alignment);
+		for (size_t i = 0; i < files.size(); ++i)
+		{
+			writer.addFile(files[i].first, files[i].second, compression);
+		}
+		writer.writeToFile(positional[0]);
+
+		pvr::AssetArchive archive(positional[0]);
+		uint64_t totalSize = 0, totalStored = 0;
+		for (uint32_t i = 0; i < archive.getNumEntries(); ++i)
+		{
+			const pvr::AssetArchive::EntryInfo info = archive.getEntryInfo(i);
+			totalSize += info.size;
+			totalStored += info.storedSize;
+			if (verbose)
+			{
+				printf("%10llu %10llu %s %s\n", static_cast<unsigned long long>(info.size), static_cast<unsigned long long>(info.storedSize),
+					info.compression == pvr::asset_archive::Compression::LZ4 ? "lz4 " : "    ", info.name.c_str());
+			}
+		}
+		printf("Packed %u assets (%llu bytes, %llu stored) into '%s'\n", archive.getNumEntries(), static_cast<unsigned long long>(totalSize),
+			static_cast<unsigned long long>(totalStored), positional[0].c_str());
+	}
+	catch (const std::exception& e)
+	{
+		fprintf(stderr, "PVRAssetPacker: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,163 @@
+/*!
+\brief A command line tool measuring how long an application takes to open its assets at startup: Probing every search
+path in turn, as the Shell used to, and with the CachingAssetProvider (see PVRCore/stream/CachingAssetProvider.h).
+\file PVRCore/tools/PVRAssetProviderBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/CachingAssetProvider.h"
+#include "PVRCore/stream/MappedFileStream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+// Try the name as given, then every search path in turn, as Shell::getAssetStream did before it used the
+// CachingAssetProvider.
+class ProbingAssetProvider : public pvr::IAssetProvider
+{
+public:
+	explicit ProbingAssetProvider(const std::vector<std::string>& searchPaths) : _searchPaths(searchPaths) {}
+
+	std::unique_ptr<pvr::Stream> getAssetStream(const std::string& filename, bool logErrorOnNotFound = true)
+	{
+		(void)logErrorOnNotFound;
+		for (const std::string& path : _searchPaths)
+		{
+			std::unique_ptr<pvr::Stream> stream(new pvr::MappedFileStream(path + filename, false));
+			stream->open();
+			if (stream->isopen())
+			{
+				return stream;
+			}
+		}
+		return std::unique_ptr<pvr::Stream>();
+	}
+
+private:
+	std::vector<std::string> _searchPaths;
+};
+
+// Open every asset and read its header, or all of it, and return a checksum of what was read.
+uint64_t openAll(pvr::IAssetProvider& provider, const std::vector<std::string>& names, bool readWhole, uint32_t& numFound)
+{
+	uint64_t checksum = 0;
+	std::vector<char> data;
+	numFound = 0;
+	for (const std::string& name : names)
+	{
+		std::unique_ptr<pvr::Stream> stream = provider.getAssetStream(name, false);
+		if (!stream)
+		{
+			continue;
+		}
+		++numFound;
+		data.resize(readWhole ? stream->getSize() : std::min<size_t>(16, stream->getSize()));
+		size_t dataRead = 0;
+		stream->read(1, data.size(), data.data(), dataRead);
+		for (size_t i = 0; i < dataRead; i += 64)
+		{
+			checksum = checksum * 31 + static_cast<unsigned char>(data[i]);
+		}
+	}
+	return checksum;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numPasses = 3;
+	uint32_t readWhole = 0;
+	std::vector<std::string> filenames;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i][0] != '-')
+		{
+			filenames.push_back(argv[i]);
+		}
+		else if (!readOption(argv[i], "-passes=", numPasses) && !readOption(argv[i], "-whole=", readWhole))
+		{
+			filenames.clear();
+			break;
+		}
+	}
+	if (filenames.empty() || !numPasses)
+	{
+		printf("Usage: %s [-passes=<times every asset is opened>] [-whole=<1 to read the whole assets, not only their headers>] <asset files...>\n", argv[0]);
+		return 1;
+	}
+
+	// The search paths of a Shell: the name as given, the current directory, then the directories of the assets. The
+	// assets are requested by name only, so each is found in the search path of its directory. Applications also
+	// probe for optional files that do not exist: one for every four assets.
+	std::vector<std::string> searchPaths = { "", "./" };
+	std::vector<std::string> names;
+	for (const std::string& filename : filenames)
+	{
+		const size_t separator = filename.find_last_of("/\\");
+		const std::string directory = separator == std::string::npos ? std::string() : filename.substr(0, separator + 1);
+		if (std::find(searchPaths.begin(), searchPaths.end(), directory) == searchPaths.end())
+		{
+			searchPaths.push_back(directory);
+		}
+		names.push_back(separator == std::string::npos ? filename : filename.substr(separator + 1));
+	}
+	for (size_t i = 0; i < filenames.size() / 4; ++i)
+	{
+		names.push_back("PVRAssetProviderBenchmark_missing_" + std::to_string(i) + ".pvr");
+	}
+
+	try
+	{
+		printf("%u requests (%u assets, %u missing), %u search paths, %s\n", static_cast<uint32_t>(names.size()), static_cast<uint32_t>(filenames.size()),
+			static_cast<uint32_t>(names.size() - filenames.size()), static_cast<uint32_t>(searchPaths.size()), readWhole ? "reading the whole assets" : "reading their headers");
+		ProbingAssetProvider probingProvider(searchPaths);
+		pvr::CachingAssetProvider cachingProvider(searchPaths);
+		// Once to warm up the file cache.
+		uint32_t numFound = 0;
+		const uint64_t expectedChecksum = openAll(probingProvider, names, readWhole != 0, numFound);
+		for (uint32_t pass = 0; pass < numPasses; ++pass)
+		{
+			for (int caching = 0; caching < 2; ++caching)
+			{
+				pvr::IAssetProvider& provider = caching ? static_cast<pvr::IAssetProvider&>(cachingProvider) : probingProvider;
+				const auto start = std::chrono::high_resolution_clock::now();
+				const uint64_t checksum = openAll(provider, names, readWhole != 0, numFound);
+				const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+				printf("pass %u, %-22s %8.3f ms  %u found%s\n", pass + 1, caching ? "CachingAssetProvider:" : "probing every path:", milliseconds, numFound,
+					checksum == expectedChecksum ? "" : "  (DIFFERENT DATA)");
+			}
+		}
+		const pvr::AssetProviderStatistics statistics = cachingProvider.getStatistics();
+		printf("CachingAssetProvider: %llu memory hits, %llu index hits, %llu probes, %llu misses, %llu files in %llu directories indexed, %llu assets (%llu bytes) "
+			   "in memory\n",
+			static_cast<unsigned long long>(statistics.numMemoryHits), static_cast<unsigned long long>(statistics.numIndexHits),
+			static_cast<unsigned long long>(statistics.numDirectOpens), static_cast<unsigned long long>(statistics.numMisses),
+			static_cast<unsigned long long>(statistics.numIndexedFiles), static_cast<unsigned long long>(statistics.numIndexedDirectories),
+			static_cast<unsigned long long>(statistics.numCachedAssets), static_cast<unsigned long long>(statistics.numBytesCached));
+	}
+	catch (const std::exception& e)
+	{
+		printf("Failed: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
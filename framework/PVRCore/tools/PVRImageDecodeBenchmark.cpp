@@ -0,0 +1,245 @@
+/*!
+\brief A command line tool timing textureLoad (see PVRCore/texture/TextureLoad.h) on generated run length encoded and
+palettized TGA files and palettized BMP files, read through a FileStream and through a MappedFileStream.
+\file PVRCore/tools/PVRImageDecodeBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/FileStream.h"
+#include "PVRCore/stream/MappedFileStream.h"
+#include "PVRCore/texture/TextureLoad.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+void write16(std::vector<uint8_t>& file, uint16_t value)
+{
+	file.push_back(static_cast<uint8_t>(value & 0xff));
+	file.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void write32(std::vector<uint8_t>& file, uint32_t value)
+{
+	write16(file, static_cast<uint16_t>(value & 0xffff));
+	write16(file, static_cast<uint16_t>(value >> 16));
+}
+
+// A TGA file of random pixels. Image types 1 (palettized) and 2 (true colour) are stored raw, 9 and 10 are their run
+// length encoded versions, with packets of random length, half of them repeats.
+std::vector<uint8_t> createTga(uint8_t imageType, uint16_t paletteLength, uint8_t paletteBits, uint8_t pixelBits, uint16_t size, std::mt19937& random)
+{
+	std::vector<uint8_t> file;
+	file.push_back(0); // No image identifier
+	file.push_back(paletteLength ? 1 : 0);
+	file.push_back(imageType);
+	write16(file, 0); // First palette entry
+	write16(file, paletteLength);
+	file.push_back(paletteBits);
+	write16(file, 0); // Origin
+	write16(file, 0);
+	write16(file, size);
+	write16(file, size);
+	file.push_back(pixelBits);
+	file.push_back(8); // Alpha bits
+	for (uint32_t i = 0; i < paletteLength * (paletteBits / 8u); ++i)
+	{
+		file.push_back(static_cast<uint8_t>(random()));
+	}
+
+	const uint32_t bytesPerPixel = pixelBits / 8u;
+	auto writePixel = [&]() {
+		for (uint32_t i = 0; i < bytesPerPixel; ++i)
+		{
+			file.push_back(static_cast<uint8_t>(paletteLength ? random() % paletteLength : random()));
+		}
+	};
+	const uint32_t numPixels = static_cast<uint32_t>(size) * size;
+	if (imageType < 8)
+	{
+		for (uint32_t i = 0; i < numPixels; ++i)
+		{
+			writePixel();
+		}
+		return file;
+	}
+	for (uint32_t pixel = 0; pixel < numPixels;)
+	{
+		const uint32_t length = std::min(1 + static_cast<uint32_t>(random() % 128), numPixels - pixel);
+		if ((random() & 1) || length == 1)
+		{
+			file.push_back(static_cast<uint8_t>(length - 1));
+			for (uint32_t i = 0; i < length; ++i)
+			{
+				writePixel();
+			}
+		}
+		else
+		{
+			file.push_back(static_cast<uint8_t>(0x80 | (length - 1)));
+			writePixel();
+		}
+		pixel += length;
+	}
+	return file;
+}
+
+// A palettized BMP file of random pixels. The width is odd, so that the rows need padding.
+std::vector<uint8_t> createBmp(uint16_t pixelBits, uint16_t size, std::mt19937& random)
+{
+	const int32_t width = size - 1;
+	const uint32_t paletteLength = 1u << pixelBits;
+	const uint32_t rowBytes = ((width * pixelBits + 7) / 8 + 3) & ~3u;
+	std::vector<uint8_t> file;
+	file.push_back('B');
+	file.push_back('M');
+	write32(file, 0); // File size
+	write32(file, 0); // Reserved
+	write32(file, 14 + 40 + paletteLength);
+	write32(file, 40); // Header size
+	write32(file, static_cast<uint32_t>(width));
+	write32(file, size);
+	write16(file, 1); // Planes
+	write16(file, pixelBits);
+	write32(file, 0); // No compression
+	write32(file, rowBytes * size);
+	write32(file, 0); // Resolution
+	write32(file, 0);
+	write32(file, paletteLength);
+	write32(file, 0); // Important colours
+	for (uint32_t i = 0; i < paletteLength; ++i)
+	{
+		file.push_back(static_cast<uint8_t>(random()));
+	}
+	for (uint32_t i = 0; i < rowBytes * size; ++i)
+	{
+		file.push_back(static_cast<uint8_t>(random()));
+	}
+	return file;
+}
+
+// FNV-1a, so that the decoded images can be compared between builds.
+uint64_t hashTexture(const pvr::Texture& texture)
+{
+	uint64_t hash = 1469598103934665603ull;
+	for (uint64_t i = 0; i < texture.getDataSize(); ++i)
+	{
+		hash = (hash ^ texture.getDataPointer()[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+pvr::Stream::ptr_type openFileStream(const std::string& filename)
+{
+	return pvr::Stream::ptr_type(new pvr::FileStream(filename, "rb"));
+}
+
+pvr::Stream::ptr_type openMappedFileStream(const std::string& filename)
+{
+	return pvr::Stream::ptr_type(new pvr::MappedFileStream(filename));
+}
+
+void report(const char* name, const std::string& filename, size_t fileSize, pvr::TextureFileFormat format, pvr::Stream::ptr_type (*openStream)(const std::string&),
+	const char* streamName, uint32_t numRepeats)
+{
+	double bestMilliseconds = 0;
+	uint64_t hash = 0;
+	for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		pvr::Texture texture = pvr::textureLoad(openStream(filename), format);
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		bestMilliseconds = repeat ? std::min(bestMilliseconds, milliseconds) : milliseconds;
+		hash = hashTexture(texture);
+	}
+	printf("%-22s %-16s %7.1f MB  %9.2f ms  %8.1f MB/s  hash %016llx\n", name, streamName, fileSize / 1e6, bestMilliseconds, fileSize / (bestMilliseconds * 1000.0),
+		static_cast<unsigned long long>(hash));
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t size = 4096;
+	uint32_t numRepeats = 5;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-size=", size) && !readOption(argv[i], "-repeat=", numRepeats))
+		{
+			printf("Usage: %s [-size=<width and height of the generated images, default 4096>] [-repeat=<runs, of which the fastest is reported>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (size < 2 || size > 65535 || !numRepeats)
+	{
+		printf("The size must be between 2 and 65535, and the number of runs greater than zero\n");
+		return 1;
+	}
+
+	struct Image
+	{
+		const char* name;
+		pvr::TextureFileFormat format;
+		std::vector<uint8_t> file;
+	};
+	std::mt19937 random(7);
+	const uint16_t imageSize = static_cast<uint16_t>(size);
+	Image images[] = {
+		{ "TGA RLE 32bpp", pvr::TextureFileFormat::TGA, createTga(10, 0, 0, 32, imageSize, random) },
+		{ "TGA RLE 24bpp", pvr::TextureFileFormat::TGA, createTga(10, 0, 0, 24, imageSize, random) },
+		{ "TGA RLE indexed", pvr::TextureFileFormat::TGA, createTga(9, 256, 8, 8, imageSize, random) },
+		{ "TGA indexed, pal24", pvr::TextureFileFormat::TGA, createTga(1, 200, 24, 8, imageSize, random) },
+		{ "TGA indexed, pal32", pvr::TextureFileFormat::TGA, createTga(1, 256, 32, 8, imageSize, random) },
+		{ "BMP 8-bit", pvr::TextureFileFormat::BMP, createBmp(8, imageSize, random) },
+		{ "BMP 4-bit", pvr::TextureFileFormat::BMP, createBmp(4, imageSize, random) },
+	};
+
+	printf("%ux%u generated images, best of %u runs of the whole textureLoad, MB/s of the file\n", size, size, numRepeats);
+	// Each image is written to the current directory, read back (from the file cache), and removed.
+	const std::string filename = "PVRImageDecodeBenchmark.tmp";
+	try
+	{
+		for (const Image& image : images)
+		{
+			FILE* file = fopen(filename.c_str(), "wb");
+			if (!file || fwrite(image.file.data(), 1, image.file.size(), file) != image.file.size())
+			{
+				printf("Failed to write %s\n", filename.c_str());
+				if (file)
+				{
+					fclose(file);
+				}
+				remove(filename.c_str());
+				return 1;
+			}
+			fclose(file);
+			report(image.name, filename, image.file.size(), image.format, openFileStream, "FileStream", numRepeats);
+			report(image.name, filename, image.file.size(), image.format, openMappedFileStream, "MappedFileStream", numRepeats);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		printf("Failed: %s\n", e.what());
+		remove(filename.c_str());
+		return 1;
+	}
+	remove(filename.c_str());
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,91 @@
+/*!
+\brief A command line tool measuring how long textures take to load from disk, e.g. a PVR file against the same texture
+stored as KTX2, with and without Zstandard supercompression. Every texture is checked against the first one.
+\file PVRCore/tools/PVRKTX2Benchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/FileStream.h"
+#include "PVRCore/texture/TextureLoad.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+pvr::Texture loadTexture(const std::string& filename)
+{
+	return pvr::textureLoad(pvr::FileStream::createFileStream(filename.c_str(), "rb"), pvr::getTextureFormatFromFilename(filename.c_str()));
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numRepeats = 50;
+	std::vector<std::string> filenames;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i][0] != '-')
+		{
+			filenames.push_back(argv[i]);
+		}
+		else if (!readOption(argv[i], "-repeat=", numRepeats))
+		{
+			filenames.clear();
+			break;
+		}
+	}
+	if (filenames.empty() || !numRepeats)
+	{
+		printf("Usage: %s [-repeat=<times each texture is loaded>] <reference texture> [<texture files...>]\n", argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		const pvr::Texture reference = loadTexture(filenames[0]);
+		printf("%s: %ux%u, %u MIP levels, %u faces, %u bytes of texture data, each file loaded %u times\n", filenames[0].c_str(), reference.getWidth(),
+			reference.getHeight(), reference.getNumMipMapLevels(), reference.getNumFaces(), reference.getDataSize(), numRepeats);
+		for (const std::string& filename : filenames)
+		{
+			const uint64_t fileSize = pvr::FileStream::createFileStream(filename.c_str(), "rb")->getSize();
+			const pvr::Texture texture = loadTexture(filename);
+			if (texture.getDataSize() != reference.getDataSize() || memcmp(texture.getDataPointer(), reference.getDataPointer(), reference.getDataSize()) != 0)
+			{
+				printf("%-40s does not contain the same texture data as %s\n", filename.c_str(), filenames[0].c_str());
+				return 1;
+			}
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+			{
+				loadTexture(filename);
+			}
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / numRepeats;
+			printf("%-40s %9llu bytes (%5.1f%%)  %8.3f ms per load  %8.1f MB/s\n", filename.c_str(), static_cast<unsigned long long>(fileSize),
+				100.0 * fileSize / reference.getDataSize(), milliseconds, reference.getDataSize() / (milliseconds * 1000.0));
+		}
+	}
+	catch (const std::exception& e)
+	{
+		printf("Failed: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,112 @@
+/*!
+\brief A command line tool measuring how many messages per second the Logger (see PVRCore/Log.h) accepts from 1 to
+16 threads logging at the same time, synchronously and asynchronously. The messages themselves go to the standard
+output and to log.txt as usual, so redirect the standard output (for example to /dev/null): The results are printed to
+the standard error.
+\file PVRCore/tools/PVRLogBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/Log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Result
+{
+	double producerMilliseconds; // Until every thread has returned from its last call to the logger
+	double totalMilliseconds; // Until every message has been written out
+};
+
+// Log numMessages messages from each of numThreads threads.
+Result run(Logger& logger, uint32_t numThreads, uint32_t numMessages)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	std::vector<std::thread> threads;
+	for (uint32_t thread = 0; thread < numThreads; ++thread)
+	{
+		threads.emplace_back([&logger, thread, numMessages] {
+			for (uint32_t message = 0; message < numMessages; ++message)
+			{
+				logger(LogLevel::Information, "Thread %u: frame %u took %.3f ms", thread, message, 16.6f + 0.001f * message);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	Result result;
+	result.producerMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	logger.flush();
+	result.totalMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	return result;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t maxThreads = 16;
+	uint32_t numMessages = 20000;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-threads=", maxThreads) && !readOption(argv[i], "-messages=", numMessages))
+		{
+			fprintf(stderr, "Usage: %s [-threads=<max logging threads>] [-messages=<messages per thread>] > /dev/null\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!maxThreads || !numMessages)
+	{
+		fprintf(stderr, "The number of threads and of messages must be greater than zero\n");
+		return 1;
+	}
+
+	struct Mode
+	{
+		const char* name;
+		bool asynchronous;
+		pvr::LogOverflowPolicy overflowPolicy;
+	};
+	const Mode modes[] = {
+		{ "synchronous", false, pvr::LogOverflowPolicy::Block },
+		{ "asynchronous, block", true, pvr::LogOverflowPolicy::Block },
+		{ "asynchronous, drop", true, pvr::LogOverflowPolicy::Drop },
+	};
+	fprintf(stderr, "%u messages per thread. Messages per second until the last call to the logger returns, and until all are written out\n", numMessages);
+	Logger logger;
+	for (const Mode& mode : modes)
+	{
+		logger.setAsynchronous(mode.asynchronous, mode.overflowPolicy);
+		for (uint32_t numThreads = 1;; numThreads = std::min(numThreads * 2, maxThreads))
+		{
+			const Result result = run(logger, numThreads, numMessages);
+			const double totalMessages = static_cast<double>(numThreads) * numMessages;
+			fprintf(stderr, "%-20s %2u thread(s): %12.0f msg/s returned  %12.0f msg/s written\n", mode.name, numThreads,
+				totalMessages * 1000.0 / result.producerMilliseconds, totalMessages * 1000.0 / result.totalMilliseconds);
+			if (numThreads == maxThreads)
+			{
+				break;
+			}
+		}
+	}
+	logger.setAsynchronous(false);
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,129 @@
+/*!
+\brief A command line tool comparing FileStream and MappedFileStream (see PVRCore/stream/MappedFileStream.h): Reading
+whole files, and opening files to read only their header, from the file cache and (on POSIX systems) from disk.
+\file PVRCore/tools/PVRMappedFileBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/stream/FileStream.h"
+#include "PVRCore/stream/MappedFileStream.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Drop the pages of the file from the file cache, so that the next read comes from the disk. Returns false if that is
+// not possible on this platform.
+bool evictFromFileCache(const std::string& filename)
+{
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+	const int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	const bool evicted = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(file);
+	return evicted;
+#else
+	(void)filename;
+	return false;
+#endif
+}
+
+// Open the file and read readSize bytes from its start (all of it if 0). Returns the number of bytes read.
+size_t openAndRead(const std::string& filename, bool mapped, size_t readSize, std::vector<char>& buffer)
+{
+	pvr::Stream::ptr_type stream = mapped ? pvr::MappedFileStream::createMappedFileStream(filename.c_str()) : pvr::FileStream::createFileStream(filename.c_str(), "rb");
+	const size_t size = readSize ? std::min(readSize, stream->getSize()) : stream->getSize();
+	buffer.resize(std::max(buffer.size(), size));
+	stream->readExact(1, size, buffer.data());
+	return size;
+}
+
+double timeReads(const std::string& filename, bool mapped, size_t readSize, bool cold, uint32_t numRepeats, std::vector<char>& buffer)
+{
+	double milliseconds = 0;
+	for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		if (cold)
+		{
+			evictFromFileCache(filename);
+		}
+		const auto start = std::chrono::high_resolution_clock::now();
+		openAndRead(filename, mapped, readSize, buffer);
+		milliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+	return milliseconds / numRepeats;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numRepeats = 20;
+	uint32_t headerSize = 4096;
+	std::vector<std::string> filenames;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i][0] != '-')
+		{
+			filenames.push_back(argv[i]);
+		}
+		else if (!readOption(argv[i], "-repeat=", numRepeats) && !readOption(argv[i], "-header=", headerSize))
+		{
+			filenames.clear();
+			break;
+		}
+	}
+	if (filenames.empty() || !numRepeats || !headerSize)
+	{
+		printf("Usage: %s [-repeat=<times each file is read>] [-header=<bytes read for a header only read>] <files...>\n", argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		std::vector<char> buffer;
+		for (const std::string& filename : filenames)
+		{
+			const size_t fileSize = openAndRead(filename, false, 0, buffer);
+			printf("%s: %llu bytes, ms per open and read\n", filename.c_str(), static_cast<unsigned long long>(fileSize));
+			const bool canEvict = evictFromFileCache(filename);
+			for (uint32_t cold = 0; cold < (canEvict ? 2u : 1u); ++cold)
+			{
+				const char* cache = cold ? "from disk " : "from cache";
+				printf("  %s  whole file:    FileStream %9.3f  MappedFileStream %9.3f\n", cache, timeReads(filename, false, 0, cold != 0, numRepeats, buffer),
+					timeReads(filename, true, 0, cold != 0, numRepeats, buffer));
+				printf("  %s  first %6u B:  FileStream %9.3f  MappedFileStream %9.3f\n", cache, headerSize,
+					timeReads(filename, false, headerSize, cold != 0, numRepeats, buffer), timeReads(filename, true, headerSize, cold != 0, numRepeats, buffer));
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		printf("Failed: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,200 @@
+/*!
+\brief A command line tool comparing the unbounded and the bounded LockedQueue (see PVRCore/Threading.h) with the
+producer/consumer patterns of the GnomeHorde example.
+\file PVRCore/tools/PVRQueueBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/Log.h"
+#include "PVRCore/Threading.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+// The item of the GnomeHorde tile queues.
+struct Item
+{
+	int32_t itemsDiscarded;
+	int32_t x, y;
+	Item() : itemsDiscarded(0), x(-1), y(-1) {}
+};
+
+struct Config
+{
+	uint32_t numFrames;
+	uint32_t itemsPerFrame;
+	uint32_t batchSize;
+};
+
+void waitUntil(const std::atomic<uint32_t>& value, uint32_t target)
+{
+	while (value.load(std::memory_order_acquire) < target)
+	{
+		std::this_thread::yield();
+	}
+}
+
+// 1:N - One thread produces the work of each frame (in batches of batchSize, as the main thread of GnomeHorde kicks
+// the lines to process), and numConsumers threads consume it one item at a time. A frame ends when all of its items
+// have been consumed.
+template<typename Queue>
+double oneToMany(const Config& config, uint32_t numConsumers)
+{
+	std::unique_ptr<Queue> queue(new Queue);
+	std::atomic<uint32_t> numConsumed(0);
+	std::vector<std::thread> consumers;
+	for (uint32_t i = 0; i < numConsumers; ++i)
+	{
+		consumers.emplace_back([&]() {
+			typename Queue::ConsumerToken token = queue->getConsumerToken();
+			Item item;
+			while (queue->consume(token, item))
+			{
+				numConsumed.fetch_add(1, std::memory_order_release);
+			}
+		});
+	}
+
+	typename Queue::ProducerToken token = queue->getProducerToken();
+	std::vector<Item> items(config.batchSize);
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t frame = 0; frame < config.numFrames; ++frame)
+	{
+		for (uint32_t produced = 0; produced < config.itemsPerFrame; produced += config.batchSize)
+		{
+			const uint32_t numItems = std::min(config.batchSize, config.itemsPerFrame - produced);
+			if (numItems == 1)
+			{
+				queue->produce(token, items[0]);
+			}
+			else
+			{
+				queue->produceMultiple(token, items.data(), numItems);
+			}
+		}
+		waitUntil(numConsumed, (frame + 1) * config.itemsPerFrame);
+	}
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	queue->done();
+	for (std::thread& consumer : consumers)
+	{
+		consumer.join();
+	}
+	return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+// N:1 - numProducers threads each produce their share of the items of a frame one at a time (as the GnomeHorde
+// visibility and tile threads fill the draw queue), and one thread consumes them in batches of up to 256.
+template<typename Queue>
+double manyToOne(const Config& config, uint32_t numProducers)
+{
+	std::unique_ptr<Queue> queue(new Queue);
+	std::atomic<uint32_t> frameStarted(0);
+	std::vector<std::thread> producers;
+	for (uint32_t i = 0; i < numProducers; ++i)
+	{
+		producers.emplace_back([&, i]() {
+			typename Queue::ProducerToken token = queue->getProducerToken();
+			const uint32_t first = config.itemsPerFrame * i / numProducers;
+			const uint32_t last = config.itemsPerFrame * (i + 1) / numProducers;
+			Item item;
+			for (uint32_t frame = 0; frame < config.numFrames; ++frame)
+			{
+				waitUntil(frameStarted, frame + 1);
+				for (uint32_t index = first; index < last; ++index)
+				{
+					queue->produce(token, item);
+				}
+			}
+		});
+	}
+
+	typename Queue::ConsumerToken token = queue->getConsumerToken();
+	Item items[256];
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t frame = 0; frame < config.numFrames; ++frame)
+	{
+		frameStarted.store(frame + 1, std::memory_order_release);
+		for (uint32_t numConsumed = 0; numConsumed < config.itemsPerFrame;)
+		{
+			numConsumed += static_cast<uint32_t>(queue->consumeMultiple(token, items, 256));
+		}
+	}
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	for (std::thread& producer : producers)
+	{
+		producer.join();
+	}
+	queue->done();
+	return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void report(const char* pattern, const char* queueName, uint32_t numThreads, const Config& config, double microseconds)
+{
+	printf("%-4s %-10s %5u items/frame, batch %4u, %2u threads: %9.1f us/frame %8.1f ns/item\n", pattern, queueName, config.itemsPerFrame, config.batchSize,
+		numThreads, microseconds / config.numFrames, microseconds * 1000.0 / (static_cast<double>(config.numFrames) * config.itemsPerFrame));
+}
+
+const uint32_t BoundedCapacity = 4096;
+typedef pvr::LockedQueue<Item> UnboundedQueue;
+typedef pvr::LockedQueue<Item, BoundedCapacity> BoundedQueue;
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	// The defaults are the rates of GnomeHorde: 50x50 tiles per frame, dispatched one by one to the tile threads and
+	// collected by the main thread, and the 50 lines of tiles kicked in a single batch to the visibility threads.
+	Config config;
+	config.numFrames = 1000;
+	config.itemsPerFrame = 2500;
+	config.batchSize = 1;
+	uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 2u);
+	uint32_t lineItems = 50;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-frames=", config.numFrames) && !readOption(argv[i], "-items=", config.itemsPerFrame) &&
+			!readOption(argv[i], "-lines=", lineItems) && !readOption(argv[i], "-threads=", maxThreads))
+		{
+			printf("Usage: %s [-frames=<frames>] [-items=<items per frame>] [-lines=<batched items per frame>] [-threads=<max threads>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!config.numFrames || !config.itemsPerFrame || !lineItems || !maxThreads)
+	{
+		printf("All the options must be greater than zero\n");
+		return 1;
+	}
+	Config lineConfig = config;
+	lineConfig.itemsPerFrame = lineItems;
+	lineConfig.batchSize = lineItems;
+
+	printf("%u frames, %u items per frame, %u batched items per frame, bounded capacity %u\n", config.numFrames, config.itemsPerFrame, lineItems, BoundedCapacity);
+	for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+	{
+		report("1:N", "unbounded", numThreads, config, oneToMany<UnboundedQueue>(config, numThreads));
+		report("1:N", "bounded", numThreads, config, oneToMany<BoundedQueue>(config, numThreads));
+		report("1:N", "unbounded", numThreads, lineConfig, oneToMany<UnboundedQueue>(lineConfig, numThreads));
+		report("1:N", "bounded", numThreads, lineConfig, oneToMany<BoundedQueue>(lineConfig, numThreads));
+		report("N:1", "unbounded", numThreads, config, manyToOne<UnboundedQueue>(config, numThreads));
+		report("N:1", "bounded", numThreads, config, manyToOne<BoundedQueue>(config, numThreads));
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,145 @@
+/*!
+\brief A command line tool checking the PVRTC1 and ETC1 decompressors (see PVRCore/texture/PVRTDecompress.h) bit for bit
+against the scalar decompressors they replaced, and measuring both, in megapixels per second.
+\file PVRCore/tools/PVRTDecompressBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/texture/PVRTDecompress.h"
+#include "PVRCore/tools/PVRTDecompressReference.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+enum class Codec
+{
+	PVRTC2bpp,
+	PVRTC4bpp,
+	ETC1
+};
+
+const char* getName(Codec codec)
+{
+	switch (codec)
+	{
+	case Codec::PVRTC2bpp: return "PVRTC1 2bpp";
+	case Codec::PVRTC4bpp: return "PVRTC1 4bpp";
+	default: return "ETC1";
+	}
+}
+
+// Size of the compressed data, which is padded to the minimum size of the format.
+size_t getCompressedSize(Codec codec, uint32_t width, uint32_t height)
+{
+	switch (codec)
+	{
+	case Codec::PVRTC2bpp: return static_cast<size_t>(std::max(width, 16u)) * std::max(height, 8u) / 4;
+	case Codec::PVRTC4bpp: return static_cast<size_t>(std::max(width, 8u)) * std::max(height, 8u) / 2;
+	default: return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * 8;
+	}
+}
+
+void decompress(Codec codec, bool useReference, const std::vector<uint8_t>& compressed, uint32_t width, uint32_t height, std::vector<uint8_t>& output)
+{
+	if (codec == Codec::ETC1)
+	{
+		useReference ? reference::PVRTDecompressETC(compressed.data(), width, height, output.data(), 0)
+					 : pvr::PVRTDecompressETC(compressed.data(), width, height, output.data(), 0);
+	}
+	else
+	{
+		const uint32_t do2bitMode = codec == Codec::PVRTC2bpp ? 1 : 0;
+		useReference ? reference::PVRTDecompressPVRTC(compressed.data(), do2bitMode, width, height, output.data())
+					 : pvr::PVRTDecompressPVRTC(compressed.data(), do2bitMode, width, height, output.data());
+	}
+}
+
+// Megapixels per second of numRepeats decompressions.
+double measure(Codec codec, bool useReference, const std::vector<uint8_t>& compressed, uint32_t width, uint32_t height, uint32_t numRepeats, std::vector<uint8_t>& output)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		decompress(codec, useReference, compressed, width, height, output);
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	return static_cast<double>(width) * height * numRepeats / (seconds * 1e6);
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numRepeats = 10;
+	uint32_t seed = 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-repeat=", numRepeats) && !readOption(argv[i], "-seed=", seed))
+		{
+			printf("Usage: %s [-repeat=<times each texture is timed>] [-seed=<seed of the random compressed data>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// Random compressed data: Every bit pattern is a valid PVRTC1 or ETC1 block, so this covers all the modes.
+	// PVRTC1 needs power of two sizes. Sizes below the minimum of the format are decompressed through a temporary buffer.
+	const uint32_t sizes[][2] = { { 1, 1 }, { 2, 4 }, { 4, 4 }, { 8, 8 }, { 16, 8 }, { 8, 32 }, { 64, 64 }, { 256, 128 }, { 512, 512 }, { 2048, 2048 } };
+	const Codec codecs[] = { Codec::PVRTC2bpp, Codec::PVRTC4bpp, Codec::ETC1 };
+	std::mt19937 random(seed);
+	uint32_t numMismatches = 0;
+	printf("%-12s %11s  %16s  %16s  %s\n", "Format", "Size", "Reference MP/s", "Current MP/s", "Output");
+	for (Codec codec : codecs)
+	{
+		for (const auto& size : sizes)
+		{
+			const uint32_t width = size[0], height = size[1];
+			std::vector<uint8_t> compressed(getCompressedSize(codec, width, height));
+			for (uint8_t& byte : compressed)
+			{
+				byte = static_cast<uint8_t>(random());
+			}
+			std::vector<uint8_t> expected(static_cast<size_t>(width) * height * 4), actual(expected.size());
+			decompress(codec, true, compressed, width, height, expected);
+			decompress(codec, false, compressed, width, height, actual);
+			const bool identical = memcmp(expected.data(), actual.data(), expected.size()) == 0;
+			numMismatches += identical ? 0 : 1;
+
+			// Small sizes are only checked: Too little work to be timed
+			char sizeText[32];
+			snprintf(sizeText, sizeof(sizeText), "%ux%u", width, height);
+			if (static_cast<uint64_t>(width) * height >= 256 * 128)
+			{
+				// As many pixels for every size as numRepeats textures of 512x512
+				const uint32_t repeats = static_cast<uint32_t>(std::max<uint64_t>(1, numRepeats * 512ull * 512ull / (static_cast<uint64_t>(width) * height)));
+				printf("%-12s %11s  %16.1f  %16.1f  %s\n", getName(codec), sizeText, measure(codec, true, compressed, width, height, repeats, expected),
+					measure(codec, false, compressed, width, height, repeats, actual), identical ? "identical" : "DIFFERENT");
+			}
+			else
+			{
+				printf("%-12s %11s  %16s  %16s  %s\n", getName(codec), sizeText, "-", "-", identical ? "identical" : "DIFFERENT");
+			}
+		}
+	}
+	if (numMismatches)
+	{
+		printf("%u decompressed textures differ from the reference\n", numMismatches);
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,84 @@
+/*!
+\brief A command line tool checking the data layout of TextureHeader (see PVRCore/texture/TextureHeader.h) for textures
+of more than 4 GiB: The offset of every surface, through getDataOffset and through getSurfaces, against the offsets
+worked out independently in 64 bits.
+\file PVRCore/tools/PVRTextureLayoutCheck.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/texture/TextureHeader.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+struct Layout
+{
+	const char* name;
+	pvr::PixelFormat pixelFormat;
+	uint32_t blockWidth, blockHeight, bytesPerBlock;
+	uint32_t size, numMipMaps, numSurfaces, numFaces;
+};
+
+// The size of one face of a MIP level: A whole number of blocks in each dimension.
+uint64_t getFaceSize(const Layout& layout, uint32_t mipLevel)
+{
+	const uint32_t size = std::max(layout.size >> mipLevel, 1u);
+	return static_cast<uint64_t>((size + layout.blockWidth - 1) / layout.blockWidth) * ((size + layout.blockHeight - 1) / layout.blockHeight) * layout.bytesPerBlock;
+}
+
+// Returns the number of surfaces whose offset differs from the expected one.
+uint32_t check(const Layout& layout)
+{
+	const pvr::TextureHeader header(layout.pixelFormat, layout.size, layout.size, 1, layout.numMipMaps, pvr::ColorSpace::lRGB, pvr::VariableType::UnsignedByteNorm,
+		layout.numSurfaces, layout.numFaces);
+	uint32_t numMismatches = 0;
+	uint64_t expectedOffset = 0;
+	pvr::TextureHeader::SurfaceIterator surface = header.getSurfaces().begin();
+	for (uint32_t mipLevel = 0; mipLevel < layout.numMipMaps; ++mipLevel)
+	{
+		const uint64_t faceSize = getFaceSize(layout, mipLevel);
+		for (uint32_t arrayMember = 0; arrayMember < layout.numSurfaces; ++arrayMember)
+		{
+			for (uint32_t face = 0; face < layout.numFaces; ++face, ++surface, expectedOffset += faceSize)
+			{
+				const uint64_t offset = static_cast<uint64_t>(header.getDataOffset(mipLevel, arrayMember, face));
+				if (offset != expectedOffset || static_cast<uint64_t>(surface->offset) != expectedOffset || surface->dataSize != faceSize)
+				{
+					if (!numMismatches)
+					{
+						printf("  first mismatch at MIP level %u, array member %u, face %u: offset %llu, getSurfaces %llu, expected %llu, size %u, expected %llu\n", mipLevel,
+							arrayMember, face, static_cast<unsigned long long>(offset), static_cast<unsigned long long>(surface->offset),
+							static_cast<unsigned long long>(expectedOffset), surface->dataSize, static_cast<unsigned long long>(faceSize));
+					}
+					++numMismatches;
+				}
+			}
+		}
+	}
+	if (surface != header.getSurfaces().end())
+	{
+		printf("  getSurfaces has more surfaces than expected\n");
+		++numMismatches;
+	}
+	printf("%-28s %6u surfaces, %14llu bytes: %s\n", layout.name, static_cast<uint32_t>(header.getSurfaces().size()), static_cast<unsigned long long>(expectedOffset),
+		numMismatches ? "DIFFERENT" : "identical");
+	return numMismatches;
+}
+} // namespace
+
+int main()
+{
+	const Layout layouts[] = {
+		{ "RGBA8 4096^2 cube x256", pvr::PixelFormat::RGBA_8888(), 1, 1, 4, 4096, 13, 256, 6 },
+		{ "ETC2 8192^2 cube x64", pvr::PixelFormat(pvr::CompressedPixelFormat::ETC2_RGB), 4, 4, 8, 8192, 14, 64, 6 },
+		{ "RGBA8 1024^2 x16 (< 4 GiB)", pvr::PixelFormat::RGBA_8888(), 1, 1, 4, 1024, 11, 16, 1 },
+	};
+	uint32_t numMismatches = 0;
+	for (const Layout& layout : layouts)
+	{
+		numMismatches += check(layout);
+	}
+	return numMismatches ? 1 : 0;
+}
+//!\endcond
@@ -0,0 +1,130 @@
+/*!
+\brief A command line tool measuring how long the TextureAsyncLoader (see PVRCore/texture/TextureLoadAsync.h) takes to
+load a set of textures with one worker thread, as the single-threaded scheduler did, and with more workers.
+\file PVRCore/tools/PVRTextureLoadBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/Log.h"
+#include "PVRCore/IAssetProvider.h"
+#include "PVRCore/stream/FileStream.h"
+#include "PVRCore/texture/TextureLoadAsync.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+class FileAssetProvider : public pvr::IAssetProvider
+{
+public:
+	std::unique_ptr<pvr::Stream> getAssetStream(const std::string& filename, bool logErrorOnNotFound = true)
+	{
+		return pvr::FileStream::createFileStream(filename.c_str(), "rb", logErrorOnNotFound);
+	}
+};
+
+struct Result
+{
+	double milliseconds;
+	uint64_t numBytes;
+	uint32_t numFailed;
+};
+
+// Queue every texture numRepeats times, then wait for all of them.
+Result loadAll(const std::vector<std::string>& filenames, uint32_t numRepeats, uint32_t numWorkers)
+{
+	FileAssetProvider provider;
+	pvr::async::TextureAsyncLoader loader(numWorkers);
+	std::vector<pvr::async::TextureAsyncLoader::AsyncResult> futures;
+	futures.reserve(filenames.size() * numRepeats);
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		for (const std::string& filename : filenames)
+		{
+			futures.push_back(loader.loadTextureAsync(filename, &provider, pvr::getTextureFormatFromFilename(filename.c_str())));
+		}
+	}
+	Result result = {};
+	for (auto& future : futures)
+	{
+		pvr::async::TexturePtr texture = future->get();
+		if (future->isSuccessful())
+		{
+			result.numBytes += texture->getDataSize();
+		}
+		else
+		{
+			++result.numFailed;
+		}
+	}
+	result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	return result;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	uint32_t numRepeats = 1;
+	std::vector<std::string> filenames;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (argv[i][0] != '-')
+		{
+			filenames.push_back(argv[i]);
+		}
+		else if (!readOption(argv[i], "-threads=", maxThreads) && !readOption(argv[i], "-repeat=", numRepeats))
+		{
+			filenames.clear();
+			break;
+		}
+	}
+	if (filenames.empty() || !maxThreads || !numRepeats)
+	{
+		printf("Usage: %s [-threads=<max worker threads>] [-repeat=<times each texture is loaded>] <texture files...>\n", argv[0]);
+		return 1;
+	}
+	// Once to warm up the file cache, so that every run reads the files from memory.
+	loadAll(filenames, 1, maxThreads);
+
+	printf("%u textures, each loaded %u time(s)\n", static_cast<uint32_t>(filenames.size()), numRepeats);
+	double singleWorkerMilliseconds = 0;
+	for (uint32_t numWorkers = 1;; numWorkers = std::min(numWorkers * 2, maxThreads))
+	{
+		const Result result = loadAll(filenames, numRepeats, numWorkers);
+		if (numWorkers == 1)
+		{
+			singleWorkerMilliseconds = result.milliseconds;
+		}
+		printf("%2u worker(s): %9.2f ms  %8.1f MB/s  speedup %5.2fx", numWorkers, result.milliseconds, result.numBytes / (result.milliseconds * 1000.0),
+			singleWorkerMilliseconds / result.milliseconds);
+		if (result.numFailed)
+		{
+			printf("  (%u failed)", result.numFailed);
+		}
+		printf("\n");
+		if (numWorkers == maxThreads)
+		{
+			break;
+		}
+	}
+	return 0;
+}
+//!\endcond
@@ -0,0 +1,160 @@
+/*!
+\brief A command line tool timing the image based lighting bakers of PVRCore/texture/TextureUtils.h: The BRDF lookup
+table at several sizes, and the irradiance and prefiltered cube maps of a generated HDR sky.
+\file PVRCore/tools/PVRTextureUtilsBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRCore/texture/TextureUtils.h"
+#include "PVRCore/glm.h"
+#include "PVRCore/Log.h"
+#include "PVRCore/Threading.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <vector>
+
+namespace {
+// The direction through the centre of a texel of a cube map face, with the faces in the usual +X, -X, +Y, -Y, +Z, -Z
+// order.
+glm::vec3 getTexelDirection(uint32_t face, uint32_t x, uint32_t y, uint32_t faceSize)
+{
+	const float u = 2.f * (x + .5f) / faceSize - 1.f;
+	const float v = 2.f * (y + .5f) / faceSize - 1.f;
+	const glm::vec3 directions[] = { glm::vec3(1.f, -v, -u), glm::vec3(-1.f, -v, u), glm::vec3(u, 1.f, v), glm::vec3(u, -1.f, -v), glm::vec3(u, -v, 1.f),
+		glm::vec3(-u, -v, -1.f) };
+	return glm::normalize(directions[face]);
+}
+
+// An RGBA 32 bit float HDR cube map: A sky gradient, a darker ground and a small, very bright sun. If constant, every
+// texel is 1 instead.
+pvr::Texture createEnvironmentMap(uint32_t faceSize, bool constant)
+{
+	pvr::TextureHeader header(pvr::PixelFormat::RGBA_32323232(), faceSize, faceSize, 1, 1, pvr::ColorSpace::lRGB, pvr::VariableType::SignedFloat, 1, 6);
+	pvr::Texture environmentMap(header);
+	const glm::vec3 sunDirection = glm::normalize(glm::vec3(.3f, .8f, .5f));
+	for (uint32_t face = 0; face < 6; ++face)
+	{
+		glm::vec4* texels = reinterpret_cast<glm::vec4*>(environmentMap.getDataPointer(0, 0, face));
+		for (uint32_t y = 0; y < faceSize; ++y)
+		{
+			for (uint32_t x = 0; x < faceSize; ++x)
+			{
+				const glm::vec3 direction = getTexelDirection(face, x, y, faceSize);
+				const float sun = glm::dot(direction, sunDirection) > .995f ? 50.f : 0.f;
+				const glm::vec3 color = glm::vec3(.2f, .4f, .9f) * std::max(direction.y, 0.f) + glm::vec3(.3f, .25f, .2f) * std::max(-direction.y, 0.f) + sun;
+				texels[y * faceSize + x] = constant ? glm::vec4(1.f) : glm::vec4(color, 1.f);
+			}
+		}
+	}
+	return environmentMap;
+}
+
+// The smallest and the largest red value of all the texels of an RGBA 32 bit float texture.
+void getRedRange(const pvr::Texture& texture, float& minRed, float& maxRed)
+{
+	const glm::vec4* texels = reinterpret_cast<const glm::vec4*>(texture.getDataPointer());
+	minRed = maxRed = texels[0].r;
+	for (uint64_t i = 1; i < texture.getDataSize() / sizeof(glm::vec4); ++i)
+	{
+		minRed = std::min(minRed, texels[i].r);
+		maxRed = std::max(maxRed, texels[i].r);
+	}
+}
+
+double timeBest(uint32_t numRepeats, const std::function<void()>& function)
+{
+	double best = 0;
+	for (uint32_t repeat = 0; repeat < numRepeats; ++repeat)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		function();
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		best = repeat ? std::min(best, milliseconds) : milliseconds;
+	}
+	return best;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t lutSize = 0;
+	uint32_t maxThreads = 0;
+	uint32_t numRepeats = 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-lut=", lutSize) && !readOption(argv[i], "-threads=", maxThreads) && !readOption(argv[i], "-repeat=", numRepeats))
+		{
+			printf("Usage: %s [-lut=<size of the BRDF lookup table, default 256, 512 and 1024>] [-threads=<max threads, default all>] "
+				   "[-repeat=<runs, of which the fastest is reported>]\n",
+				argv[0]);
+			return 1;
+		}
+	}
+	if (!numRepeats)
+	{
+		printf("The number of runs must be greater than zero\n");
+		return 1;
+	}
+
+	try
+	{
+		const uint32_t numThreads = maxThreads ? maxThreads : pvr::async::getSharedTaskScheduler().getNumWorkers() + 1;
+		printf("Best of %u runs, %u thread(s)\n", numRepeats, numThreads);
+		std::vector<uint32_t> lutSizes;
+		if (lutSize)
+		{
+			lutSizes.push_back(lutSize);
+		}
+		else
+		{
+			lutSizes = { 256, 512, 1024 };
+		}
+		for (uint32_t size : lutSizes)
+		{
+			pvr::Texture lut;
+			const double milliseconds = timeBest(numRepeats, [&]() { pvr::assets::generateBRDFLUT(lut, size, maxThreads); });
+			printf("BRDF LUT %4ux%-4u                                   %10.1f ms\n", size, size, milliseconds);
+		}
+
+		pvr::Texture environmentMap = createEnvironmentMap(256, false);
+		pvr::Texture irradianceMap, prefilteredMap;
+		double milliseconds = timeBest(numRepeats, [&]() { pvr::assets::generateIrradianceMap(environmentMap, irradianceMap, 64, maxThreads); });
+		printf("Irradiance map 64x64 from a 256x256 sky              %10.1f ms\n", milliseconds);
+		milliseconds = timeBest(numRepeats, [&]() { pvr::assets::generatePrefilteredMap(environmentMap, prefilteredMap, 256, 0, 1024, maxThreads); });
+		printf("Prefiltered map 256x256, %u MIP levels, 1024 samples  %10.1f ms\n", prefilteredMap.getNumMipMapLevels(), milliseconds);
+
+		// A constant environment must stay constant.
+		environmentMap = createEnvironmentMap(256, true);
+		pvr::assets::generateIrradianceMap(environmentMap, irradianceMap, 16, maxThreads);
+		pvr::assets::generatePrefilteredMap(environmentMap, prefilteredMap, 32, 0, 1024, maxThreads);
+		float minRed, maxRed;
+		getRedRange(irradianceMap, minRed, maxRed);
+		printf("Constant environment of 1: irradiance from %f to %f, ", minRed, maxRed);
+		getRedRange(prefilteredMap, minRed, maxRed);
+		printf("prefiltered from %f to %f\n", minRed, maxRed);
+	}
+	catch (const std::exception& e)
+	{
+		printf("Failed: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
+//!\endcond
@@ -252,6 +252,8 @@ inline uint32_t dataTypeSize(DataType type)
 	case DataType::Int16:
 	case DataType::Int16Norm:
 	case DataType::UInt16:
+	case DataType::UInt16Norm:
+	case DataType::Float16:
 		return 2;
 	case DataType::UInt8:
 	case DataType::UInt8Norm:
@@ -276,6 +278,8 @@ inline uint32_t numDataTypeComponents(DataType type)
 	case DataType::Int16:
 	case DataType::Int16Norm:
 	case DataType::UInt16:
+	case DataType::UInt16Norm:
+	case DataType::Float16:
 	case DataType::Fixed16_16:
 	case DataType::Int8:
 	case DataType::Int8Norm:
@@ -0,0 +1,232 @@
+/*!
+\brief Implementation of methods of the FrameStatistics class.
+\file PVRShell/FrameStatistics.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRShell/FrameStatistics.h"
+#include "PVRCore/stream/FileStream.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace pvr {
+namespace platform {
+namespace {
+inline double toMilliseconds(uint64_t nanoseconds)
+{
+	return static_cast<double>(nanoseconds) * 1e-6;
+}
+
+// Nearest-rank percentile of sorted values.
+inline uint64_t percentile(const std::vector<uint64_t>& sorted, double fraction)
+{
+	const size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+	return sorted[rank ? rank - 1 : 0];
+}
+
+void appendFormat(std::string& out, const char* format, ...)
+{
+	char buffer[256];
+	va_list args;
+	va_start(args, format);
+	const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+	if (length > 0)
+	{
+		out.append(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+	}
+}
+
+void appendJsonString(std::string& out, const std::string& value)
+{
+	out += '"';
+	for (size_t i = 0; i < value.size(); ++i)
+	{
+		const char c = value[i];
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+			out += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			appendFormat(out, "\\u%04x", c);
+		}
+		else
+		{
+			out += c;
+		}
+	}
+	out += '"';
+}
+
+void writeString(Stream& stream, const std::string& value)
+{
+	if (!value.empty())
+	{
+		stream.writeExact(1, value.size(), value.data());
+	}
+}
+} // namespace
+
+void FrameStatistics::clear()
+{
+	for (Samples* samples : { &_cpuTime, &_interval })
+	{
+		samples->min = std::numeric_limits<uint64_t>::max();
+		samples->max = 0;
+		samples->sum = 0;
+		memset(samples->histogram, 0, sizeof(samples->histogram));
+	}
+	_numWarmUpFramesSkipped = 0;
+	_numFrames = 0;
+	_previousFrameStartNs = 0;
+	_hasPreviousFrame = false;
+}
+
+void FrameStatistics::start(uint32_t capacity, uint32_t numWarmUpFrames)
+{
+	clear();
+	_capacity = std::max(capacity, 1u);
+	_numWarmUpFrames = numWarmUpFrames;
+	_cpuTime.ring.assign(_capacity, 0);
+	_interval.ring.assign(_capacity, 0);
+}
+
+void FrameStatistics::add(Samples& samples, uint64_t valueNs)
+{
+	samples.ring[_numFrames % _capacity] = valueNs;
+	samples.min = std::min(samples.min, valueNs);
+	samples.max = std::max(samples.max, valueNs);
+	samples.sum += valueNs;
+	const uint64_t bin = valueNs / (1000ull * HistogramBinWidthUs);
+	++samples.histogram[bin < NumHistogramBins ? bin : NumHistogramBins - 1];
+}
+
+void FrameStatistics::addFrame(uint64_t frameStartNs, uint64_t frameEndNs)
+{
+	if (!isEnabled())
+	{
+		return;
+	}
+	const bool hasInterval = _hasPreviousFrame;
+	const uint64_t intervalNs = frameStartNs - _previousFrameStartNs;
+	_previousFrameStartNs = frameStartNs;
+	_hasPreviousFrame = true;
+	if (!hasInterval || _numWarmUpFramesSkipped < _numWarmUpFrames)
+	{
+		++_numWarmUpFramesSkipped;
+		return;
+	}
+	add(_cpuTime, frameEndNs - frameStartNs);
+	add(_interval, intervalNs);
+	++_numFrames;
+}
+
+uint64_t FrameStatistics::getRetained(const Samples& samples, uint32_t index) const
+{
+	// Oldest first: once the ring has wrapped around, the oldest sample is the one that will be overwritten next.
+	return _numFrames <= _capacity ? samples.ring[index] : samples.ring[(_numFrames + index) % _capacity];
+}
+
+FrameStatistics::Summary FrameStatistics::summarize(const Samples& samples) const
+{
+	Summary summary;
+	memset(&summary, 0, sizeof(summary));
+	summary.numFrames = _numFrames;
+	summary.numRetainedFrames = getNumRetainedFrames();
+	if (!_numFrames)
+	{
+		return summary;
+	}
+
+	std::vector<uint64_t> sorted(samples.ring.begin(), samples.ring.begin() + summary.numRetainedFrames);
+	std::sort(sorted.begin(), sorted.end());
+	summary.min = toMilliseconds(samples.min);
+	summary.average = toMilliseconds(samples.sum) / _numFrames;
+	summary.p50 = toMilliseconds(percentile(sorted, 0.50));
+	summary.p95 = toMilliseconds(percentile(sorted, 0.95));
+	summary.p99 = toMilliseconds(percentile(sorted, 0.99));
+	summary.max = toMilliseconds(samples.max);
+	return summary;
+}
+
+void FrameStatistics::writeJson(Stream& stream, const std::string& applicationName) const
+{
+	std::string json;
+	json.reserve(4096 + getNumRetainedFrames() * 24);
+	json += "{\n\t\"application\": ";
+	appendJsonString(json, applicationName);
+	appendFormat(json, ",\n\t\"warmUpFrames\": %u,\n\t\"frames\": %u,\n\t\"retainedFrames\": %u,\n\t\"histogramBinWidthMs\": %.3f", _numWarmUpFramesSkipped, _numFrames,
+		getNumRetainedFrames(), HistogramBinWidthUs * 1e-3);
+
+	const char* names[] = { "cpuTimeMs", "frameIntervalMs" };
+	const Samples* samplesList[] = { &_cpuTime, &_interval };
+	for (uint32_t kind = 0; kind < 2; ++kind)
+	{
+		const Samples& samples = *samplesList[kind];
+		const Summary summary = summarize(samples);
+		appendFormat(json, ",\n\t\"%s\": {\n\t\t\"min\": %.4f,\n\t\t\"average\": %.4f,\n\t\t\"p50\": %.4f,\n\t\t\"p95\": %.4f,\n\t\t\"p99\": %.4f,\n\t\t\"max\": %.4f,\n",
+			names[kind], summary.min, summary.average, summary.p50, summary.p95, summary.p99, summary.max);
+
+		// The histogram stops at its last non-empty bin.
+		uint32_t numBins = NumHistogramBins;
+		while (numBins && !samples.histogram[numBins - 1])
+		{
+			--numBins;
+		}
+		json += "\t\t\"histogram\": [";
+		for (uint32_t bin = 0; bin < numBins; ++bin)
+		{
+			appendFormat(json, bin ? ", %u" : "%u", samples.histogram[bin]);
+		}
+		json += "],\n\t\t\"samples\": [";
+		for (uint32_t i = 0; i < summary.numRetainedFrames; ++i)
+		{
+			appendFormat(json, i ? ", %.4f" : "%.4f", toMilliseconds(getRetained(samples, i)));
+		}
+		json += "]\n\t}";
+	}
+	json += "\n}\n";
+	writeString(stream, json);
+}
+
+void FrameStatistics::writeCsv(Stream& stream) const
+{
+	const uint32_t numRetained = getNumRetainedFrames();
+	std::string csv;
+	csv.reserve(64 + numRetained * 32);
+	csv += "frame,cpuTimeMs,frameIntervalMs\n";
+	for (uint32_t i = 0; i < numRetained; ++i)
+	{
+		appendFormat(csv, "%u,%.4f,%.4f\n", _numWarmUpFramesSkipped + _numFrames - numRetained + i, toMilliseconds(getRetained(_cpuTime, i)),
+			toMilliseconds(getRetained(_interval, i)));
+	}
+	writeString(stream, csv);
+}
+
+void FrameStatistics::writeReport(const std::string& path, const std::string& applicationName) const
+{
+	FileStream stream(path, "w");
+	stream.open();
+	const size_t extension = path.rfind('.');
+	std::string suffix = extension == std::string::npos ? std::string() : path.substr(extension);
+	std::transform(suffix.begin(), suffix.end(), suffix.begin(), ::tolower);
+	if (suffix == ".csv")
+	{
+		writeCsv(stream);
+	}
+	else
+	{
+		writeJson(stream, applicationName);
+	}
+}
+} // namespace platform
+} // namespace pvr
+//!\endcond
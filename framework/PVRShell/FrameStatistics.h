@@ -0,0 +1,150 @@
+/*!
+\brief Contains the FrameStatistics class, which gathers the frame times of the Shell main loop for benchmarking.
+\file PVRShell/FrameStatistics.h
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+#pragma once
+#include "PVRCore/stream/Stream.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pvr {
+namespace platform {
+/// <summary>Gathers per-frame timings of the Shell main loop: the CPU time of each frame (handling the OS events and
+/// renderFrame, including presenting) and the interval between the starts of consecutive frames. All storage is
+/// allocated by start(), so that recording a frame never allocates. The samples of the most recent frames are kept in
+/// a ring buffer, from which the percentiles are computed; minimum, average, maximum and the histograms cover every
+/// frame recorded after the warm-up frames.</summary>
+class FrameStatistics
+{
+public:
+	/// <summary>The width of the histogram bins, in microseconds.</summary>
+	static const uint32_t HistogramBinWidthUs = 250;
+	/// <summary>The number of histogram bins. The last bin counts every frame longer than the others cover.</summary>
+	static const uint32_t NumHistogramBins = 256;
+
+	/// <summary>Summary statistics of a kind of sample. All times are in milliseconds.</summary>
+	struct Summary
+	{
+		uint32_t numFrames; //!< The number of frames the minimum, average and maximum cover
+		uint32_t numRetainedFrames; //!< The number of (most recent) frames the percentiles cover
+		double min; //!< Minimum
+		double average; //!< Average
+		double p50; //!< Median
+		double p95; //!< 95th percentile
+		double p99; //!< 99th percentile
+		double max; //!< Maximum
+	};
+
+	/// <summary>Constructor. Statistics are disabled until start() is called.</summary>
+	FrameStatistics() : _capacity(0), _numWarmUpFrames(0)
+	{
+		clear();
+	}
+
+	/// <summary>Allocate the storage and start recording, discarding anything recorded before.</summary>
+	/// <param name="capacity">The number of frames whose samples are retained for the percentiles.</param>
+	/// <param name="numWarmUpFrames">The number of frames to ignore at the start. The first frame is always ignored,
+	/// as it has no frame interval.</param>
+	void start(uint32_t capacity, uint32_t numWarmUpFrames);
+
+	/// <summary>Check if start() has been called.</summary>
+	/// <returns>True if frames are being recorded.</returns>
+	bool isEnabled() const
+	{
+		return _capacity != 0;
+	}
+
+	/// <summary>Record a frame. Never allocates.</summary>
+	/// <param name="frameStartNs">The time the frame started, in nanoseconds.</param>
+	/// <param name="frameEndNs">The time the frame ended, in nanoseconds.</param>
+	void addFrame(uint64_t frameStartNs, uint64_t frameEndNs);
+
+	/// <summary>Get the number of frames recorded, excluding the warm-up frames.</summary>
+	/// <returns>The number of frames recorded.</returns>
+	uint32_t getNumFrames() const
+	{
+		return _numFrames;
+	}
+
+	/// <summary>Get the number of warm-up frames that were ignored.</summary>
+	/// <returns>The number of warm-up frames ignored so far.</returns>
+	uint32_t getNumWarmUpFramesSkipped() const
+	{
+		return _numWarmUpFramesSkipped;
+	}
+
+	/// <summary>Get statistics of the CPU time of the frames.</summary>
+	/// <returns>The summary of the CPU times.</returns>
+	Summary getCpuTimeSummary() const
+	{
+		return summarize(_cpuTime);
+	}
+
+	/// <summary>Get statistics of the intervals between frames.</summary>
+	/// <returns>The summary of the frame intervals.</returns>
+	Summary getFrameIntervalSummary() const
+	{
+		return summarize(_interval);
+	}
+
+	/// <summary>Get the histogram of the CPU time of the frames. Bin i counts the frames taking from
+	/// i * HistogramBinWidthUs up to (i + 1) * HistogramBinWidthUs microseconds.</summary>
+	/// <returns>NumHistogramBins frame counts.</returns>
+	const uint32_t* getCpuTimeHistogram() const
+	{
+		return _cpuTime.histogram;
+	}
+
+	/// <summary>Get the histogram of the intervals between frames (see getCpuTimeHistogram).</summary>
+	/// <returns>NumHistogramBins frame counts.</returns>
+	const uint32_t* getFrameIntervalHistogram() const
+	{
+		return _interval.histogram;
+	}
+
+	/// <summary>Write the statistics, the histograms and the retained samples as a JSON object.</summary>
+	/// <param name="stream">The stream to write to.</param>
+	/// <param name="applicationName">The name of the application, recorded in the report.</param>
+	void writeJson(Stream& stream, const std::string& applicationName) const;
+
+	/// <summary>Write the retained samples as CSV, one frame per line.</summary>
+	/// <param name="stream">The stream to write to.</param>
+	void writeCsv(Stream& stream) const;
+
+	/// <summary>Write a report file: CSV if the path ends in ".csv", JSON otherwise.</summary>
+	/// <param name="path">The path of the file to write.</param>
+	/// <param name="applicationName">The name of the application, recorded in JSON reports.</param>
+	void writeReport(const std::string& path, const std::string& applicationName) const;
+
+private:
+	struct Samples
+	{
+		std::vector<uint64_t> ring; // Nanoseconds, in the order recorded (wrapping around)
+		uint64_t min;
+		uint64_t max;
+		uint64_t sum;
+		uint32_t histogram[NumHistogramBins];
+	};
+	void clear();
+	void add(Samples& samples, uint64_t valueNs);
+	Summary summarize(const Samples& samples) const;
+	uint64_t getRetained(const Samples& samples, uint32_t index) const;
+	uint32_t getNumRetainedFrames() const
+	{
+		return _numFrames < _capacity ? _numFrames : _capacity;
+	}
+
+	Samples _cpuTime;
+	Samples _interval;
+	uint32_t _capacity;
+	uint32_t _numWarmUpFrames;
+	uint32_t _numWarmUpFramesSkipped;
+	uint32_t _numFrames;
+	uint64_t _previousFrameStartNs;
+	bool _hasPreviousFrame;
+};
+} // namespace platform
+} // namespace pvr
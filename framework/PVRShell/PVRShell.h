@@ -116,6 +116,15 @@ PVRShell takes a set of command-line arguments which allow items like the positi
 <td>-aasamples=N</td><td>Sets the number of samples to use for full screen anti-aliasing, e.g., 0, 2, 4, 8.</td>
 </tr>
 <tr>
+<td>-assetarchive=path</td><td>Also load assets from the asset archive at path (see PVRCore/stream/AssetArchive.h), for those not found as files in the search paths.</td>
+</tr>
+<tr>
+<td>-benchmark=path</td><td>Record the CPU time and interval of every frame, and write a report of their statistics to path when the application quits: CSV if path ends in ".csv", JSON otherwise.</td>
+</tr>
+<tr>
+<td>-benchmarkwarmup=N</td><td>With -benchmark, the number of frames to skip before recording. Defaults to 10.</td>
+</tr>
+<tr>
 <td>-c=N</td><td>Save a single screenshot or a range, for a given frame or frame range, e.g., -c=14, -c=1-10.</td>
 </tr>
 <tr>
@@ -173,6 +182,9 @@ PVRShell takes a set of command-line arguments which allow items like the positi
 <td>-sw</td><td>Software render.</td>
 </tr>
 <tr>
+<td>-trace=path</td><td>Record the profiling scopes (see PVRCore/Profiling.h) and write them to path as a Chrome trace when the application quits. The framework's own scopes are only recorded if it was built with PVR_ENABLE_PROFILING.</td>
+</tr>
+<tr>
 <td>-version</td><td>Output the SDK version to the debug output.</td>
 </tr>
 <tr>
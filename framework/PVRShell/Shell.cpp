@@ -7,9 +7,11 @@
 //!\cond NO_DOXYGEN
 #include "PVRShell/Shell.h"
 #include "PVRShell/ShellData.h"
+#include "PVRCore/stream/AssetArchive.h"
 #include "PVRCore/stream/FilePath.h"
 #include "PVRShell/OS/ShellOS.h"
 #include "PVRCore/stream/FileStream.h"
+#include "PVRCore/stream/MappedFileStream.h"
 #include "PVRCore/strings/StringFunctions.h"
 #include "PVRCore/types/Types.h"
 #include "PVRCore/Log.h"
@@ -376,6 +378,7 @@ bool Shell::init(struct ShellData* data)
 	if (!_data)
 	{
 		_data = data;
+		getAssetCache(); // Create it before any loader thread may request assets
 		return true;
 	}
 
@@ -614,34 +617,13 @@ uint32_t Shell::getFakeFrameTime() const
 Stream::ptr_type Shell::getAssetStream(const std::string& filename, bool errorIfFileNotFound)
 {
 	// The shell will first attempt to open a file in your readpath with the same name.
-	// This allows you to override any built-in assets
-	Stream::ptr_type stream;
-	// Try absolute path first:
-
-	stream.reset(new FileStream(filename, "rb", false));
-	stream->open();
-	if (stream->isopen())
+	// This allows you to override any built-in assets. The filename is tried as is first, then relative to the
+	// search paths, through an index of their contents built on the first request.
+	Stream::ptr_type stream = getAssetCache().getAssetStream(filename, false);
+	if (stream)
 	{
 		return stream;
 	}
-	stream.reset(0);
-
-	// Then relative to the search paths:
-	const std::vector<std::string>& paths = getOS().getReadPaths();
-	for (size_t i = 0; i < paths.size(); ++i)
-	{
-		std::string filepath(paths[i]);
-		filepath += filename;
-
-		stream.reset(new FileStream(filepath, "rb", false));
-		stream->open();
-		if (stream->isopen())
-		{
-			return stream;
-		}
-
-		stream.reset(0);
-	}
 
 	// Now we attempt to load assets using the OS defined method
 #if defined(_WIN32) // On windows, the filename also matches the resource id in our examples, which is fortunate
@@ -682,6 +664,40 @@ Stream::ptr_type Shell::getAssetStream(const std::string& filename, bool errorIf
 	return Stream::ptr_type((Stream::ptr_type::element_type*)0);
 }
 
+CachingAssetProvider& Shell::getAssetCache()
+{
+	if (!_data->assetProvider)
+	{
+		std::vector<std::string> searchPaths(1, std::string()); // The current directory, or an absolute path
+		const std::vector<std::string>& readPaths = getOS().getReadPaths();
+		searchPaths.insert(searchPaths.end(), readPaths.begin(), readPaths.end());
+		_data->assetProvider.reset(new CachingAssetProvider(searchPaths));
+
+		// Assets are loaded before the rest of the command line is applied, so the archive is attached here.
+		std::string archivePath;
+		if (getCommandLine().getStringOption("-assetarchive", archivePath))
+		{
+			Stream::ptr_type archiveStream = _data->assetProvider->getAssetStream(archivePath, false);
+			if (!archiveStream)
+			{
+				Log(LogLevel::Error, "Asset archive '%s' not found", archivePath.c_str());
+			}
+			else
+			{
+				try
+				{
+					_data->assetProvider->setArchive(std::make_shared<AssetArchive>(std::move(archiveStream)));
+				}
+				catch (const std::exception& e)
+				{
+					Log(LogLevel::Error, "Could not use asset archive '%s': %s", archivePath.c_str(), e.what());
+				}
+			}
+		}
+	}
+	return *_data->assetProvider;
+}
+
 void Shell::setExitMessage(const char* const format, ...)
 {
 	va_list argumentList;
@@ -820,6 +836,16 @@ void Shell::showOutputInfo()
 
 	attributesInfo.append("\n");
 
+	const AssetProviderStatistics assets = getAssetCache().getStatistics();
+	tmp = strings::createFormatted("Asset requests:\t%llu (%llu from memory, %llu indexed, %llu probed, %llu archived, %llu not found)\n",
+		static_cast<unsigned long long>(assets.numRequests), static_cast<unsigned long long>(assets.numMemoryHits), static_cast<unsigned long long>(assets.numIndexHits),
+		static_cast<unsigned long long>(assets.numDirectOpens), static_cast<unsigned long long>(assets.numArchiveHits), static_cast<unsigned long long>(assets.numMisses));
+	attributesInfo.append(tmp);
+	tmp = strings::createFormatted("Asset cache:\t%llu directories (%llu entries) indexed, %llu assets (%llu bytes) in memory\n",
+		static_cast<unsigned long long>(assets.numIndexedDirectories), static_cast<unsigned long long>(assets.numIndexedFiles),
+		static_cast<unsigned long long>(assets.numCachedAssets), static_cast<unsigned long long>(assets.numBytesCached));
+	attributesInfo.append(tmp);
+
 	int32_t frame = getQuitAfterFrame();
 	if (frame != -1)
 	{
@@ -881,6 +907,11 @@ float Shell::getFPS() const
 	return _data->FPS;
 }
 
+const FrameStatistics& Shell::getFrameStatistics() const
+{
+	return _data->frameStatistics;
+}
+
 bool Shell::isScreenRotated() const
 {
 	return _data->attributes.isDisplayPortrait() && isFullScreen();
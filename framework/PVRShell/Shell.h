@@ -846,6 +846,12 @@ public:
 	/// <returns>An Frames-Per-Second value calculated periodically by the application.</returns>
 	float getFPS() const;
 
+	/// <summary>Get the frame time statistics gathered by the shell. They are only recorded if the application was
+	/// started with the -benchmark=[file] command line option, in which case they are written to the file on exit.
+	/// </summary>
+	/// <returns>The frame time statistics.</returns>
+	const FrameStatistics& getFrameStatistics() const;
+
 	/// <summary>Get the current version of the PowerVR SDK.</summary>
 	/// <returns>The current version of the PowerVR SDK.</returns>
 	static const char* getSDKVersion()
@@ -908,6 +914,12 @@ public:
 	/// </returns>
 	Stream::ptr_type getAssetStream(const std::string& filename, bool errorIfFileNotFound = true);
 
+	/// <summary>Get the provider getAssetStream uses to search the filesystem. It indexes the read paths on first use,
+	/// keeps small frequently loaded assets in memory and gathers statistics. Use it to attach an asset archive, or
+	/// call rebuildIndex() after creating files in the read paths.</summary>
+	/// <returns>The asset provider of the shell.</returns>
+	CachingAssetProvider& getAssetCache();
+
 	/// <summary>Gets the ShellOS object owned by this shell.</summary>
 	/// <returns>The ShellOS object owned by this shell.</returns>
 	ShellOS& getOS() const;
@@ -6,8 +6,10 @@
 */
 #pragma once
 #include "PVRCore/commandline/CommandLine.h"
+#include "PVRCore/stream/CachingAssetProvider.h"
 #include "PVRCore/texture/PixelFormat.h"
 #include "PVRCore/types/Types.h"
+#include "PVRShell/FrameStatistics.h"
 #include "PVRShell/Time_.h"
 
 /*! This file simply defines a version std::string. It can be commented out. */
@@ -29,6 +31,13 @@ class ShellOS;
 struct ShellData
 {
 	//!\cond NO_DOXYGEN
+	enum
+	{
+		DefaultBenchmarkWarmUpFrames = 10,
+		DefaultBenchmarkCapacity = 16384,
+		MaxBenchmarkCapacity = 1 << 20,
+	};
+
 	Time timer;
 	uint64_t timeAtInitApplication;
 	uint64_t lastFrameTime;
@@ -40,6 +49,8 @@ struct ShellData
 
 	CommandLineParser* commandLine;
 
+	std::unique_ptr<CachingAssetProvider> assetProvider;
+
 	int32_t captureFrameStart;
 	int32_t captureFrameStop;
 	uint32_t captureFrameScale;
@@ -63,13 +74,20 @@ struct ShellData
 
 	float FPS;
 	bool showFPS;
+	uint64_t fpsPeriodStart;
+	uint32_t fpsPeriodFrames;
+
+	FrameStatistics frameStatistics;
+	std::string benchmarkFile;
+	uint32_t benchmarkWarmUpFrames;
+	std::string traceFile;
 
 	Api contextType;
 	Api minContextType;
 	ShellData()
 		: os(0), commandLine(0), captureFrameStart(-1), captureFrameStop(-1), captureFrameScale(1), trapPointerOnDrag(true), forceFrameTime(false), fakeFrameTime(16),
 		  exiting(false), frameNo(0), forceReleaseInitCycle(false), dieAfterFrame(-1), dieAfterTime(-1), startTime(0), outputInfo(false), weAreDone(false), FPS(0.0f),
-		  showFPS(false), contextType(Api::Unspecified), minContextType(Api::Unspecified){};
+		  showFPS(false), fpsPeriodStart(0), fpsPeriodFrames(0), benchmarkWarmUpFrames(DefaultBenchmarkWarmUpFrames), contextType(Api::Unspecified), minContextType(Api::Unspecified){};
 	//!\endcond
 };
 } // namespace platform
@@ -9,6 +9,7 @@
 #include "PVRShell/Shell.h"
 #include "PVRCore/stream/FileStream.h"
 #include "PVRCore/Log.h"
+#include "PVRCore/Profiling.h"
 #include "PVRShell/Time_.h"
 #include <map>
 #include <cstdlib>
@@ -24,6 +25,13 @@ using std::string;
 
 namespace pvr {
 namespace platform {
+#if defined(PVR_ENABLE_PROFILING)
+namespace {
+// The names of the profiling scopes of the states, indexed by StateMachine::State.
+const char* const StateNames[] = { "NotInitialized", "InitApplication", "InitWindow", "InitView", "RenderScene", "ReleaseView", "ReleaseWindow", "QuitApplication",
+	"PreExit", "Exit" };
+} // namespace
+#endif
 
 StateMachine::StateMachine(OSApplication instance, platform::CommandLineParser& commandLine, OSDATA osdata)
 	: ShellOS(instance, osdata), _currentState(StateNotInitialized), _pause(false)
@@ -57,6 +65,9 @@ Result StateMachine::init()
 		// Build our windows title
 		_shellData.attributes.windowTitle = getApplicationName() + " - Build " + std::string(Shell::getSDKVersion());
 
+		// Profiling starts before the application is created, so that its whole lifetime is traced.
+		startProfiling();
+
 		// setup our state
 		_currentState = StateInitApplication;
 		return Result::Success;
@@ -358,6 +369,26 @@ void setForceFrameTime(Shell& shell, const char* arg, const char* val)
 		}
 	}
 }
+void setAssetArchive(Shell& /*shell*/, const char* arg, const char* val)
+{
+	WARN_AND_QUIT_IF_PARAMETER_NOT_PROVIDED(arg, val);
+	// Applied by Shell::getAssetCache(), as assets are loaded before the command line is applied.
+}
+void setBenchmark(Shell& shell, const char* arg, const char* val)
+{
+	WARN_AND_QUIT_IF_PARAMETER_NOT_PROVIDED(arg, val);
+	shell.getOS()._shellData.benchmarkFile = val;
+}
+void setBenchmarkWarmUp(Shell& shell, const char* arg, const char* val)
+{
+	WARN_AND_QUIT_IF_PARAMETER_NOT_PROVIDED(arg, val);
+	shell.getOS()._shellData.benchmarkWarmUpFrames = static_cast<uint32_t>(std::max(0, atoi(val)));
+}
+void setTrace(Shell& /*shell*/, const char* arg, const char* val)
+{
+	WARN_AND_QUIT_IF_PARAMETER_NOT_PROVIDED(arg, val);
+	// Applied by StateMachine::init(), as tracing starts before the application is created.
+}
 void showVersion(Shell& shell, const char* /*arg*/, const char* /*val*/)
 {
 	Log(LogLevel::Information, "Version: '%hs'", shell.getSDKVersion());
@@ -383,7 +414,8 @@ const std::map<std::string, SetShellParameterPtr> supportedCommandLineOptions{ s
 	std::make_pair("-loglevel", &setLogLevel), std::make_pair("-colorbpp", &setColorBpp), std::make_pair("-colourbpp", &setColorBpp), std::make_pair("-cbpp", &setColorBpp),
 	std::make_pair("-depthbpp", &setDepthBpp), std::make_pair("-dbpp", &setDepthBpp), std::make_pair("-stencilbpp", &setStencilBpp), std::make_pair("-dbpp", &setStencilBpp),
 	std::make_pair("-c", &setCaptureFrames), std::make_pair("-screenshotscale", &setScreenshotScale), std::make_pair("-priority", &setContextPriority),
-	std::make_pair("-config", &setDesiredCconfigId), std::make_pair("-forceframetime", &setForceFrameTime), std::make_pair("-fft", &setForceFrameTime),
+	std::make_pair("-config", &setDesiredCconfigId), std::make_pair("-forceframetime", &setForceFrameTime), std::make_pair("-fft", &setForceFrameTime), std::make_pair("-assetarchive", &setAssetArchive),
+	std::make_pair("-benchmark", &setBenchmark), std::make_pair("-benchmarkwarmup", &setBenchmarkWarmUp), std::make_pair("-trace", &setTrace),
 	std::make_pair("-version", &showVersion), std::make_pair("-fps", &setShowFps), std::make_pair("-info", &showInfo), std::make_pair("-h", &showCommandLineOptionsAndExit),
 	std::make_pair("-help", &showCommandLineOptionsAndExit), std::make_pair("--help", &showCommandLineOptionsAndExit) };
 
@@ -409,6 +441,90 @@ void showCommandLineOptionsAndExit(Shell& shell, const char* /*arg*/, const char
 }
 } // namespace
 
+void StateMachine::startFrameStatistics()
+{
+	if (_shellData.benchmarkFile.empty() || _shellData.frameStatistics.isEnabled())
+	{
+		return;
+	}
+	// Keep every frame if the number of frames is known, so that the percentiles cover the whole run.
+	uint32_t capacity = ShellData::DefaultBenchmarkCapacity;
+	if (_shellData.dieAfterFrame >= 0)
+	{
+		capacity = std::min(static_cast<uint32_t>(_shellData.dieAfterFrame) + 1, static_cast<uint32_t>(ShellData::MaxBenchmarkCapacity));
+	}
+	_shellData.frameStatistics.start(capacity, _shellData.benchmarkWarmUpFrames);
+}
+
+void StateMachine::writeBenchmarkReport()
+{
+	const FrameStatistics& statistics = _shellData.frameStatistics;
+	if (!statistics.isEnabled())
+	{
+		return;
+	}
+	if (!statistics.getNumFrames())
+	{
+		Log(LogLevel::Warning, "Benchmark: No frames were measured after the %u warm-up frame(s).", statistics.getNumWarmUpFramesSkipped());
+	}
+	else
+	{
+		const FrameStatistics::Summary cpu = statistics.getCpuTimeSummary();
+		const FrameStatistics::Summary interval = statistics.getFrameIntervalSummary();
+		Log(LogLevel::Information, "Benchmark: %u frames measured after %u warm-up frame(s).", cpu.numFrames, statistics.getNumWarmUpFramesSkipped());
+		Log(LogLevel::Information, "Benchmark: Frame CPU time (ms): min %.3f, avg %.3f, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f", cpu.min, cpu.average, cpu.p50, cpu.p95,
+			cpu.p99, cpu.max);
+		Log(LogLevel::Information, "Benchmark: Frame interval (ms): min %.3f, avg %.3f, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f", interval.min, interval.average,
+			interval.p50, interval.p95, interval.p99, interval.max);
+	}
+	try
+	{
+		statistics.writeReport(_shellData.benchmarkFile, getApplicationName());
+		Log(LogLevel::Information, "Benchmark: Report written to '%s'.", _shellData.benchmarkFile.c_str());
+	}
+	catch (const std::exception& e)
+	{
+		Log(LogLevel::Error, "Benchmark: Failed to write the report '%s': %s", _shellData.benchmarkFile.c_str(), e.what());
+	}
+}
+
+void StateMachine::startProfiling()
+{
+	if (!_shellData.commandLine->getParsedCommandLine().getStringOption("-trace", _shellData.traceFile) || _shellData.traceFile.empty())
+	{
+		return;
+	}
+#if !defined(PVR_ENABLE_PROFILING)
+	Log(LogLevel::Warning, "Profiling: The framework was built without PVR_ENABLE_PROFILING, so the trace '%s' will only contain the scopes the application records itself.",
+		_shellData.traceFile.c_str());
+#endif
+	profiling::setThreadName("Main");
+	profiling::setEnabled(true);
+}
+
+void StateMachine::writeProfilingTrace()
+{
+	if (_shellData.traceFile.empty())
+	{
+		return;
+	}
+	profiling::setEnabled(false);
+	try
+	{
+		profiling::writeChromeTrace(_shellData.traceFile);
+		Log(LogLevel::Information, "Profiling: Trace written to '%s'.", _shellData.traceFile.c_str());
+	}
+	catch (const std::exception& e)
+	{
+		Log(LogLevel::Error, "Profiling: Failed to write the trace '%s': %s", _shellData.traceFile.c_str(), e.what());
+	}
+	if (profiling::getNumDroppedEvents())
+	{
+		Log(LogLevel::Warning, "Profiling: %llu events were dropped because a thread recorded too many.", static_cast<unsigned long long>(profiling::getNumDroppedEvents()));
+	}
+	_shellData.traceFile.clear();
+}
+
 void StateMachine::applyCommandLine()
 {
 #define WARNING_UNKNOWN_OPTION(x) \
@@ -493,11 +609,25 @@ Result StateMachine::executeOnce(const State state)
 Result StateMachine::executeOnce()
 {
 	// don't handle the events while paused
-	Result result(Result::Success);
 	if (_pause)
 	{
-		return result;
+		return Result::Success;
 	}
+	Result result;
+	{
+		PVR_PROFILE_SCOPE_CATEGORY(StateNames[_currentState], "shell");
+		result = executeState();
+	}
+	if (_currentState == StateExit)
+	{
+		writeProfilingTrace();
+	}
+	return result;
+}
+
+Result StateMachine::executeState()
+{
+	Result result(Result::Success);
 
 	// Handle our state
 	switch (_currentState)
@@ -579,6 +709,9 @@ Result StateMachine::executeOnce()
 		{
 			_currentState = StateRenderScene;
 			_shellData.startTime = _shellData.timer.getCurrentTimeMilliSecs();
+			_shellData.fpsPeriodStart = _shellData.startTime;
+			_shellData.fpsPeriodFrames = 0;
+			startFrameStatistics();
 		}
 		else
 		{
@@ -595,11 +728,21 @@ Result StateMachine::executeOnce()
 		break;
 	case StateRenderScene:
 	{
+		const uint64_t frameStart = _shellData.timer.getCurrentTimeNanoSecs();
+
 		// Process any OS events
-		ShellOS::handleOSEvents();
+		{
+			PVR_PROFILE_SCOPE_CATEGORY("HandleOSEvents", "shell");
+			ShellOS::handleOSEvents();
+		}
 
 		// Call RenderScene
-		result = _shell->shellRenderFrame();
+		{
+			PVR_PROFILE_SCOPE_CATEGORY("RenderFrame", "shell");
+			result = _shell->shellRenderFrame();
+		}
+
+		_shellData.frameStatistics.addFrame(frameStart, _shellData.timer.getCurrentTimeNanoSecs());
 
 		if (_shellData.weAreDone && result == Result::Success)
 		{
@@ -618,17 +761,16 @@ Result StateMachine::executeOnce()
 
 		// Calculate our FPS
 		{
-			static uint64_t prevTime(_shellData.timer.getCurrentTimeMilliSecs()), NumFPSFrames(0);
-			uint64_t time(_shellData.timer.getCurrentTimeMilliSecs()), delta(time - prevTime);
+			uint64_t time(_shellData.timer.getCurrentTimeMilliSecs()), delta(time - _shellData.fpsPeriodStart);
 
-			++NumFPSFrames;
+			++_shellData.fpsPeriodFrames;
 
 			if (delta >= 1000)
 			{
-				_shellData.FPS = 1000.0f * NumFPSFrames / static_cast<float>(delta);
+				_shellData.FPS = 1000.0f * _shellData.fpsPeriodFrames / static_cast<float>(delta);
 
-				NumFPSFrames = 0;
-				prevTime = time;
+				_shellData.fpsPeriodFrames = 0;
+				_shellData.fpsPeriodStart = time;
 
 				if (_shellData.showFPS)
 				{
@@ -682,6 +824,7 @@ Result StateMachine::executeOnce()
 		break;
 	case StateQuitApplication:
 		Log(LogLevel::Debug, "QuitApplication");
+		writeBenchmarkReport();
 		result = _shell->shellQuitApplication();
 
 		if (result != Result::Success)
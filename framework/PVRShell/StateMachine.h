@@ -95,8 +95,13 @@ public:
 	}
 
 private:
+	Result executeState();
 	void applyCommandLine();
 	void readApiFromCommandLine();
+	void startFrameStatistics();
+	void writeBenchmarkReport();
+	void startProfiling();
+	void writeProfilingTrace();
 
 	State _currentState;
 	bool _pause;
@@ -291,26 +291,8 @@ inline pvr::Texture getTextureData(IAssetProvider& app, const char* file)
 #if defined(GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG) || defined(GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG) || defined(GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG) || \
 	defined(GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG)
 
-			// Set up the new texture and header.
-			TextureHeader cDecompressedHeader(outTexture);
-
-			cDecompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID);
-
-			cDecompressedHeader.setChannelType(VariableType::UnsignedByteNorm);
-			cDecompressedTexture = Texture(cDecompressedHeader);
-
-			// Do decompression, one surface at a time.
-			for (uint32_t uiMIPLevel = 0; uiMIPLevel < outTexture.getNumMipMapLevels(); ++uiMIPLevel)
-			{
-				for (uint32_t uiArray = 0; uiArray < outTexture.getNumArrayMembers(); ++uiArray)
-				{
-					for (uint32_t uiFace = 0; uiFace < outTexture.getNumFaces(); ++uiFace)
-					{
-						pvr::PVRTDecompressPVRTC(outTexture.getDataPointer(uiMIPLevel, uiArray, uiFace), (outTexture.getBitsPerPixel() == 2 ? 1 : 0),
-							outTexture.getWidth(uiMIPLevel), outTexture.getHeight(uiMIPLevel), cDecompressedTexture.getDataPointer(uiMIPLevel, uiArray, uiFace));
-					}
-				}
-			}
+			// Decompress all surfaces to RGBA8888 at once.
+			cDecompressedTexture = pvr::PVRTDecompressTexture(outTexture);
 			// Use the decompressed texture instead
 			outTexture = cDecompressedTexture;
 			break;
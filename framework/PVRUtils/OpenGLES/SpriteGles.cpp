@@ -11,6 +11,7 @@ MatrixGroup_)
 #include "PVRCore/strings/StringHash.h"
 #include "PVRUtils/OpenGLES/ErrorsGles.h"
 #include "PVRCore/strings/UnicodeConverter.h"
+#include "PVRCore/Profiling.h"
 #include "PVRCore/types/GpuDataTypes.h"
 
 using glm::vec2;
@@ -61,6 +62,7 @@ Sprite_::Sprite_(UIRenderer& uiRenderer) : _color(1.f, 1.f, 1.f, 1.f), _alphaMod
 
 void Sprite_::commitUpdates() const
 {
+	PVR_PROFILE_SCOPE_CATEGORY("Sprite::commitUpdates", "ui");
 	calculateMvp(0, glm::mat4(1.f), _uiRenderer->getScreenRotation() * _uiRenderer->getProjection(), _uiRenderer->getViewport());
 }
 
@@ -721,6 +723,7 @@ MatrixGroup_::MatrixGroup_(UIRenderer& uiRenderer, uint64_t id) : Group_(uiRende
 
 void MatrixGroup_::commitUpdates() const
 {
+	PVR_PROFILE_SCOPE_CATEGORY("MatrixGroup::commitUpdates", "ui");
 	calculateMvp(0, glm::mat4(1.f), _uiRenderer->getScreenRotation() * _viewProj, _uiRenderer->getViewport());
 }
 
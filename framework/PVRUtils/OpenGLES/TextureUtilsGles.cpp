@@ -156,29 +156,12 @@ TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allo
 					// No longer compressed if this is the case.
 					isCompressedFormat = false;
 
-					// Set up the new texture and header.
-					TextureHeader cDecompressedHeader(texture);
-					cDecompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID);
-
-					cDecompressedHeader.setChannelType(VariableType::UnsignedByteNorm);
-					cDecompressedTexture = Texture(cDecompressedHeader);
+					// Decompress all surfaces to RGBA8888 at once.
+					cDecompressedTexture = PVRTDecompressTexture(*textureToUse);
 
 					// Update the texture format.
 					utils::getOpenGLFormat(cDecompressedTexture.getPixelFormat(), cDecompressedTexture.getColorSpace(), cDecompressedTexture.getChannelType(), glInternalFormat,
 						glFormat, glType, glTypeSize, unused);
-
-					// Do decompression, one surface at a time.
-					for (uint32_t uiMIPLevel = 0; uiMIPLevel < textureToUse->getNumMipMapLevels(); ++uiMIPLevel)
-					{
-						for (uint32_t uiArray = 0; uiArray < textureToUse->getNumArrayMembers(); ++uiArray)
-						{
-							for (uint32_t uiFace = 0; uiFace < textureToUse->getNumFaces(); ++uiFace)
-							{
-								PVRTDecompressPVRTC(textureToUse->getDataPointer(uiMIPLevel, uiArray, uiFace), (textureToUse->getBitsPerPixel() == 2 ? 1 : 0),
-									textureToUse->getWidth(uiMIPLevel), textureToUse->getHeight(uiMIPLevel), cDecompressedTexture.getDataPointer(uiMIPLevel, uiArray, uiFace));
-							}
-						}
-					}
 					// Make sure the function knows to use a decompressed texture instead.
 					textureToUse = &cDecompressedTexture;
 
@@ -216,29 +199,12 @@ TextureUploadResults textureUpload(const Texture& texture, bool isEs2, bool allo
 					// No longer compressed if this is the case.
 					isCompressedFormat = false;
 
-					// Set up the new texture and header.
-					TextureHeader cDecompressedHeader(texture);
-					cDecompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID);
-
-					cDecompressedHeader.setChannelType(VariableType::UnsignedByteNorm);
-					cDecompressedTexture = Texture(cDecompressedHeader);
+					// Decompress all surfaces to RGBA8888 at once.
+					cDecompressedTexture = PVRTDecompressTexture(*textureToUse);
 
 					// Update the texture format.
 					utils::getOpenGLFormat(cDecompressedTexture.getPixelFormat(), cDecompressedTexture.getColorSpace(), cDecompressedTexture.getChannelType(), glInternalFormat,
 						glFormat, glType, glTypeSize, unused);
-
-					// Do decompression, one surface at a time.
-					for (uint32_t uiMIPLevel = 0; uiMIPLevel < textureToUse->getNumMipMapLevels(); ++uiMIPLevel)
-					{
-						for (uint32_t uiArray = 0; uiArray < textureToUse->getNumArrayMembers(); ++uiArray)
-						{
-							for (uint32_t uiFace = 0; uiFace < textureToUse->getNumFaces(); ++uiFace)
-							{
-								PVRTDecompressPVRTC(textureToUse->getDataPointer(uiMIPLevel, uiArray, uiFace), (textureToUse->getBitsPerPixel() == 2 ? 1 : 0),
-									textureToUse->getWidth(uiMIPLevel), textureToUse->getHeight(uiMIPLevel), cDecompressedTexture.getDataPointer(uiMIPLevel, uiArray, uiFace));
-							}
-						}
-					}
 					// Make sure the function knows to use a decompressed texture instead.
 					textureToUse = &cDecompressedTexture;
 
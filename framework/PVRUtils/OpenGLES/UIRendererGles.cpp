@@ -8,6 +8,7 @@
 #include "UIRendererGles.h"
 #include "ErrorsGles.h"
 #include "PVRCore/stream/BufferStream.h"
+#include "PVRCore/Profiling.h"
 #include "PVRUtils/OpenGLES/HelperGles.h"
 #include "PVRUtils/ArialBoldFont.h"
 #include "PVRUtils/PowerVRLogo.h"
@@ -635,6 +636,7 @@ inline Api getCurrentGlesVersion()
 
 void UIRenderer::init(uint32_t width, uint32_t height, bool fullscreen, bool isFrameBufferSRGB)
 {
+	PVR_PROFILE_SCOPE_CATEGORY("UIRenderer::init", "ui");
 	_api = pvr::utils::getCurrentGlesVersion();
 
 	debugThrowOnApiError("");
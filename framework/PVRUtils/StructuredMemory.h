@@ -609,6 +609,96 @@ class StructuredBufferView;
 class StructuredBufferView;
 //!\endcond
 
+//!\cond NO_DOXYGEN
+namespace internal {
+template<typename T>
+inline void writeStructuredValue(char* destination, const T& value)
+{
+	memcpy(destination, &value, sizeof(T));
+}
+// std140 pads each column of a 3-row matrix to a vec4
+inline void writeStructuredValue(char* destination, const glm::mat2x3& value)
+{
+	const glm::mat2x4 newvalue(value);
+	memcpy(destination, &newvalue, sizeof(newvalue));
+}
+inline void writeStructuredValue(char* destination, const glm::mat3x3& value)
+{
+	const glm::mat3x4 newvalue(value);
+	memcpy(destination, &newvalue, sizeof(newvalue));
+}
+inline void writeStructuredValue(char* destination, const glm::mat4x3& value)
+{
+	const glm::mat4x4 newvalue(value);
+	memcpy(destination, &newvalue, sizeof(newvalue));
+}
+} // namespace internal
+//!\endcond
+
+/// <summary>A precompiled reference to an entry of a StructuredBufferView: the result of resolving a path of names
+/// (and the array indices of its ancestors) once, so that the entry can then be written any number of times without
+/// looking up names. Create it with StructuredBufferViewElement::getAccessor or StructuredBufferView::getAccessor, and
+/// write through it with StructuredBufferView::setValue, setValues and setArrayValues. An accessor remains valid as long
+/// as the layout of the StructuredBufferView does not change; it does not depend on the mapped memory.</summary>
+class StructuredBufferViewAccessor
+{
+private:
+	friend class StructuredBufferViewElement;
+	uint32_t _offset; // Offset of array element 0 inside dynamic slice 0
+	uint32_t _arrayStride;
+	uint32_t _dynamicSliceSize;
+	uint32_t _numArrayElements;
+	GpuDatatypes _type;
+
+public:
+	/// <summary>Constructor. Creates an invalid accessor.</summary>
+	StructuredBufferViewAccessor() : _offset(0), _arrayStride(0), _dynamicSliceSize(0), _numArrayElements(0), _type(GpuDatatypes::none) {}
+
+	/// <summary>Get the offset of an array element of this entry from the start of the buffer.</summary>
+	/// <param name="arrayIndex">The array element</param>
+	/// <param name="dynamicSlice">The dynamic slice</param>
+	/// <returns>The offset, in bytes, from the start of the buffer (dynamic slice 0)</returns>
+	uint32_t getOffset(uint32_t arrayIndex = 0, uint32_t dynamicSlice = 0) const
+	{
+		return _offset + arrayIndex * _arrayStride + dynamicSlice * _dynamicSliceSize;
+	}
+
+	/// <summary>Get the distance in bytes between consecutive array elements of this entry.</summary>
+	/// <returns>The array stride</returns>
+	uint32_t getArrayStride() const
+	{
+		return _arrayStride;
+	}
+
+	/// <summary>Get the distance in bytes between the same entry in consecutive dynamic slices.</summary>
+	/// <returns>The dynamic slice size</returns>
+	uint32_t getDynamicSliceSize() const
+	{
+		return _dynamicSliceSize;
+	}
+
+	/// <summary>Get the number of array elements of this entry.</summary>
+	/// <returns>The number of array elements</returns>
+	uint32_t getNumArrayElements() const
+	{
+		return _numArrayElements;
+	}
+
+	/// <summary>Get the type of this entry.</summary>
+	/// <returns>The type of the entry (GpuDatatypes::none for structures)</returns>
+	GpuDatatypes getType() const
+	{
+		return _type;
+	}
+
+	/// <summary>Check if this accessor refers to an entry.</summary>
+	/// <returns>True if the accessor was created from an entry, false if it was default constructed</returns>
+	bool isValid() const
+	{
+		return _arrayStride != 0;
+	}
+};
+
 /// <summary>Defines a StructuredBufferViewElement. A StructuredBufferViewElement handles the public interface used for working with a StructuredMemoryEntry.</summary>
 class StructuredBufferViewElement
 {
@@ -629,24 +719,37 @@ private:
 		}
 		init(dynamicSlice);
 	}
-	void init(uint32_t dynamicSlice = 0)
+	// The offset inside dynamic slice 0, and the root element.
+	uint32_t calcOffsetInSlice(const StructuredMemoryEntry*& root) const
 	{
 		// Get the offset INSIDE CURRENT LEVEL.
-		_offset = _prototype.getArrayElementOffset(_indices[0]);
+		uint32_t offset = _prototype.getArrayElementOffset(_indices[0]);
 		const StructuredMemoryEntry* parent = _prototype.getParent();
 		size_t level = 1; // How many levels up we have gone
-		uint64_t dynamicSliceSize = 0;
-		uint32_t mappedDynamicSlice = 0;
+		root = nullptr;
 		while (parent) // Until we reach the root element
 		{
 			debug_assertion(parent->getNumArrayElements() > _indices[level], "StructuredBufferViewElement: Attempted out-of-bounds access in getOffset");
-			_offset += parent->getArrayElementOffset(_indices[level++]);
-			dynamicSliceSize = parent->getSize();
-			mappedDynamicSlice = parent->getMappedDynamicSlice();
-			// store the mapped memory so we only have to do this lookup once rather than each time setValue is called
-			_mappedMemory = parent->getMappedMemory();
+			offset += parent->getArrayElementOffset(_indices[level++]);
+			root = parent;
 			parent = parent->getParent();
 		}
+		return offset;
+	}
+
+	void init(uint32_t dynamicSlice = 0)
+	{
+		const StructuredMemoryEntry* root;
+		_offset = calcOffsetInSlice(root);
+		uint64_t dynamicSliceSize = 0;
+		uint32_t mappedDynamicSlice = 0;
+		if (root)
+		{
+			dynamicSliceSize = root->getSize();
+			mappedDynamicSlice = root->getMappedDynamicSlice();
+			// store the mapped memory so we only have to do this lookup once rather than each time setValue is called
+			_mappedMemory = root->getMappedMemory();
+		}
 
 		// at this point dynamicSliceSize matches the root size
 		debug_assertion(dynamicSlice >= mappedDynamicSlice, "StructuredBufferViewElement: Mapped dynamic slice must be greater than or equal to the current dynamic slice");
@@ -782,6 +885,22 @@ public:
 		return _offset;
 	}
 
+	/// <summary>Resolve this element into an accessor that can be used to write it (or any of its array elements, in any
+	/// dynamic slice) without further name lookups. The array indices of the ancestors of this element are baked into the
+	/// accessor, while its own array index and the dynamic slice are chosen when writing.</summary>
+	/// <returns>An accessor for this element</returns>
+	StructuredBufferViewAccessor getAccessor() const
+	{
+		const StructuredMemoryEntry* root;
+		StructuredBufferViewAccessor accessor;
+		accessor._offset = calcOffsetInSlice(root) - _prototype._arrayMemberSize * _indices[0];
+		accessor._arrayStride = _prototype._arrayMemberSize;
+		accessor._dynamicSliceSize = root ? static_cast<uint32_t>(root->getSize()) : static_cast<uint32_t>(_prototype.getSize());
+		accessor._numArrayElements = _prototype.getNumArrayElements();
+		accessor._type = _prototype.getPrimitiveType();
+		return accessor;
+	}
+
 	/// <summary>Gets the size of the underlying structure memory entry</summary>
 	/// <returns>Return the size of the underlying structure memory entry.</returns>
 	uint64_t getValueSize() const
@@ -1001,6 +1120,15 @@ private:
 	StructuredMemoryEntry _root;
 	uint32_t _numDynamicSlices;
 
+	char* getAccessedMemory(const StructuredBufferViewAccessor& accessor, uint32_t arrayIndex, uint32_t dynamicSlice)
+	{
+		debug_assertion(accessor.isValid(), "StructuredBufferView: Attempted to write through an invalid accessor");
+		debug_assertion(arrayIndex < accessor.getNumArrayElements(), "StructuredBufferView: Attempted out-of-bounds array access");
+		debug_assertion(_root.getMappedMemory() != nullptr, "StructuredBufferView: Before writing values the memory must be set.");
+		debug_assertion(dynamicSlice >= _root.getMappedDynamicSlice(), "StructuredBufferView: Mapped dynamic slice must be greater than or equal to the current dynamic slice");
+		return static_cast<char*>(_root.getMappedMemory()) + accessor.getOffset(arrayIndex, dynamicSlice - _root.getMappedDynamicSlice());
+	}
+
 public:
 	/// <summary>Constructor. Creates an empty StructuredBufferView.</summary>
 	StructuredBufferView() : _numDynamicSlices(1) {}
@@ -1212,6 +1340,63 @@ public:
 		return _root.getIndex(name);
 	}
 
+	/// <summary>Resolve a first level element into an accessor that can be written without further name lookups. For
+	/// nested elements, use getElementByName(...).getElementByName(...).getAccessor().</summary>
+	/// <param name="name">The name of the element</param>
+	/// <returns>An accessor for the element</returns>
+	StructuredBufferViewAccessor getAccessor(const StringHash& name) const
+	{
+		return getElementByName(name).getAccessor();
+	}
+
+	/// <summary>Write a value through an accessor into the mapped memory.</summary>
+	/// <param name="accessor">An accessor created from this StructuredBufferView</param>
+	/// <param name="value">The value to write</param>
+	/// <param name="arrayIndex">The array element of the accessed entry to write</param>
+	/// <param name="dynamicSlice">The dynamic slice to write. Must not be smaller than the mapped dynamic slice.</param>
+	template<typename T>
+	void setValue(const StructuredBufferViewAccessor& accessor, const T& value, uint32_t arrayIndex = 0, uint32_t dynamicSlice = 0)
+	{
+		internal::writeStructuredValue(getAccessedMemory(accessor, arrayIndex, dynamicSlice), value);
+	}
+
+	/// <summary>Write an array of values through an accessor into the mapped memory, one value per dynamic slice. Use this to
+	/// write the same entry for many objects that each use their own dynamic slice (for example, the matrices of
+	/// each node of a scene).</summary>
+	/// <param name="accessor">An accessor created from this StructuredBufferView</param>
+	/// <param name="values">The values to write</param>
+	/// <param name="numValues">The number of values to write</param>
+	/// <param name="firstDynamicSlice">The dynamic slice to write the first value to. Must not be smaller than the mapped
+	/// dynamic slice.</param>
+	/// <param name="arrayIndex">The array element of the accessed entry to write in each dynamic slice</param>
+	template<typename T>
+	void setValues(const StructuredBufferViewAccessor& accessor, const T* values, uint32_t numValues, uint32_t firstDynamicSlice = 0, uint32_t arrayIndex = 0)
+	{
+		debug_assertion(firstDynamicSlice + numValues <= _numDynamicSlices, "StructuredBufferView: Attempted to write past the last dynamic slice");
+		char* destination = getAccessedMemory(accessor, arrayIndex, firstDynamicSlice);
+		for (uint32_t i = 0; i < numValues; ++i, destination += accessor.getDynamicSliceSize())
+		{
+			internal::writeStructuredValue(destination, values[i]);
+		}
+	}
+
+	/// <summary>Write an array of values through an accessor into consecutive array elements of the accessed entry.</summary>
+	/// <param name="accessor">An accessor created from this StructuredBufferView</param>
+	/// <param name="values">The values to write</param>
+	/// <param name="numValues">The number of values to write</param>
+	/// <param name="firstArrayIndex">The array element to write the first value to</param>
+	/// <param name="dynamicSlice">The dynamic slice to write. Must not be smaller than the mapped dynamic slice.</param>
+	template<typename T>
+	void setArrayValues(const StructuredBufferViewAccessor& accessor, const T* values, uint32_t numValues, uint32_t firstArrayIndex = 0, uint32_t dynamicSlice = 0)
+	{
+		debug_assertion(firstArrayIndex + numValues <= accessor.getNumArrayElements(), "StructuredBufferView: Attempted out-of-bounds array access");
+		char* destination = getAccessedMemory(accessor, firstArrayIndex, dynamicSlice);
+		for (uint32_t i = 0; i < numValues; ++i, destination += accessor.getArrayStride())
+		{
+			internal::writeStructuredValue(destination, values[i]);
+		}
+	}
+
 	//!\cond NO_DOXYGEN
 	std::string toString()
 	{
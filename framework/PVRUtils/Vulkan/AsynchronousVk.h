@@ -68,6 +68,13 @@ public:
 	/// <summary>Initiates the asynchronous image upload.</summary>
 	void loadNow()
 	{
+		if (!beginExecution()) // Cancelled before we got to it
+		{
+			_successful = false;
+			_resultSemaphore->signal();
+			callBack();
+			return;
+		}
 		_result = customUploadImage();
 
 		_successful = (_result.isValid());
@@ -170,7 +177,8 @@ inline void imageUploadAsyncWorker(ImageUploadFuture params)
 
 /// <summary> This class wraps a worker thread that uploads texture to the GPU asynchronously and returns
 /// futures to them. This class would normally be used with Texture Futures as well, in order to do both
-/// of the operations asynchronously.
+/// of the operations asynchronously. Uses a single worker thread, as all uploads record into the same command pool;
+/// the (CPU heavy) texture decoding is parallelised by the TextureAsyncLoader that provides the input futures.
 class ImageApiAsyncUploader : public async::AsyncScheduler<pvrvk::ImageView, ImageUploadFuture, imageUploadAsyncWorker>
 {
 private:
@@ -180,7 +188,7 @@ private:
 	async::Mutex* _cmdQueueMutex;
 
 public:
-	ImageApiAsyncUploader()
+	ImageApiAsyncUploader() : AsyncScheduler(1)
 	{
 		_myInfo = "ImageApiAsyncUploader";
 	}
@@ -221,8 +229,10 @@ public:
 	/// of the Result future (the Texture future) is signalled as complete. Defaults to false, so as to avoid the deadlock that
 	/// will happen if the user attempts to call "get" on the future while the signal will happen just after return of the callback.
 	/// Set to "true" if you want to do something WITHOUT calling "get" on the future, but before the texture is  used.</param>
+	/// <param name="priority">The priority of this upload relative to the other uploads queued on this uploader.</param>
 	/// <returns> A texture upload Future which you can use to query or get the uploaded texture</returns>
-	AsyncApiTexture uploadTextureAsync(const AsyncTexture& texture, bool allowDecompress = true, CallbackType callback = nullptr, bool callbackBeforeSignal = false)
+	AsyncApiTexture uploadTextureAsync(const AsyncTexture& texture, bool allowDecompress = true, CallbackType callback = nullptr, bool callbackBeforeSignal = false,
+		async::TaskPriority priority = async::TaskPriority::Normal)
 	{
 		assertion(_queueVk.isValid(), "Context has not been initialized");
 		auto future = ImageUploadFuture::ElementType::createNew();
@@ -236,10 +246,7 @@ public:
 		params.setCallBack(callback);
 		params._callbackBeforeSignal = callbackBeforeSignal;
 		params._cmdQueueMutex = _cmdQueueMutex;
-		_queueSemaphore.wait();
-		_queue.push_back(future);
-		_queueSemaphore.signal();
-		_workSemaphore.signal();
+		enqueue(future, priority);
 		return future;
 	}
 };
@@ -112,6 +112,7 @@ inline pvrvk::SamplerMipmapMode convertToPVRVkMipmapMode(Filter filter)
 inline pvrvk::Format convertToPVRVkVertexInputFormat(DataType dataType, uint8_t width)
 {
 	static const pvrvk::Format Float32[] = { pvrvk::Format::e_R32_SFLOAT, pvrvk::Format::e_R32G32_SFLOAT, pvrvk::Format::e_R32G32B32_SFLOAT, pvrvk::Format::e_R32G32B32A32_SFLOAT };
+	static const pvrvk::Format Float16[] = { pvrvk::Format::e_R16_SFLOAT, pvrvk::Format::e_R16G16_SFLOAT, pvrvk::Format::e_R16G16B16_SFLOAT, pvrvk::Format::e_R16G16B16A16_SFLOAT };
 	static const pvrvk::Format Int32[] = { pvrvk::Format::e_R32_SINT, pvrvk::Format::e_R32G32_SINT, pvrvk::Format::e_R32G32B32_SINT, pvrvk::Format::e_R32G32B32A32_SINT };
 	static const pvrvk::Format UInt32[] = { pvrvk::Format::e_R32_UINT, pvrvk::Format::e_R32G32_UINT, pvrvk::Format::e_R32G32B32_UINT, pvrvk::Format::e_R32G32B32A32_UINT };
 	static const pvrvk::Format Int8[] = { pvrvk::Format::e_R8_SINT, pvrvk::Format::e_R8G8_SINT, pvrvk::Format::e_R8G8B8_SINT, pvrvk::Format::e_R8G8B8A8_SINT };
@@ -126,6 +127,8 @@ inline pvrvk::Format convertToPVRVkVertexInputFormat(DataType dataType, uint8_t
 	{
 	case DataType::Float32:
 		return Float32[width - 1];
+	case DataType::Float16:
+		return Float16[width - 1];
 	case DataType::Int16:
 		return Int16[width - 1];
 	case DataType::Int16Norm:
@@ -236,26 +236,8 @@ pvrvk::ImageView uploadImageAndViewSubmit(pvrvk::Device& device, const Texture&
 namespace {
 void decompressPvrtc(const Texture& texture, Texture& cDecompressedTexture)
 {
-	// Set up the new texture and header.
-	TextureHeader cDecompressedHeader(texture);
-	// robin: not sure what should happen here. The PVRTGENPIXELID4 macro is used in the old SDK.
-	cDecompressedHeader.setPixelFormat(GeneratePixelType4<'r', 'g', 'b', 'a', 8, 8, 8, 8>::ID);
-
-	cDecompressedHeader.setChannelType(VariableType::UnsignedByteNorm);
-	cDecompressedTexture = Texture(cDecompressedHeader);
-
-	// Do decompression, one surface at a time.
-	for (uint32_t uiMipMapLevel = 0; uiMipMapLevel < texture.getNumMipMapLevels(); ++uiMipMapLevel)
-	{
-		for (uint32_t uiArray = 0; uiArray < texture.getNumArrayMembers(); ++uiArray)
-		{
-			for (uint32_t uiFace = 0; uiFace < texture.getNumFaces(); ++uiFace)
-			{
-				PVRTDecompressPVRTC(texture.getDataPointer(uiMipMapLevel, uiArray, uiFace), (texture.getBitsPerPixel() == 2 ? 1 : 0), texture.getWidth(uiMipMapLevel),
-					texture.getHeight(uiMipMapLevel), cDecompressedTexture.getDataPointer(uiMipMapLevel, uiArray, uiFace));
-			}
-		}
-	}
+	// Decompress all surfaces to RGBA8888 at once.
+	cDecompressedTexture = PVRTDecompressTexture(texture);
 }
 
 inline pvrvk::Format getDepthStencilFormat(const DisplayAttributes& displayAttribs)
@@ -873,9 +855,6 @@ pvrvk::Image uploadImageHelper(pvrvk::Device& device, const Texture& texture, bo
 	uint32_t texHeight = static_cast<uint32_t>(textureToUse->getHeight());
 	uint32_t texDepth = static_cast<uint32_t>(textureToUse->getDepth());
 
-	uint32_t dataWidth = static_cast<uint32_t>(textureToUse->getWidth());
-	uint32_t dataHeight = static_cast<uint32_t>(textureToUse->getHeight());
-
 	uint16_t texMipLevels = static_cast<uint16_t>(textureToUse->getNumMipMapLevels());
 	uint16_t texArraySlices = static_cast<uint16_t>(textureToUse->getNumArrayMembers());
 	uint16_t texFaces = static_cast<uint16_t>(textureToUse->getNumFaces());
@@ -910,36 +889,27 @@ pvrvk::Image uploadImageHelper(pvrvk::Device& device, const Texture& texture, bo
 		// Faces are considered array elements, so each Framework array slice in a cube array will be 6 vulkan array slices.
 
 		// Edit the info to be the small, linear images that we are using.
+		// The surfaces are visited in the order they are laid out in the texture: by mip level, then array slice, then face.
 		std::vector<ImageUpdateInfo> imageUpdates(texMipLevels * texArraySlices * texFaces);
 		uint32_t imageUpdateIndex = 0;
-		for (uint32_t mipLevel = 0; mipLevel < texMipLevels; ++mipLevel)
+		uint32_t minWidth, minHeight, minDepth;
+		textureToUse->getMinDimensionsForFormat(minWidth, minHeight, minDepth);
+		const unsigned char* textureData = textureToUse->getDataPointer();
+		for (const TextureSurface& surface : textureToUse->getSurfaces())
 		{
-			uint32_t minWidth, minHeight, minDepth;
-			textureToUse->getMinDimensionsForFormat(minWidth, minHeight, minDepth);
-			dataWidth = static_cast<uint32_t>(std::max(textureToUse->getWidth(mipLevel), minWidth));
-			dataHeight = static_cast<uint32_t>(std::max(textureToUse->getHeight(mipLevel), minHeight));
-			texWidth = textureToUse->getWidth(mipLevel);
-			texHeight = textureToUse->getHeight(mipLevel);
-			texDepth = textureToUse->getDepth(mipLevel);
-			for (uint32_t arraySlice = 0; arraySlice < texArraySlices; ++arraySlice)
-			{
-				for (uint32_t face = 0; face < texFaces; ++face)
-				{
-					ImageUpdateInfo& update = imageUpdates[imageUpdateIndex];
-					update.imageWidth = texWidth;
-					update.imageHeight = texHeight;
-					update.dataWidth = dataWidth;
-					update.dataHeight = dataHeight;
-					update.depth = texDepth;
-					update.arrayIndex = arraySlice;
-					update.cubeFace = face;
-					update.mipLevel = mipLevel;
-					update.data = textureToUse->getDataPointer(mipLevel, arraySlice, face);
-					update.dataSize = textureToUse->getDataSize(mipLevel, false, false);
-					++imageUpdateIndex;
-				} // next face
-			} // next arrayslice
-		} // next miplevel
+			ImageUpdateInfo& update = imageUpdates[imageUpdateIndex];
+			update.imageWidth = textureToUse->getWidth(surface.mipLevel);
+			update.imageHeight = textureToUse->getHeight(surface.mipLevel);
+			update.dataWidth = static_cast<uint32_t>(std::max(update.imageWidth, minWidth));
+			update.dataHeight = static_cast<uint32_t>(std::max(update.imageHeight, minHeight));
+			update.depth = textureToUse->getDepth(surface.mipLevel);
+			update.arrayIndex = surface.arrayMember;
+			update.cubeFace = surface.face;
+			update.mipLevel = surface.mipLevel;
+			update.data = textureData + surface.offset;
+			update.dataSize = surface.dataSize;
+			++imageUpdateIndex;
+		}
 
 		updateImage(device, commandBuffer, imageUpdates.data(), static_cast<uint32_t>(imageUpdates.size()), format, finalLayout, texFaces > 1, image, bufferAllocator);
 	}
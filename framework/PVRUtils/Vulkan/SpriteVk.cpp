@@ -13,6 +13,7 @@ MatrixGroup_)
 #include "PVRVk/SamplerVk.h"
 #include "PVRVk/ImageVk.h"
 #include "PVRCore/strings/UnicodeConverter.h"
+#include "PVRCore/Profiling.h"
 
 using glm::vec2;
 using glm::vec3;
@@ -63,6 +64,7 @@ Sprite_::Sprite_(UIRenderer& uiRenderer) : _color(1.f, 1.f, 1.f, 1.f), _alphaMod
 
 void Sprite_::commitUpdates() const
 {
+	PVR_PROFILE_SCOPE_CATEGORY("Sprite::commitUpdates", "ui");
 	calculateMvp(0, glm::mat4(1.f), _uiRenderer->getScreenRotation() * _uiRenderer->getProjection(), _uiRenderer->getViewport());
 }
 
@@ -742,6 +744,7 @@ MatrixGroup_::MatrixGroup_(UIRenderer& uiRenderer, uint64_t id) : Group_(uiRende
 
 void MatrixGroup_::commitUpdates() const
 {
+	PVR_PROFILE_SCOPE_CATEGORY("MatrixGroup::commitUpdates", "ui");
 	calculateMvp(0, glm::mat4(1.f), _uiRenderer->getScreenRotation() * _viewProj, _uiRenderer->getViewport());
 }
 
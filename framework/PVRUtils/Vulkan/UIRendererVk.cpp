@@ -7,6 +7,7 @@
 //!\cond NO_DOXYGEN
 
 #include "PVRCore/stream/BufferStream.h"
+#include "PVRCore/Profiling.h"
 #include "PVRVk/ImageVk.h"
 #include "PVRVk/SamplerVk.h"
 #include "PVRVk/PipelineLayoutVk.h"
@@ -210,6 +211,7 @@ Text UIRenderer::createText(const TextElement& textElement)
 void UIRenderer::init(uint32_t width, uint32_t height, bool fullscreen, const RenderPass& renderpass, uint32_t subpass, bool isFrameBufferSrgb, CommandPool& cmdPool, Queue& queue,
 	bool createDefaultLogo, bool createDefaultTitle, bool createDefaultFont, uint32_t maxNumInstances, uint32_t maxNumSprites)
 {
+	PVR_PROFILE_SCOPE_CATEGORY("UIRenderer::init", "ui");
 	destroy();
 	_mustEndCommandBuffer = false;
 	_device = renderpass->getDevice();
@@ -0,0 +1,131 @@
+/*!
+\brief A command line tool comparing the ways of writing per object uniforms with a StructuredBufferView (see
+PVRUtils/StructuredMemory.h): Looking the entries up by name or by index for every write, writing through precompiled
+StructuredBufferViewAccessors, and writing an entry of all the objects at once with StructuredBufferView::setValues.
+\file PVRUtils/tools/PVRStructuredBufferBenchmark.cpp
+\author PowerVR by Imagination, Developer Technology Team
+\copyright Copyright (c) Imagination Technologies Limited.
+*/
+//!\cond NO_DOXYGEN
+#include "PVRUtils/StructuredMemory.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+// The average time of numFrames calls of writeFrame, in microseconds.
+template<typename Function>
+double timeFrames(uint32_t numFrames, const Function& writeFrame)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t frame = 0; frame < numFrames; ++frame)
+	{
+		writeFrame();
+	}
+	return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / numFrames;
+}
+
+bool readOption(const char* arg, const char* name, uint32_t& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0)
+	{
+		return false;
+	}
+	value = static_cast<uint32_t>(strtoul(arg + length, NULL, 10));
+	return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	uint32_t numObjects = 10000;
+	uint32_t numFrames = 200;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!readOption(argv[i], "-objects=", numObjects) && !readOption(argv[i], "-frames=", numFrames))
+		{
+			printf("Usage: %s [-objects=<objects, each with a dynamic slice of the buffer>] [-frames=<frames>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!numObjects || !numFrames)
+	{
+		printf("The number of objects and of frames must be greater than zero\n");
+		return 1;
+	}
+
+	// The per node uniforms of a typical example: Two matrices and a normal matrix (a mat3, padded as std140 requires)
+	pvr::utils::StructuredMemoryDescription description;
+	description.addElement("MVPMatrix", pvr::GpuDatatypes::mat4x4);
+	description.addElement("WorldViewMatrix", pvr::GpuDatatypes::mat4x4);
+	description.addElement("NormalMatrix", pvr::GpuDatatypes::mat3x3);
+	pvr::utils::StructuredBufferView view;
+	view.initDynamic(description, numObjects, pvr::BufferUsageFlags::UniformBuffer, 256);
+
+	std::vector<glm::mat4> mvpMatrices(numObjects), worldViewMatrices(numObjects);
+	std::vector<glm::mat3> normalMatrices(numObjects);
+	for (uint32_t i = 0; i < numObjects; ++i)
+	{
+		mvpMatrices[i] = glm::mat4(static_cast<float>(i));
+		worldViewMatrices[i] = glm::mat4(static_cast<float>(i) * 2.f);
+		normalMatrices[i] = glm::mat3(static_cast<float>(i) * 3.f);
+	}
+
+	// Each method writes to its own copy of the memory, so that the results can be compared. The padding is never
+	// written, so all the copies start with the same contents, which no value written matches.
+	const char fill = static_cast<char>(0xCD);
+	std::vector<char> byName(view.getSize(), fill), byIndex(view.getSize(), fill), byAccessor(view.getSize(), fill), bySetValues(view.getSize(), fill);
+
+	view.pointToMappedMemory(byName.data());
+	const double byNameMicroseconds = timeFrames(numFrames, [&]() {
+		for (uint32_t i = 0; i < numObjects; ++i)
+		{
+			view.getElementByName("MVPMatrix", 0, i).setValue(mvpMatrices[i]);
+			view.getElementByName("WorldViewMatrix", 0, i).setValue(worldViewMatrices[i]);
+			view.getElementByName("NormalMatrix", 0, i).setValue(normalMatrices[i]);
+		}
+	});
+
+	const uint32_t mvpIndex = view.getIndex("MVPMatrix"), worldViewIndex = view.getIndex("WorldViewMatrix"), normalIndex = view.getIndex("NormalMatrix");
+	view.pointToMappedMemory(byIndex.data());
+	const double byIndexMicroseconds = timeFrames(numFrames, [&]() {
+		for (uint32_t i = 0; i < numObjects; ++i)
+		{
+			view.getElement(mvpIndex, 0, i).setValue(mvpMatrices[i]);
+			view.getElement(worldViewIndex, 0, i).setValue(worldViewMatrices[i]);
+			view.getElement(normalIndex, 0, i).setValue(normalMatrices[i]);
+		}
+	});
+
+	const pvr::utils::StructuredBufferViewAccessor mvp = view.getAccessor("MVPMatrix");
+	const pvr::utils::StructuredBufferViewAccessor worldView = view.getAccessor("WorldViewMatrix");
+	const pvr::utils::StructuredBufferViewAccessor normal = view.getAccessor("NormalMatrix");
+	view.pointToMappedMemory(byAccessor.data());
+	const double byAccessorMicroseconds = timeFrames(numFrames, [&]() {
+		for (uint32_t i = 0; i < numObjects; ++i)
+		{
+			view.setValue(mvp, mvpMatrices[i], 0, i);
+			view.setValue(worldView, worldViewMatrices[i], 0, i);
+			view.setValue(normal, normalMatrices[i], 0, i);
+		}
+	});
+
+	view.pointToMappedMemory(bySetValues.data());
+	const double bySetValuesMicroseconds = timeFrames(numFrames, [&]() {
+		view.setValues(mvp, mvpMatrices.data(), numObjects);
+		view.setValues(worldView, worldViewMatrices.data(), numObjects);
+		view.setValues(normal, normalMatrices.data(), numObjects);
+	});
+
+	printf("%u objects with a dynamic slice of %u bytes each, 3 entries written per object per frame, %u frames\n", numObjects,
+		static_cast<uint32_t>(view.getDynamicSliceSize()), numFrames);
+	printf("getElementByName + setValue:  %9.1f us/frame\n", byNameMicroseconds);
+	printf("getElement(index) + setValue: %9.1f us/frame  %s\n", byIndexMicroseconds, byIndex == byName ? "identical" : "DIFFERENT");
+	printf("accessor setValue per object: %9.1f us/frame  %s\n", byAccessorMicroseconds, byAccessor == byName ? "identical" : "DIFFERENT");
+	printf("setValues per entry:          %9.1f us/frame  %s\n", bySetValuesMicroseconds, bySetValues == byName ? "identical" : "DIFFERENT");
+	return byIndex == byName && byAccessor == byName && bySetValues == byName ? 0 : 1;
+}
+//!\endcond